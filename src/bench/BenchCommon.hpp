@@ -0,0 +1,94 @@
+#pragma once
+
+// BenchCommon.hpp — Lo comun de los benchmarks de Diagnostics.
+// Solo se compila con -DPAIMON_BENCHMARKS=ON (CMake); en el mod publicado no
+// entra ni el codigo de src/bench/ ni sus botones.
+//
+// Cada benchmark expone un runXBenchmark() sincrono que devuelve su reporte y
+// deja el detalle en el log. launch() lo corre en el carril Maintenance del
+// pool de ThumbnailLoader (nada de hilos sueltos: cleanup() drena el pool y
+// hace join antes de que mueran los singletons) y pasa el reporte al hilo
+// principal.
+
+#include "../core/QualityConfig.hpp"
+#include "../features/thumbnails/services/ThumbnailLoader.hpp"
+#include "../utils/PaimonNotification.hpp"
+#include <Geode/Geode.hpp>
+#include <Geode/utils/string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paimon::bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double msBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+inline double msSince(Clock::time_point t0) {
+    return msBetween(t0, Clock::now());
+}
+
+inline int64_t nsBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+}
+
+// reordena `v` (nth_element); p en [0, 1]
+inline double percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+    std::nth_element(v.begin(), v.begin() + static_cast<ptrdiff_t>(idx), v.end());
+    return static_cast<double>(v[idx]);
+}
+
+inline std::vector<uint8_t> readFile(std::filesystem::path const& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// GIFs de la cache de thumbnails (cacheDir()); corpus de los benchmarks de GIF
+inline std::vector<std::filesystem::path> collectCachedGIFs(size_t maxFiles) {
+    std::vector<std::filesystem::path> out;
+    std::error_code ec;
+    auto dir = paimon::quality::cacheDir();
+    if (!std::filesystem::exists(dir, ec)) return out;
+    for (auto const& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (ec || !entry.is_regular_file()) continue;
+        if (geode::utils::string::toLower(geode::utils::string::pathToString(entry.path().extension())) != ".gif") continue;
+        out.push_back(entry.path());
+    }
+    // los mas grandes primero: son los que importan para el pico
+    std::sort(out.begin(), out.end(), [](auto const& a, auto const& b) {
+        std::error_code e1, e2;
+        return std::filesystem::file_size(a, e1) > std::filesystem::file_size(b, e2);
+    });
+    if (out.size() > maxFiles) out.resize(maxFiles);
+    return out;
+}
+
+/**
+ * Corre `run` en el carril Maintenance y luego `done(report)` en el hilo
+ * principal. `label` sale en la notificacion de arranque.
+ */
+template <class Run, class Done>
+void launch(std::string const& label, Run run, Done done) {
+    PaimonNotify::create(fmt::format("Running {}...", label), geode::NotificationIcon::Loading)->show();
+    bool queued = ThumbnailLoader::get().submitMaintenance([run = std::move(run), done = std::move(done)]() {
+        auto report = std::make_shared<decltype(run())>(run());
+        geode::Loader::get()->queueInMainThread([done, report]() { done(*report); });
+    });
+    if (!queued) {
+        PaimonNotify::create(fmt::format("Can't run {} right now.", label), geode::NotificationIcon::Error)->show();
+    }
+}
+
+} // namespace paimon::bench
@@ -0,0 +1,33 @@
+#pragma once
+
+// DominantColorsBenchmark.hpp — DominantColors::extract contra la version
+// anterior (hasta 2000 muestras convertidas a LAB una a una y k-means sobre
+// los pixeles). Con las miniaturas del manifest (las mismas que recorre
+// LevelColors::extractColorsFromCache) mide el tiempo por imagen de las dos y
+// la diferencia de color (CIEDE2000) entre lo que sacan.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace paimon::bench {
+
+struct DominantColorsTiming {
+    double totalMs = 0;
+    double meanMs = 0;   // por imagen
+    double maxMs = 0;
+};
+
+struct DominantColorsBenchReport {
+    size_t images = 0;
+    uint64_t pixels = 0;
+    DominantColorsTiming legacy;
+    DominantColorsTiming current;
+    double meanDeltaE = 0;   // por imagen, el peor de los dos colores
+    double maxDeltaE = 0;
+    size_t outOfTolerance = 0;  // imagenes por encima de TOLERANCE_DELTA_E
+    static constexpr double TOLERANCE_DELTA_E = 10.0;
+};
+
+DominantColorsBenchReport runDominantColorsBenchmark(size_t maxImages = 64, int repeats = 5);
+
+} // namespace paimon::bench
@@ -0,0 +1,177 @@
+#include "GIFCacheBenchmark.hpp"
+#include "BenchCommon.hpp"
+#include "../core/QualityConfig.hpp"
+#include "../utils/GIFDecoder.hpp"
+#include "../utils/GIFFrameStore.hpp"
+#include <Geode/Geode.hpp>
+#include <Geode/utils/string.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace geode::prelude;
+
+namespace paimon::bench {
+
+namespace {
+// ── Formato anterior (v2): cabecera + RGBA8888 tal cual por frame ───
+
+namespace legacy {
+    constexpr uint32_t VERSION = 2;
+
+    void write(std::string const& path, int width, int height, std::vector<GIFDecoder::Frame> const& frames) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        uint32_t frameCount = static_cast<uint32_t>(frames.size());
+        file.write(reinterpret_cast<char const*>(&VERSION), sizeof(VERSION));
+        file.write(reinterpret_cast<char const*>(&width), sizeof(width));
+        file.write(reinterpret_cast<char const*>(&height), sizeof(height));
+        file.write(reinterpret_cast<char const*>(&frameCount), sizeof(frameCount));
+        for (auto const& frame : frames) {
+            float delay = frame.delayMs / 1000.0f;
+            uint32_t dataSize = static_cast<uint32_t>(frame.pixels.size());
+            file.write(reinterpret_cast<char const*>(&delay), sizeof(delay));
+            file.write(reinterpret_cast<char const*>(&frame.width), sizeof(frame.width));
+            file.write(reinterpret_cast<char const*>(&frame.height), sizeof(frame.height));
+            file.write(reinterpret_cast<char const*>(&dataSize), sizeof(dataSize));
+            file.write(reinterpret_cast<char const*>(frame.pixels.data()), dataSize);
+        }
+    }
+
+    // lee hasta `maxFrames` frames; mismo recorrido que el loadFromDiskCache de antes
+    std::vector<std::vector<uint8_t>> read(std::string const& path, size_t maxFrames) {
+        std::vector<std::vector<uint8_t>> out;
+        std::ifstream file(path, std::ios::binary);
+        uint32_t version = 0, frameCount = 0;
+        int width = 0, height = 0;
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&width), sizeof(width));
+        file.read(reinterpret_cast<char*>(&height), sizeof(height));
+        file.read(reinterpret_cast<char*>(&frameCount), sizeof(frameCount));
+        if (!file || version != VERSION) return out;
+        for (uint32_t i = 0; i < frameCount && out.size() < maxFrames; ++i) {
+            float delay;
+            int w, h;
+            uint32_t dataSize;
+            file.read(reinterpret_cast<char*>(&delay), sizeof(delay));
+            file.read(reinterpret_cast<char*>(&w), sizeof(w));
+            file.read(reinterpret_cast<char*>(&h), sizeof(h));
+            file.read(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
+            if (!file) break;
+            std::vector<uint8_t> pixels(dataSize);
+            file.read(reinterpret_cast<char*>(pixels.data()), dataSize);
+            out.push_back(std::move(pixels));
+        }
+        return out;
+    }
+}
+
+std::vector<std::vector<uint8_t>> readStore(std::string const& path, size_t maxFrames) {
+    std::vector<std::vector<uint8_t>> out;
+    GIFFrameStore::Reader reader;
+    if (!reader.open(path)) return out;
+    GIFDecoder::Frame frame;
+    while (out.size() < maxFrames && reader.nextFrame(frame)) {
+        out.push_back(frame.pixels);
+    }
+    return out;
+}
+
+uint64_t fileBytes(std::filesystem::path const& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+} // namespace
+
+GIFCacheBenchReport runGIFCacheBenchmark(size_t maxFiles) {
+    GIFCacheBenchReport report;
+
+    auto dir = paimon::quality::cacheDir() / "gif-cache-bench";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    auto rawPath = geode::utils::string::pathToString(dir / "raw.bin");
+    auto storePath = geode::utils::string::pathToString(dir / "store.bin");
+
+    for (auto const& path : collectCachedGIFs(maxFiles)) {
+        auto data = readFile(path);
+        if (data.empty()) continue;
+
+        GIFDecoder::Stream stream(data.data(), data.size());
+        if (!stream.valid()) continue;
+        std::vector<GIFDecoder::Frame> frames;
+        GIFDecoder::Frame frame;
+        while (stream.nextFrame(frame)) frames.push_back(std::move(frame));
+        if (frames.empty()) continue;
+        int width = stream.width();
+        int height = stream.height();
+
+        auto t0 = Clock::now();
+        legacy::write(rawPath, width, height, frames);
+        report.raw.writeMs += msSince(t0);
+
+        t0 = Clock::now();
+        GIFFrameStore::Writer writer;
+        bool written = writer.open(storePath, width, height);
+        for (auto const& f : frames) written = written && writer.append(f);
+        written = writer.finish() && written;
+        report.store.writeMs += msSince(t0);
+        if (!written) continue;
+
+        uint64_t rawBytes = fileBytes(rawPath);
+        uint64_t storeBytes = fileBytes(storePath);
+
+        t0 = Clock::now();
+        legacy::read(rawPath, 1);
+        double rawFirst = msSince(t0);
+        t0 = Clock::now();
+        readStore(storePath, 1);
+        double storeFirst = msSince(t0);
+
+        t0 = Clock::now();
+        auto rawFrames = legacy::read(rawPath, frames.size());
+        double rawLoad = msSince(t0);
+        t0 = Clock::now();
+        auto storeFrames = readStore(storePath, frames.size());
+        double storeLoad = msSince(t0);
+
+        bool same = rawFrames.size() == frames.size() && storeFrames.size() == frames.size();
+        for (size_t i = 0; same && i < frames.size(); ++i) {
+            same = rawFrames[i] == frames[i].pixels && storeFrames[i] == frames[i].pixels;
+        }
+        if (!same) report.mismatchedFiles++;
+
+        log::info("[GIFCacheBenchmark] {} ({}x{}, {} frames, GIF {} KB): {} KB -> {} KB, "
+            "primer frame {:.2f}ms -> {:.2f}ms, todo {:.1f}ms -> {:.1f}ms{}",
+            geode::utils::string::pathToString(path.filename()), width, height, frames.size(),
+            data.size() / 1024, rawBytes / 1024, storeBytes / 1024,
+            rawFirst, storeFirst, rawLoad, storeLoad, same ? "" : " (DISTINTOS)");
+
+        report.files++;
+        report.frames += frames.size();
+        report.gifBytes += data.size();
+        report.raw.bytes += rawBytes;
+        report.store.bytes += storeBytes;
+        report.raw.firstFrameMs += rawFirst;
+        report.store.firstFrameMs += storeFirst;
+        report.raw.loadMs += rawLoad;
+        report.store.loadMs += storeLoad;
+    }
+
+    std::filesystem::remove_all(dir, ec);
+
+    if (report.files == 0) {
+        log::info("[GIFCacheBenchmark] no hay GIFs en la cache");
+        return report;
+    }
+    log::info("[GIFCacheBenchmark] {} GIFs, {} frames: disco {} KB -> {} KB (GIFs {} KB), "
+        "escritura {:.1f}ms -> {:.1f}ms, primer frame {:.1f}ms -> {:.1f}ms, lectura {:.1f}ms -> {:.1f}ms",
+        report.files, report.frames, report.raw.bytes / 1024, report.store.bytes / 1024, report.gifBytes / 1024,
+        report.raw.writeMs, report.store.writeMs, report.raw.firstFrameMs, report.store.firstFrameMs,
+        report.raw.loadMs, report.store.loadMs);
+    if (report.mismatchedFiles) {
+        log::warn("[GIFCacheBenchmark] {} GIFs con frames distintos tras leer la cache", report.mismatchedFiles);
+    }
+    return report;
+}
+
+} // namespace paimon::bench
@@ -0,0 +1,33 @@
+#pragma once
+
+// GIFCacheBenchmark.hpp — Cache en disco de AnimatedGIFSprite: formato viejo
+// (v2, RGBA8888 sin comprimir por frame) contra GIFFrameStore (v3, keyframe +
+// rects delta comprimidos con paimon::lz). Con los GIFs de la cache de
+// thumbnails escribe los dos formatos a una carpeta temporal y mide tamaño en
+// disco, tiempo de escritura, tiempo hasta el primer frame y lectura completa
+// (con los frames reconstruidos), comprobando que salen iguales.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace paimon::bench {
+
+struct GIFCacheFormatResult {
+    uint64_t bytes = 0;       // todos los archivos
+    double writeMs = 0;
+    double firstFrameMs = 0;  // suma de abrir + primer frame
+    double loadMs = 0;        // suma de leer todos los frames
+};
+
+struct GIFCacheBenchReport {
+    size_t files = 0;
+    uint64_t frames = 0;
+    uint64_t gifBytes = 0;    // los GIFs originales
+    GIFCacheFormatResult raw;    // v2
+    GIFCacheFormatResult store;  // v3 (GIFFrameStore)
+    size_t mismatchedFiles = 0;
+};
+
+GIFCacheBenchReport runGIFCacheBenchmark(size_t maxFiles = 24);
+
+} // namespace paimon::bench
@@ -0,0 +1,522 @@
+#include "GIFDecodeBenchmark.hpp"
+#include "BenchCommon.hpp"
+#include "../utils/GIFDecoder.hpp"
+#include <Geode/Geode.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace geode::prelude;
+
+namespace paimon::bench {
+
+namespace {
+// ── Kernel anterior (copia tal cual, sin logs) ──────────────────────
+
+namespace legacy {
+    struct RawFrame {
+        std::vector<uint8_t> pixels;
+        int width, height, left, top;
+    };
+
+    bool parseHeader(uint8_t const*& ptr, uint8_t const* end, int& width, int& height);
+    bool parseColorTable(uint8_t const*& ptr, uint8_t const* end, std::vector<uint8_t>& palette, int size);
+    bool parseFrame(uint8_t const*& ptr, uint8_t const* end, RawFrame& frame, std::vector<uint8_t> const& globalPalette, int transparentIndex, bool hasTransparency);
+
+    GIFDecoder::GIFData decode(uint8_t const* data, size_t size) {
+        GIFDecoder::GIFData result;
+        result.isAnimated = false;
+
+        if (!GIFDecoder::isGIF(data, size)) {
+            return result;
+        }
+
+        uint8_t const* ptr = data;
+        uint8_t const* end = data + size;
+
+        if (!parseHeader(ptr, end, result.width, result.height)) {
+            return result;
+        }
+
+        // leo flags
+        if (ptr >= end) return result;
+        uint8_t flags = *ptr++;
+        bool hasGlobalColorTable = (flags & 0x80) != 0;
+        int globalColorTableSize = 1 << ((flags & 0x07) + 1);
+
+        // salto color de fondo y aspect ratio
+        ptr += 2;
+
+        // leo la tabla global de colores si toca
+        std::vector<uint8_t> globalPalette;
+        if (hasGlobalColorTable) {
+            if (!parseColorTable(ptr, end, globalPalette, globalColorTableSize)) {
+                return result;
+            }
+        }
+
+        // parseo frames
+        int frameCount = 0;
+        int currentDelay = 100; // delay por defecto
+        int transparentIndex = -1;
+        bool hasTransparency = false;
+        int disposalMethod = 0; // 0: nada, 1: dejar, 2: limpiar, 3: restaurar previo
+
+        // canvas donde voy componiendo el GIF entero
+        std::vector<uint8_t> canvas(result.width * result.height * 4, 0);
+        std::vector<uint8_t> backupCanvas = canvas;
+
+        int prevDisposal = 0;
+        RawFrame prevRawFrame = {std::vector<uint8_t>(), 0, 0, 0, 0};
+
+        while (ptr < end && frameCount < 500) {
+            if (*ptr == 0x21) { // bloque de extension
+                ptr++;
+                if (ptr >= end) break;
+                uint8_t label = *ptr++;
+
+                // extension de control grafico (delays y transparencia)
+                if (label == 0xF9) {
+                    if (ptr + 1 >= end) break;
+                    uint8_t blockSize = *ptr++;
+                    if (blockSize == 4 && ptr + 4 <= end) {
+                        uint8_t packed = *ptr++;
+                        uint16_t delay = ptr[0] | (ptr[1] << 8);
+                        uint8_t transIdx = ptr[2];
+                        ptr += 3;
+
+                        currentDelay = (delay == 0) ? 100 : delay * 10; // GIF usa centesimas de segundo
+                        hasTransparency = (packed & 1) != 0;
+                        transparentIndex = transIdx;
+                        disposalMethod = (packed >> 2) & 0x07;
+                    } else {
+                        ptr += blockSize;
+                    }
+                    // salto terminador de bloque
+                    if (ptr < end && *ptr == 0) ptr++;
+                } else {
+                    // salto cualquier otra extension que no me interesa
+                    while (ptr < end) {
+                        uint8_t blockSize = *ptr++;
+                        if (blockSize == 0) break;
+                        ptr += blockSize;
+                    }
+                }
+            } else if (*ptr == 0x2C) { // descriptor de imagen
+                RawFrame rawFrame;
+                if (parseFrame(ptr, end, rawFrame, globalPalette, transparentIndex, hasTransparency)) {
+
+                    // 1. manejo el "disposal" del frame anterior
+                    if (prevDisposal == 2) {
+                        // restauro a fondo (transparente)
+                        for (int y = 0; y < prevRawFrame.height; y++) {
+                            for (int x = 0; x < prevRawFrame.width; x++) {
+                                int cy = prevRawFrame.top + y;
+                                int cx = prevRawFrame.left + x;
+                                if (cx >= 0 && cx < result.width && cy >= 0 && cy < result.height) {
+                                    int idx = (cy * result.width + cx) * 4;
+                                    canvas[idx] = 0;
+                                    canvas[idx+1] = 0;
+                                    canvas[idx+2] = 0;
+                                    canvas[idx+3] = 0;
+                                }
+                            }
+                        }
+                    } else if (prevDisposal == 3) {
+                        // restauro al canvas anterior
+                        canvas = backupCanvas;
+                    }
+
+                    // 2. si este frame pide disposal 3, guardo copia del canvas
+                    if (disposalMethod == 3) {
+                        backupCanvas = canvas;
+                    }
+
+                    // 3. dibujo el frame actual encima del canvas
+                    for (int y = 0; y < rawFrame.height; y++) {
+                        for (int x = 0; x < rawFrame.width; x++) {
+                            int cy = rawFrame.top + y;
+                            int cx = rawFrame.left + x;
+                            if (cx >= 0 && cx < result.width && cy >= 0 && cy < result.height) {
+                                int rawIdx = (y * rawFrame.width + x) * 4;
+                                int canvasIdx = (cy * result.width + cx) * 4;
+
+                                if (rawFrame.pixels[rawIdx + 3] > 0) {
+                                    canvas[canvasIdx] = rawFrame.pixels[rawIdx];
+                                    canvas[canvasIdx+1] = rawFrame.pixels[rawIdx+1];
+                                    canvas[canvasIdx+2] = rawFrame.pixels[rawIdx+2];
+                                    canvas[canvasIdx+3] = rawFrame.pixels[rawIdx+3];
+                                }
+                            }
+                        }
+                    }
+
+                    // 4. guardo un frame que cubre todo el canvas
+                    GIFDecoder::Frame frame;
+                    frame.left = 0;
+                    frame.top = 0;
+                    frame.width = result.width;
+                    frame.height = result.height;
+                    frame.delayMs = currentDelay;
+                    frame.pixels = canvas;
+
+                    result.frames.push_back(frame);
+                    frameCount++;
+
+                    // 5. actualizo estado para el siguiente frame
+                    prevDisposal = disposalMethod;
+                    prevRawFrame = rawFrame;
+
+                } else {
+                    break;
+                }
+            } else if (*ptr == 0x3B) { // trailer (fin del GIF)
+                break;
+            } else {
+                ptr++; // byte que no reconozco, lo salto
+            }
+        }
+
+        result.isAnimated = result.frames.size() > 1;
+
+        return result;
+    }
+
+    bool parseHeader(uint8_t const*& ptr, uint8_t const* end, int& width, int& height) {
+        if (ptr + 13 > end) return false;
+
+        ptr += 6; // salto firma
+        width = ptr[0] | (ptr[1] << 8);
+        height = ptr[2] | (ptr[3] << 8);
+        ptr += 4;
+
+        return width > 0 && height > 0 && width <= 4096 && height <= 4096;
+    }
+
+    bool parseColorTable(uint8_t const*& ptr, uint8_t const* end, std::vector<uint8_t>& palette, int size) {
+        if (ptr + size * 3 > end) return false;
+
+        palette.resize(size * 3);
+        memcpy(palette.data(), ptr, size * 3);
+        ptr += size * 3;
+
+        return true;
+    }
+
+    // descompresion LZW del stream de indices
+    bool lzwDecode(std::vector<uint8_t> const& compressed, std::vector<uint8_t>& output, int minCodeSize, int pixelCount) {
+        int clearCode = 1 << minCodeSize;
+        int eoiCode = clearCode + 1;
+        int nextCode = eoiCode + 1;
+        int currentCodeSize = minCodeSize + 1;
+        int codeMask = (1 << currentCodeSize) - 1;
+
+        // entrada del diccionario LZW
+        struct DictEntry {
+            int prefix = -1;
+            uint8_t suffix = 0;
+            int length = 0;
+        };
+        // pre‑reservo el diccionario (max 4096 codigos)
+        std::vector<DictEntry> dictionary(4096);
+
+        // inicializo el diccionario base
+        for (int i = 0; i < clearCode; ++i) {
+            dictionary[i] = { -1, (uint8_t)i, 1 };
+        }
+
+        int dictSize = eoiCode + 1;
+        int oldCode = -1;
+
+        // estado de lectura de bits
+        int bitPos = 0;
+        int bytePos = 0;
+
+        output.reserve(pixelCount);
+
+        // buffer reutilizable para secuencias LZW (evita alloc por codigo)
+        std::vector<uint8_t> sequence;
+        sequence.reserve(4096);
+
+        while (output.size() < pixelCount) {
+            // leo un codigo
+            int code = 0;
+            for (int i = 0; i < currentCodeSize; ++i) {
+                if (bytePos >= compressed.size()) break;
+                if ((compressed[bytePos] >> bitPos) & 1) {
+                    code |= (1 << i);
+                }
+                bitPos++;
+                if (bitPos == 8) {
+                    bitPos = 0;
+                    bytePos++;
+                }
+            }
+
+            if (code == clearCode) {
+                currentCodeSize = minCodeSize + 1;
+                codeMask = (1 << currentCodeSize) - 1;
+                dictSize = eoiCode + 1;
+                nextCode = eoiCode + 1;
+                oldCode = -1;
+                continue;
+            }
+
+            if (code == eoiCode) break;
+
+            if (oldCode == -1) {
+                if (code < dictSize) {
+                    output.push_back(dictionary[code].suffix);
+                    oldCode = code;
+                }
+                continue;
+            }
+
+            int inCode = code;
+            sequence.clear();
+
+            if (code >= dictSize) {
+                if (code == dictSize) {
+                    // caso especial: code = nextCode
+                    int temp = oldCode;
+                    while (temp != -1) {
+                        sequence.push_back(dictionary[temp].suffix);
+                        temp = dictionary[temp].prefix;
+                    }
+                    std::reverse(sequence.begin(), sequence.end());
+                    sequence.push_back(sequence[0]);
+                } else {
+                    // codigo invalido, corto aqui
+                    return false;
+                }
+            } else {
+                int temp = code;
+                while (temp != -1) {
+                    sequence.push_back(dictionary[temp].suffix);
+                    temp = dictionary[temp].prefix;
+                }
+                std::reverse(sequence.begin(), sequence.end());
+            }
+
+            output.insert(output.end(), sequence.begin(), sequence.end());
+
+            // anado entrada nueva al diccionario
+            if (dictSize < 4096) {
+                int temp = oldCode;
+
+                uint8_t firstChar = sequence[0];
+                dictionary[dictSize] = { oldCode, firstChar, dictionary[oldCode].length + 1 };
+                dictSize++;
+
+                if (dictSize >= (1 << currentCodeSize) && currentCodeSize < 12) {
+                    currentCodeSize++;
+                }
+            }
+
+            oldCode = inCode;
+        }
+
+        return true;
+    }
+
+    bool parseFrame(uint8_t const*& ptr, uint8_t const* end, RawFrame& frame, std::vector<uint8_t> const& globalPalette, int transparentIndex, bool hasTransparency) {
+        if (ptr + 10 > end) return false;
+
+        ptr++; // salto separador de imagen
+
+        // leo las dimensiones del frame
+        frame.left = ptr[0] | (ptr[1] << 8);
+        frame.top = ptr[2] | (ptr[3] << 8);
+        frame.width = ptr[4] | (ptr[5] << 8);
+        frame.height = ptr[6] | (ptr[7] << 8);
+        uint8_t flags = ptr[8];
+        ptr += 9;
+
+        bool hasLocalColorTable = (flags & 0x80) != 0;
+        int localColorTableSize = hasLocalColorTable ? (1 << ((flags & 0x07) + 1)) : 0;
+        bool interlaced = (flags & 0x40) != 0;
+
+        // leo tabla local de colores si existe
+        std::vector<uint8_t> localPalette;
+        if (hasLocalColorTable) {
+            if (!parseColorTable(ptr, end, localPalette, localColorTableSize)) {
+                return false;
+            }
+        }
+
+        std::vector<uint8_t> const& palette = hasLocalColorTable ? localPalette : globalPalette;
+
+        // leo el tamano minimo del codigo LZW
+        if (ptr >= end) return false;
+        uint8_t lzwMinCodeSize = *ptr++;
+
+        // junto los datos comprimidos en un vector
+        std::vector<uint8_t> compressedData;
+        while (ptr < end) {
+            uint8_t blockSize = *ptr++;
+            if (blockSize == 0) break;
+            if (ptr + blockSize > end) return false;
+            compressedData.insert(compressedData.end(), ptr, ptr + blockSize);
+            ptr += blockSize;
+        }
+
+        // descomprimo el stream LZW
+        std::vector<uint8_t> indices;
+        if (!lzwDecode(compressedData, indices, lzwMinCodeSize, frame.width * frame.height)) {
+            return false;
+        }
+
+        // construyo el frame en RGBA
+        frame.pixels.resize(frame.width * frame.height * 4);
+
+        // si esta entrelazado, reordeno indices
+        std::vector<uint8_t> deinterlacedIndices(frame.width * frame.height);
+        if (interlaced) {
+            int passOffsets[] = {0, 4, 2, 1};
+            int passInc[] = {8, 8, 4, 2};
+
+            int currentPass = 0;
+            int currentY = 0;
+            int currentX = 0;
+
+            for (uint8_t idx : indices) {
+                if (currentY >= frame.height) break;
+
+                deinterlacedIndices[currentY * frame.width + currentX] = idx;
+
+                currentX++;
+                if (currentX == frame.width) {
+                    currentX = 0;
+                    currentY += passInc[currentPass];
+                    if (currentY >= frame.height) {
+                        currentPass++;
+                        if (currentPass < 4) {
+                            currentY = passOffsets[currentPass];
+                        }
+                    }
+                }
+            }
+        } else {
+            deinterlacedIndices = indices;
+        }
+
+        // paso de indices a RGBA
+        for (int i = 0; i < frame.width * frame.height; i++) {
+            if (i >= deinterlacedIndices.size()) break;
+
+            uint8_t colorIndex = deinterlacedIndices[i];
+
+            if (hasTransparency && colorIndex == transparentIndex) {
+                frame.pixels[i * 4 + 0] = 0;
+                frame.pixels[i * 4 + 1] = 0;
+                frame.pixels[i * 4 + 2] = 0;
+                frame.pixels[i * 4 + 3] = 0;
+            } else {
+                if (colorIndex * 3 + 2 < palette.size()) {
+                    frame.pixels[i * 4 + 0] = palette[colorIndex * 3 + 0];
+                    frame.pixels[i * 4 + 1] = palette[colorIndex * 3 + 1];
+                    frame.pixels[i * 4 + 2] = palette[colorIndex * 3 + 2];
+                    frame.pixels[i * 4 + 3] = 255;
+                } else {
+                    // indice fuera de rango, dejo negro opaco
+                    frame.pixels[i * 4 + 0] = 0;
+                    frame.pixels[i * 4 + 1] = 0;
+                    frame.pixels[i * 4 + 2] = 0;
+                    frame.pixels[i * 4 + 3] = 255;
+                }
+            }
+        }
+
+        return true;
+    }
+} // namespace legacy
+
+// ── Kernel actual ───────────────────────────────────────────────────
+
+GIFDecoder::GIFData decodeCurrent(uint8_t const* data, size_t size) {
+    // lo mismo que GIFDecoder::decode pero sin su log por llamada
+    GIFDecoder::GIFData result{};
+    GIFDecoder::Stream stream(data, size);
+    if (!stream.valid()) return result;
+    result.width = stream.width();
+    result.height = stream.height();
+    GIFDecoder::Frame frame;
+    while (stream.nextFrame(frame)) result.frames.push_back(std::move(frame));
+    result.isAnimated = result.frames.size() > 1;
+    return result;
+}
+
+bool sameFrames(GIFDecoder::GIFData const& a, GIFDecoder::GIFData const& b) {
+    if (a.frames.size() != b.frames.size()) return false;
+    for (size_t i = 0; i < a.frames.size(); ++i) {
+        if (a.frames[i].pixels != b.frames[i].pixels || a.frames[i].delayMs != b.frames[i].delayMs) return false;
+    }
+    return true;
+}
+
+template <class Decode>
+GIFDecodeThroughput measure(std::vector<std::vector<uint8_t>> const& corpus, size_t inputBytes,
+    std::chrono::milliseconds minDuration, Decode&& decode) {
+    size_t outputBytes = 0;
+    uint64_t passes = 0;
+    auto t0 = Clock::now();
+    auto deadline = t0 + minDuration;
+    do {
+        for (auto const& data : corpus) {
+            auto gif = decode(data.data(), data.size());
+            for (auto const& frame : gif.frames) outputBytes += frame.pixels.size();
+        }
+        passes++;
+    } while (Clock::now() < deadline);
+
+    GIFDecodeThroughput t;
+    t.totalMs = msSince(t0);
+    double seconds = t.totalMs / 1000.0;
+    if (seconds > 0) {
+        t.inputMBps = static_cast<double>(inputBytes * passes) / (1024.0 * 1024.0) / seconds;
+        t.outputMBps = static_cast<double>(outputBytes) / (1024.0 * 1024.0) / seconds;
+    }
+    return t;
+}
+} // namespace
+
+GIFDecodeBenchReport runGIFDecodeBenchmark(size_t maxFiles, std::chrono::milliseconds minDurationPerVariant) {
+    GIFDecodeBenchReport report;
+
+    std::vector<std::vector<uint8_t>> corpus;
+    for (auto const& path : collectCachedGIFs(maxFiles)) {
+        auto data = readFile(path);
+        if (!GIFDecoder::isGIF(data.data(), data.size())) continue;
+
+        // los dos kernels tienen que dar los mismos frames
+        auto before = legacy::decode(data.data(), data.size());
+        auto after = decodeCurrent(data.data(), data.size());
+        if (after.frames.empty()) continue;
+        if (!sameFrames(before, after)) report.mismatchedFiles++;
+
+        report.frames += after.frames.size();
+        report.inputBytes += data.size();
+        corpus.push_back(std::move(data));
+    }
+    report.files = corpus.size();
+    if (corpus.empty()) {
+        log::info("[GIFDecodeBenchmark] no hay GIFs en la cache");
+        return report;
+    }
+
+    report.legacy = measure(corpus, report.inputBytes, minDurationPerVariant, legacy::decode);
+    report.current = measure(corpus, report.inputBytes, minDurationPerVariant, decodeCurrent);
+
+    log::info("[GIFDecodeBenchmark] {} GIFs, {} frames, {} KB por pasada", report.files, report.frames, report.inputBytes / 1024);
+    log::info("[GIFDecodeBenchmark] entrada {:.1f} MB/s -> {:.1f} MB/s, salida RGBA {:.1f} MB/s -> {:.1f} MB/s ({:.2f}x)",
+        report.legacy.inputMBps, report.current.inputMBps,
+        report.legacy.outputMBps, report.current.outputMBps,
+        report.legacy.inputMBps > 0 ? report.current.inputMBps / report.legacy.inputMBps : 0.0);
+    if (report.mismatchedFiles) {
+        // esperable solo en entrelazados de menos de 5 filas, que el kernel viejo cortaba
+        log::warn("[GIFDecodeBenchmark] {} GIFs con frames distintos entre kernels", report.mismatchedFiles);
+    }
+    return report;
+}
+
+} // namespace paimon::bench
@@ -0,0 +1,35 @@
+#pragma once
+
+// GIFDecodeBenchmark.hpp — Throughput del kernel de GIFDecoder.
+// Decodifica los GIFs de la cache de thumbnails con el decoder actual (tabla
+// LZW con primer byte/longitud, bits leidos de los sub-bloques, expansion de
+// paleta por tabla y desentrelazado en el sitio) y con una copia del kernel
+// anterior (cadena de prefijos + reverse, sub-bloques concatenados, buffer de
+// desentrelazado aparte). Mide MB/s de entrada (GIF comprimido) y de salida
+// (RGBA compuesto) y comprueba que los frames salen iguales.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace paimon::bench {
+
+struct GIFDecodeThroughput {
+    double inputMBps = 0;   // MB de GIF comprimido por segundo
+    double outputMBps = 0;  // MB de RGBA por segundo
+    double totalMs = 0;
+};
+
+struct GIFDecodeBenchReport {
+    GIFDecodeThroughput legacy;  // kernel anterior
+    GIFDecodeThroughput current; // GIFDecoder::Stream
+    size_t files = 0;
+    uint64_t frames = 0;
+    size_t inputBytes = 0;       // por pasada
+    size_t mismatchedFiles = 0;  // frames distintos entre los dos kernels
+};
+
+GIFDecodeBenchReport runGIFDecodeBenchmark(size_t maxFiles = 24,
+    std::chrono::milliseconds minDurationPerVariant = std::chrono::milliseconds(300));
+
+} // namespace paimon::bench
@@ -0,0 +1,152 @@
+#include "GIFStreamBenchmark.hpp"
+#include "BenchCommon.hpp"
+#include "../core/QualityConfig.hpp"
+#include "../utils/GIFDecoder.hpp"
+#include <Geode/Geode.hpp>
+#include <Geode/utils/string.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+
+#ifdef GEODE_IS_WINDOWS
+#include <Windows.h>
+#include <Psapi.h>
+#elif defined(GEODE_IS_ANDROID) || defined(__linux__)
+#include <unistd.h>
+#endif
+
+using namespace geode::prelude;
+
+namespace paimon::bench {
+
+namespace {
+// frame 0 + una tanda de 3: lo que AnimatedGIFSprite tiene pendiente de subir como mucho
+constexpr size_t SPRITE_WINDOW = 4;
+
+// RSS actual del proceso en KB; -1 donde no hay forma barata de leerlo
+int64_t residentKB() {
+#if defined(GEODE_IS_WINDOWS)
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<int64_t>(pmc.WorkingSetSize / 1024);
+    }
+    return -1;
+#elif defined(GEODE_IS_ANDROID) || defined(__linux__)
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return -1;
+    long pages = 0, resident = 0;
+    int n = std::fscanf(f, "%ld %ld", &pages, &resident);
+    std::fclose(f);
+    if (n != 2) return -1;
+    return static_cast<int64_t>(resident) * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+struct RssProbe {
+    int64_t base = residentKB();
+    int64_t peak = base;
+
+    void sample() {
+        if (base < 0) return;
+        peak = std::max(peak, residentKB());
+    }
+    int64_t delta() const { return base < 0 ? -1 : peak - base; }
+};
+
+GIFDecodeSample runBatch(std::vector<uint8_t> const& data, int& outFrames) {
+    GIFDecodeSample s;
+    RssProbe rss;
+    auto t0 = Clock::now();
+    auto gif = GIFDecoder::decode(data.data(), data.size());
+    auto t1 = Clock::now();
+    rss.sample();
+
+    // con decode() no hay nada que mostrar hasta que acaba
+    s.firstFrameMs = msBetween(t0, t1);
+    s.totalMs = s.firstFrameMs;
+    s.peakBytes = data.size();
+    for (auto const& frame : gif.frames) s.peakBytes += frame.pixels.capacity();
+    // canvas + backup mientras decodifica
+    s.peakBytes += static_cast<size_t>(gif.width) * gif.height * 4 * 2;
+    s.rssDeltaKB = rss.delta();
+    outFrames = static_cast<int>(gif.frames.size());
+    return s;
+}
+
+GIFDecodeSample runStream(std::vector<uint8_t> data) {
+    GIFDecodeSample s;
+    RssProbe rss;
+    auto t0 = Clock::now();
+    GIFDecoder::Stream stream(std::move(data));
+
+    // la ventana imita la cola del sprite: entra un frame, sale el mas viejo (ya "subido")
+    std::deque<GIFDecoder::Frame> window;
+    size_t windowBytes = 0;
+    GIFDecoder::Frame frame;
+    bool first = true;
+    while (stream.nextFrame(frame)) {
+        if (first) {
+            s.firstFrameMs = msBetween(t0, Clock::now());
+            first = false;
+        }
+        windowBytes += frame.pixels.capacity();
+        window.push_back(std::move(frame));
+        if (window.size() > SPRITE_WINDOW) {
+            windowBytes -= window.front().pixels.capacity();
+            window.pop_front();
+        }
+        s.peakBytes = std::max(s.peakBytes, stream.residentBytes() + windowBytes);
+        rss.sample();
+    }
+    s.totalMs = msBetween(t0, Clock::now());
+    s.rssDeltaKB = rss.delta();
+    return s;
+}
+
+} // namespace
+
+GIFStreamBenchReport runGIFStreamBenchmark(size_t maxFiles) {
+    GIFStreamBenchReport report;
+    auto paths = collectCachedGIFs(maxFiles);
+    log::info("[GIFStreamBenchmark] {} GIFs de {}", paths.size(),
+        geode::utils::string::pathToString(paimon::quality::cacheDir()));
+
+    for (auto const& path : paths) {
+        auto data = readFile(path);
+        if (!GIFDecoder::isGIF(data.data(), data.size())) continue;
+
+        GIFStreamFileResult r;
+        r.name = geode::utils::string::pathToString(path.filename());
+        r.fileBytes = data.size();
+        GIFDecoder::getDimensions(data.data(), data.size(), r.width, r.height);
+        // stream primero: el batch deja el heap crecido y ensuciaria su RSS
+        r.stream = runStream(data);
+        r.batch = runBatch(data, r.frames);
+        if (r.frames == 0) continue;
+
+        log::info("[GIFStreamBenchmark] {} ({} KB, {}x{}, {} frames): primer frame {:.1f}ms -> {:.1f}ms, "
+            "total {:.1f}ms -> {:.1f}ms, pico {} KB -> {} KB, RSS +{} KB -> +{} KB",
+            r.name, r.fileBytes / 1024, r.width, r.height, r.frames,
+            r.batch.firstFrameMs, r.stream.firstFrameMs, r.batch.totalMs, r.stream.totalMs,
+            r.batch.peakBytes / 1024, r.stream.peakBytes / 1024, r.batch.rssDeltaKB, r.stream.rssDeltaKB);
+
+        report.batchPeakMaxBytes = std::max(report.batchPeakMaxBytes, r.batch.peakBytes);
+        report.streamPeakMaxBytes = std::max(report.streamPeakMaxBytes, r.stream.peakBytes);
+        report.batchFirstFrameMeanMs += r.batch.firstFrameMs;
+        report.streamFirstFrameMeanMs += r.stream.firstFrameMs;
+        report.files.push_back(std::move(r));
+    }
+
+    if (!report.files.empty()) {
+        report.batchFirstFrameMeanMs /= static_cast<double>(report.files.size());
+        report.streamFirstFrameMeanMs /= static_cast<double>(report.files.size());
+    }
+    log::info("[GIFStreamBenchmark] media primer frame {:.1f}ms -> {:.1f}ms, peor pico {} KB -> {} KB",
+        report.batchFirstFrameMeanMs, report.streamFirstFrameMeanMs,
+        report.batchPeakMaxBytes / 1024, report.streamPeakMaxBytes / 1024);
+    return report;
+}
+
+} // namespace paimon::bench
@@ -0,0 +1,44 @@
+#pragma once
+
+// GIFStreamBenchmark.hpp — Decode completo vs GIFDecoder::Stream.
+// Recorre los GIFs reales de la cache de thumbnails (cacheDir()/*.gif) y los
+// decodifica de las dos formas: GIFDecoder::decode (todos los frames en RAM
+// antes de mostrar nada) y Stream con la ventana que usa AnimatedGIFSprite
+// (frame 0 + una tanda). Mide tiempo hasta el primer frame, tiempo total,
+// pico de bytes del decoder y el delta de RSS del proceso.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace paimon::bench {
+
+struct GIFDecodeSample {
+    double firstFrameMs = 0;
+    double totalMs = 0;
+    size_t peakBytes = 0;  // bytes vivos del decode (stream comprimido + frames + canvas)
+    int64_t rssDeltaKB = 0; // pico de RSS sobre el de partida; -1 si la plataforma no lo da
+};
+
+struct GIFStreamFileResult {
+    std::string name;
+    size_t fileBytes = 0;
+    int width = 0;
+    int height = 0;
+    int frames = 0;
+    GIFDecodeSample batch;  // GIFDecoder::decode
+    GIFDecodeSample stream; // GIFDecoder::Stream
+};
+
+struct GIFStreamBenchReport {
+    std::vector<GIFStreamFileResult> files;
+    double batchFirstFrameMeanMs = 0;
+    double streamFirstFrameMeanMs = 0;
+    size_t batchPeakMaxBytes = 0;
+    size_t streamPeakMaxBytes = 0;
+};
+
+GIFStreamBenchReport runGIFStreamBenchmark(size_t maxFiles = 24);
+
+} // namespace paimon::bench
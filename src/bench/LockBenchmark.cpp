@@ -0,0 +1,208 @@
+#include "LockBenchmark.hpp"
+#include "BenchCommon.hpp"
+#include "../framework/concurrency/ShardedMap.hpp"
+#include <Geode/loader/Log.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace geode::prelude;
+
+namespace paimon::bench {
+
+namespace {
+constexpr int CELLS_PER_FRAME = 300;
+constexpr int ID_SPACE = 4096;
+constexpr size_t BUCKETS = 1024;
+// las invalidaciones reales son raras (subida/borrado de un thumbnail)
+constexpr int INVALIDATE_EVERY = 64;
+
+// acumula espera (solo main thread) y hold (todos los hilos)
+struct Probe {
+    std::vector<int64_t>* waits = nullptr;
+    int64_t holdNs = 0;
+    uint64_t holds = 0;
+
+    template <class Fn>
+    void timed(Clock::time_point before, Fn&& fn) {
+        auto acquired = Clock::now();
+        fn();
+        auto released = Clock::now();
+        if (waits) waits->push_back(nsBetween(before, acquired));
+        holdNs += nsBetween(acquired, released);
+        holds++;
+    }
+};
+
+// ── Layout viejo: todo detras de un recursive_mutex ─────────────────
+
+struct GlobalState {
+    std::recursive_mutex mutex;
+    std::unordered_map<int, int> textures;
+    std::unordered_map<int, int> tasks;
+    std::unordered_map<int, int> versions;
+    std::unordered_set<int> gifs;
+
+    void poll(int id, Probe& probe) {
+        auto t = Clock::now();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        probe.timed(t, [&] { (void)textures.count(id); });
+    }
+    void version(int id, Probe& probe) {
+        auto t = Clock::now();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        probe.timed(t, [&] { (void)versions.count(id); });
+    }
+    void gif(int id, Probe& probe) {
+        auto t = Clock::now();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        probe.timed(t, [&] { (void)gifs.count(id); });
+    }
+    void write(int id, int op, Probe& probe) {
+        auto t = Clock::now();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        probe.timed(t, [&] {
+            switch (op) {
+                case 0: tasks[id] = id; break;
+                case 1: tasks.erase(id); textures[id] = id; break;
+                case 2: gifs.insert(id); break;
+                default:
+                    textures.erase(id);
+                    if (id % INVALIDATE_EVERY == 0) versions[id]++;
+                    break;
+            }
+        });
+    }
+};
+
+// ── Layout nuevo: shards + buckets atomicos ─────────────────────────
+
+struct ShardedState {
+    paimon::concurrency::ShardedMap<int, int> textures;
+    paimon::concurrency::ShardedMap<int, int> tasks;
+    paimon::concurrency::ShardedMap<int, int> versions;
+    paimon::concurrency::ShardedSet<int> gifs;
+    std::array<std::atomic<uint32_t>, BUCKETS> buckets{};
+
+    void poll(int id, Probe& probe) {
+        auto t = Clock::now();
+        textures.read(id, [&](auto const& m) { probe.timed(t, [&] { (void)m.count(id); }); });
+    }
+    void version(int id, Probe& probe) {
+        auto t = Clock::now();
+        if (buckets[static_cast<uint32_t>(id) % BUCKETS].load(std::memory_order_acquire) == 0) {
+            probe.timed(t, [] {});
+            return;
+        }
+        versions.read(id, [&](auto const& m) { probe.timed(t, [&] { (void)m.count(id); }); });
+    }
+    void gif(int id, Probe& probe) {
+        auto t = Clock::now();
+        gifs.read(id, [&](auto const& s) { probe.timed(t, [&] { (void)s.count(id); }); });
+    }
+    void write(int id, int op, Probe& probe) {
+        auto t = Clock::now();
+        switch (op) {
+            case 0: tasks.update(id, [&](auto& m) { probe.timed(t, [&] { m[id] = id; }); }); break;
+            case 1:
+                tasks.update(id, [&](auto& m) { probe.timed(t, [&] { m.erase(id); }); });
+                textures.update(id, [&](auto& m) { m[id] = id; });
+                break;
+            case 2: gifs.update(id, [&](auto& s) { probe.timed(t, [&] { s.insert(id); }); }); break;
+            default:
+                textures.update(id, [&](auto& m) { probe.timed(t, [&] { m.erase(id); }); });
+                if (id % INVALIDATE_EVERY == 0) {
+                    versions.update(id, [&](auto& m) { m[id]++; });
+                    buckets[static_cast<uint32_t>(id) % BUCKETS].fetch_add(1, std::memory_order_release);
+                }
+                break;
+        }
+    }
+};
+
+template <class State>
+LockBenchResult runVariant(unsigned writers, std::chrono::milliseconds duration) {
+    State state;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> writerOps{0};
+    std::atomic<int64_t> writerHoldNs{0};
+    std::atomic<uint64_t> writerHolds{0};
+
+    std::vector<std::thread> threads;
+    threads.reserve(writers);
+    for (unsigned w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            std::mt19937 rng(1234 + w);
+            std::uniform_int_distribution<int> idDist(1, ID_SPACE);
+            Probe probe;
+            uint64_t ops = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                state.write(idDist(rng), static_cast<int>(ops & 3), probe);
+                ops++;
+            }
+            writerOps.fetch_add(ops);
+            writerHoldNs.fetch_add(probe.holdNs);
+            writerHolds.fetch_add(probe.holds);
+        });
+    }
+
+    std::vector<int64_t> waits;
+    waits.reserve(1 << 20);
+    std::vector<int64_t> frames;
+    Probe probe{&waits};
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> startDist(1, ID_SPACE - CELLS_PER_FRAME);
+
+    auto end = Clock::now() + duration;
+    while (Clock::now() < end && waits.size() + CELLS_PER_FRAME * 3 < waits.capacity()) {
+        int first = startDist(rng);
+        auto f0 = Clock::now();
+        for (int id = first; id < first + CELLS_PER_FRAME; ++id) {
+            state.poll(id, probe);
+            state.version(id, probe);
+            state.gif(id, probe);
+        }
+        frames.push_back(nsBetween(f0, Clock::now()));
+    }
+    stop.store(true);
+    for (auto& t : threads) t.join();
+
+    LockBenchResult r;
+    r.frames = frames.size();
+    r.frameP50Us = percentile(frames, 0.50) / 1000.0;
+    r.frameP99Us = percentile(frames, 0.99) / 1000.0;
+    r.waitP50Ns = percentile(waits, 0.50);
+    r.waitP99Ns = percentile(waits, 0.99);
+    uint64_t holds = probe.holds + writerHolds.load();
+    r.holdMeanNs = holds ? static_cast<double>(probe.holdNs + writerHoldNs.load()) / static_cast<double>(holds) : 0;
+    r.writerOps = writerOps.load();
+    return r;
+}
+
+void logResult(char const* name, LockBenchResult const& r) {
+    log::info("[LockBenchmark] {}: frame p50={:.1f}us p99={:.1f}us, espera p50={:.0f}ns p99={:.0f}ns, "
+        "hold medio={:.0f}ns, frames={} escrituras={}",
+        name, r.frameP50Us, r.frameP99Us, r.waitP50Ns, r.waitP99Ns, r.holdMeanNs, r.frames, r.writerOps);
+}
+} // namespace
+
+LockBenchReport runLockBenchmark(std::chrono::milliseconds durationPerVariant) {
+    LockBenchReport report;
+    report.writerThreads = std::clamp(std::thread::hardware_concurrency(), 2u, 7u) - 1;
+
+    report.global = runVariant<GlobalState>(report.writerThreads, durationPerVariant);
+    report.sharded = runVariant<ShardedState>(report.writerThreads, durationPerVariant);
+
+    log::info("[LockBenchmark] {} celdas por frame, {} hilos escribiendo", CELLS_PER_FRAME, report.writerThreads);
+    logResult("recursive_mutex global", report.global);
+    logResult("shards", report.sharded);
+    return report;
+}
+
+} // namespace paimon::bench
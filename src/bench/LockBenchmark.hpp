@@ -0,0 +1,35 @@
+#pragma once
+
+// LockBenchmark.hpp — Benchmark de contencion del estado del ThumbnailLoader.
+// Reproduce el patron real: el main thread consulta isLoaded /
+// getInvalidationVersion / hasGIFData para ~300 celdas por frame mientras los
+// workers insertan y borran en las mismas tablas. Corre el mismo trafico
+// contra el layout viejo (un recursive_mutex para todo) y contra los shards
+// (ShardedMap + buckets atomicos) y mide espera y tiempo con el lock tomado.
+// Los escritores son hilos propios del benchmark y terminan (join) antes de
+// devolver el reporte.
+
+#include <chrono>
+#include <cstdint>
+
+namespace paimon::bench {
+
+struct LockBenchResult {
+    double frameP50Us = 0;   // tiempo de la pasada de 300 celdas en el main thread
+    double frameP99Us = 0;
+    double waitP50Ns = 0;    // espera del main thread por lock
+    double waitP99Ns = 0;
+    double holdMeanNs = 0;   // tiempo medio con el lock tomado (todos los hilos)
+    uint64_t frames = 0;
+    uint64_t writerOps = 0;
+};
+
+struct LockBenchReport {
+    LockBenchResult global;  // antes: un solo recursive_mutex
+    LockBenchResult sharded; // despues
+    unsigned writerThreads = 0;
+};
+
+LockBenchReport runLockBenchmark(std::chrono::milliseconds durationPerVariant = std::chrono::milliseconds(400));
+
+} // namespace paimon::bench
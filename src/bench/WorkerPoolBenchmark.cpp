@@ -0,0 +1,109 @@
+#include "WorkerPoolBenchmark.hpp"
+#include "BenchCommon.hpp"
+#include "../framework/concurrency/WorkerPool.hpp"
+#include <Geode/Geode.hpp>
+#include <atomic>
+#include <future>
+#include <vector>
+
+using namespace geode::prelude;
+
+namespace paimon::bench {
+
+namespace {
+// trabajo de juguete: unos microsegundos de CPU, del orden de un hit de disco pequeño
+constexpr int SPIN_ITERATIONS = 2000;
+
+uint32_t busyWork(uint32_t seed) {
+    uint32_t x = seed | 1;
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+struct Samples {
+    std::vector<Clock::time_point> submitted;
+    std::vector<Clock::time_point> started;
+    std::atomic<uint32_t> sink{0};
+
+    explicit Samples(size_t jobs) : submitted(jobs), started(jobs) {}
+
+    void run(size_t i) {
+        started[i] = Clock::now();
+        sink.fetch_xor(busyWork(static_cast<uint32_t>(i)), std::memory_order_relaxed);
+    }
+};
+
+WorkerPoolBenchResult summarize(Samples& s, Clock::time_point t0, size_t jobs) {
+    WorkerPoolBenchResult r;
+    r.totalMs = msSince(t0);
+    r.jobsPerSec = r.totalMs > 0 ? static_cast<double>(jobs) / (r.totalMs / 1000.0) : 0;
+    std::vector<int64_t> latencies(jobs);
+    for (size_t i = 0; i < jobs; ++i) latencies[i] = nsBetween(s.submitted[i], s.started[i]);
+    r.startP50Us = percentile(latencies, 0.50) / 1000.0;
+    r.startP99Us = percentile(latencies, 0.99) / 1000.0;
+    return r;
+}
+
+WorkerPoolBenchResult runSpawn(size_t jobs, size_t wave) {
+    Samples samples(jobs);
+    std::vector<std::future<void>> inFlight;
+    inFlight.reserve(wave);
+    auto t0 = Clock::now();
+    for (size_t first = 0; first < jobs; first += wave) {
+        size_t last = std::min(jobs, first + wave);
+        for (size_t i = first; i < last; ++i) {
+            samples.submitted[i] = Clock::now();
+            inFlight.push_back(std::async(std::launch::async, [&samples, i] { samples.run(i); }));
+        }
+        for (auto& f : inFlight) f.get();
+        inFlight.clear();
+    }
+    return summarize(samples, t0, jobs);
+}
+
+WorkerPoolBenchResult runPool(size_t jobs, size_t wave) {
+    Samples samples(jobs);
+    paimon::concurrency::WorkerPool pool("PoolBench");
+    // el primer submit arranca los hilos; fuera de la medida, como en el juego
+    pool.submit(paimon::concurrency::WorkerPool::Lane::Decode, 0, [] {});
+    pool.waitIdle();
+
+    auto t0 = Clock::now();
+    for (size_t first = 0; first < jobs; first += wave) {
+        size_t last = std::min(jobs, first + wave);
+        for (size_t i = first; i < last; ++i) {
+            samples.submitted[i] = Clock::now();
+            // mitad Disk, mitad Decode: como una tanda de tareas del loader
+            auto lane = (i & 1) ? paimon::concurrency::WorkerPool::Lane::Decode
+                                : paimon::concurrency::WorkerPool::Lane::Disk;
+            pool.submit(lane, 0, [&samples, i] { samples.run(i); });
+        }
+        pool.waitIdle();
+    }
+    auto result = summarize(samples, t0, jobs);
+    pool.shutdown();
+    return result;
+}
+} // namespace
+
+WorkerPoolBenchReport runWorkerPoolBenchmark(size_t jobs, size_t wave) {
+    WorkerPoolBenchReport report;
+    report.jobs = std::max<size_t>(1, jobs);
+    report.wave = std::max<size_t>(1, wave);
+
+    report.spawn = runSpawn(report.jobs, report.wave);
+    report.pool = runPool(report.jobs, report.wave);
+
+    log::info("[WorkerPoolBenchmark] {} jobs en oleadas de {}", report.jobs, report.wave);
+    log::info("[WorkerPoolBenchmark] std::async por job: {:.0f} jobs/s, arranque p50={:.1f}us p99={:.1f}us, {:.1f}ms",
+        report.spawn.jobsPerSec, report.spawn.startP50Us, report.spawn.startP99Us, report.spawn.totalMs);
+    log::info("[WorkerPoolBenchmark] WorkerPool: {:.0f} jobs/s, arranque p50={:.1f}us p99={:.1f}us, {:.1f}ms",
+        report.pool.jobsPerSec, report.pool.startP50Us, report.pool.startP99Us, report.pool.totalMs);
+    return report;
+}
+
+} // namespace paimon::bench
@@ -0,0 +1,30 @@
+#pragma once
+
+// WorkerPoolBenchmark.hpp — WorkerPool contra un std::async por job (lo que
+// hacia ThumbnailLoader antes). Lanza la misma tanda de jobs cortos de las dos
+// formas, en oleadas como las que suelta processQueue al hacer scroll, y mide
+// jobs/s y la latencia desde el submit hasta que el job empieza (p50/p99).
+// Usa un pool propio, no el de ThumbnailLoader.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace paimon::bench {
+
+struct WorkerPoolBenchResult {
+    double jobsPerSec = 0;
+    double startP50Us = 0;  // submit -> el job empieza a correr
+    double startP99Us = 0;
+    double totalMs = 0;
+};
+
+struct WorkerPoolBenchReport {
+    WorkerPoolBenchResult spawn;  // std::async por job
+    WorkerPoolBenchResult pool;   // WorkerPool
+    size_t jobs = 0;
+    size_t wave = 0;
+};
+
+WorkerPoolBenchReport runWorkerPoolBenchmark(size_t jobs = 20000, size_t wave = 64);
+
+} // namespace paimon::bench
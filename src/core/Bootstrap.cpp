@@ -10,7 +10,6 @@
 #include "../utils/MainThreadDelay.hpp"
 #include "../utils/HttpClient.hpp"
 #include "QualityConfig.hpp"
-#include <thread>
 #include <filesystem>
 
 using namespace geode::prelude;
@@ -65,17 +64,11 @@ void PaimonOnModLoaded() {
 
     log::info("[PaimonThumbnails][Init] Applying startup init");
 
-    log::info("[PaimonThumbnails][Init] Scheduling color extraction thread");
-    // hilo de I/O de disco + procesamiento CPU — no migrable a WebTask (no es peticion web).
-    // el delay y la extraccion se ejecutan en background para no bloquear el main thread.
+    log::info("[PaimonThumbnails][Init] Scheduling color extraction");
+    // va en el pool del ThumbnailLoader por debajo de las miniaturas visibles;
+    // no bloquea y sigue desde el checkpoint si la sesion anterior no acabo
     paimon::scheduleMainThreadDelay(0.5f, []() {
-        std::thread([]() {
-            geode::utils::thread::setName("PaimonThumbnails ColorExtract");
-            LevelColors::get().extractColorsFromCache();
-            geode::Loader::get()->queueInMainThread([]() {
-                log::info("[PaimonThumbnails][Init] Color extraction finished");
-            });
-        }).detach();
+        LevelColors::get().extractColorsFromCache();
     });
 
     log::info("[PaimonThumbnails][Init] Startup init complete");
@@ -5,6 +5,7 @@
 // should use these to guarantee one persistent variant per quality tier.
 
 #include "Settings.hpp"
+#include "../utils/ImageResample.hpp"
 #include <string>
 #include <cstdint>
 #include <algorithm>
@@ -60,35 +61,21 @@ inline ScaledSize fitToQuality(int srcW, int srcH) {
     return {dstW, dstH};
 }
 
-// Downscale RGBA8888 pixel data in-place (box filter, simple & fast).
+// Downscale RGBA8888 pixel data in-place to the active tier's maxDimension().
+// Uses area averaging (see utils/ImageResample), so thin lines and text in
+// thumbnails survive instead of aliasing like nearest-neighbour would.
 // Returns true if downscale was applied, false if the source already fits.
 inline bool downscaleRGBA(std::vector<uint8_t>& pixels, int& w, int& h) {
     auto dst = fitToQuality(w, h);
     if (dst.width == w && dst.height == h) return false;
+    if (pixels.size() < static_cast<size_t>(w) * static_cast<size_t>(h) * 4) return false;
 
-    int dstW = dst.width;
-    int dstH = dst.height;
-    std::vector<uint8_t> out(dstW * dstH * 4);
-
-    float xRatio = static_cast<float>(w) / dstW;
-    float yRatio = static_cast<float>(h) / dstH;
-
-    for (int y = 0; y < dstH; ++y) {
-        for (int x = 0; x < dstW; ++x) {
-            int srcX = std::min(static_cast<int>(x * xRatio), w - 1);
-            int srcY = std::min(static_cast<int>(y * yRatio), h - 1);
-            int srcIdx = (srcY * w + srcX) * 4;
-            int dstIdx = (y * dstW + x) * 4;
-            out[dstIdx + 0] = pixels[srcIdx + 0];
-            out[dstIdx + 1] = pixels[srcIdx + 1];
-            out[dstIdx + 2] = pixels[srcIdx + 2];
-            out[dstIdx + 3] = pixels[srcIdx + 3];
-        }
-    }
+    auto out = paimon::image::resampleAreaRGBA(pixels.data(), w, h, dst.width, dst.height);
+    if (out.empty()) return false;
 
     pixels = std::move(out);
-    w = dstW;
-    h = dstH;
+    w = dst.width;
+    h = dst.height;
     return true;
 }
 
@@ -13,6 +13,8 @@
 #include "../features/thumbnails/services/LocalThumbs.hpp"
 #include "../features/thumbnails/services/LevelColors.hpp"
 #include "../utils/AnimatedGIFSprite.hpp"
+#include "../utils/MemoryBudget.hpp"
+#include "../utils/HttpClient.hpp"
 #include "QualityConfig.hpp"
 #include <filesystem>
 
@@ -53,10 +55,12 @@ void cleanupDiskCache(char const* context) {
 // - NO tocamos datos offline del usuario (fondos de menu, thumbnails locales, settings)
 $on_game(Exiting) {
     ProfileThumbs::s_shutdownMode.store(true, std::memory_order_release);
+    // nada de evicciones del presupuesto mientras se desmontan los caches
+    paimon::memory::MemoryBudget::get().shutdown();
 
     // cancelar tareas pendientes de ThumbnailLoader ANTES de limpiar disco
     // para que los hilos de fondo no reescriban archivos que vamos a borrar
-    ThumbnailLoader::get().cleanup();
+    ThumbnailLoader::get().cleanup(true);
 
     bool clearCacheOnExit = Mod::get()->getSettingValue<bool>("clear-cache-on-exit");
 
@@ -65,6 +69,8 @@ $on_game(Exiting) {
     if (!clearCacheOnExit) {
         ThumbnailLoader::get().diskManifest().flush();
     }
+    // URLs de CDN: las ops encoladas desde el ultimo flush (vive en el save dir, no se borra)
+    HttpClient::get().saveManifestToDisk();
 
     LocalThumbs::get().shutdown();
     ProfileThumbs::get().shutdown();
@@ -66,6 +66,13 @@ namespace thumbnails {
     inline bool gifRamCache() {
         return geode::Mod::get()->getSettingValue<bool>("gif-ram-cache");
     }
+    inline double uploadBudgetMs() {
+        return geode::Mod::get()->getSettingValue<double>("texture-upload-budget-ms");
+    }
+    // ventana de frescura del cache de disco; 0 = no revalidar
+    inline int64_t revalidateHours() {
+        return geode::Mod::get()->getSettingValue<int64_t>("thumbnail-revalidate-hours");
+    }
 } // namespace thumbnails
 
 // ── LevelInfo ───────────────────────────────────────────────────────────
@@ -216,6 +223,22 @@ namespace quality {
             default:              return 160ull * 1024 * 1024;
         }
     }
+    // presupuesto comun de RAM de todos los caches de imagen (MemoryBudget)
+    inline size_t memoryBudgetBytes() {
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+        switch (current()) {
+            case Quality::Low:    return 96ull * 1024 * 1024;
+            case Quality::High:   return 224ull * 1024 * 1024;
+            default:              return 160ull * 1024 * 1024;
+        }
+#else
+        switch (current()) {
+            case Quality::Low:    return 256ull * 1024 * 1024;
+            case Quality::High:   return 768ull * 1024 * 1024;
+            default:              return 448ull * 1024 * 1024;
+        }
+#endif
+    }
     // disk cache byte quota
     inline size_t diskCacheBytes() {
         switch (current()) {
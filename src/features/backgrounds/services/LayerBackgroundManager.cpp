@@ -392,7 +392,7 @@ void LayerBackgroundManager::applyGifBg(CCLayer* layer, std::string const& path,
             overlay->setZOrder(1);
             container->addChild(overlay);
         }
-    });
+    }, AnimatedGIFSprite::BACKGROUND_PRIORITY);
 }
 
 // ── API principal ──
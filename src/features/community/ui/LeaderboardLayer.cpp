@@ -20,6 +20,7 @@
 #include <Geode/binding/CCMenuItemSpriteExtra.hpp>
 #include "../../../utils/Shaders.hpp"
 #include "../../../utils/SpriteHelper.hpp"
+#include <optional>
 #include <random>
 #include <cmath>
 
@@ -27,6 +28,12 @@ using namespace geode::prelude;
 using namespace Shaders;
 
 namespace {
+    // lo que loadLeaderboard necesita de /api/<type>/current
+    struct FeaturedEntry {
+        int levelID = 0;
+        long long expiresAt = 0;
+    };
+
     class LeaderboardPaimonSprite : public CCSprite {
     public:
         float m_intensity = 1.0f;
@@ -383,69 +390,76 @@ void LeaderboardLayer::loadLeaderboard(std::string type) {
     m_featuredExpiresAt = 0;
 
     WeakRef<LeaderboardLayer> self = this;
-    HttpClient::get().get("/api/" + type + "/current", [self, type](bool success, std::string const& json) {
-        auto layer = self.lock();
-        if (!layer) return;
-
-        if (success) {
+    // el json se parsea fuera del hilo principal; aca solo llega levelID + expiresAt
+    HttpClient::get().getParsed<std::optional<FeaturedEntry>>("/api/" + type + "/current",
+        [](bool success, std::string const& json) -> std::optional<FeaturedEntry> {
+            if (!success) return std::nullopt;
             auto dataRes = matjson::parse(json);
-            if (dataRes.isOk()) {
-                auto data = dataRes.unwrap();
-                if (data["success"].asBool().unwrapOr(false)) {
-                    auto levelData = data["data"];
-                    int levelID = levelData["levelID"].asInt().unwrapOr(0);
-                    layer->m_featuredExpiresAt = (long long)levelData["expiresAt"].asDouble().unwrapOr(0);
-
-                    if (levelID > 0) {
-                        auto level = GJGameLevel::create();
-                        level->m_levelID = levelID;
-                        level->m_levelName = Localization::get().getString("leaderboard.loading");
-                        level->m_creatorName = "";
-
-                        auto saved = GameLevelManager::get()->getSavedLevel(levelID);
-                        if (saved) {
-                            level->m_levelName = saved->m_levelName;
-                            level->m_creatorName = saved->m_creatorName;
-                            level->m_stars = saved->m_stars;
-                            level->m_difficulty = saved->m_difficulty;
-                            level->m_demon = saved->m_demon;
-                            level->m_demonDifficulty = saved->m_demonDifficulty;
-                            level->m_songID = saved->m_songID;
-                            level->m_audioTrack = saved->m_audioTrack;
-                            level->m_levelString = saved->m_levelString;
-                        }
-
-                        layer->m_featuredLevel = level;
-
-                        // pedir info completa al server GD
-                        auto searchObj = GJSearchObject::create(SearchType::MapPackOnClick, std::to_string(levelID));
-                        auto glm = GameLevelManager::get();
-                        glm->m_levelManagerDelegate = layer.data();
-                        glm->getOnlineLevels(searchObj);
+            if (!dataRes.isOk()) return std::nullopt;
+            auto data = dataRes.unwrap();
+            if (!data["success"].asBool().unwrapOr(false)) return std::nullopt;
+            auto levelData = data["data"];
+            return FeaturedEntry{
+                levelData["levelID"].asInt().unwrapOr(0),
+                (long long)levelData["expiresAt"].asDouble().unwrapOr(0)
+            };
+        },
+        [self, type](std::optional<FeaturedEntry> featured) {
+            auto layer = self.lock();
+            if (!layer) return;
+
+            if (featured) {
+                int levelID = featured->levelID;
+                layer->m_featuredExpiresAt = featured->expiresAt;
+
+                if (levelID > 0) {
+                    auto level = GJGameLevel::create();
+                    level->m_levelID = levelID;
+                    level->m_levelName = Localization::get().getString("leaderboard.loading");
+                    level->m_creatorName = "";
+
+                    auto saved = GameLevelManager::get()->getSavedLevel(levelID);
+                    if (saved) {
+                        level->m_levelName = saved->m_levelName;
+                        level->m_creatorName = saved->m_creatorName;
+                        level->m_stars = saved->m_stars;
+                        level->m_difficulty = saved->m_difficulty;
+                        level->m_demon = saved->m_demon;
+                        level->m_demonDifficulty = saved->m_demonDifficulty;
+                        level->m_songID = saved->m_songID;
+                        level->m_audioTrack = saved->m_audioTrack;
+                        level->m_levelString = saved->m_levelString;
                     }
+
+                    layer->m_featuredLevel = level;
+
+                    // pedir info completa al server GD
+                    auto searchObj = GJSearchObject::create(SearchType::MapPackOnClick, std::to_string(levelID));
+                    auto glm = GameLevelManager::get();
+                    glm->m_levelManagerDelegate = layer.data();
+                    glm->getOnlineLevels(searchObj);
                 }
             }
-        }
 
-        // marcar datos como cargados
-        layer->m_dataLoaded = true;
+            // marcar datos como cargados
+            layer->m_dataLoaded = true;
 
-        if (layer->m_featuredLevel) {
-            layer->updateBackground(layer->m_featuredLevel->m_levelID);
-        } else {
-            layer->updateBackground(0);
-            // si no hay nivel, thumb tambien esta "listo"
-            layer->m_thumbLoaded = true;
-        }
+            if (layer->m_featuredLevel) {
+                layer->updateBackground(layer->m_featuredLevel->m_levelID);
+            } else {
+                layer->updateBackground(0);
+                // si no hay nivel, thumb tambien esta "listo"
+                layer->m_thumbLoaded = true;
+            }
 
-        // crear lista (solo una vez)
-        if (!layer->m_listCreated) {
-            layer->m_listCreated = true;
-            layer->createList(type);
-        }
+            // crear lista (solo una vez)
+            if (!layer->m_listCreated) {
+                layer->m_listCreated = true;
+                layer->createList(type);
+            }
 
-        layer->checkLoadingComplete();
-    });
+            layer->checkLoadingComplete();
+        });
 }
 
 void LeaderboardLayer::createList(std::string type) {
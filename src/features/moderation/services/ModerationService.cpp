@@ -149,19 +149,19 @@ void ModerationService::syncVerificationQueue(PendingCategory category, QueueCal
                   + "&accountID=" + std::to_string(accountID);
     }
 
-    HttpClient::get().get(endpoint, [callback, category](bool success, std::string const& response) {
-        if (!success) { callback(true, PendingQueue::get().list(category)); return; }
+    // la cola puede traer cientos de items: se parsea fuera del hilo principal
+    // y nullopt = usar la cola local
+    using ParsedQueue = std::optional<std::vector<PendingItem>>;
+    HttpClient::get().getParsed<ParsedQueue>(endpoint, [category](bool success, std::string const& response) -> ParsedQueue {
+        if (!success) return std::nullopt;
 
         auto jsonRes = matjson::parse(response);
-        if (!jsonRes.isOk()) { callback(true, PendingQueue::get().list(category)); return; }
+        if (!jsonRes.isOk()) return std::nullopt;
         auto json = jsonRes.unwrap();
 
-        if (!json.contains("items") || !json["items"].isArray()) {
-            callback(true, PendingQueue::get().list(category));
-            return;
-        }
+        if (!json.contains("items") || !json["items"].isArray()) return std::nullopt;
         auto itemsRes = json["items"].asArray();
-        if (!itemsRes) { callback(true, PendingQueue::get().list(category)); return; }
+        if (!itemsRes) return std::nullopt;
 
         std::vector<PendingItem> items;
         for (auto const& item : itemsRes.unwrap()) {
@@ -273,7 +273,10 @@ void ModerationService::syncVerificationQueue(PendingCategory category, QueueCal
 
             if (it.levelID != 0) items.push_back(std::move(it));
         }
-        callback(true, items);
+        return items;
+    }, [callback, category](ParsedQueue items) {
+        if (!items) { callback(true, PendingQueue::get().list(category)); return; }
+        callback(true, *items);
     });
 }
 
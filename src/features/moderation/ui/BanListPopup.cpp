@@ -14,6 +14,14 @@
 using namespace geode::prelude;
 using namespace cocos2d;
 
+namespace {
+// lo que sale de /api/admin/banlist, ya parseado
+struct ParsedBanList {
+    std::vector<std::string> users;
+    std::map<std::string, BanDetail> details;
+};
+}
+
 BanListPopup* BanListPopup::create() {
     auto ret = new BanListPopup();
     if (ret && ret->init()) {
@@ -59,55 +67,59 @@ bool BanListPopup::init() {
     Ref<PaimonLoadingOverlay> loadingRef = overlay;
 
     auto self = WeakRef<BanListPopup>(this);
-    HttpClient::get().getBanList([self, loadingRef](bool success, std::string const& jsonData) {
-        if (loadingRef) loadingRef->dismiss();
-        auto popup = self.lock();
-        if (!popup) return;
-
-        std::vector<std::string> users;
-
-        if (success) {
-            auto parsed = matjson::parse(jsonData);
-            if (parsed.isOk()) {
-                auto root = parsed.unwrap();
-                if (root.isObject()) {
-                    auto banned = root["banned"];
-                    if (banned.isArray()) {
-                        auto arrRes = banned.asArray();
-                        if (arrRes.isOk()) {
-                            for (auto const& v : arrRes.unwrap()) {
-                                if (v.isString()) {
-                                    users.push_back(v.asString().unwrapOr(""));
-                                }
-                            }
-                        }
+    // el json se parsea fuera del hilo principal; al popup solo llega el resultado
+    HttpClient::get().getBanList<ParsedBanList>([](bool success, std::string const& jsonData) -> ParsedBanList {
+        ParsedBanList out;
+        if (!success) return out;
+
+        auto parsed = matjson::parse(jsonData);
+        if (!parsed.isOk()) return out;
+        auto root = parsed.unwrap();
+        if (!root.isObject()) return out;
+
+        auto banned = root["banned"];
+        if (banned.isArray()) {
+            auto arrRes = banned.asArray();
+            if (arrRes.isOk()) {
+                for (auto const& v : arrRes.unwrap()) {
+                    if (v.isString()) {
+                        out.users.push_back(v.asString().unwrapOr(""));
                     }
+                }
+            }
+        }
 
-                    if (root.contains("details") && root["details"].isObject()) {
-                        for (auto const& val : root["details"]) {
-                            if (val.isObject()) {
-                                auto keyOpt = val.getKey();
-                                if (!keyOpt) continue;
-                                std::string key = *keyOpt;
-
-                                BanDetail d;
-                                if (val.contains("reason") && val["reason"].isString())
-                                    d.reason = val["reason"].asString().unwrapOr("");
-                                if (val.contains("bannedBy") && val["bannedBy"].isString())
-                                    d.bannedBy = val["bannedBy"].asString().unwrapOr("");
-                                if (val.contains("date") && val["date"].isString())
-                                    d.date = val["date"].asString().unwrapOr("");
-
-                                popup->m_banDetails[key] = d;
-                            }
-                        }
-                    }
+        if (root.contains("details") && root["details"].isObject()) {
+            for (auto const& val : root["details"]) {
+                if (val.isObject()) {
+                    auto keyOpt = val.getKey();
+                    if (!keyOpt) continue;
+                    std::string key = *keyOpt;
+
+                    BanDetail d;
+                    if (val.contains("reason") && val["reason"].isString())
+                        d.reason = val["reason"].asString().unwrapOr("");
+                    if (val.contains("bannedBy") && val["bannedBy"].isString())
+                        d.bannedBy = val["bannedBy"].asString().unwrapOr("");
+                    if (val.contains("date") && val["date"].isString())
+                        d.date = val["date"].asString().unwrapOr("");
+
+                    out.details[key] = d;
                 }
             }
         }
+        return out;
+    }, [self, loadingRef](ParsedBanList list) {
+        if (loadingRef) loadingRef->dismiss();
+        auto popup = self.lock();
+        if (!popup) return;
+
+        for (auto& [key, detail] : list.details) {
+            popup->m_banDetails[key] = std::move(detail);
+        }
 
         if (popup->getParent()) {
-            popup->rebuildList(users);
+            popup->rebuildList(list.users);
         }
     });
 
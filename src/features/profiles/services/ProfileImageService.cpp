@@ -247,8 +247,9 @@ void ProfileImageService::downloadProfile(int accountID, std::string const& user
                 return;
             }
 
-            auto* texture = ThumbnailTransportClient::bytesToTexture(data);
-            callback(texture != nullptr, texture);
+            ProfileThumbs::get().decodeAndUpload(profileAccountID, data, [callback](CCTexture2D* texture) {
+                callback(texture != nullptr, texture);
+            });
         });
 }
 
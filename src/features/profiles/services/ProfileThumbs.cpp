@@ -2,7 +2,10 @@
 #include "../../../managers/ThumbnailAPI.hpp"
 #include "../../../core/Settings.hpp"
 #include "../../../utils/AnimatedGIFSprite.hpp"
+#include "../../../utils/TextureUploadQueue.hpp"
 #include "../../../core/QualityConfig.hpp"
+#include "../../../utils/HttpClient.hpp"
+#include "../../../framework/net/DownloadGovernor.hpp"
 #include <Geode/utils/file.hpp>
 #include <Geode/utils/string.hpp>
 #include <filesystem>
@@ -104,6 +107,32 @@ namespace {
     }
 }
 
+namespace {
+    size_t profileTextureBytes(CCTexture2D* tex) {
+        return tex ? static_cast<size_t>(tex->getPixelsWide()) * tex->getPixelsHigh() * 4 : 0;
+    }
+}
+
+ProfileThumbs::ProfileThumbs() {
+    // el presupuesto comun saca perfiles en main thread cuando los caches se pasan
+    m_budget = paimon::memory::MemoryBudget::get().registerSource("profiles", [this](std::string const& k) {
+        int accountID = std::atoi(k.c_str());
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_profileCache.find(accountID);
+        if (it == m_profileCache.end()) return true;
+        if (!it->second.gifKey.empty()) {
+            AnimatedGIFSprite::unpinGIF(it->second.gifKey);
+        }
+        auto lruIt = m_lruMap.find(accountID);
+        if (lruIt != m_lruMap.end()) {
+            m_lruOrder.erase(lruIt->second);
+            m_lruMap.erase(lruIt);
+        }
+        m_profileCache.erase(it);
+        return true;
+    });
+}
+
 ProfileThumbs& ProfileThumbs::get() {
     static ProfileThumbs inst; 
     static bool initialized = false;
@@ -311,6 +340,9 @@ void ProfileThumbs::cacheProfile(int accountID, CCTexture2D* texture,
     m_lruOrder.push_back(accountID);
     m_lruMap[accountID] = std::prev(m_lruOrder.end());
 
+    auto& budget = paimon::memory::MemoryBudget::get();
+    budget.touch(m_budget, std::to_string(accountID), profileTextureBytes(texture), PROFILE_REBUILD_COST);
+
     // evictar si sobrepasamos el limite — O(1) con LRU
     while (m_profileCache.size() > MAX_PROFILE_CACHE_SIZE && !m_lruOrder.empty()) {
         int removeID = m_lruOrder.front();
@@ -327,6 +359,7 @@ void ProfileThumbs::cacheProfile(int accountID, CCTexture2D* texture,
             }
             m_profileCache.erase(evictIt);
         }
+        budget.forget(m_budget, std::to_string(removeID));
     }
 }
 
@@ -357,6 +390,8 @@ void ProfileThumbs::cacheProfileGIF(int accountID, std::string const& gifKey,
     
     m_profileCache[accountID] = ProfileCacheEntry(gifKey, colorA, colorB, widthFactor);
     m_profileCache[accountID].config = existingConfig;
+    // sin textura propia: los frames cuentan en el cache de GIFs (pineados)
+    paimon::memory::MemoryBudget::get().forget(m_budget, std::to_string(accountID));
 }
 
 void ProfileThumbs::cacheProfileConfig(int accountID, ProfileConfig const& config) {
@@ -407,6 +442,7 @@ ProfileCacheEntry* ProfileThumbs::getCachedProfile(int accountID) {
             m_lruMap.erase(lruIt);
         }
         m_profileCache.erase(it);
+        paimon::memory::MemoryBudget::get().forget(m_budget, std::to_string(accountID));
         return nullptr;
     }
     
@@ -417,6 +453,10 @@ ProfileCacheEntry* ProfileThumbs::getCachedProfile(int accountID) {
     }
     m_lruOrder.push_back(accountID);
     m_lruMap[accountID] = std::prev(m_lruOrder.end());
+    if (it->second.texture) {
+        paimon::memory::MemoryBudget::get().touch(m_budget, std::to_string(accountID),
+            profileTextureBytes(it->second.texture), PROFILE_REBUILD_COST);
+    }
     
     log::debug("[ProfileThumbs] Cache found for account {}", accountID);
     return &it->second;
@@ -428,6 +468,7 @@ void ProfileThumbs::clearCache(int accountID) {
     if (it != m_profileCache.end()) {
         log::debug("[ProfileThumbs] Clearing cache for account {}", accountID);
         m_profileCache.erase(it);
+        paimon::memory::MemoryBudget::get().forget(m_budget, std::to_string(accountID));
         auto lruIt = m_lruMap.find(accountID);
         if (lruIt != m_lruMap.end()) {
             m_lruOrder.erase(lruIt->second);
@@ -452,6 +493,7 @@ void ProfileThumbs::clearOldCache() {
                 m_lruOrder.erase(lruIt->second);
                 m_lruMap.erase(lruIt);
             }
+            paimon::memory::MemoryBudget::get().forget(m_budget, std::to_string(it->first));
             it = m_profileCache.erase(it);
         } else {
             ++it;
@@ -471,6 +513,7 @@ void ProfileThumbs::clearAllCache() {
     m_lruOrder.clear();
     m_lruMap.clear();
     m_noProfileCache.clear();
+    paimon::memory::MemoryBudget::get().forgetAll(m_budget);
 }
 
 void ProfileThumbs::markNoProfile(int accountID) {
@@ -811,8 +854,60 @@ void ProfileThumbs::notifyVisible(int accountID) {
     m_visibilityMap[accountID] = std::chrono::steady_clock::now();
 }
 
+int ProfileThumbs::uploadPriority(int accountID) const {
+    // mismo criterio que processQueue: visto en los ultimos 200ms = en pantalla
+    auto it = m_visibilityMap.find(accountID);
+    if (it != m_visibilityMap.end() &&
+        std::chrono::steady_clock::now() - it->second < std::chrono::milliseconds(200)) {
+        return 1000;
+    }
+    return 0;
+}
+
+void ProfileThumbs::decodeAndUpload(int accountID, std::vector<uint8_t> data, geode::CopyableFunction<void(CCTexture2D*)> callback) {
+    int priority = uploadPriority(accountID);
+    spawnBackground([accountID, priority, data = std::move(data), callback]() {
+        if (s_shutdownMode.load(std::memory_order_acquire)) return;
+
+        auto* img = new CCImage();
+        if (!img->initWithImageData(const_cast<uint8_t*>(data.data()), data.size())) {
+            log::error("[ProfileThumbs] fallo al decodificar imagen de perfil {}", accountID);
+            img->release();
+            Loader::get()->queueInMainThread([callback]() { callback(nullptr); });
+            return;
+        }
+
+        // solo la subida a GPU toca el main thread, y repartida entre frames
+        paimon::image::TextureUploadQueue::get().post(priority, [accountID, img, callback]() {
+            if (s_shutdownMode.load(std::memory_order_acquire)) {
+                img->release();
+                return;
+            }
+            auto* tex = new CCTexture2D();
+            bool ok = tex->initWithImage(img);
+            img->release();
+            if (!ok) {
+                tex->release();
+                log::error("[ProfileThumbs] fallo al crear textura de perfil {}", accountID);
+                callback(nullptr);
+                return;
+            }
+            tex->autorelease();
+            callback(tex);
+        });
+    });
+}
+
+int ProfileThumbs::downloadLimit() const {
+    // los perfiles salen del Worker: no suelto mas de los que caben en su ventana,
+    // asi la eleccion por visibilidad de abajo sigue decidiendo el orden
+    return paimon::net::DownloadGovernor::get().window(
+        paimon::net::DownloadGovernor::hostOf(HttpClient::get().getServerURL()));
+}
+
 void ProfileThumbs::processQueue() {
-    while (m_activeDownloads < MAX_CONCURRENT_DOWNLOADS && !m_downloadQueue.empty()) {
+    int limit = downloadLimit();
+    while (m_activeDownloads < limit && !m_downloadQueue.empty()) {
         m_activeDownloads++;
 
         // busco el mejor candidato
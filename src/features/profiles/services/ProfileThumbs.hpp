@@ -15,6 +15,8 @@
 
 #include <unordered_set>
 
+#include "../../../utils/MemoryBudget.hpp"
+
 struct ProfileConfig {
     std::string backgroundType = "gradient";
     float blurIntensity = 3.0f;
@@ -99,6 +101,11 @@ public:
     // notifica que un perfil es visible en pantalla (sube prioridad)
     void notifyVisible(int accountID);
 
+    // decodifica una imagen descargada fuera del main thread y sube la textura
+    // por TextureUploadQueue (antes si el perfil esta en pantalla).
+    // callback en main thread con textura autorelease o nullptr
+    void decodeAndUpload(int accountID, std::vector<uint8_t> data, geode::CopyableFunction<void(cocos2d::CCTexture2D*)> callback);
+
     // manejo de cache negativa (usuarios sin perfil)
     void markNoProfile(int accountID);
     void removeFromNoProfileCache(int accountID);
@@ -110,9 +117,10 @@ public:
     void shutdown();
 
 private:
-    ProfileThumbs() = default;
+    ProfileThumbs();
     std::string makePath(int accountID) const;
     void processQueue();
+    int uploadPriority(int accountID) const;
     
     std::unordered_map<int, ProfileCacheEntry> m_profileCache;
     // LRU O(1): lista de orden de acceso + mapa de iteradores
@@ -124,6 +132,9 @@ private:
     std::unordered_map<int, std::string> m_usernameMap; // accountID -> username para descargas pendientes
     static constexpr auto CACHE_DURATION = std::chrono::hours(24 * 14); // 14 dias
     static constexpr size_t MAX_PROFILE_CACHE_SIZE = 100; // limite de entradas en cache
+    // cuenta en MemoryBudget (solo entradas con textura; los GIF van en la de AnimatedGIFSprite)
+    paimon::memory::MemoryBudget::SourceId m_budget = -1;
+    static constexpr double PROFILE_REBUILD_COST = 1.5; // disco o descarga + decode
     static constexpr size_t MAX_NO_PROFILE_CACHE_SIZE = 1024;
     int m_insertsSinceCleanup = 0;
     static constexpr int CLEANUP_INTERVAL = 20; // cada N inserciones revisar expiradas
@@ -132,7 +143,8 @@ private:
     std::deque<int> m_downloadQueue;
     std::unordered_map<int, std::vector<geode::CopyableFunction<void(bool, cocos2d::CCTexture2D*)>>> m_pendingCallbacks;
     int m_activeDownloads = 0;
-    const int MAX_CONCURRENT_DOWNLOADS = 50;
+    // el tope sale de la ventana del Worker en DownloadGovernor (se adapta a la conexion)
+    int downloadLimit() const;
 
     void spawnBackground(std::function<void()> job);
     void pruneFinishedWorkers();
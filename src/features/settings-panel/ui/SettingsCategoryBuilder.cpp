@@ -9,8 +9,26 @@
 #include "../../../features/transitions/ui/TransitionConfigPopup.hpp"
 #include "../../../features/backgrounds/services/LayerBackgroundManager.hpp"
 #include "../../../features/thumbnails/services/ThumbnailLoader.hpp"
+#include "../../../features/thumbnails/services/LevelColors.hpp"
 #include "../../../features/profile-music/services/ProfileMusicManager.hpp"
+#include "../../../framework/net/RequestCoalescer.hpp"
+#include "../../../framework/net/DownloadGovernor.hpp"
 #include "../../../utils/PaimonNotification.hpp"
+#include "../../../utils/TextureUploadQueue.hpp"
+#include "../../../utils/MemoryBudget.hpp"
+#include "../../../utils/AnimatedGIFSprite.hpp"
+#include "../../../utils/WebHelper.hpp"
+#include "../../../utils/HttpClient.hpp"
+
+#ifdef PAIMON_BENCHMARKS
+#include "../../../bench/BenchCommon.hpp"
+#include "../../../bench/WorkerPoolBenchmark.hpp"
+#include "../../../bench/LockBenchmark.hpp"
+#include "../../../bench/GIFStreamBenchmark.hpp"
+#include "../../../bench/GIFDecodeBenchmark.hpp"
+#include "../../../bench/GIFCacheBenchmark.hpp"
+#include "../../../bench/DominantColorsBenchmark.hpp"
+#endif
 
 #include <Geode/Geode.hpp>
 
@@ -314,6 +332,18 @@ void buildPerformance(CCNode* c, float w) {
         1, 20,
         [](int v){ sset<int64_t>("thumbnail-concurrent-downloads", static_cast<int64_t>(v)); },
         w));
+
+    c->addChild(createSliderRow("Upload Budget (ms)",
+        static_cast<float>(gset<double>("texture-upload-budget-ms")),
+        0.5f, 16.0f,
+        [](float v){ sset<double>("texture-upload-budget-ms", static_cast<double>(v)); },
+        w));
+
+    c->addChild(createIntSliderRow("Recheck Cache (hours)",
+        static_cast<int>(gset<int64_t>("thumbnail-revalidate-hours")),
+        0, 168,
+        [](int v){ sset<int64_t>("thumbnail-revalidate-hours", static_cast<int64_t>(v)); },
+        w));
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -717,6 +747,224 @@ void buildMaintenance(CCNode* c, float w) {
         },
         w));
 
+    c->addChild(createSectionHeader("Diagnostics", w));
+
+#ifdef PAIMON_BENCHMARKS
+    // WorkerPool contra un std::async por job; jobs/s y latencia de arranque en el log
+    c->addChild(createButtonRow("Worker Pool Benchmark", "Run",
+        [](){
+            paimon::bench::launch("worker pool benchmark",
+                [] { return paimon::bench::runWorkerPoolBenchmark(); },
+                [](paimon::bench::WorkerPoolBenchReport const& report) {
+                    auto msg = fmt::format("Jobs/s: {:.0f} -> {:.0f}, start p99 {:.0f}us -> {:.0f}us (see log)",
+                        report.spawn.jobsPerSec, report.pool.jobsPerSec,
+                        report.spawn.startP99Us, report.pool.startP99Us);
+                    PaimonNotify::create(msg, NotificationIcon::Success)->show();
+                });
+        },
+        w));
+
+    // contencion de locks del ThumbnailLoader (antes/despues de los shards); resultado en el log
+    c->addChild(createButtonRow("Lock Benchmark", "Run",
+        [](){
+            paimon::bench::launch("lock benchmark",
+                [] { return paimon::bench::runLockBenchmark(); },
+                [](paimon::bench::LockBenchReport const& report) {
+                    auto msg = fmt::format("Lock wait p99: {:.0f}ns -> {:.0f}ns (see log)",
+                        report.global.waitP99Ns, report.sharded.waitP99Ns);
+                    PaimonNotify::create(msg, NotificationIcon::Success)->show();
+                });
+        },
+        w));
+
+    // decode completo vs GIFDecoder::Stream sobre los GIFs de la cache; tabla por archivo en el log
+    c->addChild(createButtonRow("GIF Stream Benchmark", "Run",
+        [](){
+            paimon::bench::launch("GIF stream benchmark",
+                [] { return paimon::bench::runGIFStreamBenchmark(); },
+                [](paimon::bench::GIFStreamBenchReport const& report) {
+                    if (report.files.empty()) {
+                        PaimonNotify::create("No cached GIFs to benchmark.", NotificationIcon::Info)->show();
+                        return;
+                    }
+                    auto msg = fmt::format("GIF first frame: {:.1f}ms -> {:.1f}ms, peak {} KB -> {} KB (see log)",
+                        report.batchFirstFrameMeanMs, report.streamFirstFrameMeanMs,
+                        report.batchPeakMaxBytes / 1024, report.streamPeakMaxBytes / 1024);
+                    PaimonNotify::create(msg, NotificationIcon::Success)->show();
+                });
+        },
+        w));
+
+    // MB/s del kernel de GIFDecoder contra el anterior sobre los GIFs de la cache
+    c->addChild(createButtonRow("GIF Decode Benchmark", "Run",
+        [](){
+            paimon::bench::launch("GIF decode benchmark",
+                [] { return paimon::bench::runGIFDecodeBenchmark(); },
+                [](paimon::bench::GIFDecodeBenchReport const& report) {
+                    if (report.files == 0) {
+                        PaimonNotify::create("No cached GIFs to benchmark.", NotificationIcon::Info)->show();
+                        return;
+                    }
+                    auto msg = fmt::format("GIF decode: {:.1f} -> {:.1f} MB/s over {} GIFs (see log)",
+                        report.legacy.inputMBps, report.current.inputMBps, report.files);
+                    PaimonNotify::create(msg, NotificationIcon::Success)->show();
+                });
+        },
+        w));
+
+    // cache en disco de AnimatedGIFSprite: v2 sin comprimir vs GIFFrameStore
+    c->addChild(createButtonRow("GIF Disk Cache Benchmark", "Run",
+        [](){
+            paimon::bench::launch("GIF disk cache benchmark",
+                [] { return paimon::bench::runGIFCacheBenchmark(); },
+                [](paimon::bench::GIFCacheBenchReport const& report) {
+                    if (report.files == 0) {
+                        PaimonNotify::create("No cached GIFs to benchmark.", NotificationIcon::Info)->show();
+                        return;
+                    }
+                    auto msg = fmt::format("GIF cache: {} -> {} KB, load {:.1f} -> {:.1f} ms over {} GIFs (see log)",
+                        report.raw.bytes / 1024, report.store.bytes / 1024,
+                        report.raw.loadMs, report.store.loadMs, report.files);
+                    PaimonNotify::create(msg, report.mismatchedFiles ? NotificationIcon::Warning : NotificationIcon::Success)->show();
+                });
+        },
+        w));
+
+    // DominantColors::extract (histograma) contra el extractor anterior sobre las miniaturas de la cache
+    c->addChild(createButtonRow("Dominant Colors Benchmark", "Run",
+        [](){
+            paimon::bench::launch("dominant colors benchmark",
+                [] { return paimon::bench::runDominantColorsBenchmark(); },
+                [](paimon::bench::DominantColorsBenchReport const& report) {
+                    if (report.images == 0) {
+                        PaimonNotify::create("No cached thumbnails to benchmark.", NotificationIcon::Info)->show();
+                        return;
+                    }
+                    auto msg = fmt::format("Colors: {:.2f} -> {:.2f} ms/image, max dE {:.1f} over {} images (see log)",
+                        report.legacy.meanMs, report.current.meanMs, report.maxDeltaE, report.images);
+                    PaimonNotify::create(msg, NotificationIcon::Success)->show();
+                });
+        },
+        w));
+#endif
+
+    // subidas a GPU por frame (TextureUploadQueue); el detalle por rafaga va al log
+    c->addChild(createButtonRow("Texture Uploads", "Show",
+        [](){
+            auto st = paimon::image::TextureUploadQueue::get().stats();
+            auto msg = fmt::format("Uploads: last {:.2f}ms, worst {:.2f}ms / {:.1f}ms budget, queue {} (peak {})",
+                st.lastFrameMs, st.maxFrameMs, st.budgetMs, st.depth, st.peakDepth);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // paginas compartidas de miniaturas de lista (ThumbnailAtlas)
+    c->addChild(createButtonRow("Thumbnail Atlas", "Show",
+        [](){
+            auto st = ThumbnailLoader::get().atlasStats();
+            double fill = st.alloc.pageArea ? 100.0 * st.alloc.liveArea / st.alloc.pageArea : 0.0;
+            auto msg = fmt::format("Atlas: {} tiles ({}x{}) in {} pages of {}px, {:.0f}% used, {} recycles, {} hits / {} misses",
+                st.alloc.entries, st.tileWidth, st.tileHeight, st.alloc.pages, st.pageSize, fill,
+                st.alloc.recycles, st.regionHits, st.regionMisses);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // GIFs: cache compartido y ventanas de los GIFs largos que se estan viendo
+    c->addChild(createButtonRow("GIF Residency", "Show",
+        [](){
+            auto st = AnimatedGIFSprite::residencyStats();
+            auto msg = fmt::format("GIFs: cache {:.1f} MB, {} windows {:.1f} MB ({} windowed sprites)",
+                st.cacheBytes / (1024.0 * 1024.0), st.windows, st.windowBytes / (1024.0 * 1024.0), st.windowedSprites);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // extraccion de colores en segundo plano (LevelColors)
+    c->addChild(createButtonRow("Color Extraction", "Show",
+        [](){
+            auto st = LevelColors::get().extractionStats();
+            auto msg = fmt::format("Colors: {} done, {} failed, {} skipped, {} queued, {} running{}",
+                st.done, st.failed, st.skipped, st.queued, st.inFlight, st.running ? "" : " (idle)");
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // presupuesto comun de RAM de los caches de imagen; el desglose por cache va al log
+    c->addChild(createButtonRow("Memory Budget", "Show",
+        [](){
+            auto& budget = paimon::memory::MemoryBudget::get();
+            log::info("[MemoryBudget] {}", budget.dump());
+            auto st = budget.stats();
+            auto msg = fmt::format("Image caches: {:.0f} / {:.0f} MB (peak {:.0f}), {} trims (see log)",
+                st.usedBytes / (1024.0 * 1024.0), st.budgetBytes / (1024.0 * 1024.0),
+                st.peakBytes / (1024.0 * 1024.0), st.pressureTrims);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // GETs compartidos entre callers y respuestas servidas desde la memo
+    c->addChild(createButtonRow("HTTP Coalescing", "Show",
+        [](){
+            auto st = paimon::net::RequestCoalescer::get().stats();
+            auto msg = fmt::format("HTTP: {} sent, {} coalesced, {} memo hits, {:.1f} KB saved",
+                st.requests, st.coalesced, st.memoHits, st.bytesSaved / 1024.0);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // hits de disco pasada la ventana: cuantos confirmo un 304 y cuantos cambiaron
+    c->addChild(createButtonRow("Cache Revalidation", "Show",
+        [](){
+            auto& st = ThumbnailLoader::get().stats();
+            auto msg = fmt::format("Revalidation: {} checked, {} fresh, {} changed, {:.1f} KB saved",
+                st.revalidations.load(), st.revalidatedFresh.load(), st.revalidatedChanged.load(),
+                st.revalidationBytesSaved.load() / 1024.0);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // ventana adaptativa de descargas por host (CDN, Worker...)
+    c->addChild(createButtonRow("Download Windows", "Show",
+        [](){
+            auto hosts = paimon::net::DownloadGovernor::get().stats();
+            std::string msg = hosts.empty() ? "Downloads: no requests yet" : "";
+            for (auto const& st : hosts) {
+                if (!msg.empty()) msg += " | ";
+                msg += fmt::format("{}: window {:.1f} (peak {}), {} in flight, {} queued, {:.0f}ms (min {:.0f}), {:.1f} KB/s, {}/{} failed ({} timeouts), {} backoffs",
+                    st.host, st.window, st.peakWindow, st.inFlight, st.queued,
+                    st.latencyMs, st.baseLatencyMs, st.throughputKBps,
+                    st.failures, st.requests, st.timeouts, st.decreases);
+            }
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // URLs directas de CDN: LRU, log en disco y lo que costo cargarlo al arrancar
+    c->addChild(createButtonRow("CDN Manifest", "Show",
+        [](){
+            auto st = HttpClient::get().manifestCacheStats();
+            auto msg = fmt::format("CDN manifest: {}/{} levels, {} hits / {} misses, {} evicted, {:.1f} KB on disk, loaded in {:.2f}ms ({})",
+                st.entries, st.capacity, st.hits, st.misses, st.evictions,
+                st.fileBytes / 1024.0, st.loadMs, st.loadSource);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
+    // ms de hilo principal por respuesta: callbacks de siempre vs parse fuera de main
+    c->addChild(createButtonRow("HTTP Main Thread", "Show",
+        [](){
+            auto inl = WebHelper::mainThreadStats(WebHelper::Delivery::Inline);
+            auto off = WebHelper::mainThreadStats(WebHelper::Delivery::OffMain);
+            log::info("[WebHelper] main thread por respuesta: inline {} resp, media {:.3f}ms, max {:.2f}ms; "
+                "off-main {} resp, media {:.3f}ms, max {:.2f}ms",
+                inl.responses, inl.meanMs(), inl.maxMs, off.responses, off.meanMs(), off.maxMs);
+            auto msg = fmt::format("Main thread/response: inline {:.2f}ms (max {:.1f}), off-main {:.2f}ms (max {:.1f})",
+                inl.meanMs(), inl.maxMs, off.meanMs(), off.maxMs);
+            PaimonNotify::create(msg, NotificationIcon::Info)->show();
+        },
+        w));
+
     c->addChild(createButtonRow("Fetch Mod Code", "Fetch",
         [](){
             PaimonNotify::create("Use Geode mod settings to fetch your mod code.", NotificationIcon::Info)->show();
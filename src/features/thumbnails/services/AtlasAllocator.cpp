@@ -0,0 +1,281 @@
+#include "AtlasAllocator.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace paimon::cache {
+
+// ── Skyline ─────────────────────────────────────────────────────────
+
+void AtlasAllocator::Skyline::reset(int size) {
+    m_size = size;
+    m_nodes.clear();
+    m_nodes.push_back(Node{0, 0, size});
+}
+
+int AtlasAllocator::Skyline::fitAt(size_t i, int w, int h) const {
+    int x = m_nodes[i].x;
+    if (x + w > m_size) return -1;
+    int y = 0;
+    int remaining = w;
+    while (remaining > 0) {
+        if (i >= m_nodes.size()) return -1;
+        y = std::max(y, m_nodes[i].y);
+        if (y + h > m_size) return -1;
+        remaining -= m_nodes[i].width;
+        ++i;
+    }
+    return y;
+}
+
+std::optional<AtlasAllocator::Rect> AtlasAllocator::Skyline::insert(int w, int h) {
+    // bottom-left: el que deja el borde superior mas bajo; en empate el segmento mas angosto
+    int bestTop = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    size_t bestIndex = m_nodes.size();
+    Rect best;
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        int y = fitAt(i, w, h);
+        if (y < 0) continue;
+        if (y + h < bestTop || (y + h == bestTop && m_nodes[i].width < bestWidth)) {
+            bestTop = y + h;
+            bestWidth = m_nodes[i].width;
+            bestIndex = i;
+            best = Rect{m_nodes[i].x, y, w, h};
+        }
+    }
+    if (bestIndex == m_nodes.size()) return std::nullopt;
+
+    m_nodes.insert(m_nodes.begin() + static_cast<ptrdiff_t>(bestIndex), Node{best.x, best.y + h, w});
+
+    // recorto los segmentos que quedaron debajo del nuevo
+    for (size_t i = bestIndex + 1; i < m_nodes.size();) {
+        auto const& prev = m_nodes[i - 1];
+        int prevEnd = prev.x + prev.width;
+        if (m_nodes[i].x >= prevEnd) break;
+        int shrink = prevEnd - m_nodes[i].x;
+        m_nodes[i].x += shrink;
+        m_nodes[i].width -= shrink;
+        if (m_nodes[i].width <= 0) {
+            m_nodes.erase(m_nodes.begin() + static_cast<ptrdiff_t>(i));
+            continue;
+        }
+        break;
+    }
+
+    // junto vecinos a la misma altura
+    for (size_t i = 0; i + 1 < m_nodes.size();) {
+        if (m_nodes[i].y == m_nodes[i + 1].y) {
+            m_nodes[i].width += m_nodes[i + 1].width;
+            m_nodes.erase(m_nodes.begin() + static_cast<ptrdiff_t>(i + 1));
+        } else {
+            ++i;
+        }
+    }
+    return best;
+}
+
+// ── AtlasAllocator ──────────────────────────────────────────────────
+
+AtlasAllocator::AtlasAllocator() : AtlasAllocator(Config{}) {}
+
+AtlasAllocator::AtlasAllocator(Config config) : m_config(config) {
+    m_config.pageSize = std::max(64, m_config.pageSize);
+    m_config.maxPages = std::max(1, m_config.maxPages);
+    m_config.padding = std::max(0, m_config.padding);
+}
+
+std::optional<AtlasAllocator::Slot> AtlasAllocator::insert(int key, uint8_t const* rgba, int w, int h, uint64_t tick) {
+    if (!rgba || w <= 0 || h <= 0) return std::nullopt;
+    int ow = w + m_config.padding * 2;
+    int oh = h + m_config.padding * 2;
+    if (ow > m_config.pageSize || oh > m_config.pageSize) {
+        m_stats.failures++;
+        return std::nullopt;
+    }
+
+    remove(key);
+
+    std::optional<uint32_t> page;
+    std::optional<Rect> outer;
+    for (uint32_t p = 0; p < m_pages.size() && !outer; ++p) {
+        if ((outer = place(p, ow, oh))) page = p;
+    }
+    if (!outer && m_pages.size() < static_cast<size_t>(m_config.maxPages)) {
+        uint32_t p = addPage();
+        if ((outer = place(p, ow, oh))) page = p;
+    }
+    if (!outer) {
+        // sin sitio: se recicla la pagina usada hace mas tiempo. las celdas
+        // que la muestran se quedan con su textura; lo nuevo va a otra
+        uint32_t victim = 0;
+        for (uint32_t p = 1; p < m_pages.size(); ++p) {
+            if (m_pages[p].lastUse < m_pages[victim].lastUse) victim = p;
+        }
+        resetPage(victim, true);
+        if ((outer = place(victim, ow, oh))) page = victim;
+    }
+    if (!outer) {
+        m_stats.failures++;
+        return std::nullopt;
+    }
+
+    auto& pg = m_pages[*page];
+    pg.liveArea += static_cast<uint64_t>(ow) * static_cast<uint64_t>(oh);
+    pg.lastUse = std::max(pg.lastUse, tick);
+    pg.entries++;
+    Entry entry{*page, *outer};
+    m_entries[key] = entry;
+    m_uploads.push_back(Upload{*page, false, *outer, padTile(rgba, w, h)});
+    m_stats.inserts++;
+    return slotFor(entry);
+}
+
+bool AtlasAllocator::remove(int key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return false;
+    auto& pg = m_pages[it->second.page];
+    uint64_t area = static_cast<uint64_t>(it->second.outer.w) * static_cast<uint64_t>(it->second.outer.h);
+    pg.liveArea -= std::min(pg.liveArea, area);
+    pg.deadArea += area;
+    pg.entries--;
+    uint32_t page = it->second.page;
+    m_entries.erase(it);
+
+    // vacia: arranca de cero con generacion nueva
+    if (pg.entries == 0) resetPage(page, false);
+    return true;
+}
+
+std::optional<AtlasAllocator::Slot> AtlasAllocator::find(int key) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return std::nullopt;
+    return slotFor(it->second);
+}
+
+void AtlasAllocator::touch(int key, uint64_t tick) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+    auto& pg = m_pages[it->second.page];
+    pg.lastUse = std::max(pg.lastUse, tick);
+}
+
+bool AtlasAllocator::evictPage(uint32_t page) {
+    if (page >= m_pages.size()) return false;
+    resetPage(page, true);
+    return true;
+}
+
+void AtlasAllocator::clear() {
+    m_pages.clear();
+    m_entries.clear();
+    m_uploads.clear();
+    m_evicted.clear();
+}
+
+uint32_t AtlasAllocator::pageGeneration(uint32_t page) const {
+    return page < m_pages.size() ? m_pages[page].generation : 0;
+}
+
+size_t AtlasAllocator::pageEntries(uint32_t page) const {
+    return page < m_pages.size() ? m_pages[page].entries : 0;
+}
+
+std::vector<AtlasAllocator::Upload> AtlasAllocator::takeUploads() {
+    std::vector<Upload> out;
+    out.swap(m_uploads);
+    return out;
+}
+
+std::vector<int> AtlasAllocator::takeEvicted() {
+    std::vector<int> out;
+    out.swap(m_evicted);
+    return out;
+}
+
+AtlasAllocator::Stats AtlasAllocator::stats() const {
+    Stats s = m_stats;
+    s.pages = m_pages.size();
+    s.entries = m_entries.size();
+    uint64_t side = static_cast<uint64_t>(m_config.pageSize);
+    s.pageArea = side * side * m_pages.size();
+    for (auto const& pg : m_pages) {
+        s.liveArea += pg.liveArea;
+        s.deadArea += pg.deadArea;
+    }
+    return s;
+}
+
+std::optional<AtlasAllocator::Rect> AtlasAllocator::place(uint32_t page, int w, int h) {
+    return m_pages[page].skyline.insert(w, h);
+}
+
+uint32_t AtlasAllocator::addPage() {
+    Page pg;
+    pg.skyline.reset(m_config.pageSize);
+    pg.generation = m_nextGeneration++;
+    m_pages.push_back(std::move(pg));
+    return static_cast<uint32_t>(m_pages.size() - 1);
+}
+
+void AtlasAllocator::resetPage(uint32_t page, bool evict) {
+    auto& pg = m_pages[page];
+    if (evict) {
+        size_t before = m_evicted.size();
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.page == page) {
+                m_evicted.push_back(it->first);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_stats.evictedOnRecycle += m_evicted.size() - before;
+        m_stats.recycles++;
+    }
+    pg.skyline.reset(m_config.pageSize);
+    pg.liveArea = 0;
+    pg.deadArea = 0;
+    pg.entries = 0;
+    pg.generation = m_nextGeneration++;
+    // lo pendiente de la generacion vieja ya no se sube
+    m_uploads.erase(std::remove_if(m_uploads.begin(), m_uploads.end(),
+        [page](Upload const& u) { return u.page == page; }), m_uploads.end());
+    m_uploads.push_back(Upload{page, true, Rect{}, {}});
+}
+
+std::vector<uint8_t> AtlasAllocator::padTile(uint8_t const* rgba, int w, int h) const {
+    int pad = m_config.padding;
+    int ow = w + pad * 2;
+    int oh = h + pad * 2;
+    size_t rowBytes = static_cast<size_t>(w) * 4;
+    size_t outerBytes = static_cast<size_t>(ow) * 4;
+    std::vector<uint8_t> out(outerBytes * oh);
+
+    auto dstRow = [&](int row) { return out.data() + outerBytes * row; };
+
+    for (int row = 0; row < h; ++row) {
+        uint8_t* dst = dstRow(row + pad);
+        uint8_t const* src = rgba + static_cast<size_t>(row) * rowBytes;
+        std::memcpy(dst + static_cast<size_t>(pad) * 4, src, rowBytes);
+        // extruyo la primera y ultima columna
+        for (int i = 0; i < pad; ++i) {
+            std::memcpy(dst + static_cast<size_t>(i) * 4, src, 4);
+            std::memcpy(dst + (static_cast<size_t>(pad + w + i)) * 4, src + rowBytes - 4, 4);
+        }
+    }
+    // y la primera y ultima fila (ya con las esquinas extruidas)
+    for (int i = 0; i < pad; ++i) {
+        std::memcpy(dstRow(i), dstRow(pad), outerBytes);
+        std::memcpy(dstRow(pad + h + i), dstRow(pad + h - 1), outerBytes);
+    }
+    return out;
+}
+
+AtlasAllocator::Slot AtlasAllocator::slotFor(Entry const& e) const {
+    int pad = m_config.padding;
+    return Slot{e.page, m_pages[e.page].generation,
+        Rect{e.outer.x + pad, e.outer.y + pad, e.outer.w - pad * 2, e.outer.h - pad * 2}};
+}
+
+} // namespace paimon::cache
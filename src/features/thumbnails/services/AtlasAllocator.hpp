@@ -0,0 +1,148 @@
+#pragma once
+
+// AtlasAllocator.hpp — Reparto de thumbnails de lista en paginas RGBA grandes.
+// Solo CPU: no toca cocos ni GL, asi se puede probar sin ventana. Cada pagina
+// tiene un empaquetador skyline (bottom-left); el que sube a GPU
+// (ThumbnailAtlas) pide takeUploads() y escribe cada tile en su textura.
+//
+// - Los tiles llevan un borde de `padding` px con el borde extruido, asi el
+//   filtrado lineal no mezcla con el vecino.
+// - No hay espejo de pixeles: la textura es la unica copia de la pagina. El
+//   tile se sube una vez (ya con su padding) y el buffer se suelta.
+// - Quitar un tile no libera su hueco: el skyline no sabe reusar agujeros.
+//   Sin espejo no se puede reempaquetar, asi que cuando no hay sitio se
+//   recicla entera la pagina usada hace mas tiempo: sus tiles salen
+//   (takeEvicted) y la pagina arranca vacia con generacion nueva.
+// - Ninguna escritura cae sobre pixeles que alguien pudo ver: los tiles nuevos
+//   van a espacio nunca usado de la pagina, y reciclar o vaciar una pagina
+//   sube su generacion (el lado GPU crea otra textura en vez de pisar la
+//   vieja, que siguen usando los sprites ya creados).
+//
+// No es thread-safe; lo protege quien lo usa.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace paimon::cache {
+
+class AtlasAllocator {
+public:
+    struct Config {
+        int pageSize = 2048;
+        int maxPages = 2;
+        int padding = 2;
+    };
+
+    struct Rect {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+    };
+
+    // rect sin el padding, en pixeles de la pagina
+    struct Slot {
+        uint32_t page = 0;
+        uint32_t generation = 0;
+        Rect rect;
+    };
+
+    // reset = la pagina cambio de generacion: la textura actual ya no vale.
+    // si no, pixels (rect.w * rect.h * 4, padding incluido) van a rect
+    struct Upload {
+        uint32_t page = 0;
+        bool reset = false;
+        Rect rect;
+        std::vector<uint8_t> pixels;
+    };
+
+    struct Stats {
+        size_t pages = 0;
+        size_t entries = 0;
+        uint64_t pageArea = 0;   // area total de las paginas (px)
+        uint64_t liveArea = 0;   // tiles vivos, con padding
+        uint64_t deadArea = 0;   // tiles quitados que aun ocupan sitio
+        uint64_t inserts = 0;
+        uint64_t failures = 0;   // el tile no entra ni en una pagina vacia
+        uint64_t recycles = 0;   // paginas vaciadas para hacer sitio
+        uint64_t evictedOnRecycle = 0;
+    };
+
+    AtlasAllocator();
+    explicit AtlasAllocator(Config config);
+
+    // reserva sitio para rgba (w*h*4) y deja la subida en takeUploads();
+    // reemplaza la entrada previa de key. `tick` marca el uso (ver touch)
+    std::optional<Slot> insert(int key, uint8_t const* rgba, int w, int h, uint64_t tick);
+    bool remove(int key);
+    std::optional<Slot> find(int key) const;
+    // la pagina de key se uso en `tick`; la de tick mas viejo es la que se recicla
+    void touch(int key, uint64_t tick);
+    // vacia la pagina a pedido (presupuesto de memoria); sus keys van a takeEvicted()
+    bool evictPage(uint32_t page);
+    void clear();
+
+    Config const& config() const { return m_config; }
+    size_t pageCount() const { return m_pages.size(); }
+    uint32_t pageGeneration(uint32_t page) const;
+    size_t pageEntries(uint32_t page) const;
+
+    std::vector<Upload> takeUploads();
+    // keys que salieron al reciclar una pagina desde el ultimo take
+    std::vector<int> takeEvicted();
+    Stats stats() const;
+
+private:
+    // skyline bottom-left: segmentos {x, y, width} ordenados por x
+    class Skyline {
+    public:
+        void reset(int size);
+        std::optional<Rect> insert(int w, int h);
+
+    private:
+        struct Node {
+            int x;
+            int y;
+            int width;
+        };
+        std::vector<Node> m_nodes;
+        int m_size = 0;
+
+        // y donde apoyaria un rect de w empezando en el nodo i; -1 si no entra
+        int fitAt(size_t i, int w, int h) const;
+    };
+
+    struct Page {
+        Skyline skyline;
+        uint32_t generation = 0;
+        uint64_t liveArea = 0;
+        uint64_t deadArea = 0;
+        uint64_t lastUse = 0;
+        size_t entries = 0;
+    };
+
+    struct Entry {
+        uint32_t page;
+        Rect outer; // con padding
+    };
+
+    Config m_config;
+    std::vector<Page> m_pages;
+    std::unordered_map<int, Entry> m_entries;
+    std::vector<Upload> m_uploads;
+    std::vector<int> m_evicted;
+    Stats m_stats;
+    uint32_t m_nextGeneration = 1;
+
+    std::optional<Rect> place(uint32_t page, int w, int h);
+    uint32_t addPage();
+    // vacia la pagina (generacion nueva); con evict sus entradas van a m_evicted
+    void resetPage(uint32_t page, bool evict);
+    std::vector<uint8_t> padTile(uint8_t const* rgba, int w, int h) const;
+    Slot slotFor(Entry const& e) const;
+};
+
+} // namespace paimon::cache
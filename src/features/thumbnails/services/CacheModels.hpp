@@ -8,6 +8,8 @@
 #include <string>
 #include <string_view>
 #include <cstdint>
+#include <atomic>
+#include <array>
 #include <chrono>
 #include <unordered_map>
 #include <mutex>
@@ -84,13 +86,13 @@ struct CacheKeyHash {
 
 // ── Disk Manifest Entry ─────────────────────────────────────────────
 
-// Metadata persistente por archivo en disco. Se serializa a JSON como
-// un diccionario dentro del manifest file.
+// Metadata persistente por archivo en disco. Se serializa como registro
+// binario de tamaño fijo en manifest.bin / manifest.journal.
 struct DiskManifestEntry {
     std::string filename;          // nombre en disco, e.g. <levelID>.png
     int levelID = 0;               // levelID original (0 para gallery)
     std::string sourceUrl;         // URL de descarga si aplica
-    std::string revisionToken;     // hash de revision: thumbnailId o fallback date|format|url
+    std::string revisionToken;     // validador HTTP de la descarga (ETag o "lm:<Last-Modified>"), ver WebHelper::validatorOf
     std::string format;            // "png", "gif", "jpg", "webp"
     int width = 0;
     int height = 0;
@@ -100,6 +102,14 @@ struct DiskManifestEntry {
     bool isGif = false;
     std::string qualityTag;        // quality tier cuando se guardo
 
+    // variante pre-decodificada (<filename>.ptd), vacia si aun no se genero
+    std::string decodedFilename;
+    std::string decodedFormat;     // "rgba8888" o "rgb565"
+    size_t decodedByteSize = 0;
+
+    // bytes totales en disco de esta entrada (fuente + variante decodificada)
+    size_t diskBytes() const { return byteSize + decodedByteSize; }
+
     // genera un revision token a partir de ThumbnailInfo del transport
     static std::string makeRevisionToken(std::string const& thumbnailId, std::string const& date,
                                          std::string const& format, std::string const& url) {
@@ -126,6 +136,7 @@ struct CacheStats {
     std::atomic<uint64_t> ramMisses{0};
     std::atomic<uint64_t> diskHits{0};
     std::atomic<uint64_t> diskMisses{0};
+    std::atomic<uint64_t> decodedDiskHits{0}; // disk hits servidos desde la variante .ptd mapeada
     std::atomic<uint64_t> staleHits{0};     // RAM hit pero version stale
     std::atomic<uint64_t> downloads{0};
     std::atomic<uint64_t> downloadErrors{0};
@@ -133,13 +144,68 @@ struct CacheStats {
     std::atomic<uint64_t> diskEvictions{0};
     std::atomic<uint64_t> decodeTimeUsTotal{0}; // microsegundos acumulados de decode
 
+    // manifest CDN por pagina de lista: cuantos levels ya tenian URL directa
+    // y cuantos se resolvieron con el lookup batch (el resto va al Worker)
+    std::atomic<uint64_t> manifestPages{0};
+    std::atomic<uint64_t> manifestPageLevels{0};
+    std::atomic<uint64_t> manifestHits{0};
+    std::atomic<uint64_t> manifestLookups{0};  // ids pedidos en batch
+    std::atomic<uint64_t> manifestResolved{0}; // de esos, cuantos volvieron con CDN
+
+    // revalidacion condicional de lo servido desde disco pasada la ventana
+    std::atomic<uint64_t> revalidations{0};          // requests condicionales enviados
+    std::atomic<uint64_t> revalidatedFresh{0};       // 304 o mismos bytes: solo se renueva lastValidated
+    std::atomic<uint64_t> revalidatedChanged{0};     // el servidor tenia otra version
+    std::atomic<uint64_t> revalidationBytesSaved{0}; // bytes que no hubo que volver a bajar
+
+    double manifestHitRatio() const {
+        uint64_t levels = manifestPageLevels.load(std::memory_order_relaxed);
+        if (levels == 0) return 0.0;
+        return static_cast<double>(manifestHits.load(std::memory_order_relaxed) +
+            manifestResolved.load(std::memory_order_relaxed)) / static_cast<double>(levels);
+    }
+
+    // downscale por quality tier (indice = settings::Quality: low, med, high).
+    // decodedBytes = RGBA a resolucion original; uploadedBytes = lo que llega a
+    // initWithData. La diferencia es RAM (buffer + LRU) y VRAM ahorrada.
+    struct TierDownscale {
+        std::atomic<uint64_t> images{0};
+        std::atomic<uint64_t> downscaled{0};
+        std::atomic<uint64_t> decodedBytes{0};
+        std::atomic<uint64_t> uploadedBytes{0};
+
+        uint64_t savedBytes() const {
+            uint64_t in = decodedBytes.load(std::memory_order_relaxed);
+            uint64_t out = uploadedBytes.load(std::memory_order_relaxed);
+            return in > out ? in - out : 0;
+        }
+    };
+    std::array<TierDownscale, 3> tierDownscale;
+
+    void recordDownscale(size_t tier, uint64_t decodedBytes, uint64_t uploadedBytes) {
+        if (tier >= tierDownscale.size()) return;
+        auto& t = tierDownscale[tier];
+        t.images.fetch_add(1, std::memory_order_relaxed);
+        if (uploadedBytes < decodedBytes) t.downscaled.fetch_add(1, std::memory_order_relaxed);
+        t.decodedBytes.fetch_add(decodedBytes, std::memory_order_relaxed);
+        t.uploadedBytes.fetch_add(uploadedBytes, std::memory_order_relaxed);
+    }
+
     void reset() {
         ramHits = 0; ramMisses = 0;
-        diskHits = 0; diskMisses = 0;
+        diskHits = 0; diskMisses = 0; decodedDiskHits = 0;
         staleHits = 0;
         downloads = 0; downloadErrors = 0;
         ramEvictions = 0; diskEvictions = 0;
         decodeTimeUsTotal = 0;
+        manifestPages = 0; manifestPageLevels = 0;
+        manifestHits = 0; manifestLookups = 0; manifestResolved = 0;
+        revalidations = 0; revalidatedFresh = 0; revalidatedChanged = 0;
+        revalidationBytesSaved = 0;
+        for (auto& t : tierDownscale) {
+            t.images = 0; t.downscaled = 0;
+            t.decodedBytes = 0; t.uploadedBytes = 0;
+        }
     }
 };
 
@@ -0,0 +1,89 @@
+#include "DecodedThumbCache.hpp"
+#include "../../../utils/BinaryIO.hpp"
+#include <cstring>
+
+namespace paimon::cache::decoded {
+
+namespace {
+using binio::getLE;
+using binio::putLE;
+
+constexpr char MAGIC[4] = {'P', 'T', 'D', '1'};
+constexpr size_t HEADER_SIZE = 24;
+constexpr char const* EXTENSION = ".ptd";
+
+size_t bytesPerPixel(DecodedPixelFormat f) {
+    return f == DecodedPixelFormat::RGB565 ? 2 : 4;
+}
+
+bool isOpaque(std::vector<uint8_t> const& rgba) {
+    for (size_t i = 3; i < rgba.size(); i += 4) {
+        if (rgba[i] != 255) return false;
+    }
+    return true;
+}
+} // namespace
+
+std::string filenameFor(std::string const& sourceFilename) {
+    return sourceFilename + EXTENSION;
+}
+
+Encoded encode(std::vector<uint8_t> const& rgba, int width, int height,
+               uint64_t sourceBytes, bool sourceIsGif, bool allowRgb565) {
+    if (width <= 0 || height <= 0) return {};
+    size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    if (rgba.size() < pixelCount * 4) return {};
+
+    Encoded out;
+    out.format = (allowRgb565 && isOpaque(rgba)) ? DecodedPixelFormat::RGB565 : DecodedPixelFormat::RGBA8888;
+    size_t payload = pixelCount * bytesPerPixel(out.format);
+
+    auto& buf = out.bytes;
+    buf.resize(HEADER_SIZE + payload);
+    std::memcpy(buf.data(), MAGIC, 4);
+    buf[4] = static_cast<uint8_t>(out.format);
+    buf[5] = sourceIsGif ? 1 : 0;
+    putLE<uint32_t>(buf.data() + 8, static_cast<uint32_t>(width));
+    putLE<uint32_t>(buf.data() + 12, static_cast<uint32_t>(height));
+    putLE<uint64_t>(buf.data() + 16, sourceBytes);
+
+    uint8_t* dst = buf.data() + HEADER_SIZE;
+    if (out.format == DecodedPixelFormat::RGB565) {
+        for (size_t i = 0; i < pixelCount; ++i) {
+            uint8_t const* p = rgba.data() + i * 4;
+            uint16_t v = static_cast<uint16_t>(((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3));
+            putLE<uint16_t>(dst + i * 2, v);
+        }
+    } else {
+        std::memcpy(dst, rgba.data(), payload);
+    }
+    return out;
+}
+
+std::optional<DecodedThumb> parse(std::shared_ptr<void const> owner, uint8_t const* data, size_t size,
+                                  uint64_t expectedSourceBytes) {
+    if (!owner || !data || size < HEADER_SIZE) return std::nullopt;
+
+    uint8_t const* h = data;
+    if (std::memcmp(h, MAGIC, 4) != 0) return std::nullopt;
+    if (h[4] > static_cast<uint8_t>(DecodedPixelFormat::RGB565)) return std::nullopt;
+
+    DecodedThumb out;
+    out.format = static_cast<DecodedPixelFormat>(h[4]);
+    out.sourceIsGif = (h[5] & 1) != 0;
+    out.width = static_cast<int>(getLE<uint32_t>(h + 8));
+    out.height = static_cast<int>(getLE<uint32_t>(h + 12));
+    uint64_t sourceBytes = getLE<uint64_t>(h + 16);
+
+    if (out.width <= 0 || out.height <= 0 || out.width > 16384 || out.height > 16384) return std::nullopt;
+    if (expectedSourceBytes != 0 && sourceBytes != expectedSourceBytes) return std::nullopt;
+
+    size_t payload = static_cast<size_t>(out.width) * static_cast<size_t>(out.height) * bytesPerPixel(out.format);
+    if (size < HEADER_SIZE + payload) return std::nullopt;
+
+    out.pixels = h + HEADER_SIZE;
+    out.owner = std::move(owner);
+    return out;
+}
+
+} // namespace paimon::cache::decoded
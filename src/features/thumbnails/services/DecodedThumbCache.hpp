@@ -0,0 +1,66 @@
+#pragma once
+
+// DecodedThumbCache.hpp — Variante pre-decodificada de los thumbnails en disco.
+// Junto a <levelID>.png / .gif se guarda la key <archivo>.ptd en el pack
+// (ThumbPackStore) con los pixeles ya reducidos al tier activo (RGBA8888, o
+// RGB565 en el tier low si la imagen es opaca) y un header pequeño. Las cargas
+// siguientes leen la vista mapeada del pack y pasan los pixeles directo a
+// initWithData, sin leer ni decodificar el PNG.
+//
+// Layout (little-endian):
+//   0  char[4]  magic "PTD1"
+//   4  u8       pixel format (DecodedPixelFormat)
+//   5  u8       flags (bit0 = fuente GIF)
+//   6  u16      reservado
+//   8  u32      width
+//   12 u32      height
+//   16 u64      bytes del archivo fuente (detecta variantes stale)
+//   24 ...      pixeles, width*height*bpp
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace paimon::cache {
+
+enum class DecodedPixelFormat : uint8_t {
+    RGBA8888 = 0,
+    RGB565   = 1,
+};
+
+struct DecodedThumb {
+    std::shared_ptr<void const> owner; // mantiene vivos los pixeles (mapeo o buffer)
+    uint8_t const* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    DecodedPixelFormat format = DecodedPixelFormat::RGBA8888;
+    bool sourceIsGif = false;
+};
+
+namespace decoded {
+    // nombre de la variante decodificada para un archivo fuente: "123.png" -> "123.png.ptd"
+    std::string filenameFor(std::string const& sourceFilename);
+
+    struct Encoded {
+        std::vector<uint8_t> bytes; // vacio si fallo
+        DecodedPixelFormat format = DecodedPixelFormat::RGBA8888;
+    };
+
+    // serializa la variante (header + pixeles). allowRgb565 solo se aplica si
+    // todos los pixeles son opacos.
+    Encoded encode(std::vector<uint8_t> const& rgba, int width, int height,
+                   uint64_t sourceBytes, bool sourceIsGif, bool allowRgb565);
+
+    // valida una variante ya leida (owner mantiene vivos los bytes). nullopt si
+    // esta corrupta o su sourceBytes no coincide con el archivo fuente actual.
+    std::optional<DecodedThumb> parse(std::shared_ptr<void const> owner, uint8_t const* data, size_t size,
+                                      uint64_t expectedSourceBytes);
+
+    inline char const* formatTag(DecodedPixelFormat f) {
+        return f == DecodedPixelFormat::RGB565 ? "rgb565" : "rgba8888";
+    }
+} // namespace decoded
+
+} // namespace paimon::cache
@@ -1,16 +1,22 @@
 #include "DiskManifest.hpp"
+#include "ManifestJournal.hpp"
+#include "../../../utils/Debug.hpp"
 #include <Geode/loader/Log.hpp>
 #include <Geode/utils/string.hpp>
 #include <matjson.hpp>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 using namespace geode::prelude;
 
 namespace paimon::cache {
 
-static constexpr const char* MANIFEST_FILENAME = "manifest.json";
+static constexpr const char* MANIFEST_FILENAME = "manifest.bin";
+static constexpr const char* JOURNAL_FILENAME = "manifest.journal";
+static constexpr const char* LEGACY_MANIFEST_FILENAME = "manifest.json";
+static constexpr uint64_t JOURNAL_CHECKPOINT_MIN_BYTES = 256 * 1024;
 
 std::string DiskManifest::makeKey(int levelID, bool isGif) const {
     return isGif ? ("-" + std::to_string(levelID)) : std::to_string(levelID);
@@ -21,56 +27,102 @@ std::string DiskManifest::makeUrlKey(std::string const& url) const {
     return "url:" + url;
 }
 
+void DiskManifest::attachStore(ThumbPackStore* store) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    m_store = store;
+}
+
+bool DiskManifest::storedFileExists(std::string const& filename) const {
+    if (m_store && m_store->contains(filename)) return true;
+    std::error_code ec;
+    return std::filesystem::exists(m_cacheDir / filename, ec);
+}
+
+void DiskManifest::removeStoredFile(std::string const& filename) {
+    if (filename.empty()) return;
+    if (m_store && m_store->remove(filename)) return;
+    std::error_code ec;
+    std::filesystem::remove(m_cacheDir / filename, ec);
+}
+
 void DiskManifest::load(std::filesystem::path const& cacheDir) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto t0 = std::chrono::steady_clock::now();
     m_cacheDir = cacheDir;
     m_manifestPath = cacheDir / MANIFEST_FILENAME;
+    m_journalPath = cacheDir / JOURNAL_FILENAME;
     m_entries.clear();
     m_urlToKey.clear();
+    m_journalBuf.clear();
+    m_pendingTouches.clear();
+    m_generation = 0;
+    m_baseBytes = 0;
+    m_journalBytes = 0;
     m_dirty = false;
+    m_needsCheckpoint = false;
+
+    char const* source = "binary";
+    if (!loadBinary()) {
+        // sin base valida: migrar el manifest.json viejo o reconstruir desde
+        // la carpeta/pack. en ambos casos el proximo flush escribe la base
+        std::error_code ec;
+        auto legacyPath = cacheDir / LEGACY_MANIFEST_FILENAME;
+        if (std::filesystem::exists(legacyPath, ec) && loadLegacyJson(legacyPath)) {
+            source = "json";
+        } else {
+            m_entries.clear();
+            scanDirectory();
+            source = "scan";
+        }
+        m_needsCheckpoint = true;
+        m_dirty = true;
+    }
 
-    std::error_code ec;
-    if (!std::filesystem::exists(m_manifestPath, ec)) {
-        // no hay manifest previo — escanear la carpeta para crear uno inicial
-        // esto permite migracion desde la version sin manifest
-        if (!std::filesystem::exists(cacheDir, ec)) return;
-
-        for (auto const& entry : std::filesystem::directory_iterator(cacheDir, ec)) {
-            if (ec || !entry.is_regular_file()) continue;
-            auto ext = geode::utils::string::toLower(
-                geode::utils::string::pathToString(entry.path().extension()));
-            if (ext != ".png" && ext != ".gif") continue;
-
-            auto stem = geode::utils::string::pathToString(entry.path().stem());
-            int id = geode::utils::numFromString<int>(stem).unwrapOr(0);
-            if (id <= 0) continue;
+    validateEntries();
 
-            bool isGif = (ext == ".gif");
-            size_t bytes = static_cast<size_t>(entry.file_size(ec));
-            if (ec) { ec.clear(); bytes = 0; }
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    log::info("[DiskManifest] loaded {} entries from {} in {:.2f} ms", m_entries.size(), source, ms);
+}
 
-            DiskManifestEntry me;
-            me.filename = geode::utils::string::pathToString(entry.path().filename());
-            me.levelID = id;
-            me.format = isGif ? "gif" : "png";
-            me.byteSize = bytes;
-            me.isGif = isGif;
-            me.touchAccess();
-            me.touchValidated();
+bool DiskManifest::loadBinary() {
+    std::error_code ec;
+    if (!std::filesystem::exists(m_manifestPath, ec)) return false;
 
-            m_entries[makeKey(id, isGif)] = std::move(me);
+    auto base = journal::readBase(m_manifestPath, m_entries);
+    if (!base.ok) {
+        log::warn("[DiskManifest] manifest.bin unreadable, rebuilding");
+        m_entries.clear();
+        return false;
+    }
+    m_generation = base.generation;
+    m_baseBytes = base.bytes;
+
+    auto rep = journal::replay(m_journalPath, m_generation, m_entries);
+    if (rep.ok) {
+        // cola rota (crash a mitad de un append): se corta en el ultimo registro valido
+        if (rep.validBytes < rep.fileBytes) {
+            log::warn("[DiskManifest] journal truncated at {} of {} bytes", rep.validBytes, rep.fileBytes);
+            std::filesystem::resize_file(m_journalPath, rep.validBytes, ec);
         }
-
-        m_dirty = true;
-        log::info("[DiskManifest] migrated {} entries from directory scan", m_entries.size());
-        return;
+        m_journalBytes = rep.validBytes;
+        PaimonDebug::log("[DiskManifest] journal replay: {} ops", rep.records);
+    } else {
+        // sin journal o de una generacion vieja: sus ops ya estan en la base
+        if (!journal::reset(m_journalPath, m_generation)) {
+            // anexar a un journal de otra generacion no vale: primero checkpoint
+            log::warn("[DiskManifest] could not reset manifest journal");
+            m_needsCheckpoint = true;
+        }
+        m_journalBytes = journal::HEADER_BYTES;
     }
+    return true;
+}
 
-    // leer y parsear manifest existente
-    std::ifstream file(m_manifestPath, std::ios::in);
+bool DiskManifest::loadLegacyJson(std::filesystem::path const& path) {
+    std::ifstream file(path, std::ios::in);
     if (!file.is_open()) {
-        log::warn("[DiskManifest] could not open manifest for reading");
-        return;
+        log::warn("[DiskManifest] could not open legacy manifest for reading");
+        return false;
     }
 
     std::stringstream ss;
@@ -79,21 +131,16 @@ void DiskManifest::load(std::filesystem::path const& cacheDir) {
 
     auto parseResult = matjson::parse(ss.str());
     if (!parseResult.isOk()) {
-        log::warn("[DiskManifest] manifest parse error, rebuilding");
-        m_dirty = true;
-        return;
+        log::warn("[DiskManifest] legacy manifest parse error, rebuilding");
+        return false;
     }
     auto& root = parseResult.unwrap();
 
     if (!root.isObject()) {
-        log::warn("[DiskManifest] manifest root is not object, rebuilding");
-        m_dirty = true;
-        return;
+        log::warn("[DiskManifest] legacy manifest root is not object, rebuilding");
+        return false;
     }
 
-    int loaded = 0;
-    int orphans = 0;
-
     for (auto& [key, val] : root) {
         if (!val.isObject()) continue;
 
@@ -110,68 +157,181 @@ void DiskManifest::load(std::filesystem::path const& cacheDir) {
         me.lastValidatedEpoch = val["lastValidated"].asInt().unwrapOr(0);
         me.isGif = val["isGif"].asBool().unwrapOr(false);
         me.qualityTag = val["qualityTag"].asString().unwrapOr("");
+        me.decodedFilename = val["decodedFilename"].asString().unwrapOr("");
+        me.decodedFormat = val["decodedFormat"].asString().unwrapOr("");
+        me.decodedByteSize = static_cast<size_t>(val["decodedBytes"].asInt().unwrapOr(0));
 
-        // validar que el archivo existe en disco
-        if (!me.filename.empty()) {
-            auto filePath = cacheDir / me.filename;
-            if (!std::filesystem::exists(filePath, ec)) {
-                orphans++;
-                m_dirty = true;
-                continue; // no lo cargamos al indice
-            }
+        m_entries[key] = std::move(me);
+    }
+    return true;
+}
+
+void DiskManifest::scanDirectory() {
+    // no hay manifest previo — escanear la carpeta para crear uno inicial
+    // esto permite migracion desde la version sin manifest
+    std::error_code ec;
+    if (!std::filesystem::exists(m_cacheDir, ec)) return;
+
+    for (auto const& entry : std::filesystem::directory_iterator(m_cacheDir, ec)) {
+        if (ec || !entry.is_regular_file()) continue;
+        auto ext = geode::utils::string::toLower(
+            geode::utils::string::pathToString(entry.path().extension()));
+        if (ext != ".png" && ext != ".gif") continue;
+
+        auto stem = geode::utils::string::pathToString(entry.path().stem());
+        int id = geode::utils::numFromString<int>(stem).unwrapOr(0);
+        if (id <= 0) continue;
+
+        bool isGif = (ext == ".gif");
+        size_t bytes = static_cast<size_t>(entry.file_size(ec));
+        if (ec) { ec.clear(); bytes = 0; }
+
+        DiskManifestEntry me;
+        me.filename = geode::utils::string::pathToString(entry.path().filename());
+        me.levelID = id;
+        me.format = isGif ? "gif" : "png";
+        me.byteSize = bytes;
+        me.isGif = isGif;
+        me.touchAccess();
+        me.touchValidated();
+
+        m_entries[makeKey(id, isGif)] = std::move(me);
+    }
+
+    // fuentes estaticas que ya viven en el pack; las variantes .ptd sin
+    // manifest no se pueden asociar y las descarta validateEntries
+    if (m_store) {
+        for (auto const& key : m_store->keys()) {
+            if (!key.ends_with(".png")) continue;
+            int id = geode::utils::numFromString<int>(key.substr(0, key.size() - 4)).unwrapOr(0);
+            if (id <= 0) continue;
+
+            DiskManifestEntry me;
+            me.filename = key;
+            me.levelID = id;
+            me.format = "png";
+            me.byteSize = m_store->sizeOf(key);
+            me.isGif = false;
+            me.touchAccess();
+            me.touchValidated();
+
+            m_entries[makeKey(id, false)] = std::move(me);
         }
+    }
 
-        // registrar en indices
-        m_entries[key] = std::move(me);
-        if (!m_entries[key].sourceUrl.empty()) {
-            m_urlToKey[m_entries[key].sourceUrl] = key;
+    log::info("[DiskManifest] migrated {} entries from directory scan", m_entries.size());
+}
+
+void DiskManifest::validateEntries() {
+    size_t orphans = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        auto& me = it->second;
+        // validar que el archivo existe (indice del pack o archivo suelto)
+        if (!me.filename.empty() && !storedFileExists(me.filename)) {
+            orphans++;
+            it = m_entries.erase(it);
+            continue;
         }
-        loaded++;
+        if (!me.decodedFilename.empty() && !storedFileExists(me.decodedFilename)) {
+            // la variante decodificada se regenera en la proxima carga
+            me.decodedFilename.clear();
+            me.decodedFormat.clear();
+            me.decodedByteSize = 0;
+            m_needsCheckpoint = true;
+        }
+        if (!me.sourceUrl.empty()) {
+            m_urlToKey[me.sourceUrl] = it->first;
+        }
+        ++it;
     }
 
-    if (orphans > 0) {
-        log::info("[DiskManifest] loaded {} entries, {} orphans removed", loaded, orphans);
-    } else {
-        log::info("[DiskManifest] loaded {} entries", loaded);
+    // keys del pack que el manifest no conoce (crash entre el append y el
+    // flush): no se pueden servir, se marcan muertas para la compactacion
+    size_t unreferenced = 0;
+    if (m_store) {
+        std::unordered_set<std::string> referenced;
+        referenced.reserve(m_entries.size() * 2);
+        for (auto const& [_, me] : m_entries) {
+            if (!me.filename.empty()) referenced.insert(me.filename);
+            if (!me.decodedFilename.empty()) referenced.insert(me.decodedFilename);
+        }
+        for (auto const& key : m_store->keys()) {
+            if (!referenced.count(key) && m_store->remove(key)) unreferenced++;
+        }
     }
+
+    if (orphans > 0 || unreferenced > 0) {
+        m_needsCheckpoint = true;
+        log::info("[DiskManifest] {} orphans removed, {} unreferenced pack keys dropped",
+            orphans, unreferenced);
+    }
+    if (m_needsCheckpoint) m_dirty = true;
 }
 
 void DiskManifest::flush() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    if (!m_dirty) return;
-
-    matjson::Value root = matjson::makeObject({});
+    if (m_manifestPath.empty()) return; // todavia no se cargo
+    if (!m_dirty && m_pendingTouches.empty()) return;
 
-    for (auto const& [key, me] : m_entries) {
-        matjson::Value entry = matjson::makeObject({});
-        entry["filename"] = me.filename;
-        entry["levelID"] = me.levelID;
-        entry["sourceUrl"] = me.sourceUrl;
-        entry["revisionToken"] = me.revisionToken;
-        entry["format"] = me.format;
-        entry["width"] = me.width;
-        entry["height"] = me.height;
-        entry["byteSize"] = static_cast<int64_t>(me.byteSize);
-        entry["lastAccess"] = me.lastAccessEpoch;
-        entry["lastValidated"] = me.lastValidatedEpoch;
-        entry["isGif"] = me.isGif;
-        entry["qualityTag"] = me.qualityTag;
-        root[key] = entry;
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto const& [key, epoch] : m_pendingTouches) {
+        if (m_entries.count(key)) journal::encodeTouch(m_journalBuf, key, epoch);
     }
+    m_pendingTouches.clear();
 
     std::error_code ec;
     std::filesystem::create_directories(m_cacheDir, ec);
 
-    std::ofstream file(m_manifestPath, std::ios::out | std::ios::trunc);
-    if (!file.is_open()) {
-        log::error("[DiskManifest] could not open manifest for writing");
-        return;
+    // checkpoint cuando el journal pesa mas que media base: el replay queda
+    // acotado y la base no se reescribe en cada flush
+    uint64_t threshold = std::max<uint64_t>(JOURNAL_CHECKPOINT_MIN_BYTES, m_baseBytes / 2);
+    size_t ops = m_journalBuf.size();
+    bool checkpointed = false;
+    if (m_needsCheckpoint || m_journalBytes + m_journalBuf.size() > threshold) {
+        checkpointed = checkpoint();
+    }
+    if (!checkpointed) {
+        if (!journal::append(m_journalPath, m_journalBuf)) {
+            // las ops quedan en el buffer para el proximo intento
+            log::error("[DiskManifest] could not append to manifest journal");
+            return;
+        }
+        m_journalBytes += m_journalBuf.size();
+        m_journalBuf.clear();
+        m_dirty = false;
     }
 
-    file << root.dump(matjson::NO_INDENTATION);
-    file.close();
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    log::debug("[DiskManifest] flushed {} entries ({}, {} journal bytes) in {:.2f} ms",
+        m_entries.size(), checkpointed ? "checkpoint" : "append", ops, ms);
+}
+
+bool DiskManifest::checkpoint() {
+    uint32_t next = m_generation + 1;
+    auto bytes = journal::writeBase(m_manifestPath, next, m_entries);
+    if (bytes == 0) {
+        // la base y el journal anteriores siguen intactos; las ops van al journal
+        log::error("[DiskManifest] could not write manifest checkpoint");
+        return false;
+    }
+    m_generation = next;
+    m_baseBytes = bytes;
+    m_journalBytes = journal::HEADER_BYTES;
+    m_journalBuf.clear();
     m_dirty = false;
-    log::debug("[DiskManifest] flushed {} entries", m_entries.size());
+    m_needsCheckpoint = false;
+    if (!journal::reset(m_journalPath, m_generation)) {
+        // el journal sigue con la generacion vieja y se ignora al cargar: lo
+        // que se le anexe se perderia. hasta que un reset salga bien, cada
+        // flush reescribe la base entera en vez de anexar
+        log::warn("[DiskManifest] could not reset manifest journal, next flush rewrites the base");
+        m_needsCheckpoint = true;
+        m_dirty = true;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(m_cacheDir / LEGACY_MANIFEST_FILENAME, ec);
+    return true;
 }
 
 // ── Consultas ───────────────────────────────────────────────────
@@ -229,6 +389,8 @@ void DiskManifest::upsert(int levelID, bool isGif, DiskManifestEntry entry) {
     if (!entry.sourceUrl.empty()) {
         m_urlToKey[entry.sourceUrl] = key;
     }
+    journal::encodeUpsert(m_journalBuf, key, entry);
+    m_pendingTouches.erase(key);
     m_entries[key] = std::move(entry);
     m_dirty = true;
 }
@@ -237,6 +399,8 @@ void DiskManifest::upsertUrl(std::string const& url, DiskManifestEntry entry) {
     auto key = makeUrlKey(url);
     entry.sourceUrl = url;
     m_urlToKey[url] = key;
+    journal::encodeUpsert(m_journalBuf, key, entry);
+    m_pendingTouches.erase(key);
     m_entries[key] = std::move(entry);
     m_dirty = true;
 }
@@ -249,6 +413,8 @@ void DiskManifest::remove(int levelID, bool isGif) {
             m_urlToKey.erase(it->second.sourceUrl);
         }
         m_entries.erase(it);
+        m_pendingTouches.erase(key);
+        journal::encodeRemove(m_journalBuf, key);
         m_dirty = true;
     }
 }
@@ -257,14 +423,40 @@ void DiskManifest::removeUrl(std::string const& url) {
     auto keyIt = m_urlToKey.find(url);
     if (keyIt != m_urlToKey.end()) {
         m_entries.erase(keyIt->second);
+        m_pendingTouches.erase(keyIt->second);
+        journal::encodeRemove(m_journalBuf, keyIt->second);
         m_urlToKey.erase(keyIt);
         m_dirty = true;
     }
 }
 
+void DiskManifest::setDecodedVariant(int levelID, bool isGif, std::string filename, std::string format, size_t bytes) {
+    auto it = m_entries.find(makeKey(levelID, isGif));
+    if (it == m_entries.end()) return;
+    it->second.decodedFilename = std::move(filename);
+    it->second.decodedFormat = std::move(format);
+    it->second.decodedByteSize = it->second.decodedFilename.empty() ? 0 : bytes;
+    journal::encodeUpsert(m_journalBuf, it->first, it->second);
+    m_dirty = true;
+}
+
+void DiskManifest::setDimensions(int levelID, bool isGif, int width, int height) {
+    auto it = m_entries.find(makeKey(levelID, isGif));
+    if (it == m_entries.end()) return;
+    if (it->second.width == width && it->second.height == height) return;
+    it->second.width = width;
+    it->second.height = height;
+    journal::encodeUpsert(m_journalBuf, it->first, it->second);
+    m_dirty = true;
+}
+
 void DiskManifest::clear() {
     m_entries.clear();
     m_urlToKey.clear();
+    m_pendingTouches.clear();
+    // lo anterior del buffer ya no importa
+    m_journalBuf.clear();
+    journal::encodeClear(m_journalBuf);
     m_dirty = true;
 }
 
@@ -272,7 +464,8 @@ void DiskManifest::touchAccess(int levelID, bool isGif) {
     auto it = m_entries.find(makeKey(levelID, isGif));
     if (it != m_entries.end()) {
         it->second.touchAccess();
-        // no marcamos dirty para no forzar flush solo por access
+        // no marcamos dirty: el touch viaja con el proximo flush
+        m_pendingTouches[it->first] = it->second.lastAccessEpoch;
     }
 }
 
@@ -282,6 +475,7 @@ void DiskManifest::touchAccessUrl(std::string const& url) {
     auto it = m_entries.find(keyIt->second);
     if (it != m_entries.end()) {
         it->second.touchAccess();
+        m_pendingTouches[it->first] = it->second.lastAccessEpoch;
     }
 }
 
@@ -313,12 +507,13 @@ DiskManifest::PruneResult DiskManifest::computePrune(size_t maxBytes, std::chron
         if (realID >= 1 && realID <= 22) continue;
 
         int64_t age = nowEpoch - me.lastAccessEpoch;
+        size_t bytes = me.diskBytes();
         if (age > maxAgeSeconds) {
             result.filesToDelete.push_back(me.filename);
-            result.freedBytes += me.byteSize;
-            currentTotal = (currentTotal >= me.byteSize) ? (currentTotal - me.byteSize) : 0;
+            result.freedBytes += bytes;
+            currentTotal = (currentTotal >= bytes) ? (currentTotal - bytes) : 0;
         } else {
-            candidates.push_back({key, me.filename, me.byteSize, me.lastAccessEpoch, me.levelID});
+            candidates.push_back({key, me.filename, bytes, me.lastAccessEpoch, me.levelID});
         }
     }
 
@@ -360,11 +555,13 @@ void DiskManifest::applyPrune(PruneResult const& result) {
             if (!entryIt->second.sourceUrl.empty()) {
                 m_urlToKey.erase(entryIt->second.sourceUrl);
             }
-            // borrar archivo fisico
-            auto filePath = m_cacheDir / filename;
-            std::error_code ec;
-            std::filesystem::remove(filePath, ec);
+            // fuente y variante decodificada: en el pack es solo un tombstone
+            // en el indice; el espacio lo recupera la compactacion
+            removeStoredFile(filename);
+            removeStoredFile(entryIt->second.decodedFilename);
 
+            m_pendingTouches.erase(entryIt->first);
+            journal::encodeRemove(m_journalBuf, entryIt->first);
             m_entries.erase(entryIt);
             m_dirty = true;
         }
@@ -381,7 +578,7 @@ size_t DiskManifest::totalBytes() const {
 size_t DiskManifest::totalBytesLocked() const {
     size_t total = 0;
     for (auto const& [_, me] : m_entries) {
-        total += me.byteSize;
+        total += me.diskBytes();
     }
     return total;
 }
@@ -391,6 +588,15 @@ size_t DiskManifest::entryCount() const {
     return m_entries.size();
 }
 
+std::vector<DiskManifestEntry> DiskManifest::levelEntries(bool isGif) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<DiskManifestEntry> out;
+    for (auto const& [key, me] : m_entries) {
+        if (me.levelID > 0 && me.isGif == isGif) out.push_back(me);
+    }
+    return out;
+}
+
 // ── Legacy compat ───────────────────────────────────────────
 
 std::unordered_set<int> DiskManifest::legacyKeySet() const {
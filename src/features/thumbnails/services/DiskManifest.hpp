@@ -2,15 +2,19 @@
 
 // DiskManifest.hpp — Indice persistente del cache de disco.
 // Reemplaza el antiguo unordered_set<int> m_diskCache por un indice con
-// metadata completa (revision, bytes, lastAccess, etc.) que se serializa
-// a JSON y se hidrata al arrancar.
+// metadata completa (revision, bytes, lastAccess, etc.). Se persiste como
+// snapshot binario + journal append-only (ver ManifestJournal.hpp): cada
+// mutacion encola una op y flush() solo agrega esas ops al journal; la base
+// se reescribe en checkpoints cuando el journal crece demasiado.
 
 #include "CacheModels.hpp"
+#include "ThumbPackStore.hpp"
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace paimon::cache {
 
@@ -19,9 +23,13 @@ public:
     // carga el manifest desde disco; valida archivos faltantes/corruptos
     void load(std::filesystem::path const& cacheDir);
 
-    // persiste el manifest a disco (deferred: solo si dirty)
+    // persiste las ops pendientes al journal (o hace checkpoint). no-op si no hay nada
     void flush();
 
+    // pack donde viven las fuentes estaticas y las variantes .ptd. sin pack
+    // (o para keys que no estan en el) se usa el archivo suelto en cacheDir
+    void attachStore(ThumbPackStore* store);
+
     // ── Consultas (thread-safe: toman mutex internamente) ────────
 
     bool contains(int levelID, bool isGif) const;
@@ -44,9 +52,12 @@ public:
     void upsertUrl(std::string const& url, DiskManifestEntry entry);
     void remove(int levelID, bool isGif);
     void removeUrl(std::string const& url);
+    // registra (o limpia, con filename vacio) la variante pre-decodificada
+    void setDecodedVariant(int levelID, bool isGif, std::string filename, std::string format, size_t bytes);
+    void setDimensions(int levelID, bool isGif, int width, int height);
     void clear();
 
-    // touch lastAccess sin marcar dirty para flush completo
+    // touch lastAccess: se coalescen por key y se escriben en el proximo flush
     void touchAccess(int levelID, bool isGif);
     void touchAccessUrl(std::string const& url);
 
@@ -65,6 +76,8 @@ public:
     size_t totalBytes() const;
     size_t totalBytesLocked() const; // caller DEBE tener mutex
     size_t entryCount() const;
+    // copia de las entradas de niveles (sin gallery) de un tipo
+    std::vector<DiskManifestEntry> levelEntries(bool isGif) const;
 
     // ── Legacy compat ───────────────────────────────────────────
 
@@ -79,8 +92,26 @@ private:
     std::unordered_map<std::string, std::string> m_urlToKey; // url -> manifest key
     std::filesystem::path m_cacheDir;
     std::filesystem::path m_manifestPath;
+    std::filesystem::path m_journalPath;
     bool m_dirty = false;
-
+    ThumbPackStore* m_store = nullptr;
+
+    // ── Persistencia ────────────────────────────────────────────
+    std::vector<uint8_t> m_journalBuf;                         // ops aun no escritas
+    std::unordered_map<std::string, int64_t> m_pendingTouches; // key -> lastAccess
+    uint32_t m_generation = 0;
+    uint64_t m_baseBytes = 0;
+    uint64_t m_journalBytes = 0;
+    bool m_needsCheckpoint = false; // base ausente/migrada o validacion cambio entradas
+
+    bool loadBinary();
+    bool loadLegacyJson(std::filesystem::path const& path);
+    void scanDirectory();
+    void validateEntries();
+    bool checkpoint();
+
+    bool storedFileExists(std::string const& filename) const;
+    void removeStoredFile(std::string const& filename);
     std::string makeKey(int levelID, bool isGif) const;
     std::string makeUrlKey(std::string const& url) const;
 };
@@ -1,12 +1,16 @@
 #include "LevelColors.hpp"
 #include "../../../utils/PaimonFormat.hpp"
 #include "../../../utils/DominantColors.hpp"
-#include "../../../core/QualityConfig.hpp"
+#include "ThumbnailLoader.hpp"
+#include "../../../utils/MainThreadDelay.hpp"
 #include <Geode/loader/Mod.hpp>
 #include <Geode/loader/Log.hpp>
 #include <cocos2d.h>
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <filesystem>
+#include <thread>
 
 using namespace geode::prelude;
 using namespace cocos2d;
@@ -104,144 +108,305 @@ void LevelColors::flushIfDirty() {
     }
 }
 
-void LevelColors::extractFromImage(int32_t levelID, cocos2d::CCImage* image) {
-    if (!image) return;
-    log::debug("[LevelColors] extractFromImage: levelID={}", levelID);
-
-    unsigned char* imgData = image->getData();
-    int w = image->getWidth();
-    int h = image->getHeight();
-    bool hasAlpha = image->hasAlpha();
-    
-    if (!imgData || w <= 0 || h <= 0) return;
-    
-    // convertir rgba->rgb24 si necesario.
+namespace {
+// rgba -> rgb24 si hace falta y DominantColors
+LevelColorPair pairFromPixels(const uint8_t* imgData, int w, int h, bool hasAlpha) {
     std::vector<uint8_t> rgb24;
-    const uint8_t* rgbPtr = nullptr;
+    const uint8_t* rgbPtr = imgData;
     
     if (hasAlpha) {
-        rgb24.resize(w * h * 3);
-        for (int i = 0; i < w * h; i++) {
+        rgb24.resize(static_cast<size_t>(w) * h * 3);
+        for (size_t i = 0; i < static_cast<size_t>(w) * h; i++) {
             rgb24[i * 3 + 0] = imgData[i * 4 + 0];
             rgb24[i * 3 + 1] = imgData[i * 4 + 1];
             rgb24[i * 3 + 2] = imgData[i * 4 + 2];
         }
         rgbPtr = rgb24.data();
-    } else {
-        rgbPtr = imgData;
     }
     
     auto pair = DominantColors::extract(rgbPtr, w, h);
-    cocos2d::ccColor3B colorA{pair.first.r, pair.first.g, pair.first.b};
-    cocos2d::ccColor3B colorB{pair.second.r, pair.second.g, pair.second.b};
+    return LevelColorPair{
+        ccColor3B{pair.first.r, pair.first.g, pair.first.b},
+        ccColor3B{pair.second.r, pair.second.g, pair.second.b}
+    };
+}
 
-    this->set(levelID, colorA, colorB);
+// decodifica una miniatura cacheada; nullopt si los bytes no son una imagen
+std::optional<LevelColorPair> pairFromImageBytes(std::vector<uint8_t>& data) {
+    auto image = new cocos2d::CCImage();
+    if (!image->initWithImageData(data.data(), data.size())) {
+        image->release();
+        return std::nullopt;
+    }
+    std::optional<LevelColorPair> pair;
+    if (image->getData() && image->getWidth() > 0 && image->getHeight() > 0) {
+        pair = pairFromPixels(image->getData(), image->getWidth(), image->getHeight(), image->hasAlpha());
+    }
+    image->release();
+    return pair;
+}
+
+// el checkpoint compara revisiones, no bytes: si se re-sube la miniatura
+// cambia el token y se vuelve a extraer
+uint64_t revisionHash(paimon::cache::DiskManifestEntry const& entry) {
+    std::string key = entry.revisionToken.empty()
+        ? fmt::format("{}|{}", entry.filename, entry.byteSize)
+        : entry.revisionToken;
+    return PaimonFormat::calculateHash(std::vector<uint8_t>(key.begin(), key.end()));
+}
+} // namespace
+
+void LevelColors::extractFromImage(int32_t levelID, cocos2d::CCImage* image) {
+    if (!image) return;
+    log::debug("[LevelColors] extractFromImage: levelID={}", levelID);
+
+    unsigned char* imgData = image->getData();
+    int w = image->getWidth();
+    int h = image->getHeight();
+    
+    if (!imgData || w <= 0 || h <= 0) return;
+    
+    auto pair = pairFromPixels(imgData, w, h, image->hasAlpha());
+    this->set(levelID, pair.a, pair.b);
 }
 
 void LevelColors::extractFromRawData(int32_t levelID, const uint8_t* imgData, int w, int h, bool hasAlpha) {
     if (!imgData || w <= 0 || h <= 0) return;
     log::debug("[LevelColors] extractFromRawData: levelID={} {}x{} alpha={}", levelID, w, h, hasAlpha);
     
-    // convertir rgba->rgb24 si necesario.
-    std::vector<uint8_t> rgb24;
-    const uint8_t* rgbPtr = nullptr;
-    
-    if (hasAlpha) {
-        rgb24.resize(w * h * 3);
-        for (int i = 0; i < w * h; i++) {
-            rgb24[i * 3 + 0] = imgData[i * 4 + 0];
-            rgb24[i * 3 + 1] = imgData[i * 4 + 1];
-            rgb24[i * 3 + 2] = imgData[i * 4 + 2];
-        }
-        rgbPtr = rgb24.data();
-    } else {
-        rgbPtr = imgData;
-    }
-    
-    auto pair2 = DominantColors::extract(rgbPtr, w, h);
-    cocos2d::ccColor3B colorA2{pair2.first.r, pair2.first.g, pair2.first.b};
-    cocos2d::ccColor3B colorB2{pair2.second.r, pair2.second.g, pair2.second.b};
+    auto pair = pairFromPixels(imgData, w, h, hasAlpha);
+    this->set(levelID, pair.a, pair.b);
+}
 
-    this->set(levelID, colorA2, colorB2);
+void LevelColors::store(int32_t levelID, LevelColorPair pair) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    load();
+    m_items[levelID] = pair;
+    m_dirty = true;
 }
 
-// procesar imagen cacheada.
-void processCachedImage(std::filesystem::path const& filepath, int32_t levelID) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        log::warn("[LevelColors] fallo al abrir: {}", geode::utils::string::pathToString(filepath));
-        return;
-    }
-    
-    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-    
+// ── extraccion en segundo plano ─────────────────────────────────────
+
+std::filesystem::path LevelColors::checkpointPath() const {
+    return Mod::get()->getSaveDir() / "thumbnails" / "level_colors_scan.paimon";
+}
+
+unsigned LevelColors::maxParallelExtractions() {
+    // el resto de hilos de Decode quedan libres pa las miniaturas visibles
+    unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+    return std::clamp<unsigned>(hc / 4, 1, 2);
+#else
+    return std::clamp<unsigned>(hc / 2, 1, 4);
+#endif
+}
+
+void LevelColors::loadCheckpoint() {
+    if (m_checkpointLoaded) return;
+    m_checkpointLoaded = true;
+
+    auto data = PaimonFormat::load(checkpointPath());
     if (data.empty()) return;
-    
-    auto image = new cocos2d::CCImage();
-    if (!image->initWithImageData(const_cast<uint8_t*>(data.data()), data.size())) {
-        log::warn("[LevelColors] fallo al decodificar imagen: {}", geode::utils::string::pathToString(filepath));
-        image->release();
-        return;
+
+    // una linea por nivel: id,revision(hex),fallo
+    std::string content(data.begin(), data.end());
+    std::stringstream ss(content);
+    std::string line;
+    while (std::getline(ss, line)) {
+        std::stringstream ls(line);
+        std::string id, revision, failed;
+        if (!std::getline(ls, id, ',') || !std::getline(ls, revision, ',') || !std::getline(ls, failed, ',')) continue;
+        auto levelID = geode::utils::numFromString<int32_t>(id);
+        if (!levelID.isOk()) continue;
+        ScanMark mark;
+        mark.revision = std::strtoull(revision.c_str(), nullptr, 16);
+        mark.failed = failed == "1";
+        m_scanMarks[levelID.unwrap()] = mark;
     }
-    
-    LevelColors::get().extractFromImage(levelID, image);
+    log::debug("[LevelColors] checkpoint: {} niveles", m_scanMarks.size());
+}
 
-    image->release();
+void LevelColors::saveCheckpoint() {
+    std::lock_guard<std::mutex> writer(m_checkpointMutex);
+    // primero los colores: el checkpoint nunca marca algo que no este en disco
+    flushIfDirty();
+
+    std::string content;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        content.reserve(m_scanMarks.size() * 32);
+        for (auto const& [levelID, mark] : m_scanMarks) {
+            content += fmt::format("{},{:x},{}\n", levelID, mark.revision, mark.failed ? 1 : 0);
+        }
+    }
+    PaimonFormat::save(checkpointPath(), std::vector<uint8_t>(content.begin(), content.end()));
 }
 
 void LevelColors::extractColorsFromCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        if (m_scanRunning) return;
+        m_scanRunning = true;
+        m_scanDone = m_scanFailed = m_scanSkipped = 0;
+        m_scanStart = std::chrono::steady_clock::now();
+    }
     log::info("[LevelColors] extrayendo colores de cache...");
+    beginExtraction();
+}
 
-    std::error_code ecCache;
-    int processed = 0;
-    int success = 0;
-    int skipped = 0;
-
-    auto scanDir = [&](std::filesystem::path const& cacheDir) {
-        std::error_code existsEc;
-        if (!std::filesystem::exists(cacheDir, existsEc) || existsEc) return;
-
-        for (auto const& entry : std::filesystem::directory_iterator(cacheDir, ecCache)) {
-            if (ecCache || !entry.is_regular_file()) continue;
+void LevelColors::beginExtraction() {
+    auto& loader = ThumbnailLoader::get();
+    // los candidatos salen del manifest: hasta que initDiskCache lo cargue, esperar
+    if (!loader.isDiskIndexReady()) {
+        paimon::scheduleMainThreadDelay(1.f, [this]() { beginExtraction(); });
+        return;
+    }
+    if (!loader.submitIdle([this]() { planExtraction(); })) {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        m_scanRunning = false;
+    }
+}
 
-            auto filepath = entry.path();
-            auto ext = geode::utils::string::toLower(geode::utils::string::pathToString(filepath.extension()));
-            if (!(ext == ".png" || ext == ".webp" || ext == ".jpg" || ext == ".jpeg")) continue;
+void LevelColors::planExtraction() {
+    auto entries = ThumbnailLoader::get().diskManifest().levelEntries(false);
+    // lo ultimo que se vio primero: son las celdas que mas pronto se van a pintar
+    std::sort(entries.begin(), entries.end(), [](auto const& a, auto const& b) {
+        return a.lastAccessEpoch > b.lastAccessEpoch;
+    });
 
-            std::string filename = geode::utils::string::pathToString(filepath.stem());
-            auto levelIDResult = geode::utils::numFromString<int32_t>(filename);
-            if (!levelIDResult.isOk()) {
-                log::debug("[LevelColors] saltando archivo no-numerico: {}", filename);
+    size_t adopted = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        loadCheckpoint();
+        m_scanQueue.clear();
+        for (auto const& entry : entries) {
+            uint64_t revision = revisionHash(entry);
+            auto it = m_scanMarks.find(entry.levelID);
+            std::optional<ScanMark> mark;
+            if (it != m_scanMarks.end()) mark = it->second;
+            auto action = paimon::colors::planScan(mark, revision, getPair(entry.levelID).has_value());
+            if (action == ScanAction::Skip) {
+                m_scanSkipped++;
                 continue;
             }
-            int32_t levelID = levelIDResult.unwrap();
-
-            if (getPair(levelID).has_value()) {
-                skipped++;
+            // colores de antes del checkpoint (o de una carga normal): se adoptan
+            if (action == ScanAction::Adopt) {
+                m_scanMarks[entry.levelID] = ScanMark{revision, false};
+                m_scanSkipped++;
+                adopted++;
                 continue;
             }
+            m_scanQueue.push_back(ScanItem{entry.levelID, revision, action});
+        }
+        log::info("[LevelColors] {} miniaturas en el manifest: {} por extraer, {} ya hechas",
+            entries.size(), m_scanQueue.size(), m_scanSkipped);
+    }
+    if (adopted) saveCheckpoint();
+    pumpExtraction();
+}
 
-            processed++;
-            processCachedImage(filepath, levelID);
-            if (getPair(levelID).has_value()) {
-                success++;
-            }
+void LevelColors::pumpExtraction() {
+    std::vector<ScanItem> start;
+    bool finished = false;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        if (!m_scanRunning) return;
+        while (m_scanInFlight < maxParallelExtractions() && !m_scanQueue.empty()) {
+            start.push_back(m_scanQueue.front());
+            m_scanQueue.pop_front();
+            m_scanInFlight++;
+        }
+        if (m_scanInFlight == 0 && m_scanQueue.empty()) {
+            m_scanRunning = false;
+            finished = true;
+        }
+    }
 
-            if (success % 10 == 0 && success > 0) {
-                log::info("[LevelColors] progreso: {} ok, {} saltado", success, skipped);
+    bool interrupted = false;
+    for (auto item : start) {
+        bool queued = ThumbnailLoader::get().submitIdle([this, item]() {
+            extractOne(item);
+        });
+        if (!queued) {
+            // pool apagandose (cleanup): se para aqui y el checkpoint sigue la proxima vez
+            std::lock_guard<std::mutex> lock(m_scanMutex);
+            m_scanInFlight--;
+            m_scanQueue.clear();
+            if (m_scanRunning) {
+                m_scanRunning = false;
+                interrupted = true;
+                log::info("[LevelColors] extraccion interrumpida, {} hechas", m_scanDone);
             }
         }
-    };
+    }
 
-    // coherencia: escanear ambos orígenes de thumbnails
-    scanDir(Mod::get()->getSaveDir() / "thumbnails");
-    scanDir(paimon::quality::cacheDir());
-    
-    log::info("[LevelColors] listo: {} ok, {} saltado, {} procesado", 
-              success, skipped, processed);
-    
-    // fuerzo escritura si quedaron cambios pendientes del batch
-    flushIfDirty();
+    if (interrupted) saveCheckpoint();
+    if (finished) {
+        saveCheckpoint();
+        {
+            std::lock_guard<std::mutex> lock(m_scanMutex);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_scanStart).count();
+            log::info("[LevelColors] listo: {} ok, {} fallidas, {} saltadas en {:.1f}s",
+                m_scanDone, m_scanFailed, m_scanSkipped, secs);
+        }
+    }
+}
+
+void LevelColors::extractOne(ScanItem item) {
+    auto [levelID, revision, action] = item;
+    // si mientras tanto se guardo por otro camino (carga normal), no repetir.
+    // con Recompute el par que haya es de la miniatura vieja y no vale
+    if (paimon::colors::reuseStoredPair(action, getPair(levelID).has_value())) {
+        finishOne(levelID, revision, true, true);
+        return;
+    }
+
+    auto data = ThumbnailLoader::get().readCachedSource(levelID, false);
+    if (data.empty()) {
+        // ya no esta en cache (poda); no se marca
+        finishOne(levelID, revision, false, false);
+        return;
+    }
+
+    auto pair = pairFromImageBytes(data);
+    if (pair) {
+        store(levelID, *pair);
+    } else {
+        log::warn("[LevelColors] fallo al decodificar imagen: pack:{}", levelID);
+    }
+    finishOne(levelID, revision, true, pair.has_value());
 }
 
+void LevelColors::finishOne(int32_t levelID, uint64_t revision, bool decoded, bool ok) {
+    bool checkpoint = false;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        m_scanInFlight--;
+        if (decoded) {
+            m_scanMarks[levelID] = ScanMark{revision, !ok};
+            if (ok) m_scanDone++;
+            else m_scanFailed++;
+            if (++m_sinceCheckpoint >= CHECKPOINT_EVERY) {
+                m_sinceCheckpoint = 0;
+                checkpoint = true;
+            }
+            if (ok && m_scanDone % 100 == 0) {
+                log::info("[LevelColors] progreso: {} ok, {} pendientes", m_scanDone, m_scanQueue.size());
+            }
+        }
+    }
+    if (checkpoint) saveCheckpoint();
+    pumpExtraction();
+}
+
+LevelColors::ExtractionStats LevelColors::extractionStats() const {
+    std::lock_guard<std::mutex> lock(m_scanMutex);
+    ExtractionStats stats;
+    stats.running = m_scanRunning;
+    stats.queued = m_scanQueue.size();
+    stats.inFlight = m_scanInFlight;
+    stats.done = m_scanDone;
+    stats.failed = m_scanFailed;
+    stats.skipped = m_scanSkipped;
+    return stats;
+}
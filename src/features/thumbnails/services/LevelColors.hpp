@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Geode/DefaultInclude.hpp>
+#include "LevelColorsScan.hpp"
+#include <chrono>
+#include <deque>
 #include <optional>
 #include <utility>
 #include <mutex>
@@ -21,8 +24,21 @@ public:
     // fuerza escritura a disco si hay cambios pendientes
     void flushIfDirty();
     
-    // procesar todas miniatura cacheadas y extraer colores
+    // extrae en segundo plano los colores de las miniaturas del manifest que
+    // aun no los tienen (o cuya revision cambio). Va en el pool del
+    // ThumbnailLoader por debajo de cualquier carga visible y guarda un
+    // checkpoint, asi al reiniciar sigue donde lo dejo. No bloquea.
     void extractColorsFromCache();
+
+    struct ExtractionStats {
+        bool running = false;
+        size_t queued = 0;
+        size_t inFlight = 0;
+        size_t done = 0;
+        size_t failed = 0;
+        size_t skipped = 0;   // ya tenian colores de esa revision
+    };
+    ExtractionStats extractionStats() const;
     
     // extraer colores de un ccimage cargado
     void extractFromImage(int32_t levelID, cocos2d::CCImage* image);
@@ -37,6 +53,40 @@ private:
     void load() const;
     void save() const;
 
+    // ── extraccion en segundo plano ─────────────────────────────
+    using ScanMark = paimon::colors::ScanMark;
+    using ScanAction = paimon::colors::ScanAction;
+    struct ScanItem {
+        int32_t levelID = 0;
+        uint64_t revision = 0;
+        ScanAction action = ScanAction::Extract;
+    };
+    std::filesystem::path checkpointPath() const;
+    void loadCheckpoint();   // con m_scanMutex
+    void saveCheckpoint();
+    void beginExtraction();
+    void planExtraction();
+    void pumpExtraction();
+    void extractOne(ScanItem item);
+    void finishOne(int32_t levelID, uint64_t revision, bool decoded, bool ok);
+    // como set() pero sin el guardado por lotes: lo escribe el checkpoint
+    void store(int32_t levelID, LevelColorPair pair);
+    static unsigned maxParallelExtractions();
+
+    mutable std::mutex m_scanMutex;
+    std::mutex m_checkpointMutex;  // un solo escritor del checkpoint
+    std::deque<ScanItem> m_scanQueue;
+    std::unordered_map<int32_t, ScanMark> m_scanMarks;
+    bool m_checkpointLoaded = false;
+    bool m_scanRunning = false;
+    size_t m_scanInFlight = 0;
+    size_t m_scanDone = 0;
+    size_t m_scanFailed = 0;
+    size_t m_scanSkipped = 0;
+    int m_sinceCheckpoint = 0;
+    std::chrono::steady_clock::time_point m_scanStart;
+    static constexpr int CHECKPOINT_EVERY = 50;  // imagenes entre checkpoints
+
     mutable bool m_loaded = false;
     mutable std::unordered_map<int32_t, LevelColorPair> m_items;
     mutable std::mutex m_mutex;
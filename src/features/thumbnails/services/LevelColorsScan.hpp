@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+// LevelColorsScan.hpp — que hace la extraccion en segundo plano con cada
+// miniatura del manifest. Sin Geode a proposito: es la parte que decide si
+// unos colores viejos valen o hay que recalcularlos.
+
+namespace paimon::colors {
+
+struct ScanMark {
+    uint64_t revision = 0;  // hash del revisionToken del manifest
+    bool failed = false;    // no se pudo decodificar esa revision
+};
+
+enum class ScanAction {
+    Skip,       // ya tiene colores (o fallo) de esta revision
+    Adopt,      // colores de antes del checkpoint: se marcan con esta revision
+    Extract,    // no tiene colores; si otra carga los guarda mientras tanto, valen
+    Recompute,  // la miniatura cambio: los colores que haya son de la version vieja
+};
+
+inline ScanAction planScan(std::optional<ScanMark> const& mark, uint64_t revision, bool hasPair) {
+    if (!mark) return hasPair ? ScanAction::Adopt : ScanAction::Extract;
+    if (mark->revision != revision) return ScanAction::Recompute;
+    if (mark->failed || hasPair) return ScanAction::Skip;
+    return ScanAction::Extract;
+}
+
+// en el worker: reutilizar el par guardado en vez de decodificar
+inline bool reuseStoredPair(ScanAction action, bool hasPair) {
+    return action == ScanAction::Extract && hasPair;
+}
+
+} // namespace paimon::colors
@@ -10,6 +10,9 @@ ListThumbnailManager& ListThumbnailManager::get() {
 }
 
 void ListThumbnailManager::processList(std::vector<int> const& levelIDs, ListCallback callback, std::shared_ptr<bool> callerAlive) {
+    // una sola consulta de manifest pa toda la lista antes de abrir las descargas
+    ThumbnailLoader::get().resolveManifestBatch(levelIDs);
+
     for (int id : levelIDs) {
         if (callerAlive && !*callerAlive) return;
         
@@ -10,6 +10,7 @@
 #include <unordered_set>
 #include <future>
 #include "../../../core/QualityConfig.hpp"
+#include "ThumbnailLoader.hpp"
 
 using namespace geode::prelude;
 
@@ -153,6 +154,10 @@ std::vector<int32_t> LocalThumbs::getAllLevelIDs() const {
 
     scanDir(dir());
     scanDir(paimon::quality::cacheDir());
+    // descargadas en el pack del cache (ya no son archivos sueltos)
+    for (int id : ThumbnailLoader::get().cachedLevelIDs()) {
+        uniqueIds.insert(id);
+    }
 
     ids.assign(uniqueIds.begin(), uniqueIds.end());
     return ids;
@@ -222,6 +227,22 @@ CCTexture2D* LocalThumbs::loadTexture(int32_t levelID) const {
 
     // buscar en carpeta cache
     if (auto tex = tryLoadFromDir(paimon::quality::cacheDir())) return tex;
+
+    // descargadas: viven en el pack del cache, no como archivo suelto
+    auto packed = ThumbnailLoader::get().readCachedSource(levelID, false);
+    if (!packed.empty()) {
+        auto image = new CCImage();
+        if (image->initWithImageData(packed.data(), static_cast<int>(packed.size()))) {
+            auto tex = new CCTexture2D();
+            if (tex->initWithImage(image)) {
+                image->release();
+                tex->autorelease();
+                return tex;
+            }
+            tex->release();
+        }
+        image->release();
+    }
     
     log::debug("[LocalThumbs] loadTexture: not found levelID={}", levelID);
     return nullptr;
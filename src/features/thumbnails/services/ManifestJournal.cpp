@@ -0,0 +1,344 @@
+#include "ManifestJournal.hpp"
+#include "../../../utils/BinaryIO.hpp"
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/string.hpp>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+using namespace geode::prelude;
+
+namespace paimon::cache::journal {
+
+namespace {
+using binio::crc32;
+using binio::getLE;
+using binio::putLE;
+using binio::readWholeFile;
+
+constexpr char BASE_MAGIC[4] = {'P', 'M', 'F', '1'};
+constexpr char JOURNAL_MAGIC[4] = {'P', 'M', 'J', '1'};
+constexpr uint32_t BASE_VERSION = 1;
+constexpr size_t BASE_HEADER_SIZE = 32;
+constexpr size_t RECORD_HEADER_SIZE = 8; // u32 len + u32 crc
+
+// registro fijo (little-endian):
+//   0  i32 levelID        4  i32 width          8  i32 height       12 u32 flags (bit0 isGif)
+//   16 u64 byteSize       24 i64 lastAccess     32 i64 lastValidated 40 u64 decodedByteSize
+//   48 8 x (u32 offset, u32 len) a la tabla de strings, en orden de Slot
+enum Slot : size_t {
+    SlotKey = 0,
+    SlotFilename,
+    SlotSourceUrl,
+    SlotRevision,
+    SlotFormat,
+    SlotQualityTag,
+    SlotDecodedFilename,
+    SlotDecodedFormat,
+    SlotCount,
+};
+constexpr size_t STRINGS_OFFSET = 48;
+constexpr size_t RECORD_SIZE = STRINGS_OFFSET + SlotCount * 8;
+
+// format / qualityTag / decodedFormat se repiten en casi todas las entradas:
+// en la base se guardan una sola vez
+struct StringTable {
+    std::vector<uint8_t>& bytes;
+    std::unordered_map<std::string, uint32_t>* interned = nullptr;
+
+    uint32_t add(std::string const& s, bool intern) {
+        if (intern && interned) {
+            auto it = interned->find(s);
+            if (it != interned->end()) return it->second;
+        }
+        auto off = static_cast<uint32_t>(bytes.size());
+        bytes.insert(bytes.end(), s.begin(), s.end());
+        if (intern && interned) interned->emplace(s, off);
+        return off;
+    }
+};
+
+void encodeRecord(uint8_t* rec, std::string const& key, DiskManifestEntry const& e, StringTable& strings) {
+    putLE<int32_t>(rec + 0, e.levelID);
+    putLE<int32_t>(rec + 4, e.width);
+    putLE<int32_t>(rec + 8, e.height);
+    putLE<uint32_t>(rec + 12, e.isGif ? 1u : 0u);
+    putLE<uint64_t>(rec + 16, e.byteSize);
+    putLE<int64_t>(rec + 24, e.lastAccessEpoch);
+    putLE<int64_t>(rec + 32, e.lastValidatedEpoch);
+    putLE<uint64_t>(rec + 40, e.decodedByteSize);
+
+    auto slot = [&](Slot s, std::string const& value, bool intern) {
+        uint8_t* p = rec + STRINGS_OFFSET + s * 8;
+        putLE<uint32_t>(p, strings.add(value, intern));
+        putLE<uint32_t>(p + 4, static_cast<uint32_t>(value.size()));
+    };
+    slot(SlotKey, key, false);
+    slot(SlotFilename, e.filename, false);
+    slot(SlotSourceUrl, e.sourceUrl, false);
+    slot(SlotRevision, e.revisionToken, false);
+    slot(SlotFormat, e.format, true);
+    slot(SlotQualityTag, e.qualityTag, true);
+    slot(SlotDecodedFilename, e.decodedFilename, false);
+    slot(SlotDecodedFormat, e.decodedFormat, true);
+}
+
+bool decodeRecord(uint8_t const* rec, uint8_t const* strings, size_t stringBytes,
+                  std::string& key, DiskManifestEntry& e) {
+    std::array<std::string_view, SlotCount> s;
+    for (size_t i = 0; i < SlotCount; ++i) {
+        uint8_t const* p = rec + STRINGS_OFFSET + i * 8;
+        uint64_t off = getLE<uint32_t>(p);
+        uint64_t len = getLE<uint32_t>(p + 4);
+        if (off + len > stringBytes) return false;
+        s[i] = std::string_view(reinterpret_cast<char const*>(strings + off), static_cast<size_t>(len));
+    }
+    if (s[SlotKey].empty()) return false;
+
+    key.assign(s[SlotKey]);
+    e.levelID = getLE<int32_t>(rec + 0);
+    e.width = getLE<int32_t>(rec + 4);
+    e.height = getLE<int32_t>(rec + 8);
+    e.isGif = (getLE<uint32_t>(rec + 12) & 1) != 0;
+    e.byteSize = static_cast<size_t>(getLE<uint64_t>(rec + 16));
+    e.lastAccessEpoch = getLE<int64_t>(rec + 24);
+    e.lastValidatedEpoch = getLE<int64_t>(rec + 32);
+    e.decodedByteSize = static_cast<size_t>(getLE<uint64_t>(rec + 40));
+    e.filename.assign(s[SlotFilename]);
+    e.sourceUrl.assign(s[SlotSourceUrl]);
+    e.revisionToken.assign(s[SlotRevision]);
+    e.format.assign(s[SlotFormat]);
+    e.qualityTag.assign(s[SlotQualityTag]);
+    e.decodedFilename.assign(s[SlotDecodedFilename]);
+    e.decodedFormat.assign(s[SlotDecodedFormat]);
+    return true;
+}
+
+// reserva el header del registro, deja que fill escriba el payload y cierra len + crc
+template <typename Fn>
+void encodeFramed(std::vector<uint8_t>& buf, Fn&& fill) {
+    size_t start = buf.size();
+    buf.resize(start + RECORD_HEADER_SIZE);
+    fill(buf);
+    size_t payloadLen = buf.size() - start - RECORD_HEADER_SIZE;
+    putLE<uint32_t>(buf.data() + start, static_cast<uint32_t>(payloadLen));
+    putLE<uint32_t>(buf.data() + start + 4, crc32(buf.data() + start + RECORD_HEADER_SIZE, payloadLen));
+}
+
+void encodeKeyOp(std::vector<uint8_t>& buf, Op op, std::string const& key) {
+    buf.push_back(static_cast<uint8_t>(op));
+    uint8_t len[2];
+    putLE<uint16_t>(len, static_cast<uint16_t>(std::min<size_t>(key.size(), 0xFFFF)));
+    buf.insert(buf.end(), len, len + 2);
+    buf.insert(buf.end(), key.begin(), key.begin() + std::min<size_t>(key.size(), 0xFFFF));
+}
+} // namespace
+
+// ── Base ────────────────────────────────────────────────────────────
+
+uint64_t writeBase(std::filesystem::path const& path, uint32_t generation, EntryMap const& entries) {
+    std::vector<uint8_t> records(entries.size() * RECORD_SIZE);
+    std::vector<uint8_t> strings;
+    strings.reserve(entries.size() * 48);
+    std::unordered_map<std::string, uint32_t> interned;
+    StringTable table{strings, &interned};
+
+    size_t i = 0;
+    for (auto const& [key, entry] : entries) {
+        encodeRecord(records.data() + i * RECORD_SIZE, key, entry, table);
+        ++i;
+    }
+
+    uint8_t header[BASE_HEADER_SIZE] = {};
+    std::memcpy(header, BASE_MAGIC, 4);
+    putLE<uint32_t>(header + 4, BASE_VERSION);
+    putLE<uint32_t>(header + 8, generation);
+    putLE<uint32_t>(header + 12, static_cast<uint32_t>(entries.size()));
+    putLE<uint64_t>(header + 16, strings.size());
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) return 0;
+        file.write(reinterpret_cast<char const*>(header), BASE_HEADER_SIZE);
+        file.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(records.size()));
+        file.write(reinterpret_cast<char const*>(strings.data()), static_cast<std::streamsize>(strings.size()));
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return 0;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        log::warn("[ManifestJournal] rename de la base fallo: {}", ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return 0;
+    }
+    return BASE_HEADER_SIZE + records.size() + strings.size();
+}
+
+BaseInfo readBase(std::filesystem::path const& path, EntryMap& out) {
+    BaseInfo info;
+    std::vector<uint8_t> data;
+    if (!readWholeFile(path, data) || data.size() < BASE_HEADER_SIZE) return info;
+
+    uint8_t const* h = data.data();
+    if (std::memcmp(h, BASE_MAGIC, 4) != 0 || getLE<uint32_t>(h + 4) != BASE_VERSION) {
+        log::warn("[ManifestJournal] base con header invalido: {}", geode::utils::string::pathToString(path));
+        return info;
+    }
+    uint32_t generation = getLE<uint32_t>(h + 8);
+    uint64_t count = getLE<uint32_t>(h + 12);
+    uint64_t stringBytes = getLE<uint64_t>(h + 16);
+    if (BASE_HEADER_SIZE + count * RECORD_SIZE + stringBytes != data.size()) {
+        log::warn("[ManifestJournal] base truncada o corrupta: {}", geode::utils::string::pathToString(path));
+        return info;
+    }
+
+    uint8_t const* records = h + BASE_HEADER_SIZE;
+    uint8_t const* strings = records + count * RECORD_SIZE;
+    out.clear();
+    out.reserve(static_cast<size_t>(count));
+    std::string key;
+    for (uint64_t i = 0; i < count; ++i) {
+        DiskManifestEntry e;
+        if (!decodeRecord(records + i * RECORD_SIZE, strings, static_cast<size_t>(stringBytes), key, e)) {
+            log::warn("[ManifestJournal] registro {} de la base invalido", i);
+            out.clear();
+            return info;
+        }
+        out[key] = std::move(e);
+    }
+
+    info.ok = true;
+    info.generation = generation;
+    info.bytes = data.size();
+    return info;
+}
+
+// ── Journal ─────────────────────────────────────────────────────────
+
+void encodeUpsert(std::vector<uint8_t>& buf, std::string const& key, DiskManifestEntry const& entry) {
+    encodeFramed(buf, [&](std::vector<uint8_t>& b) {
+        b.push_back(static_cast<uint8_t>(Op::Upsert));
+        size_t recOff = b.size();
+        b.resize(recOff + RECORD_SIZE);
+        // strings relativos al final del registro: se arman aparte y se pegan
+        std::vector<uint8_t> strings;
+        StringTable table{strings};
+        encodeRecord(b.data() + recOff, key, entry, table);
+        b.insert(b.end(), strings.begin(), strings.end());
+    });
+}
+
+void encodeRemove(std::vector<uint8_t>& buf, std::string const& key) {
+    encodeFramed(buf, [&](std::vector<uint8_t>& b) {
+        encodeKeyOp(b, Op::Remove, key);
+    });
+}
+
+void encodeTouch(std::vector<uint8_t>& buf, std::string const& key, int64_t lastAccessEpoch) {
+    encodeFramed(buf, [&](std::vector<uint8_t>& b) {
+        encodeKeyOp(b, Op::Touch, key);
+        uint8_t epoch[8];
+        putLE<int64_t>(epoch, lastAccessEpoch);
+        b.insert(b.end(), epoch, epoch + 8);
+    });
+}
+
+void encodeClear(std::vector<uint8_t>& buf) {
+    encodeFramed(buf, [&](std::vector<uint8_t>& b) {
+        b.push_back(static_cast<uint8_t>(Op::Clear));
+    });
+}
+
+ReplayInfo replay(std::filesystem::path const& path, uint32_t expectedGeneration, EntryMap& entries) {
+    ReplayInfo info;
+    std::vector<uint8_t> data;
+    if (!readWholeFile(path, data)) return info;
+    info.fileBytes = data.size();
+    if (data.size() < HEADER_BYTES || std::memcmp(data.data(), JOURNAL_MAGIC, 4) != 0) return info;
+
+    info.generation = getLE<uint32_t>(data.data() + 4);
+    if (info.generation != expectedGeneration) return info;
+    info.ok = true;
+
+    uint64_t off = HEADER_BYTES;
+    std::string key;
+    while (off + RECORD_HEADER_SIZE <= data.size()) {
+        uint8_t const* rec = data.data() + off;
+        uint64_t len = getLE<uint32_t>(rec);
+        if (len == 0 || off + RECORD_HEADER_SIZE + len > data.size()) break;
+        uint8_t const* payload = rec + RECORD_HEADER_SIZE;
+        if (crc32(payload, static_cast<size_t>(len)) != getLE<uint32_t>(rec + 4)) break;
+
+        auto op = static_cast<Op>(payload[0]);
+        bool valid = true;
+        switch (op) {
+            case Op::Upsert: {
+                if (len < 1 + RECORD_SIZE) { valid = false; break; }
+                DiskManifestEntry e;
+                uint8_t const* strings = payload + 1 + RECORD_SIZE;
+                if (!decodeRecord(payload + 1, strings, static_cast<size_t>(len - 1 - RECORD_SIZE), key, e)) {
+                    valid = false;
+                    break;
+                }
+                entries[key] = std::move(e);
+                break;
+            }
+            case Op::Remove:
+            case Op::Touch: {
+                if (len < 3) { valid = false; break; }
+                uint64_t keyLen = getLE<uint16_t>(payload + 1);
+                uint64_t need = 3 + keyLen + (op == Op::Touch ? 8 : 0);
+                if (len < need) { valid = false; break; }
+                key.assign(reinterpret_cast<char const*>(payload + 3), static_cast<size_t>(keyLen));
+                if (op == Op::Remove) {
+                    entries.erase(key);
+                } else if (auto it = entries.find(key); it != entries.end()) {
+                    it->second.lastAccessEpoch = getLE<int64_t>(payload + 3 + keyLen);
+                }
+                break;
+            }
+            case Op::Clear:
+                entries.clear();
+                break;
+            default:
+                valid = false;
+                break;
+        }
+        if (!valid) break;
+
+        off += RECORD_HEADER_SIZE + len;
+        info.records++;
+    }
+    info.validBytes = off;
+    return info;
+}
+
+bool reset(std::filesystem::path const& path, uint32_t generation) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    uint8_t header[HEADER_BYTES];
+    std::memcpy(header, JOURNAL_MAGIC, 4);
+    putLE<uint32_t>(header + 4, generation);
+    file.write(reinterpret_cast<char const*>(header), HEADER_BYTES);
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+bool append(std::filesystem::path const& path, std::vector<uint8_t> const& buf) {
+    if (buf.empty()) return true;
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file) return false;
+    file.write(reinterpret_cast<char const*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+} // namespace paimon::cache::journal
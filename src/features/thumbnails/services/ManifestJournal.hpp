@@ -0,0 +1,83 @@
+#pragma once
+
+// ManifestJournal.hpp — Formato binario persistente del DiskManifest.
+// Reemplaza el manifest.json que se reescribia entero en cada flush:
+//
+//   manifest.bin      snapshot base: header + registros de tamaño fijo +
+//                     tabla de strings. Se escribe solo en checkpoints
+//                     (tmp + rename, nunca queda a medias).
+//   manifest.journal  append-only: upsert / remove / touch / clear desde el
+//                     ultimo checkpoint. Cada registro lleva largo + crc32.
+//
+// Recuperacion tras crash:
+//   - crash escribiendo la base: queda la base anterior + su journal intactos.
+//   - crash entre el rename de la base y el reset del journal: el journal
+//     tiene la generacion vieja y se descarta (sus ops ya estan en la base).
+//   - registro del journal truncado o con crc invalido: el replay para ahi y
+//     la cola se corta; se pierden solo las ops posteriores al ultimo flush.
+//   - base ilegible: el manifest se reconstruye como si no existiera.
+//
+// Base (little-endian):
+//   header 32 bytes: "PMF1" | u32 version | u32 generation | u32 count | u64 stringBytes | u64 0
+//   count * RECORD_SIZE registros (ver encodeRecord en el .cpp) | stringBytes de strings
+// Journal:
+//   header 8 bytes: "PMJ1" | u32 generation
+//   registros: u32 payloadLen | u32 crc32(payload) | payload (u8 op | ...)
+
+#include "CacheModels.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace paimon::cache::journal {
+
+using EntryMap = std::unordered_map<std::string, DiskManifestEntry>;
+
+enum class Op : uint8_t {
+    Upsert = 1,
+    Remove = 2,
+    Touch  = 3,
+    Clear  = 4,
+};
+
+// ── Base ────────────────────────────────────────────────────────────
+
+struct BaseInfo {
+    bool ok = false;
+    uint32_t generation = 0;
+    uint64_t bytes = 0;
+};
+
+// escribe el snapshot completo (tmp + rename). devuelve bytes escritos, 0 si fallo
+uint64_t writeBase(std::filesystem::path const& path, uint32_t generation, EntryMap const& entries);
+// lee el snapshot entero con una sola lectura secuencial
+BaseInfo readBase(std::filesystem::path const& path, EntryMap& out);
+
+// ── Journal ─────────────────────────────────────────────────────────
+
+// serializan una op al final de buf (listo para append)
+void encodeUpsert(std::vector<uint8_t>& buf, std::string const& key, DiskManifestEntry const& entry);
+void encodeRemove(std::vector<uint8_t>& buf, std::string const& key);
+void encodeTouch(std::vector<uint8_t>& buf, std::string const& key, int64_t lastAccessEpoch);
+void encodeClear(std::vector<uint8_t>& buf);
+
+struct ReplayInfo {
+    bool ok = false;          // false: no existe, header invalido o generacion vieja
+    uint32_t generation = 0;
+    size_t records = 0;
+    uint64_t validBytes = 0;  // hasta el ultimo registro valido (incluye header)
+    uint64_t fileBytes = 0;
+};
+
+// aplica sobre entries los registros del journal si su generacion coincide
+ReplayInfo replay(std::filesystem::path const& path, uint32_t expectedGeneration, EntryMap& entries);
+
+// trunca el journal y escribe un header nuevo
+bool reset(std::filesystem::path const& path, uint32_t generation);
+bool append(std::filesystem::path const& path, std::vector<uint8_t> const& buf);
+
+constexpr uint64_t HEADER_BYTES = 8;
+
+} // namespace paimon::cache::journal
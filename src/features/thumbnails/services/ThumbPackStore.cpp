@@ -0,0 +1,516 @@
+#include "ThumbPackStore.hpp"
+#include "../../../utils/BinaryIO.hpp"
+#include "../../../utils/Debug.hpp"
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/string.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+using namespace geode::prelude;
+
+namespace paimon::cache {
+
+namespace {
+using binio::getLE;
+using binio::putLE;
+
+constexpr char MAGIC[4] = {'P', 'K', 'R', '1'};
+constexpr size_t HEADER_SIZE = 16;
+constexpr uint8_t TYPE_PUT = 0;
+constexpr uint8_t TYPE_TOMBSTONE = 1;
+constexpr char const* SEGMENT_PREFIX = "pack_";
+constexpr char const* SEGMENT_EXT = ".dat";
+
+struct RecordView {
+    uint8_t type = TYPE_PUT;
+    std::string_view key;
+    uint64_t offset = 0;
+    uint64_t payloadOffset = 0;
+    uint32_t payloadSize = 0;
+    uint64_t recordBytes = 0;
+};
+
+// recorre los registros completos de un segmento; devuelve el offset donde
+// termina el ultimo registro valido (lo que sigue es basura o cola truncada)
+template <typename Fn>
+uint64_t forEachRecord(uint8_t const* base, size_t total, Fn&& fn) {
+    uint64_t off = 0;
+    while (off + HEADER_SIZE <= total) {
+        uint8_t const* h = base + off;
+        if (std::memcmp(h, MAGIC, 4) != 0) break;
+        RecordView rec;
+        rec.type = h[4];
+        uint16_t keyLen = getLE<uint16_t>(h + 6);
+        rec.payloadSize = getLE<uint32_t>(h + 8);
+        rec.recordBytes = HEADER_SIZE + keyLen + static_cast<uint64_t>(rec.payloadSize);
+        if (keyLen == 0 || rec.type > TYPE_TOMBSTONE || off + rec.recordBytes > total) break;
+        rec.key = std::string_view(reinterpret_cast<char const*>(h + HEADER_SIZE), keyLen);
+        rec.offset = off;
+        rec.payloadOffset = off + HEADER_SIZE + keyLen;
+        fn(rec);
+        off += rec.recordBytes;
+    }
+    return off;
+}
+
+std::optional<uint32_t> parseSegmentId(std::string const& name) {
+    std::string_view sv(name);
+    std::string_view prefix(SEGMENT_PREFIX);
+    std::string_view ext(SEGMENT_EXT);
+    if (sv.size() <= prefix.size() + ext.size()) return std::nullopt;
+    if (sv.substr(0, prefix.size()) != prefix || sv.substr(sv.size() - ext.size()) != ext) return std::nullopt;
+    auto digits = sv.substr(prefix.size(), sv.size() - prefix.size() - ext.size());
+    uint32_t id = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), id);
+    if (ec != std::errc() || ptr != digits.data() + digits.size()) return std::nullopt;
+    return id;
+}
+
+// "<levelID>.png" del layout anterior (los GIF se quedan sueltos)
+bool isLooseStaticThumb(std::string const& name) {
+    std::string_view sv(name);
+    if (sv.size() <= 4 || sv.substr(sv.size() - 4) != ".png") return false;
+    auto stem = sv.substr(0, sv.size() - 4);
+    int id = 0;
+    auto [ptr, ec] = std::from_chars(stem.data(), stem.data() + stem.size(), id);
+    return ec == std::errc() && ptr == stem.data() + stem.size();
+}
+
+bool endsWith(std::string const& s, std::string_view suffix) {
+    return s.size() >= suffix.size() && std::string_view(s).substr(s.size() - suffix.size()) == suffix;
+}
+} // namespace
+
+std::filesystem::path ThumbPackStore::segmentPath(uint32_t id) const {
+    return m_dir / fmt::format("{}{:04}{}", SEGMENT_PREFIX, id, SEGMENT_EXT);
+}
+
+bool ThumbPackStore::open(std::filesystem::path const& dir) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_open) {
+        m_active.close();
+        m_activeReader.close();
+        m_index.clear();
+        m_segments.clear();
+        m_open = false;
+    }
+    m_dir = dir;
+
+    std::error_code ec;
+    std::vector<uint32_t> ids;
+    for (auto const& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        if (auto id = parseSegmentId(geode::utils::string::pathToString(entry.path().filename()))) {
+            ids.push_back(*id);
+        }
+    }
+    if (ec) {
+        log::warn("[ThumbPackStore] no se pudo listar {}: {}", geode::utils::string::pathToString(dir), ec.message());
+    }
+    std::sort(ids.begin(), ids.end());
+
+    // orden ascendente: el registro mas nuevo de cada key gana
+    for (auto id : ids) {
+        auto& seg = m_segments[id];
+        seg.id = id;
+        seg.path = segmentPath(id);
+        scanSegmentLocked(seg);
+    }
+
+    uint32_t activeId = ids.empty() ? 1 : ids.back();
+    if (!ids.empty() && m_segments[activeId].size >= SEGMENT_MAX_BYTES) ++activeId;
+    if (!openActiveLocked(activeId)) {
+        log::error("[ThumbPackStore] no se pudo abrir el segmento activo {}", geode::utils::string::pathToString(segmentPath(activeId)));
+        return false;
+    }
+    m_open = true;
+
+    migrateLooseFilesLocked();
+
+    PaimonDebug::log("[ThumbPackStore] abierto: {} segmentos, {} entradas, activo={}",
+        m_segments.size(), m_index.size(), m_activeId);
+    return true;
+}
+
+void ThumbPackStore::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_active.close();
+    m_activeReader.close();
+    m_index.clear();
+    m_segments.clear();
+    m_open = false;
+}
+
+void ThumbPackStore::scanSegmentLocked(Segment& seg) {
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(seg.path, ec);
+    if (ec || fileSize == 0) {
+        seg.size = 0;
+        return;
+    }
+
+    uint64_t validEnd = 0;
+    {
+        auto file = MappedFile::open(seg.path);
+        if (!file) {
+            log::warn("[ThumbPackStore] no se pudo mapear {}", geode::utils::string::pathToString(seg.path));
+            seg.size = fileSize;
+            seg.deadBytes = fileSize;
+            return;
+        }
+        validEnd = forEachRecord(file->data(), file->size(), [&](RecordView const& rec) {
+            std::string key(rec.key);
+            auto it = m_index.find(key);
+            if (it != m_index.end()) {
+                markDeadLocked(it->second);
+                m_index.erase(it);
+            }
+            if (rec.type == TYPE_PUT) {
+                m_index[std::move(key)] = Location{seg.id, rec.offset, rec.payloadOffset, rec.payloadSize, rec.recordBytes};
+            } else {
+                seg.deadBytes += rec.recordBytes;
+            }
+        });
+    }
+
+    // cola truncada (crash a mitad de append): se corta para que los
+    // siguientes appends queden alineados a registros validos
+    if (validEnd < fileSize) {
+        log::warn("[ThumbPackStore] {}: descartando {} bytes de cola invalida",
+            geode::utils::string::pathToString(seg.path), fileSize - validEnd);
+        std::filesystem::resize_file(seg.path, validEnd, ec);
+        if (ec) {
+            log::warn("[ThumbPackStore] no se pudo truncar: {}", ec.message());
+        }
+    }
+    seg.size = validEnd;
+}
+
+bool ThumbPackStore::openActiveLocked(uint32_t id) {
+    m_active.close();
+    m_activeReader.close();
+    auto path = segmentPath(id);
+    m_active.open(path, std::ios::binary | std::ios::app);
+    if (!m_active) return false;
+    m_activeReader.open(path, std::ios::binary);
+
+    auto& seg = m_segments[id];
+    seg.id = id;
+    seg.path = path;
+    m_activeId = id;
+    return true;
+}
+
+std::shared_ptr<MappedFile> ThumbPackStore::mapLocked(Segment const& seg, uint64_t needEnd) const {
+    // solo segmentos cerrados: no crecen, asi que se mapean una sola vez
+    if (seg.map && seg.map->size() >= needEnd) return seg.map;
+    seg.map = MappedFile::open(seg.path);
+    if (!seg.map || seg.map->size() < needEnd) return nullptr;
+    return seg.map;
+}
+
+bool ThumbPackStore::readActiveLocked(Location const& loc, std::vector<uint8_t>& out) const {
+    if (!m_activeReader.is_open()) return false;
+    // el append ya hizo flush; seekg descarta lo que el reader tuviera en buffer
+    m_activeReader.clear();
+    m_activeReader.seekg(static_cast<std::streamoff>(loc.payloadOffset), std::ios::beg);
+    out.resize(loc.payloadSize);
+    if (loc.payloadSize > 0) {
+        m_activeReader.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(loc.payloadSize));
+    }
+    return static_cast<bool>(m_activeReader);
+}
+
+void ThumbPackStore::markDeadLocked(Location const& loc) {
+    auto it = m_segments.find(loc.segment);
+    if (it != m_segments.end()) it->second.deadBytes += loc.recordBytes;
+}
+
+bool ThumbPackStore::appendLocked(uint8_t type, std::string const& key, uint8_t const* data, size_t size, Location* outLoc) {
+    if (!m_active.is_open()) return false;
+    if (key.empty() || key.size() > std::numeric_limits<uint16_t>::max()) return false;
+    if (size > std::numeric_limits<uint32_t>::max()) return false;
+
+    uint64_t recordBytes = HEADER_SIZE + key.size() + size;
+    if (m_segments[m_activeId].size > 0 && m_segments[m_activeId].size + recordBytes > SEGMENT_MAX_BYTES) {
+        if (!openActiveLocked(m_activeId + 1)) {
+            log::error("[ThumbPackStore] no se pudo rotar al segmento {}", m_activeId + 1);
+            return false;
+        }
+    }
+    auto& seg = m_segments[m_activeId];
+
+    uint8_t header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, 4);
+    header[4] = type;
+    putLE<uint16_t>(header + 6, static_cast<uint16_t>(key.size()));
+    putLE<uint32_t>(header + 8, static_cast<uint32_t>(size));
+
+    m_active.write(reinterpret_cast<char const*>(header), HEADER_SIZE);
+    m_active.write(key.data(), static_cast<std::streamsize>(key.size()));
+    if (size > 0) m_active.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(size));
+    // flush: los lectores mapean el archivo y tienen que ver el registro entero
+    m_active.flush();
+
+    if (!m_active) {
+        // registro a medias al final: se abandona el segmento para que los
+        // siguientes appends no queden detras de basura (el scan la corta)
+        log::warn("[ThumbPackStore] fallo escribiendo en segmento {}", m_activeId);
+        seg.size += recordBytes;
+        seg.deadBytes += recordBytes;
+        m_active.clear();
+        openActiveLocked(m_activeId + 1);
+        return false;
+    }
+
+    if (outLoc) {
+        *outLoc = Location{m_activeId, seg.size, seg.size + HEADER_SIZE + key.size(), static_cast<uint32_t>(size), recordBytes};
+    }
+    seg.size += recordBytes;
+    return true;
+}
+
+bool ThumbPackStore::contains(std::string const& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.count(key) > 0;
+}
+
+size_t ThumbPackStore::sizeOf(std::string const& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    return it != m_index.end() ? it->second.payloadSize : 0;
+}
+
+ThumbPackStore::Blob ThumbPackStore::read(std::string const& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) return {};
+    auto segIt = m_segments.find(it->second.segment);
+    if (segIt == m_segments.end()) return {};
+
+    auto const& loc = it->second;
+    Blob blob;
+    if (loc.segment == m_activeId) {
+        auto buf = std::make_shared<std::vector<uint8_t>>();
+        if (!readActiveLocked(loc, *buf)) return {};
+        blob.data = buf->data();
+        blob.size = buf->size();
+        blob.owner = std::move(buf);
+        return blob;
+    }
+
+    auto map = mapLocked(segIt->second, loc.payloadOffset + loc.payloadSize);
+    if (!map) return {};
+    blob.data = map->data() + loc.payloadOffset;
+    blob.size = loc.payloadSize;
+    blob.owner = std::move(map);
+    return blob;
+}
+
+bool ThumbPackStore::put(std::string const& key, uint8_t const* data, size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) return false;
+
+    Location loc;
+    if (!appendLocked(TYPE_PUT, key, data, size, &loc)) return false;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        markDeadLocked(it->second);
+        it->second = loc;
+    } else {
+        m_index.emplace(key, loc);
+    }
+    return true;
+}
+
+bool ThumbPackStore::remove(std::string const& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) return false;
+
+    auto it = m_index.find(key);
+    if (it == m_index.end()) return false;
+    markDeadLocked(it->second);
+    m_index.erase(it);
+
+    // el tombstone evita que el scan de arranque resucite la entrada;
+    // en si mismo ya es espacio muerto
+    Location tomb;
+    if (appendLocked(TYPE_TOMBSTONE, key, nullptr, 0, &tomb)) {
+        markDeadLocked(tomb);
+    }
+    return true;
+}
+
+std::vector<std::string> ThumbPackStore::keys() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> out;
+    out.reserve(m_index.size());
+    for (auto const& [key, loc] : m_index) out.push_back(key);
+    return out;
+}
+
+bool ThumbPackStore::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const& [id, seg] : m_segments) {
+        if (id == m_activeId || seg.size == 0) continue;
+        if (static_cast<double>(seg.deadBytes) >= static_cast<double>(seg.size) * COMPACT_DEAD_RATIO) return true;
+    }
+    return false;
+}
+
+uint64_t ThumbPackStore::compact() {
+    std::vector<uint32_t> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_open) return 0;
+        for (auto const& [id, seg] : m_segments) {
+            if (id == m_activeId || seg.size == 0) continue;
+            if (static_cast<double>(seg.deadBytes) >= static_cast<double>(seg.size) * COMPACT_DEAD_RATIO) {
+                victims.push_back(id);
+            }
+        }
+    }
+    std::sort(victims.begin(), victims.end());
+
+    uint64_t reclaimed = 0;
+    for (auto id : victims) {
+        std::vector<std::string> liveKeys;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto const& [key, loc] : m_index) {
+                if (loc.segment == id) liveKeys.push_back(key);
+            }
+        }
+
+        // un registro por vez: los lectores no se quedan esperando todo el segmento
+        for (auto const& key : liveKeys) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_open) return reclaimed;
+            auto it = m_index.find(key);
+            if (it == m_index.end() || it->second.segment != id) continue;
+            auto segIt = m_segments.find(id);
+            if (segIt == m_segments.end()) break;
+
+            auto map = mapLocked(segIt->second, it->second.payloadOffset + it->second.payloadSize);
+            if (!map) continue;
+            Location loc;
+            if (appendLocked(TYPE_PUT, key, map->data() + it->second.payloadOffset, it->second.payloadSize, &loc)) {
+                it->second = loc;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_open) return reclaimed;
+        auto segIt = m_segments.find(id);
+        if (segIt == m_segments.end()) continue;
+
+        bool stillReferenced = std::any_of(m_index.begin(), m_index.end(),
+            [id](auto const& kv) { return kv.second.segment == id; });
+        if (stillReferenced) {
+            log::warn("[ThumbPackStore] compactacion de segmento {} incompleta, se conserva", id);
+            continue;
+        }
+
+        // si quedan segmentos mas viejos, sus puts podrian revivir al borrar
+        // los tombstones de este: se reescriben en el activo
+        bool hasOlder = std::any_of(m_segments.begin(), m_segments.end(),
+            [id](auto const& kv) { return kv.first < id; });
+        if (hasOlder) {
+            if (auto map = mapLocked(segIt->second, segIt->second.size)) {
+                std::vector<std::string> tombstones;
+                forEachRecord(map->data(), static_cast<size_t>(segIt->second.size), [&](RecordView const& rec) {
+                    if (rec.type == TYPE_TOMBSTONE && !m_index.count(std::string(rec.key))) {
+                        tombstones.emplace_back(rec.key);
+                    }
+                });
+                for (auto const& key : tombstones) {
+                    Location tomb;
+                    if (appendLocked(TYPE_TOMBSTONE, key, nullptr, 0, &tomb)) markDeadLocked(tomb);
+                }
+            }
+        }
+
+        auto path = segIt->second.path;
+        reclaimed += segIt->second.size;
+        m_segments.erase(segIt);
+
+        // Blob vivos mantienen su mapeo; en Windows el borrado queda pendiente
+        // hasta que se suelten (MappedFile abre con FILE_SHARE_DELETE)
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        if (ec) {
+            log::warn("[ThumbPackStore] no se pudo borrar {}: {}", geode::utils::string::pathToString(path), ec.message());
+        }
+    }
+
+    if (reclaimed > 0) {
+        PaimonDebug::log("[ThumbPackStore] compactacion: {} segmentos, {} bytes recuperados", victims.size(), reclaimed);
+    }
+    return reclaimed;
+}
+
+ThumbPackStore::Stats ThumbPackStore::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.segments = m_segments.size();
+    s.entries = m_index.size();
+    for (auto const& [id, seg] : m_segments) {
+        s.deadBytes += seg.deadBytes;
+        s.liveBytes += seg.size > seg.deadBytes ? seg.size - seg.deadBytes : 0;
+    }
+    return s;
+}
+
+void ThumbPackStore::migrateLooseFilesLocked() {
+    // importa el layout anterior: <levelID>.png y sus variantes .ptd
+    std::error_code ec;
+    std::vector<std::filesystem::path> loose;
+    for (auto const& entry : std::filesystem::directory_iterator(m_dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        auto name = geode::utils::string::pathToString(entry.path().filename());
+        if (endsWith(name, ".ptd.tmp")) {
+            std::filesystem::remove(entry.path(), ec);
+            continue;
+        }
+        if (isLooseStaticThumb(name) || endsWith(name, ".ptd")) {
+            loose.push_back(entry.path());
+        }
+    }
+    if (loose.empty()) return;
+
+    size_t imported = 0;
+    uint64_t importedBytes = 0;
+    std::vector<uint8_t> buf;
+    for (auto const& path : loose) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) continue;
+        auto size = static_cast<size_t>(in.tellg());
+        in.seekg(0, std::ios::beg);
+        buf.resize(size);
+        if (size > 0 && !in.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(size))) continue;
+        in.close();
+
+        auto key = geode::utils::string::pathToString(path.filename());
+        Location loc;
+        if (!appendLocked(TYPE_PUT, key, buf.data(), buf.size(), &loc)) break;
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            markDeadLocked(it->second);
+            it->second = loc;
+        } else {
+            m_index.emplace(key, loc);
+        }
+        std::filesystem::remove(path, ec);
+        ++imported;
+        importedBytes += size;
+    }
+
+    log::info("[ThumbPackStore] migrados {} archivos sueltos al pack ({} bytes)", imported, importedBytes);
+}
+
+} // namespace paimon::cache
@@ -0,0 +1,115 @@
+#pragma once
+
+// ThumbPackStore.hpp — Almacen append-only en segmentos para el cache de thumbnails.
+// Reemplaza los miles de <levelID>.png / .ptd sueltos en cache_<tier>/ por unos
+// pocos archivos pack_<n>.dat con un indice en memoria (key -> segmento+offset).
+//
+// - Lecturas posicionales: los segmentos cerrados ya no crecen, se mapean una
+//   vez (MappedFile) y read() devuelve una vista sin copia que mantiene vivo el
+//   mapeo. El segmento activo no se mapea (cada append obligaria a remapearlo
+//   entero): se lee el payload con seek+read a un buffer propio.
+// - Escrituras: siempre al final del segmento activo; al pasar SEGMENT_MAX_BYTES
+//   se abre uno nuevo.
+// - Borrados: registro tombstone + bytes muertos en el segmento del original.
+// - Compactacion: copia los registros vivos de segmentos con muchos bytes
+//   muertos al segmento activo y borra el archivo viejo (carril Maintenance).
+// - Arranque: el indice se reconstruye leyendo solo las cabeceras de registro;
+//   una cola truncada (crash a mitad de escritura) se descarta.
+//
+// Registro (little-endian, 16 bytes de cabecera):
+//   u32 magic "PKR1" | u8 type (0 put, 1 tombstone) | u8 0 | u16 keyLen | u32 payloadLen | u32 0
+//   key bytes | payload bytes
+//
+// Los GIF de nivel NO viven aqui: AnimatedGIFSprite y varias vistas los abren por
+// ruta, asi que siguen como archivo suelto junto a los segmentos.
+
+#include "../../../utils/MappedFile.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace paimon::cache {
+
+class ThumbPackStore {
+public:
+    // vista de solo lectura a un payload; owner mantiene vivo el mapeo (o el
+    // buffer, si salio del segmento activo)
+    struct Blob {
+        std::shared_ptr<void const> owner;
+        uint8_t const* data = nullptr;
+        size_t size = 0;
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    struct Stats {
+        size_t segments = 0;
+        size_t entries = 0;
+        uint64_t liveBytes = 0;
+        uint64_t deadBytes = 0;
+    };
+
+    // abre (o crea) el almacen en dir, reconstruye el indice e importa los
+    // archivos sueltos del layout anterior (<id>.png, *.ptd)
+    bool open(std::filesystem::path const& dir);
+    // cierra handles y mapeos (necesario antes de borrar la carpeta en Windows)
+    void close();
+
+    bool contains(std::string const& key) const;
+    size_t sizeOf(std::string const& key) const;
+    Blob read(std::string const& key) const;
+    bool put(std::string const& key, uint8_t const* data, size_t size);
+    bool remove(std::string const& key);
+    std::vector<std::string> keys() const;
+
+    // compacta segmentos cerrados con mas de COMPACT_DEAD_RATIO bytes muertos.
+    // devuelve bytes recuperados en disco
+    uint64_t compact();
+    bool needsCompaction() const;
+
+    Stats stats() const;
+
+    static constexpr uint64_t SEGMENT_MAX_BYTES = 64ull * 1024 * 1024;
+    static constexpr double COMPACT_DEAD_RATIO = 0.5;
+
+private:
+    struct Location {
+        uint32_t segment = 0;
+        uint64_t recordOffset = 0; // inicio de la cabecera
+        uint64_t payloadOffset = 0;
+        uint32_t payloadSize = 0;
+        uint64_t recordBytes = 0;  // cabecera + key + payload
+    };
+
+    struct Segment {
+        uint32_t id = 0;
+        std::filesystem::path path;
+        uint64_t size = 0;
+        uint64_t deadBytes = 0;
+        mutable std::shared_ptr<MappedFile> map; // solo segmentos cerrados
+    };
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_dir;
+    bool m_open = false;
+    std::unordered_map<std::string, Location> m_index;
+    std::unordered_map<uint32_t, Segment> m_segments;
+    uint32_t m_activeId = 0;
+    std::ofstream m_active;
+    mutable std::ifstream m_activeReader; // lecturas del segmento activo
+
+    std::filesystem::path segmentPath(uint32_t id) const;
+    bool openActiveLocked(uint32_t id);
+    bool appendLocked(uint8_t type, std::string const& key, uint8_t const* data, size_t size, Location* outLoc);
+    void scanSegmentLocked(Segment& seg);
+    std::shared_ptr<MappedFile> mapLocked(Segment const& seg, uint64_t needEnd) const;
+    bool readActiveLocked(Location const& loc, std::vector<uint8_t>& out) const;
+    void markDeadLocked(Location const& loc);
+    void migrateLooseFilesLocked();
+};
+
+} // namespace paimon::cache
@@ -0,0 +1,264 @@
+#include "ThumbnailAtlas.hpp"
+#include "../../../core/Settings.hpp"
+#include "../../../utils/Debug.hpp"
+#include "../../../utils/ImageResample.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace geode::prelude;
+
+namespace paimon::cache {
+
+namespace {
+constexpr int MAX_PAGE_SIZE = 2048;
+constexpr int PAGE_SIZE_STEP = 64;
+constexpr int TILE_PADDING = 2;
+// celdas de lista que tiene sentido tener en el atlas: la pagina visible (10)
+// y las dos de al lado. lo que pase de aqui recicla la pagina mas vieja
+constexpr int WORKING_SET_TILES = 30;
+// ancho visible de la miniatura en la celda (pt), con margen para el hover zoom
+constexpr float CELL_THUMB_WIDTH_PT = 215.0f;
+constexpr int MIN_TILE_WIDTH = 128;
+constexpr int MAX_TILE_WIDTH = 512;
+// rehacer una pagina es reducir de nuevo desde la textura que ya esta en RAM
+constexpr double PAGE_REBUILD_COST = 0.5;
+
+int maxTileWidth() {
+    return std::min(MAX_TILE_WIDTH, paimon::settings::quality::maxDimension());
+}
+
+int maxPages() {
+    return paimon::settings::quality::current() == paimon::settings::Quality::Low ? 1 : 2;
+}
+
+// el lado mas chico (multiplo de PAGE_SIZE_STEP) en el que entran los tiles
+// del working set repartidos en `pages` paginas
+int pageSizeFor(int tileW, int tileH, int pages) {
+    int ow = tileW + TILE_PADDING * 2;
+    int oh = tileH + TILE_PADDING * 2;
+    int perPage = (WORKING_SET_TILES + pages - 1) / pages;
+    for (int side = PAGE_SIZE_STEP; side < MAX_PAGE_SIZE; side += PAGE_SIZE_STEP) {
+        if (side >= ow && side >= oh && (side / ow) * (side / oh) >= perPage) return side;
+    }
+    return MAX_PAGE_SIZE;
+}
+} // namespace
+
+ThumbnailAtlas::Tile ThumbnailAtlas::makeTile(uint8_t const* rgba, int width, int height) {
+    Tile tile;
+    if (!rgba || width <= 0 || height <= 0) return tile;
+
+    int boxW = s_tileWidth.load(std::memory_order_relaxed);
+    int boxH = s_tileHeight.load(std::memory_order_relaxed);
+    if (boxW <= 0 || boxH <= 0) {
+        // el main thread aun no midio la pantalla
+        boxW = maxTileWidth();
+        boxH = boxW * 9 / 16;
+    }
+
+    float scale = std::min({1.0f,
+        static_cast<float>(boxW) / static_cast<float>(width),
+        static_cast<float>(boxH) / static_cast<float>(height)});
+    int tw = std::max(1, static_cast<int>(std::lround(width * scale)));
+    int th = std::max(1, static_cast<int>(std::lround(height * scale)));
+
+    if (tw == width && th == height) {
+        tile.pixels.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    } else {
+        tile.pixels = paimon::image::resampleAreaRGBA(rgba, width, height, tw, th);
+        if (tile.pixels.empty()) return tile;
+    }
+    tile.width = tw;
+    tile.height = th;
+    return tile;
+}
+
+ThumbnailAtlas::Tile ThumbnailAtlas::makeTileRGB565(uint8_t const* rgb565le, int width, int height) {
+    if (!rgb565le || width <= 0 || height <= 0) return {};
+    size_t count = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgba(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t v = static_cast<uint16_t>(rgb565le[i * 2] | (rgb565le[i * 2 + 1] << 8));
+        uint8_t r = static_cast<uint8_t>((v >> 11) & 0x1F);
+        uint8_t g = static_cast<uint8_t>((v >> 5) & 0x3F);
+        uint8_t b = static_cast<uint8_t>(v & 0x1F);
+        rgba[i * 4 + 0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        rgba[i * 4 + 1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        rgba[i * 4 + 2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        rgba[i * 4 + 3] = 255;
+    }
+    return makeTile(rgba.data(), width, height);
+}
+
+void ThumbnailAtlas::ensureConfigured() {
+    if (m_alloc) return;
+
+    // tamaño de tile = lo que ocupa la miniatura en pantalla, en pixeles reales
+    int tileW = maxTileWidth();
+    if (auto* director = CCDirector::sharedDirector()) {
+        auto win = director->getWinSize();
+        auto* view = director->getOpenGLView();
+        if (view && win.width > 0) {
+            float pixelsPerPoint = view->getFrameSize().width / win.width;
+            tileW = std::clamp(static_cast<int>(std::ceil(CELL_THUMB_WIDTH_PT * pixelsPerPoint)),
+                MIN_TILE_WIDTH, maxTileWidth());
+        }
+    }
+    s_tileWidth.store(tileW, std::memory_order_relaxed);
+    s_tileHeight.store(tileW * 9 / 16, std::memory_order_relaxed);
+
+    AtlasAllocator::Config config;
+    config.maxPages = maxPages();
+    config.pageSize = pageSizeFor(tileW, tileW * 9 / 16, config.maxPages);
+    config.padding = TILE_PADDING;
+    m_alloc.emplace(config);
+    PaimonDebug::log("[ThumbnailAtlas] tiles de {}x{} en hasta {} paginas de {}px",
+        tileW, tileW * 9 / 16, config.maxPages, config.pageSize);
+}
+
+bool ThumbnailAtlas::insert(int levelID, int version, Tile const& tile) {
+    if (!tile) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensureConfigured();
+
+    auto slot = m_alloc->insert(levelID, tile.pixels.data(), tile.width, tile.height, ++m_tick);
+    for (int evicted : m_alloc->takeEvicted()) m_versions.erase(evicted);
+    if (!slot) {
+        m_versions.erase(levelID);
+        uploadDirty();
+        return false;
+    }
+    m_versions[levelID] = version;
+    uploadDirty();
+    return true;
+}
+
+std::optional<ThumbnailAtlas::Region> ThumbnailAtlas::region(int levelID, int version) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_alloc) return std::nullopt;
+
+    auto ver = m_versions.find(levelID);
+    auto slot = m_alloc->find(levelID);
+    if (ver == m_versions.end() || ver->second != version || !slot ||
+        slot->page >= m_pages.size() || !m_pages[slot->page].texture ||
+        m_pages[slot->page].generation != slot->generation) {
+        m_regionMisses++;
+        return std::nullopt;
+    }
+
+    m_regionHits++;
+    m_alloc->touch(levelID, ++m_tick);
+    touchBudget(slot->page);
+    auto const& r = slot->rect;
+    return Region{
+        m_pages[slot->page].texture,
+        CC_RECT_PIXELS_TO_POINTS(CCRect(static_cast<float>(r.x), static_cast<float>(r.y),
+                                        static_cast<float>(r.w), static_cast<float>(r.h)))
+    };
+}
+
+void ThumbnailAtlas::remove(int levelID) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_versions.erase(levelID);
+    // solo contabilidad: la pagina se reescribe en el proximo insert del main thread
+    if (m_alloc) m_alloc->remove(levelID);
+}
+
+void ThumbnailAtlas::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // el proximo insert vuelve a medir la pantalla y el tier
+    m_alloc.reset();
+    m_pages.clear();
+    m_versions.clear();
+    if (m_budget >= 0) paimon::memory::MemoryBudget::get().forgetAll(m_budget);
+}
+
+void ThumbnailAtlas::setBudgetSource(paimon::memory::MemoryBudget::SourceId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = id;
+}
+
+bool ThumbnailAtlas::releasePage(uint32_t page) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_alloc || page >= m_pages.size() || !m_pages[page].texture) return true;
+    m_alloc->evictPage(page);
+    for (int evicted : m_alloc->takeEvicted()) m_versions.erase(evicted);
+    // la subida de reset suelta la textura y hace el forget()
+    uploadDirty();
+    return true;
+}
+
+void ThumbnailAtlas::touchBudget(uint32_t page) {
+    if (m_budget < 0 || !m_alloc) return;
+    size_t side = static_cast<size_t>(m_alloc->config().pageSize);
+    paimon::memory::MemoryBudget::get().touch(m_budget, std::to_string(page), side * side * 4, PAGE_REBUILD_COST);
+}
+
+void ThumbnailAtlas::abandonTextures() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& page : m_pages) {
+        (void)page.texture.take();
+    }
+    m_pages.clear();
+}
+
+ThumbnailAtlas::Stats ThumbnailAtlas::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    if (m_alloc) {
+        s.alloc = m_alloc->stats();
+        s.pageSize = m_alloc->config().pageSize;
+    }
+    s.pagesCreated = m_pagesCreated;
+    s.tileUploads = m_tileUploads;
+    s.regionHits = m_regionHits;
+    s.regionMisses = m_regionMisses;
+    s.tileWidth = s_tileWidth.load(std::memory_order_relaxed);
+    s.tileHeight = s_tileHeight.load(std::memory_order_relaxed);
+    return s;
+}
+
+void ThumbnailAtlas::uploadDirty() {
+    auto uploads = m_alloc->takeUploads();
+    if (m_pages.size() < m_alloc->pageCount()) m_pages.resize(m_alloc->pageCount());
+    int side = m_alloc->config().pageSize;
+
+    for (auto const& u : uploads) {
+        if (u.page >= m_pages.size()) continue;
+        auto& page = m_pages[u.page];
+        if (u.reset) {
+            // la generacion nueva va en otra textura; la vieja sigue viva
+            // mientras algun sprite la use
+            page.texture = nullptr;
+            page.generation = 0;
+            if (m_budget >= 0) paimon::memory::MemoryBudget::get().forget(m_budget, std::to_string(u.page));
+            continue;
+        }
+
+        uint32_t generation = m_alloc->pageGeneration(u.page);
+        if (!page.texture || page.generation != generation) {
+            // textura vacia: solo se muestrean los rects que ya se subieron
+            auto* tex = new CCTexture2D();
+            if (!tex->initWithData(nullptr, kCCTexture2DPixelFormat_RGBA8888,
+                                   side, side, CCSize(static_cast<float>(side), static_cast<float>(side)))) {
+                tex->release();
+                PaimonDebug::warn("[ThumbnailAtlas] fallo crear pagina {}", u.page);
+                continue;
+            }
+            tex->setAntiAliasTexParameters();
+            tex->autorelease();
+            page.texture = tex;
+            page.generation = generation;
+            m_pagesCreated++;
+            touchBudget(u.page);
+        }
+
+        // el tile ya trae su padding; tras subirlo no queda copia en CPU
+        ccGLBindTexture2D(page.texture->getName());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, u.rect.x, u.rect.y, u.rect.w, u.rect.h,
+                        GL_RGBA, GL_UNSIGNED_BYTE, u.pixels.data());
+        m_tileUploads++;
+    }
+}
+
+} // namespace paimon::cache
@@ -0,0 +1,111 @@
+#pragma once
+
+// ThumbnailAtlas.hpp — Paginas de atlas compartidas para las miniaturas de lista.
+// Cada celda de LevelCell tenia su propio CCTexture2D: una pagina de 10 celdas
+// eran 10 binds de textura. Aqui los thumbnails estaticos se copian reducidos
+// a tamaño de lista en unas pocas paginas RGBA (AtlasAllocator hace el
+// empaquetado) y la celda dibuja un sub-rect.
+//
+// Las paginas se miden para el working set de la lista (WORKING_SET_TILES),
+// no para toda la cache en RAM, y no tienen espejo en CPU: cada tile se sube
+// con glTexSubImage2D y se suelta. La textura completa del level sigue en la
+// cache de ThumbnailLoader porque la usan LevelInfoLayer, los popups y las
+// celdas con efectos de shader.
+//
+// - makeTile() corre en el worker de decode: reduce al tamaño de lista.
+// - insert()/region() son del main thread (suben a GL).
+// - remove() se puede llamar desde cualquier hilo; ThumbnailLoader lo llama
+//   cuando su LRU saca o invalida el level, asi el atlas sigue al LRU.
+//
+// Al reciclar o vaciar una pagina se crea otra textura para ella; los
+// sprites que ya apuntaban a la vieja la retienen y siguen viendose bien.
+//
+// Cada textura de pagina cuenta en MemoryBudget (key = indice de pagina):
+// si el presupuesto la saca, releasePage() la vacia y esas celdas vuelven a
+// la textura propia del level hasta el proximo insert.
+
+#include "AtlasAllocator.hpp"
+#include "../../../utils/MemoryBudget.hpp"
+#include <Geode/DefaultInclude.hpp>
+#include <Geode/utils/cocos.hpp>
+#include <cocos2d.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace paimon::cache {
+
+class ThumbnailAtlas {
+public:
+    struct Tile {
+        std::vector<uint8_t> pixels; // RGBA8888
+        int width = 0;
+        int height = 0;
+        explicit operator bool() const { return !pixels.empty(); }
+    };
+
+    struct Region {
+        geode::Ref<cocos2d::CCTexture2D> texture;
+        cocos2d::CCRect rect; // en puntos, listo para initWithTexture(tex, rect)
+    };
+
+    struct Stats {
+        AtlasAllocator::Stats alloc;
+        uint64_t pagesCreated = 0;  // texturas de pagina creadas/recreadas
+        uint64_t tileUploads = 0;   // glTexSubImage2D de un tile
+        uint64_t regionHits = 0;
+        uint64_t regionMisses = 0;
+        int tileWidth = 0;
+        int tileHeight = 0;
+        int pageSize = 0;
+    };
+
+    // reduce (o copia) al tamaño de tile de lista; fuera del main thread
+    static Tile makeTile(uint8_t const* rgba, int width, int height);
+    static Tile makeTileRGB565(uint8_t const* rgb565le, int width, int height);
+
+    // main thread
+    bool insert(int levelID, int version, Tile const& tile);
+    std::optional<Region> region(int levelID, int version);
+
+    void remove(int levelID);
+    void clear();
+    // cuenta de MemoryBudget para las texturas de pagina
+    void setBudgetSource(paimon::memory::MemoryBudget::SourceId id);
+    // callback del presupuesto (main thread): vacia la pagina y suelta su textura
+    bool releasePage(uint32_t page);
+    // cierre del proceso: suelta las paginas sin release() (ver ~ThumbnailLoader)
+    void abandonTextures();
+
+    Stats stats() const;
+
+private:
+    struct Page {
+        geode::Ref<cocos2d::CCTexture2D> texture;
+        uint32_t generation = 0;
+    };
+
+    void ensureConfigured();
+    void uploadDirty();
+    void touchBudget(uint32_t page);
+
+    mutable std::mutex m_mutex;
+    std::optional<AtlasAllocator> m_alloc;
+    std::vector<Page> m_pages;
+    std::unordered_map<int, int> m_versions;
+    uint64_t m_pagesCreated = 0;
+    uint64_t m_tileUploads = 0;
+    uint64_t m_tick = 0;  // orden de uso de las paginas (insert/region)
+    uint64_t m_regionHits = 0;
+    uint64_t m_regionMisses = 0;
+    paimon::memory::MemoryBudget::SourceId m_budget = -1;
+
+    // tamaño de tile: lo fija el main thread segun la pantalla; los workers lo leen
+    static inline std::atomic<int> s_tileWidth{0};
+    static inline std::atomic<int> s_tileHeight{0};
+};
+
+} // namespace paimon::cache
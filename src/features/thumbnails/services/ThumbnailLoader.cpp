@@ -2,12 +2,15 @@
 #include "ThumbnailTransportClient.hpp"
 #include "LocalThumbs.hpp"
 #include "LevelColors.hpp"
+#include "DecodedThumbCache.hpp"
 #include "../../../core/QualityConfig.hpp"
 #include "../../../utils/Constants.hpp"
 #include "../../../utils/HttpClient.hpp"
+#include "../../../framework/net/DownloadGovernor.hpp"
 #include "../../../utils/DominantColors.hpp"
 #include "../../../utils/GIFDecoder.hpp"
 #include "../../../utils/Debug.hpp"
+#include "../../../utils/TextureUploadQueue.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "../../../utils/stb_image.h"
 #include <Geode/loader/Log.hpp>
@@ -19,7 +22,6 @@
 #include <fstream>
 #include <atomic>
 #include <thread>
-#include <future>
 #include <cmath>
 #include <algorithm>
 #include <tuple>
@@ -31,7 +33,17 @@ using namespace geode::prelude;
 
 size_t ThumbnailLoader::estimateTextureBytes(cocos2d::CCTexture2D* tex) {
     if (!tex) return 0;
-    return static_cast<size_t>(tex->getPixelsWide()) * static_cast<size_t>(tex->getPixelsHigh()) * 4;
+    size_t bpp = 4;
+    switch (tex->getPixelFormat()) {
+        case kCCTexture2DPixelFormat_RGB565:
+        case kCCTexture2DPixelFormat_RGBA4444:
+        case kCCTexture2DPixelFormat_RGB5A1:
+            bpp = 2;
+            break;
+        default:
+            break;
+    }
+    return static_cast<size_t>(tex->getPixelsWide()) * static_cast<size_t>(tex->getPixelsHigh()) * bpp;
 }
 
 ThumbnailLoader& ThumbnailLoader::get() {
@@ -49,13 +61,40 @@ ThumbnailLoader::ThumbnailLoader() {
     m_qualityTag = paimon::settings::quality::tag();
     log::info("[ThumbnailLoader] constructor: maxConcurrent={} quality={}", m_maxConcurrentTasks, m_qualityTag);
     initDiskCache();
+    registerBudgetSources();
+}
+
+void ThumbnailLoader::registerBudgetSources() {
+    // los callbacks corren en main thread cuando el presupuesto comun se pasa
+    auto& budget = paimon::memory::MemoryBudget::get();
+    m_ramBudget = budget.registerSource("thumbnails", [this](std::string const& k) {
+        int key = std::atoi(k.c_str());
+        if (m_textureCache.erase(key)) {
+            if (key > 0) m_atlas.remove(key);
+            m_stats.ramEvictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    });
+    m_urlBudget = budget.registerSource("gallery", [this](std::string const& url) {
+        if (m_urlTextureCache.erase(url)) {
+            m_stats.ramEvictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    });
+    m_atlas.setBudgetSource(budget.registerSource("atlas", [this](std::string const& k) {
+        return m_atlas.releasePage(static_cast<uint32_t>(std::atoi(k.c_str())));
+    }));
+    // la lectura de memoria del sistema va al lane de mantenimiento, no al main thread
+    budget.setSampleExecutor([this](std::function<void()> job) {
+        return submitMaintenance(std::move(job));
+    });
 }
 
 ThumbnailLoader::~ThumbnailLoader() {
     log::info("[ThumbnailLoader] destructor: shutting down");
     // le aviso a los threads de background que paren
     m_shuttingDown = true;
-    waitBackgroundWorkers();
+    m_workers.shutdown();
 
     // flush manifest antes de destruir
     m_manifest.flush();
@@ -63,34 +102,41 @@ ThumbnailLoader::~ThumbnailLoader() {
     // durante el cierre del proceso (destructores estaticos) el orden de destruccion
     // es indefinido: Cocos2d, el autorelease pool y otros singletons pueden ya estar muertos.
     // geode::Ref llama release() al destruirse. Usamos take() para sacar los punteros sin release().
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    for (auto& [id, entry] : m_textureCache) {
+    m_textureCache.forEach([](int, CacheEntry& entry) {
         (void)entry.texture.take();
-    }
+    });
     m_textureCache.clear();
-    for (auto& [url, entry] : m_urlTextureCache) {
+    m_urlTextureCache.forEach([](std::string const&, CacheEntry& entry) {
         (void)entry.texture.take();
-    }
+    });
     m_urlTextureCache.clear();
+    m_atlas.abandonTextures();
 
     // Limpiar tasks y sus callbacks ANTES de que la destruccion implicita de miembros
     // los destruya. Las callbacks capturan WeakRef<PaimonLevelCell> cuyo destructor
     // interactua con CCPoolManager — que puede ya estar muerto a estas alturas.
-    for (auto& [id, task] : m_tasks) {
-        if (task) task->callbacks.clear();
-    }
-    m_tasks.clear();
-    for (auto& [url, task] : m_urlTasks) {
-        if (task) task->callbacks.clear();
+    m_tasks.forEachShard([](auto& tasks) {
+        for (auto& [id, task] : tasks) {
+            if (task) task->callbacks.clear();
+        }
+        tasks.clear();
+    });
+    {
+        std::lock_guard<std::mutex> lock(m_urlMutex);
+        for (auto& [url, task] : m_urlTasks) {
+            if (task) task->callbacks.clear();
+        }
+        m_urlTasks.clear();
     }
-    m_urlTasks.clear();
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
     m_invalidationListeners.clear();
 }
 
 void ThumbnailLoader::initDiskCache() {
-    // hilo de I/O de disco — no migrable a WebTask (no es peticion web)
-    spawnBackground([this]() {
-        geode::utils::thread::setName("ThumbnailLoader Cache Init");
+    // I/O de disco — no migrable a WebTask (no es peticion web).
+    // va por delante de cualquier lectura ya encolada
+    spawnBackground(Lane::Disk, INIT_PRIORITY, [this]() {
+        m_diskIndexReady.store(false, std::memory_order_release);
 
         // --- legacy migration: rename old "cache/" to quality dir if needed ---
         paimon::quality::migrateLegacyCache();
@@ -110,6 +156,12 @@ void ThumbnailLoader::initDiskCache() {
             return;
         }
 
+        // --- abrir el pack (importa los <id>.png / .ptd sueltos del layout anterior) ---
+        if (!m_pack.open(path)) {
+            log::warn("[ThumbnailLoader] no se pudo abrir el pack, se usan archivos sueltos");
+        }
+        m_manifest.attachStore(&m_pack);
+
         // --- cargar manifest persistente (o migrar desde directorio) ---
         {
             std::lock_guard<std::recursive_mutex> lock(m_manifest.mutex);
@@ -127,27 +179,31 @@ void ThumbnailLoader::initDiskCache() {
             m_diskCache = std::move(legacyKeys);
         }
 
+        m_diskIndexReady.store(true, std::memory_order_release);
+
         // flush si el manifest se creo por migracion
         m_manifest.flush();
 
-        PaimonDebug::log("[ThumbnailLoader] cache de disco lista. entradas en manifest: {}",
-            m_manifest.entryCount());
+        auto ps = m_pack.stats();
+        PaimonDebug::log("[ThumbnailLoader] cache de disco lista. entradas en manifest: {}, pack: {} segmentos {} entradas",
+            m_manifest.entryCount(), ps.segments, ps.entries);
+        scheduleCompaction();
     });
 }
 
-void ThumbnailLoader::pruneFailedCacheLocked(std::chrono::steady_clock::time_point now) {
-    if (m_lastFailedCachePrune != std::chrono::steady_clock::time_point::min() &&
-        now - m_lastFailedCachePrune < FAILED_CACHE_PRUNE_INTERVAL) {
+void ThumbnailLoader::pruneFailedCache(std::chrono::steady_clock::time_point now) {
+    auto nowTicks = now.time_since_epoch().count();
+    auto last = m_lastFailedCachePrune.load(std::memory_order_relaxed);
+    if (last != 0 && nowTicks - last < std::chrono::steady_clock::duration(FAILED_CACHE_PRUNE_INTERVAL).count()) {
         return;
     }
-    m_lastFailedCachePrune = now;
-    for (auto it = m_failedCache.begin(); it != m_failedCache.end();) {
-        if (now - it->second >= FAILED_CACHE_TTL) {
-            it = m_failedCache.erase(it);
-        } else {
-            ++it;
-        }
+    // un solo hilo poda por intervalo
+    if (!m_lastFailedCachePrune.compare_exchange_strong(last, nowTicks, std::memory_order_relaxed)) {
+        return;
     }
+    m_failedCache.eraseIf([&](int, std::chrono::steady_clock::time_point const& failedAt) {
+        return now - failedAt >= FAILED_CACHE_TTL;
+    });
 }
 
 void ThumbnailLoader::pruneDiskCache() {
@@ -172,6 +228,20 @@ void ThumbnailLoader::pruneDiskCache() {
 
     PaimonDebug::log("[ThumbnailLoader] poda cache disco completada. archivos borrados: {}, bytes liberados: {}",
         pruneResult.filesToDelete.size(), pruneResult.freedBytes);
+
+    flushManifest();
+    // la poda solo deja tombstones en el pack; el espacio se recupera aca
+    scheduleCompaction();
+}
+
+void ThumbnailLoader::scheduleCompaction() {
+    if (!m_pack.needsCompaction()) return;
+    spawnBackground(Lane::Maintenance, MAINTENANCE_PRIORITY, [this]() {
+        auto reclaimed = m_pack.compact();
+        if (reclaimed > 0) {
+            PaimonDebug::log("[ThumbnailLoader] pack compactado, {} bytes recuperados", reclaimed);
+        }
+    });
 }
 
 void ThumbnailLoader::setMaxConcurrentTasks(int max) {
@@ -181,38 +251,134 @@ void ThumbnailLoader::setMaxConcurrentTasks(int max) {
 #else
     m_maxConcurrentTasks = std::max(1, std::min(64, max));
 #endif
+    // el setting es ahora el punto de partida; cada host se adapta desde ahi
+    paimon::net::DownloadGovernor::get().setInitialWindow(m_maxConcurrentTasks);
+}
+
+int ThumbnailLoader::taskLimit() const {
+    // cada tarea puede acabar bajando algo: tiene que haber suficientes en marcha
+    // para llenar las ventanas de descarga, pero nunca menos que el piso (hits de
+    // disco) ni mas que lo que aguanta la plataforma
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+    constexpr int platformMax = 24;
+#else
+    constexpr int platformMax = 64;
+#endif
+    int windows = paimon::net::DownloadGovernor::get().totalWindow();
+    return std::clamp(windows, std::min(m_maxConcurrentTasks, platformMax), platformMax);
+}
+
+int ThumbnailLoader::urlTaskLimit(std::string const& url) const {
+    // las de gallery casi siempre bajan: su tope es la ventana de su host
+    return paimon::net::DownloadGovernor::get().window(paimon::net::DownloadGovernor::hostOf(url));
 }
 
 bool ThumbnailLoader::isLoaded(int levelID, bool isGif) const {
     int key = isGif ? -levelID : levelID;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    return m_textureCache.find(key) != m_textureCache.end();
+    return m_textureCache.contains(key);
 }
 
 bool ThumbnailLoader::isPending(int levelID, bool isGif) const {
     int key = isGif ? -levelID : levelID;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    return m_tasks.find(key) != m_tasks.end();
+    return m_tasks.contains(key);
 }
 
 bool ThumbnailLoader::isFailed(int levelID, bool isGif) const {
     int key = isGif ? -levelID : levelID;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    auto it = m_failedCache.find(key);
-    if (it == m_failedCache.end()) return false;
+    auto failedAt = m_failedCache.find(key);
+    if (!failedAt) return false;
     // expirado = no fallido
-    return (std::chrono::steady_clock::now() - it->second) < FAILED_CACHE_TTL;
+    return (std::chrono::steady_clock::now() - *failedAt) < FAILED_CACHE_TTL;
 }
 
 bool ThumbnailLoader::hasGIFData(int levelID) const {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    return m_gifLevels.find(levelID) != m_gifLevels.end();
+    return m_gifLevels.contains(levelID);
 }
 
 std::filesystem::path ThumbnailLoader::getCachePath(int levelID, bool isGif) {
     return paimon::quality::thumbCachePath(levelID, isGif);
 }
 
+std::vector<uint8_t> ThumbnailLoader::readCachedSource(int levelID, bool isGif) {
+    std::vector<uint8_t> data;
+    if (!readSource(levelID, isGif, data)) data.clear();
+    return data;
+}
+
+bool ThumbnailLoader::storeCachedSource(int levelID, std::vector<uint8_t> const& data) {
+    if (levelID <= 0 || data.empty()) return false;
+    bool isGif = GIFDecoder::isGIF(data.data(), data.size());
+    return persistSource(levelID, isGif, data);
+}
+
+std::vector<int> ThumbnailLoader::cachedLevelIDs() {
+    std::lock_guard<std::recursive_mutex> lock(m_diskMutex);
+    std::vector<int> ids;
+    ids.reserve(m_diskCache.size());
+    for (int key : m_diskCache) {
+        if (key > 0) ids.push_back(key);
+    }
+    return ids;
+}
+
+bool ThumbnailLoader::readSource(int realID, bool isGif, std::vector<uint8_t>& out) {
+    auto name = paimon::quality::thumbFilename(realID, isGif);
+    if (!isGif) {
+        if (auto blob = m_pack.read(name)) {
+            out.assign(blob.data, blob.data + blob.size);
+            return true;
+        }
+    }
+
+    // GIF (AnimatedGIFSprite los abre por ruta) o pack no disponible
+    std::ifstream file(paimon::quality::cacheDir() / name, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    size_t size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    out.resize(size);
+    file.read(reinterpret_cast<char*>(out.data()), size);
+    return static_cast<bool>(file) && !out.empty();
+}
+
+bool ThumbnailLoader::persistSource(int realID, bool isGif, std::vector<uint8_t> const& data, std::string const& validator) {
+    auto name = paimon::quality::thumbFilename(realID, isGif);
+    // la variante decodificada anterior ya no corresponde a la nueva fuente
+    m_pack.remove(paimon::cache::decoded::filenameFor(name));
+
+    bool stored = !isGif && m_pack.put(name, data.data(), data.size());
+    if (!stored) {
+        auto path = paimon::quality::cacheDir() / name;
+        std::error_code dirEc;
+        std::filesystem::create_directories(path.parent_path(), dirEc);
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            log::error("[ThumbnailLoader] no se pudo abrir archivo para guardar en disco");
+            return false;
+        }
+        file.write(reinterpret_cast<char const*>(data.data()), data.size());
+    }
+
+    // actualizar manifest
+    paimon::cache::DiskManifestEntry me;
+    me.filename = name;
+    me.levelID = realID;
+    me.format = isGif ? "gif" : "png";
+    me.byteSize = data.size();
+    me.isGif = isGif;
+    me.qualityTag = m_qualityTag;
+    me.revisionToken = validator;
+    me.touchAccess();
+    me.touchValidated();
+    {
+        std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+        m_manifest.upsert(realID, isGif, std::move(me));
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(m_diskMutex);
+    m_diskCache.insert(isGif ? -realID : realID);
+    return true;
+}
+
 void ThumbnailLoader::requestLoad(int levelID, std::string fileName, LoadCallback callback, int priority, bool isGif) {
     // detect quality tier change lazily
     detectQualityChange();
@@ -220,41 +386,25 @@ void ThumbnailLoader::requestLoad(int levelID, std::string fileName, LoadCallbac
     int key = isGif ? -levelID : levelID;
     log::info("[ThumbnailLoader] requestLoad: levelID={} key={} priority={} isGif={}", levelID, key, priority, isGif);
     
-    // lock protege m_textureCache, m_failedCache y m_tasks de carreras con finishTask
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
     auto now = std::chrono::steady_clock::now();
-    pruneFailedCacheLocked(now);
+    pruneFailedCache(now);
 
-    // 1. reviso cache en RAM
-    auto it = m_textureCache.find(key);
-    if (it != m_textureCache.end()) {
+    // 1. reviso cache en RAM (lock compartido del shard)
+    if (auto cached = m_textureCache.get(key)) {
         // valido version de invalidacion: si cambio, descarto la entrada vieja
-        int cachedVer = it->second.version;
-        int currentVer = getVersionForKeyLocked(key);
+        int cachedVer = cached->version;
+        int currentVer = getVersionForKey(key);
         if (cachedVer != currentVer) {
             log::info("[ThumbnailLoader] requestLoad: RAM cache stale for key={} cachedVer={} currentVer={}", key, cachedVer, currentVer);
             m_stats.staleHits.fetch_add(1, std::memory_order_relaxed);
             // entrada stale: la version no coincide, evicto y sigo como cache miss
-            if (it->second.texture) {
-                size_t bytes = estimateTextureBytes(it->second.texture);
-                if (m_textureCacheBytes >= bytes) m_textureCacheBytes -= bytes;
-                else m_textureCacheBytes = 0;
-            }
-            m_textureCache.erase(it);
-            auto lruIt = m_lruMap.find(key);
-            if (lruIt != m_lruMap.end()) {
-                m_lruOrder.erase(lruIt->second);
-                m_lruMap.erase(lruIt);
+            if (m_textureCache.eraseIf(key, [cachedVer](CacheEntry const& e) { return e.version == cachedVer; })) {
+                paimon::memory::MemoryBudget::get().forget(m_ramBudget, std::to_string(key));
             }
         } else {
             m_stats.ramHits.fetch_add(1, std::memory_order_relaxed);
-            // actualizo la LRU en O(1)
-            auto lruIt = m_lruMap.find(key);
-            if (lruIt != m_lruMap.end()) {
-                m_lruOrder.erase(lruIt->second);
-            }
-            m_lruOrder.push_back(key);
-            m_lruMap[key] = std::prev(m_lruOrder.end());
+            paimon::memory::MemoryBudget::get().touch(m_ramBudget, std::to_string(key),
+                estimateTextureBytes(cached->texture), RAM_REBUILD_COST);
 
             // touch en manifest
             {
@@ -266,7 +416,7 @@ void ThumbnailLoader::requestLoad(int levelID, std::string fileName, LoadCallbac
             
             // fuerzo callback asincrono para no trabar la UI
             log::debug("[ThumbnailLoader] requestLoad: RAM cache hit for key={}", key);
-            auto tex = it->second.texture;
+            auto tex = cached->texture;
             Loader::get()->queueInMainThread([callback, tex]() {
                 if (callback) callback(tex, true);
             });
@@ -276,9 +426,8 @@ void ThumbnailLoader::requestLoad(int levelID, std::string fileName, LoadCallbac
     m_stats.ramMisses.fetch_add(1, std::memory_order_relaxed);
 
     // 2. miro el cache de fallos (con TTL)
-    auto failIt = m_failedCache.find(key);
-    if (failIt != m_failedCache.end()) {
-        if (now - failIt->second < FAILED_CACHE_TTL) {
+    if (auto failedAt = m_failedCache.find(key)) {
+        if (now - *failedAt < FAILED_CACHE_TTL) {
             log::debug("[ThumbnailLoader] requestLoad: failed cache hit for key={}", key);
             Loader::get()->queueInMainThread([callback]() {
                 if (callback) callback(nullptr, false);
@@ -287,37 +436,51 @@ void ThumbnailLoader::requestLoad(int levelID, std::string fileName, LoadCallbac
         }
         // TTL expirado, permito reintento
         log::debug("[ThumbnailLoader] requestLoad: failed cache expired for key={}, retrying", key);
-        m_failedCache.erase(failIt);
+        m_failedCache.erase(key);
     }
 
-    // 3. reviso si ya hay una tarea en cola
-    auto taskIt = m_tasks.find(key);
-    if (taskIt != m_tasks.end()) {
-        log::debug("[ThumbnailLoader] requestLoad: task already queued for key={}, appending callback", key);
-        // solo agrego el callback a la tarea existente
-        if (callback) taskIt->second->callbacks.push_back(callback);
-        // si viene con mas prioridad se la subo
-        if (priority > taskIt->second->priority) {
-            taskIt->second->priority = priority;
-            if (!taskIt->second->running) {
-                m_priorityQueue.emplace(priority, key);
+    // 3/4. tarea existente o nueva, con el shard de la key bloqueado
+    bool created = false;
+    bool requeue = false;
+    m_tasks.update(key, [&](auto& tasks) {
+        auto taskIt = tasks.find(key);
+        // una cancelada que sigue corriendo ya no va a notificar: la reemplazo
+        if (taskIt != tasks.end() && !taskIt->second->cancelled) {
+            log::debug("[ThumbnailLoader] requestLoad: task already queued for key={}, appending callback", key);
+            auto& task = taskIt->second;
+            // solo agrego el callback a la tarea existente
+            if (callback) task->callbacks.push_back(callback);
+            // si viene con mas prioridad se la subo
+            if (priority > task->priority) {
+                task->priority = priority;
+                requeue = !task->running;
             }
+            return;
         }
-        return;
-    }
 
-    // 4. creo una tarea nueva
-    log::info("[ThumbnailLoader] requestLoad: creating new task for key={} priority={}", key, priority);
-    auto task = std::make_shared<Task>();
-    task->levelID = key;
-    task->fileName = fileName;
-    task->priority = priority;
-    if (callback) task->callbacks.push_back(callback);
+        log::info("[ThumbnailLoader] requestLoad: creating new task for key={} priority={}", key, priority);
+        auto task = std::make_shared<Task>();
+        task->levelID = key;
+        task->fileName = fileName;
+        task->priority = priority;
+        if (callback) task->callbacks.push_back(callback);
+        tasks[key] = std::move(task);
+        created = true;
+    });
+    if (!created && !requeue) return;
 
-    m_tasks[key] = task;
-    m_priorityQueue.emplace(priority, key);
-    
-    processQueue();
+    // el shard ya esta libre: ahora si la cola (orden m_queueMutex -> shard)
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (created) {
+        m_priorityQueue.push(key, priority);
+        processQueue();
+        return;
+    }
+    // subida de prioridad: muevo la entrada existente. si ya no esta en el
+    // heap es que arranco entre medio y no hay nada que mover
+    if (auto queued = m_priorityQueue.priorityOf(key); queued && *queued < priority) {
+        m_priorityQueue.update(key, priority);
+    }
 }
 
 void ThumbnailLoader::prefetchLevelAssets(int levelID, int priority) {
@@ -335,26 +498,88 @@ void ThumbnailLoader::prefetchLevels(std::vector<int> const& levelIDs, int prior
 
     std::unordered_set<int> seen;
     seen.reserve(levelIDs.size());
+    std::vector<int> unique;
+    unique.reserve(levelIDs.size());
 
     for (int levelID : levelIDs) {
         if (levelID <= 0 || !seen.insert(levelID).second) {
             continue;
         }
+        unique.push_back(levelID);
+    }
 
+    // primero la metadata de toda la pagina en una ida y vuelta; las tareas
+    // salen ya (las que estan en disco no necesitan manifest) y las que
+    // lleguen a descargar esperan al lookup dentro de HttpClient.
+    // se llama en cada tick de scroll: no cuenta como pagina
+    resolveManifestBatch(unique, false);
+    for (int levelID : unique) {
         this->prefetchLevelAssets(levelID, priority);
     }
 }
 
+void ThumbnailLoader::resolveManifestBatch(std::vector<int> const& levelIDs, bool countAsPage) {
+    if (levelIDs.empty()) return;
+
+    auto plan = HttpClient::get().planManifestLookup(levelIDs);
+    if (countAsPage) {
+        m_stats.manifestPages.fetch_add(1, std::memory_order_relaxed);
+        m_stats.manifestPageLevels.fetch_add(levelIDs.size(), std::memory_order_relaxed);
+        m_stats.manifestHits.fetch_add(plan.hits, std::memory_order_relaxed);
+    }
+
+    if (plan.missing.empty()) {
+        if (countAsPage) {
+            PaimonDebug::log("[ThumbnailLoader] manifest pagina: {} levels, {} con CDN, {} sin entrada, {} en vuelo, sin lookup",
+                levelIDs.size(), plan.hits, plan.knownMisses, plan.inFlight);
+        }
+        return;
+    }
+
+    if (countAsPage) m_stats.manifestLookups.fetch_add(plan.missing.size(), std::memory_order_relaxed);
+    size_t pageLevels = levelIDs.size();
+    size_t hits = plan.hits;
+    auto missing = plan.missing;
+    HttpClient::get().fetchManifest(plan.missing, [this, pageLevels, hits, missing, countAsPage](bool success) {
+        size_t resolved = 0;
+        if (success) {
+            for (int id : missing) {
+                if (HttpClient::get().getManifestEntry(id)) resolved++;
+            }
+        }
+        if (!countAsPage) {
+            PaimonDebug::log("[ThumbnailLoader] manifest lookup: {} ids -> {} resueltos{}", missing.size(), resolved, success ? "" : " (fallo)");
+            return;
+        }
+        m_stats.manifestResolved.fetch_add(resolved, std::memory_order_relaxed);
+        double ratio = pageLevels ? 100.0 * static_cast<double>(hits + resolved) / static_cast<double>(pageLevels) : 0.0;
+        PaimonDebug::log("[ThumbnailLoader] manifest pagina: {} levels, {} ya con CDN, lookup de {} -> {} resueltos{}, hit ratio {:.0f}% (sesion {:.0f}%)",
+            pageLevels, hits, missing.size(), resolved, success ? "" : " (fallo)", ratio,
+            m_stats.manifestHitRatio() * 100.0);
+    });
+}
+
 void ThumbnailLoader::cancelLoad(int levelID, bool isGif) {
     int key = isGif ? -levelID : levelID;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    auto it = m_tasks.find(key);
-    if (it != m_tasks.end()) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_tasks.update(key, [&](auto& tasks) {
+        auto it = tasks.find(key);
+        if (it == tasks.end()) return;
         log::info("[ThumbnailLoader] cancelLoad: key={}", key);
         it->second->cancelled = true;
-        // si ya va corriendo no la paro, solo ignoro el resultado
-        // si esta en cola con marcarla cancelada me sobra
-    }
+        // si ya va corriendo no la paro, solo ignoro el resultado.
+        // si estaba en cola la saco de la tabla y del heap: no queda nada que saltar
+        if (!it->second->running) tasks.erase(it);
+    });
+    m_priorityQueue.remove(key);
+}
+
+void ThumbnailLoader::updatePriority(int levelID, int priority, bool isGif) {
+    int key = isGif ? -levelID : levelID;
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (!m_priorityQueue.update(key, priority)) return;
+    // la prioridad de la tarea tambien decide su orden en la lane de disco
+    if (auto task = m_tasks.find(key)) (*task)->priority = priority;
 }
 
 void ThumbnailLoader::processQueue() {
@@ -366,41 +591,13 @@ void ThumbnailLoader::processQueue() {
         return;
     }
 
-    // busco el mejor candidato para correr ahora (multimap ya esta ordenado desc)
-    while (m_activeTaskCount < m_maxConcurrentTasks && !m_priorityQueue.empty()) {
-        auto bestIt = m_priorityQueue.end();
-
-        for (auto it = m_priorityQueue.begin(); it != m_priorityQueue.end(); ++it) {
-            int levelID = it->second;
-            auto taskIt = m_tasks.find(levelID);
-            if (taskIt == m_tasks.end() || !taskIt->second) {
-                continue; // tarea huerfana, se limpiara
-            }
-            if (taskIt->second->cancelled) continue;
-
-            bestIt = it;
-            break; // el primero valido es el de mayor prioridad
-        }
-
-        if (bestIt == m_priorityQueue.end()) {
-            // todas canceladas u huerfanas, limpio
-            m_priorityQueue.clear();
-            for (auto it = m_tasks.begin(); it != m_tasks.end();) {
-                if (it->second->cancelled && !it->second->running) {
-                    it = m_tasks.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-            break;
-        }
-
-        int levelID = bestIt->second;
-        m_priorityQueue.erase(bestIt);
-        
-        auto task = m_tasks[levelID];
-        if (task->cancelled) continue;
-
+    // el heap solo tiene tareas en cola, una vez cada una: el tope es el mejor candidato
+    int limit = taskLimit();
+    while (m_activeTaskCount < limit && !m_priorityQueue.empty()) {
+        int key = *m_priorityQueue.pop();
+        auto task = m_tasks.find(key).value_or(nullptr);
+        // defensivo: clearPendingQueue/cleanup pueden haberla dado de baja
+        if (!task || task->cancelled || task->running) continue;
         startTask(task);
     }
 }
@@ -412,15 +609,14 @@ void ThumbnailLoader::startTask(std::shared_ptr<Task> task) {
 
     // siempre tiro de disco primero para evitar carreras con initDiskCache
     // workerLoadFromDisk mira el FS y si no encuentra descarga
-    // hilo de I/O de disco + decodificacion CPU — no migrable a WebTask
-    spawnBackground([this, task]() {
+    // I/O de disco + decodificacion CPU — no migrable a WebTask
+    spawnBackground(Lane::Disk, task->priority, [this, task]() {
         if (m_shuttingDown.load(std::memory_order_relaxed)) {
             Loader::get()->queueInMainThread([this, task]() {
                 finishTask(task, nullptr, false);
             });
             return;
         }
-        geode::utils::thread::setName("ThumbnailLoader Disk Worker");
         workerLoadFromDisk(task);
     });
 }
@@ -446,43 +642,45 @@ void ThumbnailLoader::workerLoadFromDisk(std::shared_ptr<Task> task) {
         if (!isGif) gifInDiskIndex = m_diskCache.count(-realID) > 0;
     }
 
-    auto path = getCachePath(realID, isGif);
+    bool pathIsGif = isGif;
 
     // fallback: si el request estatico no esta en el indice, probar con GIF
     if (!inDiskIndex && !isGif && gifInDiskIndex) {
-        path = getCachePath(realID, true);
+        pathIsGif = true;
         inDiskIndex = true;
     }
-    // si el indice no lo tiene pero el FS si (race con initDiskCache), verificar FS
-    if (!inDiskIndex) {
+    // si el indice todavia no esta hidratado (race con initDiskCache), verificar pack/FS.
+    // ya hidratado, un miss del indice es un miss real y no toca el disco
+    if (!inDiskIndex && !m_diskIndexReady.load(std::memory_order_acquire)) {
         std::error_code ec;
-        if (std::filesystem::exists(path, ec)) {
+        if ((!isGif && m_pack.contains(paimon::quality::thumbFilename(realID, false))) ||
+            std::filesystem::exists(getCachePath(realID, isGif), ec)) {
+            inDiskIndex = true;
+        } else if (!isGif && std::filesystem::exists(getCachePath(realID, true), ec)) {
+            pathIsGif = true;
             inDiskIndex = true;
-        } else if (!isGif) {
-            auto gifPath = getCachePath(realID, true);
-            if (std::filesystem::exists(gifPath, ec)) {
-                path = gifPath;
-                inDiskIndex = true;
-            }
         }
     }
 
+    // lo de disco se sirve siempre; si paso la ventana se revalida por detras
+    if (inDiskIndex) maybeRevalidate(realID, pathIsGif);
+
+    // camino rapido: variante pre-decodificada mapeada, sin leer ni decodificar la fuente
+    if (inDiskIndex && tryLoadDecodedVariant(task, realID, pathIsGif)) {
+        return;
+    }
+
     std::vector<uint8_t> data;
     bool success = false;
+    bool fromCache = false;
 
     if (inDiskIndex) {
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (file.is_open()) {
-            size_t size = file.tellg();
-            file.seekg(0, std::ios::beg);
-            data.resize(size);
-            file.read(reinterpret_cast<char*>(data.data()), size);
-            success = static_cast<bool>(file);
-            if (success) {
-                PaimonDebug::log("[ThumbnailLoader] cargados {} bytes del disco pal nivel {}{}", size, realID, isGif ? " (gif)" : "");
-            }
+        success = readSource(realID, pathIsGif, data);
+        fromCache = success;
+        if (success) {
+            PaimonDebug::log("[ThumbnailLoader] cargados {} bytes del disco pal nivel {}{}", data.size(), realID, isGif ? " (gif)" : "");
         } else {
-            PaimonDebug::warn("[ThumbnailLoader] no se pudo abrir archivo pal nivel {}", realID);
+            PaimonDebug::warn("[ThumbnailLoader] no se pudo leer la fuente cacheada pal nivel {}", realID);
         }
     }
 
@@ -520,17 +718,20 @@ void ThumbnailLoader::workerLoadFromDisk(std::shared_ptr<Task> task) {
                                     rgbaData[i * 4 + 3] = 255;
                                 }
                                 
-                                if (!LevelColors::get().getPair(realID)) {
-                                    LevelColors::get().extractFromRawData(realID, rgbaData.data(), rgbW, rgbH, true);
-                                }
-                                
                                 int finalW = static_cast<int>(rgbW);
                                 int finalH = static_cast<int>(rgbH);
-                                Loader::get()->queueInMainThread([this, task, rgbaData, finalW, finalH, realID]() {
+                                applyQualityDownscale(rgbaData, finalW, finalH);
+
+                                if (!LevelColors::get().getPair(realID)) {
+                                    LevelColors::get().extractFromRawData(realID, rgbaData.data(), finalW, finalH, true);
+                                }
+                                auto tile = makeAtlasTile(task, rgbaData.data(), finalW, finalH);
+                                paimon::image::TextureUploadQueue::get().post(task->priority, [this, task, rgbaData = std::move(rgbaData), tile = std::move(tile), finalW, finalH, realID]() {
                                     if (task->cancelled) { finishTask(task, nullptr, false); return; }
                                     auto tex = new CCTexture2D();
                                     if (tex->initWithData(rgbaData.data(), kCCTexture2DPixelFormat_RGBA8888, finalW, finalH, CCSize((float)finalW, (float)finalH))) {
                                         tex->autorelease();
+                                        insertAtlasTile(realID, tile);
                                         PaimonDebug::log("[ThumbnailLoader] textura cargada desde LocalThumbs .rgb pal nivel {}", realID);
                                         finishTask(task, tex, true);
                                     } else {
@@ -565,21 +766,26 @@ void ThumbnailLoader::workerLoadFromDisk(std::shared_ptr<Task> task) {
 
         if (decoded.success && !decoded.pixels.empty()) {
             if (decoded.isGif) {
-                { std::lock_guard<std::recursive_mutex> lock(m_queueMutex); m_gifLevels.insert(realID); }
+                m_gifLevels.insert(realID);
+            }
+            // primera carga desde cache: dejo la variante decodificada para la proxima
+            if (fromCache) {
+                storeDecodedVariant(realID, pathIsGif, decoded, data.size());
             }
 
             auto pixelsCopy = std::move(decoded.pixels);
             int dw = decoded.width;
             int dh = decoded.height;
-            bool isDecodedGif = decoded.isGif;
+            auto tile = makeAtlasTile(task, pixelsCopy.data(), dw, dh);
 
-            Loader::get()->queueInMainThread([this, task, pixelsCopy, dw, dh, realID, isDecodedGif]() {
+            paimon::image::TextureUploadQueue::get().post(task->priority, [this, task, pixelsCopy = std::move(pixelsCopy), tile = std::move(tile), dw, dh, realID]() {
                 if (task->cancelled) { finishTask(task, nullptr, false); return; }
 
                 auto tex = new CCTexture2D();
                 if (tex->initWithData(pixelsCopy.data(), kCCTexture2DPixelFormat_RGBA8888,
                                       dw, dh, CCSize((float)dw, (float)dh))) {
                     tex->autorelease();
+                    insertAtlasTile(realID, tile);
                     finishTask(task, tex, true);
                 } else {
                     tex->release();
@@ -612,49 +818,20 @@ void ThumbnailLoader::workerDownload(std::shared_ptr<Task> task) {
     m_stats.downloads.fetch_add(1, std::memory_order_relaxed);
 
     Loader::get()->queueInMainThread([this, task, realID, isGif]() {
-        HttpClient::get().downloadThumbnail(realID, isGif, 
-            [this, task, realID](bool success, std::vector<uint8_t> const& data, int w, int h) {
+        // los bytes llegan en el runtime de async y de ahi pasan directo al carril
+        // de decode; al hilo principal solo vuelve el finishTask de los fallos
+        HttpClient::get().fetchThumbnail(realID, isGif, "",
+            [this, task, realID](bool success, WebHelper::BinaryResponse const& res) -> WebHelper::MainStep {
                 if (task->cancelled) {
-                    finishTask(task, nullptr, false);
-                    return;
+                    return [this, task]() { finishTask(task, nullptr, false); };
                 }
 
-                if (success && !data.empty()) {
-                    // procesamiento en thread background
-                    spawnBackground([this, task, data, realID]() {
-                        geode::utils::thread::setName("ThumbnailLoader Download Worker");
-                        // 1. guardo en disco con nombre segun formato real
+                if (success && !res.data.empty()) {
+                    // procesamiento en el carril de decode del pool
+                    spawnBackground(Lane::Decode, task->priority, [this, task, data = res.data, validator = res.validator, realID]() {
+                        // 1. guardo en disco con nombre segun formato real (y el validador pa revalidar)
                         bool dataIsGif = GIFDecoder::isGIF(data.data(), data.size());
-                        {
-                            auto path = getCachePath(realID, dataIsGif);
-                            std::error_code dirEc;
-                            std::filesystem::create_directories(path.parent_path(), dirEc);
-                            std::ofstream file(path, std::ios::binary);
-                            if (file) {
-                                file.write(reinterpret_cast<char const*>(data.data()), data.size());
-                                file.close();
-
-                                // actualizar manifest
-                                paimon::cache::DiskManifestEntry me;
-                                me.filename = paimon::quality::thumbFilename(realID, dataIsGif);
-                                me.levelID = realID;
-                                me.format = dataIsGif ? "gif" : "png";
-                                me.byteSize = data.size();
-                                me.isGif = dataIsGif;
-                                me.qualityTag = m_qualityTag;
-                                me.touchAccess();
-                                me.touchValidated();
-                                {
-                                    std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
-                                    m_manifest.upsert(realID, dataIsGif, std::move(me));
-                                }
-
-                                std::lock_guard<std::recursive_mutex> lock(m_diskMutex);
-                                m_diskCache.insert(dataIsGif ? -realID : realID);
-                            } else {
-                                log::error("[ThumbnailLoader] no se pudo abrir archivo para guardar en disco");
-                            }
-                        }
+                        persistSource(realID, dataIsGif, data, validator);
                         pruneDiskCache();
                         
                         // 2. decodifico fuera del main thread
@@ -662,28 +839,28 @@ void ThumbnailLoader::workerDownload(std::shared_ptr<Task> task) {
 
                         if (decoded.success && !decoded.pixels.empty()) {
                             if (decoded.isGif) {
-                                { std::lock_guard<std::recursive_mutex> lock(m_queueMutex); m_gifLevels.insert(realID); }
+                                m_gifLevels.insert(realID);
                             }
                             // update manifest with decoded dimensions
                             {
                                 std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
-                                if (auto* entry = const_cast<paimon::cache::DiskManifestEntry*>(
-                                        m_manifest.getEntry(realID, decoded.isGif))) {
-                                    entry->width = decoded.width;
-                                    entry->height = decoded.height;
-                                }
+                                m_manifest.setDimensions(realID, decoded.isGif, decoded.width, decoded.height);
                             }
+                            storeDecodedVariant(realID, dataIsGif, decoded, data.size());
+                            flushManifest();
 
                             auto pixelsCopy = std::move(decoded.pixels);
                             int dw = decoded.width;
                             int dh = decoded.height;
-                            Loader::get()->queueInMainThread([this, task, pixelsCopy, dw, dh]() {
+                            auto tile = makeAtlasTile(task, pixelsCopy.data(), dw, dh);
+                            paimon::image::TextureUploadQueue::get().post(task->priority, [this, task, pixelsCopy = std::move(pixelsCopy), tile = std::move(tile), dw, dh, realID]() {
                                 if (task->cancelled) { finishTask(task, nullptr, false); return; }
                                 
                                 auto tex = new CCTexture2D();
                                 if (tex->initWithData(pixelsCopy.data(), kCCTexture2DPixelFormat_RGBA8888,
                                                       dw, dh, CCSize((float)dw, (float)dh))) {
                                     tex->autorelease();
+                                    insertAtlasTile(realID, tile);
                                     finishTask(task, tex, true);
                                 } else {
                                     tex->release();
@@ -696,10 +873,10 @@ void ThumbnailLoader::workerDownload(std::shared_ptr<Task> task) {
                             });
                         }
                     });
-                } else {
-                    m_stats.downloadErrors.fetch_add(1, std::memory_order_relaxed);
-                    finishTask(task, nullptr, false);
+                    return {};
                 }
+                m_stats.downloadErrors.fetch_add(1, std::memory_order_relaxed);
+                return [this, task]() { finishTask(task, nullptr, false); };
             }
         );
     });
@@ -712,42 +889,48 @@ void ThumbnailLoader::finishTask(std::shared_ptr<Task> task, cocos2d::CCTexture2
     bool shuttingDown = m_shuttingDown.load(std::memory_order_acquire);
     bool shouldNotify = !task->cancelled && !shuttingDown;
 
-    // main thread: lock protege m_textureCache, m_failedCache, m_tasks
-    {
-        std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-
-        if (task->isUrlTask) {
-            // URL-based task (gallery shared cache) — usa pool separado
-            if (!shuttingDown && success && texture) {
-                addToUrlCache(task->url, texture);
-            } else if (!shuttingDown && !task->cancelled) {
-                m_urlFailedCache[task->url] = std::chrono::steady_clock::now();
-            }
-            if (shouldNotify) callbacks = task->callbacks;
-            m_urlTasks.erase(task->url);
+    if (task->isUrlTask) {
+        // URL-based task (gallery shared cache) — usa pool separado
+        if (!shuttingDown && success && texture) {
+            addToUrlCache(task->url, texture);
+        }
 
-            m_activeUrlTaskCount.fetch_sub(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_urlMutex);
+        if (!shuttingDown && !(success && texture) && !task->cancelled) {
+            m_urlFailedCache[task->url] = std::chrono::steady_clock::now();
+        }
+        if (shouldNotify) callbacks = task->callbacks;
+        if (auto it = m_urlTasks.find(task->url); it != m_urlTasks.end() && it->second == task) {
+            m_urlTasks.erase(it);
+        }
 
-            // procesar cola de URL pendientes
-            if (!shuttingDown) {
-                processUrlQueue();
-            }
-        } else {
-            // level-based task
-            if (!shuttingDown && success && texture) {
-                addToCache(task->levelID, texture);
-            } else if (!shuttingDown && !task->cancelled) {
-                m_failedCache[task->levelID] = std::chrono::steady_clock::now();
-            }
+        m_activeUrlTaskCount.fetch_sub(1, std::memory_order_relaxed);
+
+        // procesar cola de URL pendientes
+        if (!shuttingDown) {
+            processUrlQueue();
+        }
+    } else {
+        // level-based task
+        if (!shuttingDown && success && texture) {
+            addToCache(task->levelID, texture);
+        } else if (!shuttingDown && !task->cancelled) {
+            m_failedCache.set(task->levelID, std::chrono::steady_clock::now());
+        }
+        // callbacks y baja de la tabla bajo el mismo lock de shard que requestLoad
+        m_tasks.update(task->levelID, [&](auto& tasks) {
             if (shouldNotify) callbacks = task->callbacks;
-            m_tasks.erase(task->levelID);
+            if (auto it = tasks.find(task->levelID); it != tasks.end() && it->second == task) {
+                tasks.erase(it);
+            }
+        });
 
-            m_activeTaskCount.fetch_sub(1, std::memory_order_relaxed);
+        m_activeTaskCount.fetch_sub(1, std::memory_order_relaxed);
 
-            // proceso el siguiente level task solo si seguimos vivos
-            if (!shuttingDown) {
-                processQueue();
-            }
+        // proceso el siguiente level task solo si seguimos vivos
+        if (!shuttingDown) {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            processQueue();
         }
     }
 
@@ -759,93 +942,109 @@ void ThumbnailLoader::finishTask(std::shared_ptr<Task> task, cocos2d::CCTexture2
     }
 }
 
-int ThumbnailLoader::getVersionForKeyLocked(int key) const {
-    int realID = (key < 0) ? -key : key;
-    auto vit = m_invalidationVersions.find(realID);
-    return vit != m_invalidationVersions.end() ? vit->second : 0;
+int ThumbnailLoader::getVersionForKey(int key) const {
+    return getInvalidationVersion((key < 0) ? -key : key);
 }
 
 void ThumbnailLoader::addToCache(int levelID, cocos2d::CCTexture2D* texture, int version) {
     if (!texture) return;
 
-    size_t incomingBytes = estimateTextureBytes(texture);
-    if (auto oldIt = m_textureCache.find(levelID); oldIt != m_textureCache.end() && oldIt->second.texture) {
-        size_t oldBytes = estimateTextureBytes(oldIt->second.texture);
-        if (m_textureCacheBytes >= oldBytes) m_textureCacheBytes -= oldBytes;
-        else m_textureCacheBytes = 0;
-    }
-    
-    int ver = (version >= 0) ? version : getVersionForKeyLocked(levelID);
-    m_textureCache[levelID] = CacheEntry{texture, ver, incomingBytes};
-    m_textureCacheBytes += incomingBytes;
-    
-    // LRU O(1): quito el viejo iterador si existe, agrego al final
-    auto lruIt = m_lruMap.find(levelID);
-    if (lruIt != m_lruMap.end()) {
-        m_lruOrder.erase(lruIt->second);
-    }
-    m_lruOrder.push_back(levelID);
-    m_lruMap[levelID] = std::prev(m_lruOrder.end());
+    int ver = (version >= 0) ? version : getVersionForKey(levelID);
+    size_t bytes = estimateTextureBytes(texture);
+    m_textureCache.put(levelID, CacheEntry{texture, ver}, bytes);
+    paimon::memory::MemoryBudget::get().touch(m_ramBudget, std::to_string(levelID), bytes, RAM_REBUILD_COST);
     
     // recorto cache si pasa del maximo (dynamic from quality tier)
     size_t maxEntries = paimon::settings::quality::ramCacheEntries();
     size_t maxBytes   = paimon::settings::quality::ramCacheBytes();
-    while ((m_lruOrder.size() > maxEntries || m_textureCacheBytes > maxBytes) && !m_lruOrder.empty()) {
-        int removeID = m_lruOrder.front();
-        m_lruOrder.pop_front();
-        m_lruMap.erase(removeID);
-        if (auto removeIt = m_textureCache.find(removeID); removeIt != m_textureCache.end()) {
-            if (m_textureCacheBytes >= removeIt->second.byteSize) m_textureCacheBytes -= removeIt->second.byteSize;
-            else m_textureCacheBytes = 0;
-            m_stats.ramEvictions.fetch_add(1, std::memory_order_relaxed);
-        }
-        m_textureCache.erase(removeID);
-    }
+    size_t evicted = m_textureCache.evictTo(maxEntries, maxBytes, [this](int key) {
+        if (key > 0) m_atlas.remove(key);
+        paimon::memory::MemoryBudget::get().forget(m_ramBudget, std::to_string(key));
+    });
+    if (evicted > 0) m_stats.ramEvictions.fetch_add(evicted, std::memory_order_relaxed);
+}
+
+paimon::cache::ThumbnailAtlas::Tile ThumbnailLoader::makeAtlasTile(std::shared_ptr<Task> const& task, uint8_t const* rgba, int width, int height) {
+    // solo estaticos por levelID: son los que pintan las celdas de lista
+    if (task->levelID <= 0 || task->isUrlTask) return {};
+    return paimon::cache::ThumbnailAtlas::makeTile(rgba, width, height);
+}
+
+void ThumbnailLoader::insertAtlasTile(int levelID, paimon::cache::ThumbnailAtlas::Tile const& tile) {
+    if (!tile || m_shuttingDown.load(std::memory_order_acquire)) return;
+    m_atlas.insert(levelID, getInvalidationVersion(levelID), tile);
+}
+
+std::optional<paimon::cache::ThumbnailAtlas::Region> ThumbnailLoader::atlasRegion(int levelID) {
+    if (levelID <= 0) return std::nullopt;
+    return m_atlas.region(levelID, getInvalidationVersion(levelID));
 }
 
 void ThumbnailLoader::clearCache() {
     log::info("[ThumbnailLoader] clearCache: clearing RAM cache");
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
     m_textureCache.clear();
-    m_lruOrder.clear();
-    m_lruMap.clear();
-    m_textureCacheBytes = 0;
+    m_atlas.clear();
     m_urlTextureCache.clear();
-    m_urlLruOrder.clear();
-    m_urlLruMap.clear();
-    m_urlCacheBytes = 0;
+    paimon::memory::MemoryBudget::get().forgetAll(m_ramBudget);
+    paimon::memory::MemoryBudget::get().forgetAll(m_urlBudget);
     m_failedCache.clear();
-    m_urlFailedCache.clear();
     m_gifLevels.clear();
+    std::lock_guard<std::mutex> lock(m_urlMutex);
+    m_urlFailedCache.clear();
 }
 
 void ThumbnailLoader::invalidateLevel(int levelID, bool isGif) {
+    log::info("[ThumbnailLoader] invalidateLevel: levelID={} key={}", levelID, isGif ? -levelID : levelID);
+    invalidateInMemory(levelID, isGif);
+
+    // borro ambos formatos en disco para no dejar huerfanos
+    // I/O de disco - no migrable a WebTask
+    spawnBackground(Lane::Maintenance, MAINTENANCE_PRIORITY, [this, levelID]() {
+        std::error_code ec;
+        for (bool gif : {false, true}) {
+            auto name = paimon::quality::thumbFilename(levelID, gif);
+            m_pack.remove(name);
+            m_pack.remove(paimon::cache::decoded::filenameFor(name));
+            // GIF sueltos o PNG de antes de abrir el pack
+            std::filesystem::remove(paimon::quality::cacheDir() / name, ec);
+        }
+        // actualizar manifest
+        {
+            std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+            m_manifest.remove(levelID, false);
+            m_manifest.remove(levelID, true);
+        }
+        // actualizar legacy index
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_diskMutex);
+            m_diskCache.erase(levelID);
+            m_diskCache.erase(-levelID);
+        }
+        m_manifest.flush();
+    });
+}
+
+void ThumbnailLoader::invalidateInMemory(int levelID, bool isGif) {
     int key = isGif ? -levelID : levelID;
-    log::info("[ThumbnailLoader] invalidateLevel: levelID={} key={}", levelID, key);
     std::vector<InvalidationCallback> listeners;
 
-    {
-        std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-        // incremento la version de invalidacion para que los consumidores sepan que hay cambio
-        m_invalidationVersions[levelID]++;
-
-        // quito la entrada de la RAM
-        auto it = m_textureCache.find(key);
-        if (it != m_textureCache.end()) {
-            if (m_textureCacheBytes >= it->second.byteSize) m_textureCacheBytes -= it->second.byteSize;
-            else m_textureCacheBytes = 0;
-            m_textureCache.erase(it);
-            auto lruIt = m_lruMap.find(key);
-            if (lruIt != m_lruMap.end()) {
-                m_lruOrder.erase(lruIt->second);
-                m_lruMap.erase(lruIt);
-            }
-        }
+    // incremento la version de invalidacion para que los consumidores sepan que hay cambio.
+    // primero el mapa y despues el bucket: quien vea el bucket en 0 lee "antes" del cambio
+    m_invalidationVersions.update(levelID, [&](auto& versions) { versions[levelID]++; });
+    m_invalidationBuckets[static_cast<uint32_t>(levelID) % INVALIDATION_BUCKETS]
+        .fetch_add(1, std::memory_order_release);
 
-        // quito del cache de fallos y gif
-        m_failedCache.erase(key);
-        m_gifLevels.erase(levelID);
+    // quito la entrada de la RAM
+    m_textureCache.erase(key);
+    paimon::memory::MemoryBudget::get().forget(m_ramBudget, std::to_string(key));
+    if (key > 0) m_atlas.remove(levelID);
 
+    // quito del cache de fallos y gif
+    m_failedCache.erase(key);
+    m_gifLevels.erase(levelID);
+
+    {
+        std::lock_guard<std::mutex> lock(m_listenerMutex);
         listeners.reserve(m_invalidationListeners.size());
         for (auto const& [_, cb] : m_invalidationListeners) {
             if (cb) listeners.push_back(cb);
@@ -859,44 +1058,18 @@ void ThumbnailLoader::invalidateLevel(int levelID, bool isGif) {
             }
         });
     }
-
-    // borro ambos formatos en disco para no dejar huerfanos
-    // hilo de I/O de disco - no migrable a WebTask
-    spawnBackground([this, levelID]() {
-        geode::utils::thread::setName("ThumbnailLoader Invalidator");
-        std::error_code ec;
-        auto pngPath = getCachePath(levelID, false);
-        auto gifPath = getCachePath(levelID, true);
-        if (std::filesystem::exists(pngPath, ec)) {
-            std::filesystem::remove(pngPath, ec);
-        }
-        if (std::filesystem::exists(gifPath, ec)) {
-            std::filesystem::remove(gifPath, ec);
-        }
-        // actualizar manifest
-        {
-            std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
-            m_manifest.remove(levelID, false);
-            m_manifest.remove(levelID, true);
-        }
-        // actualizar legacy index
-        {
-            std::lock_guard<std::recursive_mutex> lock(m_diskMutex);
-            m_diskCache.erase(levelID);
-            m_diskCache.erase(-levelID);
-        }
-    });
 }
 
 int ThumbnailLoader::getInvalidationVersion(int levelID) const {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    auto it = m_invalidationVersions.find(levelID);
-    return it != m_invalidationVersions.end() ? it->second : 0;
+    // camino sin lock: ningun level de este bucket se invalido nunca
+    auto bucket = static_cast<uint32_t>(levelID) % INVALIDATION_BUCKETS;
+    if (m_invalidationBuckets[bucket].load(std::memory_order_acquire) == 0) return 0;
+    return m_invalidationVersions.find(levelID).value_or(0);
 }
 
 int ThumbnailLoader::addInvalidationListener(InvalidationCallback callback) {
     if (!callback) return 0;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
     int id = m_nextInvalidationListenerId++;
     m_invalidationListeners[id] = std::move(callback);
     return id;
@@ -904,15 +1077,17 @@ int ThumbnailLoader::addInvalidationListener(InvalidationCallback callback) {
 
 void ThumbnailLoader::removeInvalidationListener(int listenerId) {
     if (listenerId <= 0) return;
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
     m_invalidationListeners.erase(listenerId);
 }
 
 void ThumbnailLoader::clearDiskCache() {
     log::info("[ThumbnailLoader] clearDiskCache: clearing disk cache");
-    // hilo de I/O de disco — no migrable a WebTask
-    spawnBackground([this]() {
-        geode::utils::thread::setName("ThumbnailLoader Disk Clear");
+    // I/O de disco — no migrable a WebTask
+    spawnBackground(Lane::Maintenance, MAINTENANCE_PRIORITY, [this]() {
+        // soltar handles y mapeos del pack: Windows no borra archivos abiertos
+        m_diskIndexReady.store(false, std::memory_order_release);
+        m_pack.close();
         std::error_code ec;
         std::filesystem::remove_all(paimon::quality::cacheDir(), ec);
         if (ec) {
@@ -931,40 +1106,77 @@ void ThumbnailLoader::clearDiskCache() {
 }
 
 void ThumbnailLoader::clearPendingQueue() {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    for (auto& [id, task] : m_tasks) {
-        task->cancelled = true;
-    }
-    // no limpio el mapa aqui porque algunas siguen corriendo
-    // con marcarlas canceladas me vale
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_priorityQueue.clear();
+    m_tasks.forEachShard([](auto& tasks) {
+        // las que siguen corriendo se quedan marcadas hasta su finishTask
+        std::erase_if(tasks, [](auto& kv) {
+            kv.second->cancelled = true;
+            return !kv.second->running;
+        });
+    });
 }
 
 void ThumbnailLoader::updateSessionCache(int levelID, cocos2d::CCTexture2D* texture) {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
     addToCache(levelID, texture);
 }
 
-void ThumbnailLoader::cleanup() {
-    log::info("[ThumbnailLoader] cleanup: shutting down loader");
+void ThumbnailLoader::cleanup(bool exiting) {
+    log::info("[ThumbnailLoader] cleanup: shutting down loader (exiting={})", exiting);
     m_shuttingDown.store(true, std::memory_order_release);
     clearPendingQueue();
-    waitBackgroundWorkers();
+
+    auto ws = m_workers.stats();
+    PaimonDebug::log("[ThumbnailLoader] pool: jobs={} robados={} en cola={} latencia cola p50={}us p99={}us",
+        ws.completed, ws.stolen, ws.queued, ws.p50QueueUs, ws.p99QueueUs);
+    if (m_stats.manifestPages.load(std::memory_order_relaxed) > 0) {
+        PaimonDebug::log("[ThumbnailLoader] manifest: paginas={} levels={} hits={} lookups={} resueltos={} hit ratio={:.0f}%",
+            m_stats.manifestPages.load(std::memory_order_relaxed), m_stats.manifestPageLevels.load(std::memory_order_relaxed),
+            m_stats.manifestHits.load(std::memory_order_relaxed), m_stats.manifestLookups.load(std::memory_order_relaxed),
+            m_stats.manifestResolved.load(std::memory_order_relaxed), m_stats.manifestHitRatio() * 100.0);
+    }
+    static constexpr char const* TIER_TAGS[] = {"low", "med", "high"};
+    for (size_t i = 0; i < m_stats.tierDownscale.size(); ++i) {
+        auto const& t = m_stats.tierDownscale[i];
+        if (t.images.load(std::memory_order_relaxed) == 0) continue;
+        PaimonDebug::log("[ThumbnailLoader] downscale {}: imagenes={} reducidas={} ahorro RAM/VRAM={} bytes",
+            TIER_TAGS[i], t.images.load(std::memory_order_relaxed),
+            t.downscaled.load(std::memory_order_relaxed), t.savedBytes());
+    }
+    // drena la cola del pool y hace join; el pool rearranca solo si se
+    // vuelve a encolar algo (al final se rearma el loader si no es la salida)
+    m_workers.shutdown();
+    // al salir: sin workers ya nadie lee el pack; cerrarlo suelta los handles
+    // para que el borrado de la carpeta (clear-cache-on-exit) funcione en Windows.
+    // a mitad de sesion se queda abierto (clearDiskCache ya lo cierra y reabre)
+    if (exiting) {
+        m_pack.close();
+    }
 
     // Limpiar invalidation listeners ANTES de la destruccion estatica.
     // Los listeners capturan WeakRef<PaimonLevelCell> cuyo destructor
     // interactua con CCPoolManager — si se destruyen en el ~ThumbnailLoader
     // (destruccion estatica del DLL), CCPoolManager ya murio → crash.
     {
-        std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
+        std::lock_guard<std::mutex> lock(m_listenerMutex);
         m_invalidationListeners.clear();
+    }
 
-        // Limpiar callbacks de tasks que capturan WeakRef<PaimonLevelCell>.
-        // Despues de waitBackgroundWorkers() no hay threads activos,
-        // asi que podemos limpiar las callbacks y los mapas de forma segura.
-        for (auto& [id, task] : m_tasks) {
+    // Limpiar callbacks de tasks que capturan WeakRef<PaimonLevelCell>.
+    // Despues de m_workers.shutdown() no hay threads activos,
+    // asi que podemos limpiar las callbacks y los mapas de forma segura.
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_priorityQueue.clear();
+    }
+    m_tasks.forEachShard([](auto& tasks) {
+        for (auto& [id, task] : tasks) {
             if (task) task->callbacks.clear();
         }
-        m_tasks.clear();
+        tasks.clear();
+    });
+    {
+        std::lock_guard<std::mutex> lock(m_urlMutex);
         for (auto& [url, task] : m_urlTasks) {
             if (task) task->callbacks.clear();
         }
@@ -972,38 +1184,27 @@ void ThumbnailLoader::cleanup() {
     }
 
     clearCache();
-}
 
-void ThumbnailLoader::spawnBackground(std::function<void()> job) {
-    std::lock_guard<std::recursive_mutex> lock(m_workerMutex);
-    pruneFinishedWorkers();
-    m_backgroundWorkers.emplace_back(std::async(std::launch::async, [job = std::move(job)]() mutable {
-        job();
-    }));
+    // a mitad de sesion el loader sigue en uso: sin esto startTask y
+    // initDiskCache abortarian todo lo que llegue despues
+    if (!exiting) {
+        m_shuttingDown.store(false, std::memory_order_release);
+    }
 }
 
-void ThumbnailLoader::pruneFinishedWorkers() {
-    auto it = m_backgroundWorkers.begin();
-    while (it != m_backgroundWorkers.end()) {
-        if (!it->valid() || it->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            it = m_backgroundWorkers.erase(it);
-        } else {
-            ++it;
-        }
+void ThumbnailLoader::spawnBackground(Lane lane, int priority, std::function<void()> job) {
+    if (!m_workers.submit(lane, priority, std::move(job))) {
+        // solo pasa mientras el pool se drena en cleanup(); el job se descarta
+        PaimonDebug::warn("[ThumbnailLoader] job descartado: pool en shutdown");
     }
 }
 
-void ThumbnailLoader::waitBackgroundWorkers() {
-    std::vector<std::future<void>> workers;
-    {
-        std::lock_guard<std::recursive_mutex> lock(m_workerMutex);
-        workers.swap(m_backgroundWorkers);
-    }
-    for (auto& worker : workers) {
-        if (worker.valid()) {
-            worker.wait();
-        }
-    }
+bool ThumbnailLoader::submitIdle(std::function<void()> job) {
+    return m_workers.submit(Lane::Decode, IDLE_PRIORITY, std::move(job));
+}
+
+bool ThumbnailLoader::submitMaintenance(std::function<void()> job) {
+    return m_workers.submit(Lane::Maintenance, MAINTENANCE_PRIORITY, std::move(job));
 }
 
 bool ThumbnailLoader::isTextureSane(cocos2d::CCTexture2D* tex) {
@@ -1026,22 +1227,15 @@ void ThumbnailLoader::requestUrlLoad(std::string const& url, LoadCallback callba
 
     detectQualityChange();
 
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
     auto now = std::chrono::steady_clock::now();
 
-    // 1. reviso cache RAM de URLs
-    auto it = m_urlTextureCache.find(url);
-    if (it != m_urlTextureCache.end()) {
+    // 1. reviso cache RAM de URLs (el hit marca el LRU)
+    if (auto cached = m_urlTextureCache.get(url)) {
         m_stats.ramHits.fetch_add(1, std::memory_order_relaxed);
-        // LRU touch
-        auto lruIt = m_urlLruMap.find(url);
-        if (lruIt != m_urlLruMap.end()) {
-            m_urlLruOrder.erase(lruIt->second);
-        }
-        m_urlLruOrder.push_back(url);
-        m_urlLruMap[url] = std::prev(m_urlLruOrder.end());
+        paimon::memory::MemoryBudget::get().touch(m_urlBudget, url,
+            estimateTextureBytes(cached->texture), URL_REBUILD_COST);
 
-        auto tex = it->second.texture;
+        auto tex = cached->texture;
         Loader::get()->queueInMainThread([callback, tex]() {
             if (callback) callback(tex, true);
         });
@@ -1049,6 +1243,8 @@ void ThumbnailLoader::requestUrlLoad(std::string const& url, LoadCallback callba
     }
     m_stats.ramMisses.fetch_add(1, std::memory_order_relaxed);
 
+    std::lock_guard<std::mutex> lock(m_urlMutex);
+
     // 2. cache de fallos
     auto failIt = m_urlFailedCache.find(url);
     if (failIt != m_urlFailedCache.end()) {
@@ -1079,17 +1275,16 @@ void ThumbnailLoader::requestUrlLoad(std::string const& url, LoadCallback callba
     m_urlTasks[url] = task;
 
     // arranco directamente con pool separado de URLs (no compite con level tasks)
-    if (m_activeUrlTaskCount < m_maxConcurrentUrlTasks) {
+    if (m_activeUrlTaskCount < urlTaskLimit(url)) {
         task->running = true;
         m_activeUrlTaskCount.fetch_add(1, std::memory_order_relaxed);
-        spawnBackground([this, task]() {
+        spawnBackground(Lane::Disk, task->priority, [this, task]() {
             if (m_shuttingDown.load(std::memory_order_relaxed)) {
                 Loader::get()->queueInMainThread([this, task]() {
                     finishTask(task, nullptr, false);
                 });
                 return;
             }
-            geode::utils::thread::setName("ThumbnailLoader URL Worker");
             workerUrlDownload(task);
         });
     }
@@ -1097,20 +1292,19 @@ void ThumbnailLoader::requestUrlLoad(std::string const& url, LoadCallback callba
 }
 
 void ThumbnailLoader::processUrlQueue() {
-    // must be called with m_queueMutex held
+    // must be called with m_urlMutex held
     for (auto& [url, task] : m_urlTasks) {
-        if (m_activeUrlTaskCount >= m_maxConcurrentUrlTasks) break;
+        if (m_activeUrlTaskCount >= urlTaskLimit(url)) continue;
         if (task->running || task->cancelled) continue;
         task->running = true;
         m_activeUrlTaskCount.fetch_add(1, std::memory_order_relaxed);
-        spawnBackground([this, task]() {
+        spawnBackground(Lane::Disk, task->priority, [this, task]() {
             if (m_shuttingDown.load(std::memory_order_relaxed)) {
                 Loader::get()->queueInMainThread([this, task]() {
                     finishTask(task, nullptr, false);
                 });
                 return;
             }
-            geode::utils::thread::setName("ThumbnailLoader URL Worker");
             workerUrlDownload(task);
         });
     }
@@ -1123,12 +1317,11 @@ void ThumbnailLoader::requestUrlBatchLoad(std::vector<std::string> const& urls,
 }
 
 bool ThumbnailLoader::isUrlLoaded(std::string const& url) const {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    return m_urlTextureCache.find(url) != m_urlTextureCache.end();
+    return m_urlTextureCache.contains(url);
 }
 
 void ThumbnailLoader::cancelUrlLoad(std::string const& url) {
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
+    std::lock_guard<std::mutex> lock(m_urlMutex);
     auto it = m_urlTasks.find(url);
     if (it != m_urlTasks.end()) {
         it->second->cancelled = true;
@@ -1138,41 +1331,13 @@ void ThumbnailLoader::cancelUrlLoad(std::string const& url) {
 void ThumbnailLoader::addToUrlCache(std::string const& url, cocos2d::CCTexture2D* texture) {
     if (!texture || url.empty()) return;
 
-    size_t incomingBytes = estimateTextureBytes(texture);
-
-    // reemplazar existente
-    if (auto oldIt = m_urlTextureCache.find(url); oldIt != m_urlTextureCache.end()) {
-        if (m_urlCacheBytes >= oldIt->second.byteSize) m_urlCacheBytes -= oldIt->second.byteSize;
-        else m_urlCacheBytes = 0;
-    }
-
-    m_urlTextureCache[url] = CacheEntry{texture, 0, incomingBytes};
-    m_urlCacheBytes += incomingBytes;
-
-    // LRU
-    auto lruIt = m_urlLruMap.find(url);
-    if (lruIt != m_urlLruMap.end()) {
-        m_urlLruOrder.erase(lruIt->second);
-    }
-    m_urlLruOrder.push_back(url);
-    m_urlLruMap[url] = std::prev(m_urlLruOrder.end());
-
-    evictUrlCacheLocked();
-}
-
-void ThumbnailLoader::evictUrlCacheLocked() {
-    while ((m_urlLruOrder.size() > URL_CACHE_MAX_ENTRIES || m_urlCacheBytes > URL_CACHE_MAX_BYTES)
-           && !m_urlLruOrder.empty()) {
-        auto removeUrl = m_urlLruOrder.front();
-        m_urlLruOrder.pop_front();
-        m_urlLruMap.erase(removeUrl);
-        if (auto removeIt = m_urlTextureCache.find(removeUrl); removeIt != m_urlTextureCache.end()) {
-            if (m_urlCacheBytes >= removeIt->second.byteSize) m_urlCacheBytes -= removeIt->second.byteSize;
-            else m_urlCacheBytes = 0;
-            m_stats.ramEvictions.fetch_add(1, std::memory_order_relaxed);
-        }
-        m_urlTextureCache.erase(removeUrl);
-    }
+    size_t bytes = estimateTextureBytes(texture);
+    m_urlTextureCache.put(url, CacheEntry{texture, 0}, bytes);
+    paimon::memory::MemoryBudget::get().touch(m_urlBudget, url, bytes, URL_REBUILD_COST);
+    size_t evicted = m_urlTextureCache.evictTo(URL_CACHE_MAX_ENTRIES, URL_CACHE_MAX_BYTES, [this](std::string const& evictedUrl) {
+        paimon::memory::MemoryBudget::get().forget(m_urlBudget, evictedUrl);
+    });
+    if (evicted > 0) m_stats.ramEvictions.fetch_add(evicted, std::memory_order_relaxed);
 }
 
 void ThumbnailLoader::workerUrlDownload(std::shared_ptr<Task> task) {
@@ -1208,19 +1373,19 @@ ThumbnailLoader::DecodeResult ThumbnailLoader::decodeImageData(std::vector<uint8
     result.isGif = isNativeGif;
 
     if (isNativeGif) {
-        // GIF: decodifico primer frame fuera del main thread
-        auto gifData = GIFDecoder::decode(data.data(), data.size());
-        if (gifData.frames.empty() || gifData.width <= 0 || gifData.height <= 0) {
+        // GIF: solo el primer frame (la animacion la lleva AnimatedGIFSprite)
+        GIFDecoder::Frame frame;
+        if (!GIFDecoder::decodeFirstFrame(data.data(), data.size(), frame)) {
             return result;
         }
-        auto const& frame = gifData.frames.front();
         if (frame.pixels.empty() || frame.width <= 0 || frame.height <= 0) {
             return result;
         }
 
-        result.pixels.assign(frame.pixels.begin(), frame.pixels.end());
+        result.pixels = std::move(frame.pixels);
         result.width = frame.width;
         result.height = frame.height;
+        applyQualityDownscale(result.pixels, result.width, result.height);
 
         // extraer colores dominantes
         if (realID > 0 && !LevelColors::get().getPair(realID)) {
@@ -1239,6 +1404,7 @@ ThumbnailLoader::DecodeResult ThumbnailLoader::decodeImageData(std::vector<uint8
             stbi_image_free(pixels);
             result.width = w;
             result.height = h;
+            applyQualityDownscale(result.pixels, result.width, result.height);
 
             // extraer colores dominantes
             if (realID > 0 && !LevelColors::get().getPair(realID)) {
@@ -1259,25 +1425,106 @@ ThumbnailLoader::DecodeResult ThumbnailLoader::decodeImageData(std::vector<uint8
     return result;
 }
 
+// ── Pre-decoded disk variant ────────────────────────────────────────
+
+bool ThumbnailLoader::tryLoadDecodedVariant(std::shared_ptr<Task> task, int realID, bool sourceIsGif) {
+    std::string decodedName;
+    size_t sourceBytes = 0;
+    {
+        std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+        auto const* entry = m_manifest.getEntryLocked(realID, sourceIsGif);
+        if (!entry || entry->decodedFilename.empty()) return false;
+        decodedName = entry->decodedFilename;
+        sourceBytes = entry->byteSize;
+    }
+
+    auto blob = m_pack.read(decodedName);
+    auto view = paimon::cache::decoded::parse(blob.owner, blob.data, blob.size, sourceBytes);
+    if (!view) {
+        // stale o corrupta: la olvido y se regenera tras el proximo decode
+        std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+        m_manifest.setDecodedVariant(realID, sourceIsGif, "", "", 0);
+        return false;
+    }
+
+    m_stats.diskHits.fetch_add(1, std::memory_order_relaxed);
+    m_stats.decodedDiskHits.fetch_add(1, std::memory_order_relaxed);
+    if (view->sourceIsGif) {
+        m_gifLevels.insert(realID);
+    }
+
+    paimon::cache::ThumbnailAtlas::Tile tile;
+    if (task->levelID > 0) {
+        tile = view->format == paimon::cache::DecodedPixelFormat::RGB565
+            ? paimon::cache::ThumbnailAtlas::makeTileRGB565(view->pixels, view->width, view->height)
+            : paimon::cache::ThumbnailAtlas::makeTile(view->pixels, view->width, view->height);
+    }
+
+    // el DecodedThumb mantiene vivo el mapeo hasta que la textura se sube
+    paimon::image::TextureUploadQueue::get().post(task->priority, [this, task, view = std::move(*view), tile = std::move(tile), realID]() {
+        if (task->cancelled) { finishTask(task, nullptr, false); return; }
+
+        auto format = view.format == paimon::cache::DecodedPixelFormat::RGB565
+            ? kCCTexture2DPixelFormat_RGB565 : kCCTexture2DPixelFormat_RGBA8888;
+        auto tex = new CCTexture2D();
+        if (tex->initWithData(view.pixels, format, view.width, view.height,
+                              CCSize((float)view.width, (float)view.height))) {
+            tex->autorelease();
+            insertAtlasTile(realID, tile);
+            finishTask(task, tex, true);
+        } else {
+            tex->release();
+            PaimonDebug::warn("[ThumbnailLoader] fallo textura desde variante decodificada pal nivel {}", realID);
+            workerDownload(task);
+        }
+    });
+    return true;
+}
+
+void ThumbnailLoader::storeDecodedVariant(int realID, bool sourceIsGif, DecodeResult const& decoded, size_t sourceBytes) {
+    if (!decoded.success || decoded.pixels.empty()) return;
+
+    auto name = paimon::cache::decoded::filenameFor(paimon::quality::thumbFilename(realID, sourceIsGif));
+    bool allowRgb565 = paimon::settings::quality::current() == paimon::settings::Quality::Low;
+
+    auto encoded = paimon::cache::decoded::encode(decoded.pixels, decoded.width, decoded.height,
+        sourceBytes, decoded.isGif, allowRgb565);
+    if (encoded.bytes.empty()) return;
+
+    std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+    // la fuente fue podada/invalidada mientras decodificabamos
+    if (!m_manifest.containsLocked(realID, sourceIsGif)) return;
+    if (!m_pack.put(name, encoded.bytes.data(), encoded.bytes.size())) return;
+    m_manifest.setDecodedVariant(realID, sourceIsGif, name,
+        paimon::cache::decoded::formatTag(encoded.format), encoded.bytes.size());
+}
+
+void ThumbnailLoader::applyQualityDownscale(std::vector<uint8_t>& pixels, int& width, int& height) {
+    uint64_t decodedBytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 4;
+    paimon::quality::downscaleRGBA(pixels, width, height);
+    uint64_t uploadedBytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 4;
+    m_stats.recordDownscale(static_cast<size_t>(paimon::settings::quality::current()), decodedBytes, uploadedBytes);
+}
+
 // ── Remote revision ─────────────────────────────────────────────────
 
 void ThumbnailLoader::updateRemoteRevision(int levelID, std::string const& revisionToken) {
     if (levelID <= 0 || revisionToken.empty()) return;
 
-    std::lock_guard<std::recursive_mutex> lock(m_queueMutex);
-    auto it = m_remoteRevisions.find(levelID);
-    if (it != m_remoteRevisions.end() && it->second == revisionToken) {
-        return; // sin cambios
-    }
-
-    bool hadPrevious = (it != m_remoteRevisions.end());
-    m_remoteRevisions[levelID] = revisionToken;
+    bool changed = m_remoteRevisions.update(levelID, [&](auto& revisions) {
+        auto it = revisions.find(levelID);
+        if (it != revisions.end() && it->second == revisionToken) {
+            return false; // sin cambios
+        }
+        bool hadPrevious = (it != revisions.end());
+        revisions[levelID] = revisionToken;
+        return hadPrevious;
+    });
 
     // si habia una revision anterior y cambio, invalidar la cache
-    if (hadPrevious) {
+    if (changed) {
         log::info("[ThumbnailLoader] remote revision changed for level {}, invalidating", levelID);
-        // desbloqueo antes de llamar invalidateLevel (que toma el lock)
-        // pero como invalidateLevel necesita queueMutex, lo hago en main thread
+        // invalidateLevel avisa a los listeners de UI: lo hago en main thread
         Loader::get()->queueInMainThread([this, levelID]() {
             invalidateLevel(levelID, false);
             invalidateLevel(levelID, true);
@@ -1285,13 +1532,137 @@ void ThumbnailLoader::updateRemoteRevision(int levelID, std::string const& revis
     }
 }
 
+// ── Revalidacion condicional ────────────────────────────────────────
+
+void ThumbnailLoader::maybeRevalidate(int realID, bool isGif) {
+    int64_t windowHours = paimon::settings::thumbnails::revalidateHours();
+    if (windowHours <= 0 || m_shuttingDown.load(std::memory_order_relaxed)) return;
+
+    std::string validator;
+    size_t cachedBytes = 0;
+    {
+        std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+        auto const* entry = m_manifest.getEntryLocked(realID, isGif);
+        // sin entrada (LocalThumbs, indice aun sin hidratar) no hay nada que revalidar
+        if (!entry || entry->nowEpoch() - entry->lastValidatedEpoch < windowHours * 3600) return;
+        validator = entry->revisionToken;
+        cachedBytes = entry->byteSize;
+    }
+
+    int key = isGif ? -realID : realID;
+    if (validator.empty()) {
+        // sin validador el request es un GET completo: tras actualizar seria bajar
+        // la cache entera de golpe. las que no entran en el ritmo esperan en memoria
+        // (sin tocar el manifest) y vuelven a probar en un hit posterior
+        auto now = std::chrono::steady_clock::now();
+        if (auto notBefore = m_revalidateNotBefore.find(key); notBefore && now < *notBefore) return;
+        if (!takeUnvalidatedRevalidateSlot()) {
+            m_revalidateNotBefore.set(key, now + UNVALIDATED_RETRY);
+            return;
+        }
+        m_revalidateNotBefore.erase(key);
+    }
+
+    if (!m_revalidating.insert(key)) return;
+    m_stats.revalidations.fetch_add(1, std::memory_order_relaxed);
+    PaimonDebug::log("[ThumbnailLoader] revalidando nivel {}{} ({})", realID, isGif ? " (gif)" : "",
+        validator.empty() ? "sin validador" : validator);
+
+    Loader::get()->queueInMainThread([this, realID, isGif, key, validator, cachedBytes]() {
+        HttpClient::get().fetchThumbnail(realID, isGif, validator,
+            [this, realID, isGif, key, cachedBytes](bool success, WebHelper::BinaryResponse const& res) -> WebHelper::MainStep {
+                if (res.status == 304) {
+                    // lo de disco sigue valiendo: solo se renueva lastValidated
+                    m_stats.revalidatedFresh.fetch_add(1, std::memory_order_relaxed);
+                    m_stats.revalidationBytesSaved.fetch_add(cachedBytes, std::memory_order_relaxed);
+                    markValidated(realID, isGif, res.validator);
+                    m_revalidating.erase(key);
+                    return {};
+                }
+                if (!success || res.data.empty()) {
+                    // sin red o sin thumbnail: se queda lo que hay y se reintenta en el proximo hit
+                    m_revalidating.erase(key);
+                    return {};
+                }
+                // 200: sin validador guardado o el servidor tiene otra version
+                bool queued = m_workers.submit(Lane::Maintenance, MAINTENANCE_PRIORITY,
+                    [this, realID, isGif, data = res.data, validator = res.validator]() mutable {
+                        applyRevalidation(realID, isGif, std::move(data), std::move(validator));
+                    });
+                // pool en shutdown: applyRevalidation no corre, la key no puede quedar tomada
+                if (!queued) m_revalidating.erase(key);
+                return {};
+            });
+    });
+}
+
+bool ThumbnailLoader::takeUnvalidatedRevalidateSlot() {
+    auto nowTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto last = m_lastUnvalidatedRevalidate.load(std::memory_order_relaxed);
+    if (last != 0 && nowTicks - last < std::chrono::steady_clock::duration(UNVALIDATED_REVALIDATE_INTERVAL).count()) {
+        return false;
+    }
+    return m_lastUnvalidatedRevalidate.compare_exchange_strong(last, nowTicks, std::memory_order_relaxed);
+}
+
+void ThumbnailLoader::applyRevalidation(int realID, bool isGif, std::vector<uint8_t> data, std::string validator) {
+    int key = isGif ? -realID : realID;
+    std::vector<uint8_t> current;
+    if (readSource(realID, isGif, current) && current == data) {
+        // servidor sin ETag/Last-Modified (o no respeto el condicional) pero mismos bytes
+        m_stats.revalidatedFresh.fetch_add(1, std::memory_order_relaxed);
+        markValidated(realID, isGif, validator);
+        m_revalidating.erase(key);
+        return;
+    }
+
+    m_stats.revalidatedChanged.fetch_add(1, std::memory_order_relaxed);
+    bool dataIsGif = GIFDecoder::isGIF(data.data(), data.size());
+    PaimonDebug::log("[ThumbnailLoader] nivel {} cambio en el servidor, reemplazando cache ({} bytes)", realID, data.size());
+    if (dataIsGif != isGif) {
+        // cambio de formato: el archivo viejo tiene otro nombre, se borra todo y se baja de nuevo
+        m_revalidating.erase(key);
+        Loader::get()->queueInMainThread([this, realID]() {
+            invalidateLevel(realID, false);
+            invalidateLevel(realID, true);
+        });
+        return;
+    }
+
+    persistSource(realID, isGif, data, validator);
+    flushManifest();
+    m_revalidating.erase(key);
+    // la textura vieja sale de RAM y las celdas recargan desde el disco ya actualizado
+    Loader::get()->queueInMainThread([this, realID, isGif]() {
+        invalidateInMemory(realID, isGif);
+    });
+}
+
+void ThumbnailLoader::markValidated(int realID, bool isGif, std::string const& validator) {
+    {
+        std::lock_guard<std::recursive_mutex> ml(m_manifest.mutex);
+        auto const* entry = m_manifest.getEntryLocked(realID, isGif);
+        if (!entry) return;
+        auto updated = *entry;
+        updated.touchValidated();
+        // un 304 puede no repetir el validador; entonces vale el que ya estaba
+        if (!validator.empty()) updated.revisionToken = validator;
+        m_manifest.upsert(realID, isGif, std::move(updated));
+    }
+    flushManifest();
+}
+
 // ── Manifest flush ──────────────────────────────────────────────────
 
 void ThumbnailLoader::flushManifest() {
-    spawnBackground([this]() {
-        geode::utils::thread::setName("ThumbnailLoader Manifest Flush");
+    // una rafaga de descargas termina en un solo append al journal
+    if (m_manifestFlushPending.exchange(true, std::memory_order_acq_rel)) return;
+    bool queued = m_workers.submit(Lane::Maintenance, MAINTENANCE_PRIORITY, [this]() {
+        m_manifestFlushPending.store(false, std::memory_order_release);
         m_manifest.flush();
     });
+    // pool en shutdown: el flush del destructor/Exiting se encarga
+    if (!queued) m_manifestFlushPending.store(false, std::memory_order_release);
 }
 
 // ── Quality change detection ────────────────────────────────────────
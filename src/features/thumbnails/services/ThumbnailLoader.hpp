@@ -5,6 +5,7 @@
 #include <Geode/utils/function.hpp>
 #include <cocos2d.h>
 #include <string>
+#include <array>
 #include <deque>
 #include <map>
 #include <unordered_set>
@@ -14,12 +15,18 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
-#include <future>
 #include <functional>
+#include <limits>
 #include "../../../utils/GIFDecoder.hpp"
 #include "../../../core/QualityConfig.hpp"
+#include "../../../framework/concurrency/IndexedHeap.hpp"
+#include "../../../framework/concurrency/ShardedMap.hpp"
+#include "../../../framework/concurrency/WorkerPool.hpp"
+#include "../../../utils/MemoryBudget.hpp"
 #include "CacheModels.hpp"
 #include "DiskManifest.hpp"
+#include "ThumbPackStore.hpp"
+#include "ThumbnailAtlas.hpp"
 
 /**
  * cargador de thumbnails optimizado:
@@ -42,6 +49,10 @@ public:
     void requestLoad(int levelID, std::string fileName, LoadCallback callback, int priority = 0, bool isGif = false);
     void prefetchLevelAssets(int levelID, int priority = 0);
     void prefetchLevels(std::vector<int> const& levelIDs, int priority = 0);
+    // un solo lookup batch de manifest para los ids de una pagina que aun no
+    // tienen URL de CDN. las descargas de esos ids esperan la respuesta en vez
+    // de ir al Worker uno por uno. con countAsPage registra el hit ratio de la pagina
+    void resolveManifestBatch(std::vector<int> const& levelIDs, bool countAsPage = true);
     
     // carga por URL (para gallery thumbnails compartidos entre vistas)
     void requestUrlLoad(std::string const& url, LoadCallback callback, int priority = 0);
@@ -51,6 +62,9 @@ public:
 
     // cancelar carga pendiente
     void cancelLoad(int levelID, bool isGif = false);
+    // re-priorizar una carga que sigue en cola (p.ej. la celda entro/salio de pantalla).
+    // a diferencia de requestLoad puede bajarla; si ya arranco no hace nada
+    void updatePriority(int levelID, int priority, bool isGif = false);
     
     // cache
     bool isLoaded(int levelID, bool isGif = false) const;
@@ -79,21 +93,46 @@ public:
     // helpers
     static bool isTextureSane(cocos2d::CCTexture2D* tex);
     std::filesystem::path getCachePath(int levelID, bool isGif = false);
+    // bytes de la fuente cacheada (pack para estaticos, archivo suelto para GIF).
+    // vacio si no esta; reemplaza leer getCachePath() a mano para los estaticos
+    std::vector<uint8_t> readCachedSource(int levelID, bool isGif = false);
+    // guarda una fuente externa (p.ej. captura local) en el cache y el manifest
+    bool storeCachedSource(int levelID, std::vector<uint8_t> const& data);
+    // levels con thumbnail estatico en el cache de disco
+    std::vector<int> cachedLevelIDs();
     
     // compatibilidad
     void updateSessionCache(int levelID, cocos2d::CCTexture2D* texture);
     bool hasGIFData(int levelID) const;
-    void cleanup();
+    // exiting = cierre del juego: el loader queda apagado. si no, drena y
+    // vuelve a aceptar trabajo (maintenance "Run Cleanup")
+    void cleanup(bool exiting = false);
     void clearDiskCache();
     void clearPendingQueue();
 
-    // manifest
+    // trabajo de fondo en el carril Decode por debajo de cualquier carga de
+    // miniatura (p.ej. los colores de LevelColors); false si el pool se apaga
+    bool submitIdle(std::function<void()> job);
+    // trabajo largo y sin prisa en el carril Maintenance (benchmarks de
+    // Diagnostics); false si el pool se apaga
+    bool submitMaintenance(std::function<void()> job);
+    // el manifest ya se cargo (initDiskCache)
+    bool isDiskIndexReady() const { return m_diskIndexReady.load(std::memory_order_acquire); }
+
+    // manifest: encola un flush (append al journal) en el lane de mantenimiento
     void flushManifest();
     paimon::cache::DiskManifest& diskManifest() { return m_manifest; }
 
     // instrumentacion
     paimon::cache::CacheStats& stats() { return m_stats; }
     paimon::cache::CacheStats const& stats() const { return m_stats; }
+    paimon::concurrency::WorkerPool::Stats workerStats() const { return m_workers.stats(); }
+    paimon::cache::ThumbPackStore::Stats packStats() const { return m_pack.stats(); }
+    paimon::cache::ThumbnailAtlas::Stats atlasStats() const { return m_atlas.stats(); }
+
+    // sub-rect del thumbnail estatico en las paginas compartidas (tamaño de
+    // lista). solo main thread; nullopt si no esta o quedo de otra version
+    std::optional<paimon::cache::ThumbnailAtlas::Region> atlasRegion(int levelID);
 
     // deteccion de cambio de quality mid-session
     bool detectQualityChange();
@@ -106,68 +145,111 @@ private:
         int levelID;
         std::string fileName;
         std::string url; // para tareas URL-based (gallery)
-        int priority;
-        std::vector<LoadCallback> callbacks;
-        bool running = false;
-        bool cancelled = false;
+        std::atomic<int> priority{0};
+        std::vector<LoadCallback> callbacks; // protegido por el shard de m_tasks (o m_urlMutex)
+        std::atomic<bool> running{false};
+        std::atomic<bool> cancelled{false}; // lo leen los workers sin lock
         bool isUrlTask = false; // true si es carga por URL (gallery cache compartido)
     };
 
-    // manejo de cola — int key para level tasks, string key para url tasks
-    std::unordered_map<int, std::shared_ptr<Task>> m_tasks; // id -> tarea (pendiente y corriendo)
-    std::unordered_map<std::string, std::shared_ptr<Task>> m_urlTasks; // url -> tarea gallery
-    std::multimap<int, int, std::greater<int>> m_priorityQueue; // prioridad (desc) -> levelID
+    template <class K, class V>
+    using ShardedMap = paimon::concurrency::ShardedMap<K, V>;
+
+    // tabla de tareas (pendientes y corriendo), repartida en shards: isPending()
+    // y el alta de callbacks solo bloquean el shard de su key
+    ShardedMap<int, std::shared_ptr<Task>> m_tasks;
+    // heap indexado por key con las tareas que aun no arrancaron; una entrada
+    // por key, sin duplicados ni canceladas. lo protege m_queueMutex.
+    // orden de locks: m_queueMutex -> shard, nunca al reves
+    paimon::concurrency::IndexedHeap<int> m_priorityQueue;
     std::atomic<int> m_activeTaskCount{0};
     std::atomic<int> m_activeUrlTaskCount{0};
+    // piso de tareas en marcha (disco + decode); lo que baja de red lo regula
+    // la ventana de cada host en DownloadGovernor, ver taskLimit()
     int m_maxConcurrentTasks = 20;
-    int m_maxConcurrentUrlTasks = 10;
-    mutable std::recursive_mutex m_queueMutex;
+    mutable std::mutex m_queueMutex;
+
+    // tareas URL (gallery): pocas y de vida corta, un mutex simple alcanza
+    std::unordered_map<std::string, std::shared_ptr<Task>> m_urlTasks; // url -> tarea gallery
+    std::mutex m_urlMutex;
 
     // entrada de cache con version de invalidacion
     struct CacheEntry {
         geode::Ref<cocos2d::CCTexture2D> texture;
         int version = 0;
-        size_t byteSize = 0; // bytes estimados de la textura
     };
 
-    // cache ram (sesion) — LRU O(1) con list + iterador en map
-    std::unordered_map<int, CacheEntry> m_textureCache;
-    std::list<int> m_lruOrder;
-    std::unordered_map<int, std::list<int>::iterator> m_lruMap;
-    size_t m_textureCacheBytes = 0;
-
-    // cache ram URL (gallery compartido) — LRU O(1)
-    std::unordered_map<std::string, CacheEntry> m_urlTextureCache;
-    std::list<std::string> m_urlLruOrder;
-    std::unordered_map<std::string, std::list<std::string>::iterator> m_urlLruMap;
-    size_t m_urlCacheBytes = 0;
+    // cache ram (sesion) — LRU sharded; los hits solo toman lock compartido
+    paimon::concurrency::ShardedLru<int, CacheEntry> m_textureCache;
+
+    // cache ram URL (gallery compartido)
+    paimon::concurrency::ShardedLru<std::string, CacheEntry> m_urlTextureCache;
     static constexpr size_t URL_CACHE_MAX_ENTRIES = 60;
     static constexpr size_t URL_CACHE_MAX_BYTES = 64ull * 1024 * 1024;
 
+    // cuentas en MemoryBudget: los limites de arriba son techos, el presupuesto
+    // comun puede sacar antes lo que vale menos frente a GIFs y perfiles
+    paimon::memory::MemoryBudget::SourceId m_ramBudget = -1;
+    paimon::memory::MemoryBudget::SourceId m_urlBudget = -1;
+    static constexpr double RAM_REBUILD_COST = 1.0;  // re-decode del cache de disco
+    static constexpr double URL_REBUILD_COST = 2.0;  // suele ser red
+
+    // copia reducida de los estaticos de m_textureCache en paginas compartidas;
+    // sale del atlas cuando sale del LRU
+    paimon::cache::ThumbnailAtlas m_atlas;
+
+    // pack append-only con las fuentes estaticas y variantes .ptd (declarado
+    // antes que el manifest: el manifest guarda un puntero a el)
+    paimon::cache::ThumbPackStore m_pack;
+
     // disk manifest (reemplaza el antiguo unordered_set<int> m_diskCache)
     paimon::cache::DiskManifest m_manifest;
+    // hay un flush del manifest encolado; los siguientes se fusionan con ese
+    std::atomic<bool> m_manifestFlushPending{false};
 
     // legacy disk index — mantenido temporalmente para compatibilidad durante la transicion
     std::unordered_set<int> m_diskCache;
     std::recursive_mutex m_diskMutex;
+    // true cuando initDiskCache termino; antes de eso un miss del indice
+    // todavia puede estar en disco y se prueba el filesystem
+    std::atomic<bool> m_diskIndexReady{false};
     
     // cache fallidos con TTL (5 minutos)
-    std::unordered_map<int, std::chrono::steady_clock::time_point> m_failedCache;
-    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_urlFailedCache;
+    ShardedMap<int, std::chrono::steady_clock::time_point> m_failedCache;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_urlFailedCache; // m_urlMutex
     static constexpr auto FAILED_CACHE_TTL = std::chrono::minutes(5); // avoid re-requesting non-existent thumbnails
     static constexpr auto FAILED_CACHE_PRUNE_INTERVAL = std::chrono::minutes(1);
-    std::chrono::steady_clock::time_point m_lastFailedCachePrune = std::chrono::steady_clock::time_point::min();
+    // ticks de steady_clock de la ultima poda (0 = nunca); el que gana el CAS poda
+    std::atomic<std::chrono::steady_clock::rep> m_lastFailedCachePrune{0};
     
     // cache gifs
-    std::unordered_set<int> m_gifLevels;
+    paimon::concurrency::ShardedSet<int> m_gifLevels;
+
+    // keys con una revalidacion en vuelo (una por key)
+    paimon::concurrency::ShardedSet<int> m_revalidating;
+    // entradas sin validador (cache de antes de guardar ETags) se revalidan con
+    // un GET completo: como mucho uno por intervalo. las que no entran esperan
+    // UNVALIDATED_RETRY en memoria; lastValidated no se toca hasta que haya respuesta
+    static constexpr auto UNVALIDATED_REVALIDATE_INTERVAL = std::chrono::seconds(15);
+    static constexpr auto UNVALIDATED_RETRY = std::chrono::minutes(10);
+    // ticks de steady_clock del ultimo GET sin validador (0 = nunca)
+    std::atomic<std::chrono::steady_clock::rep> m_lastUnvalidatedRevalidate{0};
+    // key -> cuando puede volver a pedir turno una entrada sin validador pospuesta
+    ShardedMap<int, std::chrono::steady_clock::time_point> m_revalidateNotBefore;
 
     // remote revision tokens por level (thumbnailId o fallback)
-    std::unordered_map<int, std::string> m_remoteRevisions;
-
-    // version de invalidacion por level (se incrementa al invalidar)
-    std::unordered_map<int, int> m_invalidationVersions;
+    ShardedMap<int, std::string> m_remoteRevisions;
+
+    // version de invalidacion por level (se incrementa al invalidar).
+    // getInvalidationVersion() se llama por frame desde cada celda: primero
+    // mira un contador atomico por bucket y solo si ese bucket tuvo alguna
+    // invalidacion baja al shard. casi todos los levels nunca se invalidan
+    ShardedMap<int, int> m_invalidationVersions;
+    static constexpr size_t INVALIDATION_BUCKETS = 1024;
+    std::array<std::atomic<uint32_t>, INVALIDATION_BUCKETS> m_invalidationBuckets{};
     std::unordered_map<int, InvalidationCallback> m_invalidationListeners;
     int m_nextInvalidationListenerId = 1;
+    std::mutex m_listenerMutex;
 
     bool m_batchMode = false;
 
@@ -179,25 +261,45 @@ private:
 
     // metodos
     void processQueue();
+    int taskLimit() const;
     void startTask(std::shared_ptr<Task> task);
     void finishTask(std::shared_ptr<Task> task, cocos2d::CCTexture2D* texture, bool success);
     
     void addToCache(int levelID, cocos2d::CCTexture2D* texture, int version = -1);
+    // tile de atlas en el worker (vacio si la tarea no es un estatico de lista)
+    // y alta en el atlas junto con la textura, en el main thread
+    paimon::cache::ThumbnailAtlas::Tile makeAtlasTile(std::shared_ptr<Task> const& task, uint8_t const* rgba, int width, int height);
+    void insertAtlasTile(int levelID, paimon::cache::ThumbnailAtlas::Tile const& tile);
     void addToUrlCache(std::string const& url, cocos2d::CCTexture2D* texture);
-    void evictUrlCacheLocked();
-    int getVersionForKeyLocked(int key) const;
+    void registerBudgetSources();
+    int getVersionForKey(int key) const;
     void initDiskCache();
-    void pruneFailedCacheLocked(std::chrono::steady_clock::time_point now);
+    void pruneFailedCache(std::chrono::steady_clock::time_point now);
     void pruneDiskCache();
+    void scheduleCompaction();
+    // I/O de la fuente: estaticos en m_pack, GIF como archivo suelto
+    bool readSource(int realID, bool isGif, std::vector<uint8_t>& out);
+    // validator = ETag/Last-Modified de la respuesta, se guarda pa revalidar
+    bool persistSource(int realID, bool isGif, std::vector<uint8_t> const& data, std::string const& validator = {});
+
+    // revalidacion: un hit de disco pasada la ventana se sirve igual y se
+    // pregunta al servidor con If-None-Match/If-Modified-Since por detras
+    void maybeRevalidate(int realID, bool isGif);
+    void applyRevalidation(int realID, bool isGif, std::vector<uint8_t> data, std::string validator);
+    // true si toca un GET sin validador (ver UNVALIDATED_REVALIDATE_INTERVAL)
+    bool takeUnvalidatedRevalidateSlot();
+    void markValidated(int realID, bool isGif, std::string const& validator);
+    // la parte de invalidateLevel que no toca el disco: version, RAM y listeners
+    void invalidateInMemory(int levelID, bool isGif);
     
     // Worker methods
     void workerLoadFromDisk(std::shared_ptr<Task> task);
     void workerDownload(std::shared_ptr<Task> task);
     void workerUrlDownload(std::shared_ptr<Task> task);
     void processUrlQueue();
-    void spawnBackground(std::function<void()> job);
-    void waitBackgroundWorkers();
-    void pruneFinishedWorkers();
+    int urlTaskLimit(std::string const& url) const;
+    using Lane = paimon::concurrency::WorkerPool::Lane;
+    void spawnBackground(Lane lane, int priority, std::function<void()> job);
 
     // decode helper: decodifica pixeles y aplica downscale por quality fuera del main thread
     struct DecodeResult {
@@ -209,9 +311,18 @@ private:
         int64_t decodeTimeUs = 0;
     };
     DecodeResult decodeImageData(std::vector<uint8_t> const& data, int realID);
-
-    std::vector<std::future<void>> m_backgroundWorkers;
-    mutable std::recursive_mutex m_workerMutex;
+    // variante pre-decodificada en el pack (<archivo>.ptd, ver DecodedThumbCache)
+    bool tryLoadDecodedVariant(std::shared_ptr<Task> task, int realID, bool sourceIsGif);
+    void storeDecodedVariant(int realID, bool sourceIsGif, DecodeResult const& decoded, size_t sourceBytes);
+
+    // reduce al maxDimension() del tier activo y registra el ahorro en m_stats
+    void applyQualityDownscale(std::vector<uint8_t>& pixels, int& width, int& height);
+
+    // pool fijo de workers (disk / decode / maintenance) en vez de un std::async por job
+    paimon::concurrency::WorkerPool m_workers{"ThumbnailLoader"};
+    static constexpr int INIT_PRIORITY = std::numeric_limits<int>::max();
+    static constexpr int MAINTENANCE_PRIORITY = 0;
+    static constexpr int IDLE_PRIORITY = std::numeric_limits<int>::min();
 
     // quota de cache de disco — dynamic per quality tier
     static constexpr auto MAX_DISK_CACHE_AGE = std::chrono::hours(24 * 21);
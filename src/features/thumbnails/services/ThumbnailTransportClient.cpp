@@ -19,18 +19,17 @@ cocos2d::CCTexture2D* ThumbnailTransportClient::bytesToTexture(std::vector<uint8
 
     // GIF: decode first frame manually since CCImage doesn't handle GIF
     if (isGIFData(data)) {
-        auto gifData = GIFDecoder::decode(data.data(), data.size());
-        if (gifData.frames.empty() || gifData.width <= 0 || gifData.height <= 0) {
+        GIFDecoder::Frame frame;
+        if (!GIFDecoder::decodeFirstFrame(data.data(), data.size(), frame) || frame.width <= 0 || frame.height <= 0) {
             log::error("[ThumbTransport] Failed to decode GIF data");
             return nullptr;
         }
-        auto& frame = gifData.frames[0];
         auto* tex = new CCTexture2D();
         if (!tex->initWithData(
                 frame.pixels.data(),
                 kCCTexture2DPixelFormat_RGBA8888,
-                gifData.width, gifData.height,
-                CCSizeMake(static_cast<float>(gifData.width), static_cast<float>(gifData.height)))) {
+                frame.width, frame.height,
+                CCSizeMake(static_cast<float>(frame.width), static_cast<float>(frame.height)))) {
             tex->release();
             log::error("[ThumbTransport] Failed to create texture from GIF frame");
             return nullptr;
@@ -77,17 +76,19 @@ void ThumbnailTransportClient::getThumbnails(int levelId, ThumbnailListCallback
     if (!m_serverEnabled) { log::debug("[ThumbTransport] getThumbnails: server disabled"); callback(false, {}); return; }
     log::info("[ThumbTransport] getThumbnails: levelId={}", levelId);
 
-    HttpClient::get().getThumbnails(levelId, [callback, levelId](bool success, std::string const& response) {
-        if (!success) { log::warn("[ThumbTransport] getThumbnails callback: FAILED levelId={}", levelId); callback(false, {}); return; }
+    // el parse corre fuera del hilo principal; a main solo llega la lista
+    using ParsedList = std::optional<std::vector<ThumbnailInfo>>;
+    HttpClient::get().getThumbnails<ParsedList>(levelId, [levelId](bool success, std::string const& response) -> ParsedList {
+        if (!success) { log::warn("[ThumbTransport] getThumbnails callback: FAILED levelId={}", levelId); return std::nullopt; }
 
         auto res = matjson::parse(response);
-        if (!res.isOk()) { callback(false, {}); return; }
+        if (!res.isOk()) return std::nullopt;
         auto json = res.unwrap();
         std::vector<ThumbnailInfo> thumbnails;
 
         if (json.contains("thumbnails") && json["thumbnails"].isArray()) {
             auto arrRes = json["thumbnails"].asArray();
-            if (!arrRes.isOk()) { callback(false, {}); return; }
+            if (!arrRes.isOk()) return std::nullopt;
             for (auto const& item : arrRes.unwrap()) {
                 ThumbnailInfo info;
                 info.id     = item["id"].asString().unwrapOr("");
@@ -114,17 +115,20 @@ void ThumbnailTransportClient::getThumbnails(int levelId, ThumbnailListCallback
                 thumbnails.push_back(info);
             }
         }
-        log::info("[ThumbTransport] getThumbnails callback: levelId={} count={}", levelId, thumbnails.size());
+        return thumbnails;
+    }, [callback, levelId](ParsedList thumbnails) {
+        if (!thumbnails) { callback(false, {}); return; }
+        log::info("[ThumbTransport] getThumbnails callback: levelId={} count={}", levelId, thumbnails->size());
 
         // propagar revision remota al loader para invalidacion automatica
-        if (!thumbnails.empty()) {
-            auto const& first = thumbnails.front();
+        if (!thumbnails->empty()) {
+            auto const& first = thumbnails->front();
             auto revToken = paimon::cache::DiskManifestEntry::makeRevisionToken(
                 first.id, first.date, first.format, first.url);
             ThumbnailLoader::get().updateRemoteRevision(levelId, revToken);
         }
 
-        callback(true, thumbnails);
+        callback(true, *thumbnails);
     });
 }
 
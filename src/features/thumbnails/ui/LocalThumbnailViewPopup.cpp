@@ -1094,7 +1094,7 @@ void LocalThumbnailViewPopup::onDownloadBtn(CCObject*) {
     auto doSave = [safeRef, levelID, notifyResult](std::filesystem::path savePath) {
         log::debug("Save path chosen: {}", geode::utils::string::pathToString(savePath));
 
-        // 1) findAnyThumbnail incluye .rgb, .png, .webp en thumb y cache; 2) fallback getCachePath (.png/.gif)
+        // 1) findAnyThumbnail incluye .rgb, .png, .webp en thumb y cache; 2) fallback getCachePath (.png/.gif); 3) pack del cache
         std::optional<std::string> pathStr = LocalThumbs::get().findAnyThumbnail(levelID);
         bool fromCache = false;
         if (!pathStr) {
@@ -1155,6 +1155,21 @@ void LocalThumbnailViewPopup::onDownloadBtn(CCObject*) {
             return;
         }
 
+        // PNG descargado: vive en el pack del cache, se copian los bytes originales
+        if (auto packed = ThumbnailLoader::get().readCachedSource(levelID, false); !packed.empty()) {
+            std::filesystem::path destPath = savePath.parent_path() / (geode::utils::string::pathToString(savePath.stem()) + ".png");
+            std::thread([safeRef, packed = std::move(packed), destPath, notifyResult]() {
+                std::ofstream out(destPath, std::ios::binary | std::ios::trunc);
+                if (out) out.write(reinterpret_cast<char const*>(packed.data()), packed.size());
+                bool ok = static_cast<bool>(out);
+                Loader::get()->queueInMainThread([safeRef, ok, destPath, notifyResult]() {
+                    if (!safeRef->getParent()) return;
+                    notifyResult(ok, destPath);
+                });
+            }).detach();
+            return;
+        }
+
         // Sin ruta en disco: intentar guardar desde la textura mostrada (fallback)
         if (safeRef->m_thumbnailTexture && safeRef->m_thumbnailTexture->getPixelsWide() > 0 && safeRef->m_thumbnailTexture->getPixelsHigh() > 0) {
             int w = safeRef->m_thumbnailTexture->getPixelsWide();
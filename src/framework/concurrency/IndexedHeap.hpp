@@ -0,0 +1,144 @@
+#pragma once
+
+// IndexedHeap.hpp — Heap binario de maximos con indice key -> posicion.
+// A diferencia de un multimap/priority_queue, cada key esta como mucho una
+// vez: cambiar la prioridad mueve la entrada (sift up/down) en vez de meter
+// un duplicado, y quitar una key es O(log n) sin dejar basura que luego haya
+// que saltar al despachar.
+//
+// Empates: sale primero la que entro antes (FIFO). Un cambio de prioridad
+// conserva el orden de llegada original.
+//
+// No es thread-safe; lo protege el mutex del que lo usa.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace paimon::concurrency {
+
+template <class K, class Hash = std::hash<K>>
+class IndexedHeap {
+public:
+    // inserta o cambia la prioridad; devuelve true si la key era nueva
+    bool push(K const& key, int priority) {
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            setPriority(it->second, priority);
+            return false;
+        }
+        m_heap.push_back(Entry{key, priority, m_nextSeq++});
+        m_index.emplace(key, m_heap.size() - 1);
+        siftUp(m_heap.size() - 1);
+        return true;
+    }
+
+    // solo cambia la prioridad si la key ya esta en el heap
+    bool update(K const& key, int priority) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        setPriority(it->second, priority);
+        return true;
+    }
+
+    bool remove(K const& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        size_t i = it->second;
+        m_index.erase(it);
+        size_t last = m_heap.size() - 1;
+        if (i != last) {
+            m_heap[i] = std::move(m_heap[last]);
+            m_index[m_heap[i].key] = i;
+            m_heap.pop_back();
+            // el que subio desde el final puede tener que ir en cualquier direccion
+            if (!siftUp(i)) siftDown(i);
+        } else {
+            m_heap.pop_back();
+        }
+        return true;
+    }
+
+    std::optional<K> pop() {
+        if (m_heap.empty()) return std::nullopt;
+        K key = m_heap.front().key;
+        remove(key);
+        return key;
+    }
+
+    std::optional<int> priorityOf(K const& key) const {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return std::nullopt;
+        return m_heap[it->second].priority;
+    }
+
+    K const& top() const { return m_heap.front().key; }
+    int topPriority() const { return m_heap.front().priority; }
+    bool contains(K const& key) const { return m_index.count(key) > 0; }
+    bool empty() const { return m_heap.empty(); }
+    size_t size() const { return m_heap.size(); }
+
+    void clear() {
+        m_heap.clear();
+        m_index.clear();
+    }
+
+private:
+    struct Entry {
+        K key;
+        int priority;
+        uint64_t seq;
+    };
+    std::vector<Entry> m_heap;
+    std::unordered_map<K, size_t, Hash> m_index;
+    uint64_t m_nextSeq = 0;
+
+    static bool before(Entry const& a, Entry const& b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        return a.seq < b.seq;
+    }
+
+    void setPriority(size_t i, int priority) {
+        int old = m_heap[i].priority;
+        if (old == priority) return;
+        m_heap[i].priority = priority;
+        if (priority > old) siftUp(i);
+        else siftDown(i);
+    }
+
+    void place(size_t i) { m_index[m_heap[i].key] = i; }
+
+    bool siftUp(size_t i) {
+        size_t start = i;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(m_heap[i], m_heap[parent])) break;
+            std::swap(m_heap[i], m_heap[parent]);
+            place(i);
+            i = parent;
+        }
+        place(i);
+        return i != start;
+    }
+
+    void siftDown(size_t i) {
+        size_t n = m_heap.size();
+        while (true) {
+            size_t best = i;
+            size_t l = 2 * i + 1;
+            size_t r = l + 1;
+            if (l < n && before(m_heap[l], m_heap[best])) best = l;
+            if (r < n && before(m_heap[r], m_heap[best])) best = r;
+            if (best == i) break;
+            std::swap(m_heap[i], m_heap[best]);
+            place(i);
+            i = best;
+        }
+        place(i);
+    }
+};
+
+} // namespace paimon::concurrency
@@ -0,0 +1,315 @@
+#pragma once
+
+// ShardedMap.hpp — Mapas repartidos en shards con un shared_mutex cada uno.
+// Sustituye el patron "un unordered_map detras de un recursive_mutex global":
+// una key siempre cae en el mismo shard, las lecturas toman el lock
+// compartido y las escrituras solo bloquean su shard. Asi cientos de celdas
+// preguntando isLoaded() por frame no se pelean con los workers.
+//
+// read(key, fn) / update(key, fn) corren fn con el lock del shard tomado
+// (compartido / exclusivo) y le pasan el unordered_map del shard. fn no debe
+// tocar otro shard ni otro lock que pueda tomarse antes que este.
+//
+// ShardedLru añade un LRU aproximado por tick global: los hits solo escriben
+// un atomico (lock compartido) y la eviccion junta los ticks de todos los
+// shards en una sola pasada y saca de la mas vieja hacia arriba. Pensado para
+// caches chicos (decenas/cientos de entradas) donde recorrerlos en cada
+// insert sale mas barato que una lista global.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace paimon::concurrency {
+
+namespace detail {
+// std::hash<int> es la identidad: mezclar antes de elegir shard para que
+// IDs consecutivos no caigan todos en el mismo
+inline size_t mixHash(size_t h) {
+    uint64_t x = static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(x ^ (x >> 32));
+}
+
+template <class Container, size_t N, class Hash>
+class Shards {
+public:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+    template <class K, class Fn>
+    decltype(auto) read(K const& key, Fn&& fn) const {
+        auto& s = shardFor(key);
+        std::shared_lock lock(s.mutex);
+        return fn(static_cast<Container const&>(s.data));
+    }
+
+    template <class K, class Fn>
+    decltype(auto) update(K const& key, Fn&& fn) {
+        auto& s = shardFor(key);
+        std::unique_lock lock(s.mutex);
+        return fn(s.data);
+    }
+
+    // recorre shard por shard con lock exclusivo; nunca tiene dos a la vez
+    template <class Fn>
+    void forEachShard(Fn&& fn) {
+        for (auto& s : m_shards) {
+            std::unique_lock lock(s.mutex);
+            fn(s.data);
+        }
+    }
+
+    template <class Fn>
+    void forEachShardShared(Fn&& fn) const {
+        for (auto const& s : m_shards) {
+            std::shared_lock lock(s.mutex);
+            fn(static_cast<Container const&>(s.data));
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        forEachShardShared([&](Container const& c) { total += c.size(); });
+        return total;
+    }
+
+    void clear() {
+        forEachShard([](Container& c) { c.clear(); });
+    }
+
+    static constexpr size_t SHARD_COUNT = N;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        Container data;
+    };
+    std::array<Shard, N> m_shards;
+
+    template <class K>
+    Shard& shardFor(K const& key) { return m_shards[mixHash(Hash{}(key)) & (N - 1)]; }
+    template <class K>
+    Shard const& shardFor(K const& key) const { return m_shards[mixHash(Hash{}(key)) & (N - 1)]; }
+};
+} // namespace detail
+
+// ── ShardedMap ──────────────────────────────────────────────────────
+
+template <class K, class V, size_t N = 16, class Hash = std::hash<K>>
+class ShardedMap : public detail::Shards<std::unordered_map<K, V, Hash>, N, Hash> {
+    using Base = detail::Shards<std::unordered_map<K, V, Hash>, N, Hash>;
+public:
+    using Map = std::unordered_map<K, V, Hash>;
+
+    bool contains(K const& key) const {
+        return Base::read(key, [&](Map const& m) { return m.count(key) > 0; });
+    }
+
+    // copia del valor; para valores grandes usar read()
+    std::optional<V> find(K const& key) const {
+        return Base::read(key, [&](Map const& m) -> std::optional<V> {
+            auto it = m.find(key);
+            if (it == m.end()) return std::nullopt;
+            return it->second;
+        });
+    }
+
+    void set(K const& key, V value) {
+        Base::update(key, [&](Map& m) { m.insert_or_assign(key, std::move(value)); });
+    }
+
+    bool erase(K const& key) {
+        return Base::update(key, [&](Map& m) { return m.erase(key) > 0; });
+    }
+
+    // borra las entradas que cumplan pred(key, value); devuelve cuantas
+    template <class Pred>
+    size_t eraseIf(Pred&& pred) {
+        size_t removed = 0;
+        Base::forEachShard([&](Map& m) {
+            removed += std::erase_if(m, [&](auto const& kv) { return pred(kv.first, kv.second); });
+        });
+        return removed;
+    }
+};
+
+// ── ShardedSet ──────────────────────────────────────────────────────
+
+template <class K, size_t N = 16, class Hash = std::hash<K>>
+class ShardedSet : public detail::Shards<std::unordered_set<K, Hash>, N, Hash> {
+    using Base = detail::Shards<std::unordered_set<K, Hash>, N, Hash>;
+public:
+    using Set = std::unordered_set<K, Hash>;
+
+    bool contains(K const& key) const {
+        return Base::read(key, [&](Set const& s) { return s.count(key) > 0; });
+    }
+    bool insert(K const& key) {
+        return Base::update(key, [&](Set& s) { return s.insert(key).second; });
+    }
+    bool erase(K const& key) {
+        return Base::update(key, [&](Set& s) { return s.erase(key) > 0; });
+    }
+};
+
+// ── ShardedLru ──────────────────────────────────────────────────────
+
+template <class K, class V, size_t N = 16, class Hash = std::hash<K>>
+class ShardedLru {
+public:
+    struct Node {
+        V value;
+        size_t bytes = 0;
+        mutable std::atomic<uint64_t> lastUse{0};
+
+        Node(V v, size_t b, uint64_t tick) : value(std::move(v)), bytes(b), lastUse(tick) {}
+    };
+    using Map = std::unordered_map<K, Node, Hash>;
+
+    bool contains(K const& key) const {
+        return m_shards.read(key, [&](Map const& m) { return m.count(key) > 0; });
+    }
+
+    // hit: marca el uso sin lock exclusivo y devuelve una copia del valor
+    std::optional<V> get(K const& key) const {
+        return m_shards.read(key, [&](Map const& m) -> std::optional<V> {
+            auto it = m.find(key);
+            if (it == m.end()) return std::nullopt;
+            it->second.lastUse.store(nextTick(), std::memory_order_relaxed);
+            return it->second.value;
+        });
+    }
+
+    void put(K const& key, V value, size_t bytes) {
+        m_shards.update(key, [&](Map& m) {
+            if (auto it = m.find(key); it != m.end()) {
+                m_bytes.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+                m_count.fetch_sub(1, std::memory_order_relaxed);
+                m.erase(it);
+            }
+            m.try_emplace(key, std::move(value), bytes, nextTick());
+            m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    bool erase(K const& key) {
+        return m_shards.update(key, [&](Map& m) { return eraseLocked(m, key); });
+    }
+
+    // borra la entrada solo si pred(value) sigue siendo cierto bajo el lock
+    template <class Pred>
+    bool eraseIf(K const& key, Pred&& pred) {
+        return m_shards.update(key, [&](Map& m) {
+            auto it = m.find(key);
+            if (it == m.end() || !pred(it->second.value)) return false;
+            return eraseLocked(m, key);
+        });
+    }
+
+    // saca las entradas menos usadas hasta quedar dentro de ambos limites
+    size_t evictTo(size_t maxEntries, size_t maxBytes) {
+        return evictTo(maxEntries, maxBytes, [](K const&) {});
+    }
+
+    // igual, avisando onEvict(key) por cada entrada sacada (fuera del lock)
+    template <class OnEvict>
+    size_t evictTo(size_t maxEntries, size_t maxBytes, OnEvict&& onEvict) {
+        auto over = [&]() {
+            return m_count.load(std::memory_order_relaxed) > maxEntries ||
+                   m_bytes.load(std::memory_order_relaxed) > maxBytes;
+        };
+        struct Candidate {
+            uint64_t lastUse;
+            K key;
+        };
+        // min-heap por lastUse
+        auto newer = [](Candidate const& a, Candidate const& b) { return a.lastUse > b.lastUse; };
+
+        size_t evicted = 0;
+        while (over()) {
+            // una pasada con lock compartido junta todas; despues se sacan de
+            // la mas vieja hacia arriba sin volver a recorrer los shards
+            std::vector<Candidate> heap;
+            heap.reserve(size());
+            m_shards.forEachShardShared([&](Map const& m) {
+                for (auto const& [key, node] : m) {
+                    heap.push_back(Candidate{node.lastUse.load(std::memory_order_relaxed), key});
+                }
+            });
+            if (heap.empty()) break;
+            std::make_heap(heap.begin(), heap.end(), newer);
+
+            size_t round = 0;
+            while (!heap.empty() && over()) {
+                std::pop_heap(heap.begin(), heap.end(), newer);
+                auto c = std::move(heap.back());
+                heap.pop_back();
+                // si tuvo un hit (o se reemplazo) desde la pasada ya no es de
+                // las mas viejas: se deja
+                bool gone = m_shards.update(c.key, [&](Map& m) {
+                    auto it = m.find(c.key);
+                    if (it == m.end() || it->second.lastUse.load(std::memory_order_relaxed) != c.lastUse) return false;
+                    return eraseLocked(m, c.key);
+                });
+                if (gone) {
+                    evicted++;
+                    round++;
+                    onEvict(c.key);
+                }
+            }
+            // todas cambiaron entre medio: el proximo evictTo lo retoma
+            if (round == 0) break;
+        }
+        return evicted;
+    }
+
+    // fn(key, value&) con el shard bloqueado en exclusivo
+    template <class Fn>
+    void forEach(Fn&& fn) {
+        m_shards.forEachShard([&](Map& m) {
+            for (auto& [key, node] : m) fn(key, node.value);
+        });
+    }
+
+    void clear() {
+        m_shards.forEachShard([&](Map& m) {
+            for (auto const& [_, node] : m) {
+                m_bytes.fetch_sub(node.bytes, std::memory_order_relaxed);
+                m_count.fetch_sub(1, std::memory_order_relaxed);
+            }
+            m.clear();
+        });
+    }
+
+    size_t size() const { return m_count.load(std::memory_order_relaxed); }
+    size_t bytes() const { return m_bytes.load(std::memory_order_relaxed); }
+
+private:
+    detail::Shards<Map, N, Hash> m_shards;
+    std::atomic<size_t> m_count{0};
+    std::atomic<size_t> m_bytes{0};
+    mutable std::atomic<uint64_t> m_tick{0};
+
+    uint64_t nextTick() const { return m_tick.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    bool eraseLocked(Map& m, K const& key) {
+        auto it = m.find(key);
+        if (it == m.end()) return false;
+        m_bytes.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+        m.erase(it);
+        return true;
+    }
+};
+
+} // namespace paimon::concurrency
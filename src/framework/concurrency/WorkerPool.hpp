@@ -0,0 +1,297 @@
+#pragma once
+
+// WorkerPool.hpp — Pool fijo de hilos con carriles (lanes) y prioridad.
+// Reemplaza el patron "un std::async por job" de los servicios de cache:
+// los hilos se crean una sola vez, los jobs se encolan por prioridad
+// (mayor valor = antes) y los workers ociosos roban trabajo de otros carriles.
+//
+// Carriles:
+//   Disk        — lecturas/escrituras de cache en disco (I/O bloqueante)
+//   Decode      — decodificacion y post-proceso de imagenes (CPU)
+//   Maintenance — flush de manifest, invalidaciones, poda (baja prioridad)
+//
+// Disk y Decode se roban trabajo entre si cuando su cola esta vacia.
+// Maintenance tiene un hilo propio y no roba ni es robado, asi un flush
+// largo nunca bloquea una lectura visible.
+//
+// Uso:
+//   paimon::concurrency::WorkerPool pool("ThumbnailLoader");
+//   pool.submit(WorkerPool::Lane::Disk, priority, [] { ... });
+//   pool.shutdown(); // drena la cola y hace join
+//
+// Durante shutdown() los submit de fuera devuelven false (quien llama decide
+// que hacer con el job). Los que hace un job del propio pool (p.ej. un decode
+// que encola su escritura a disco) si entran: el drenaje sigue hasta que no
+// queda nada en ninguna cola ni corriendo.
+//
+// Tras shutdown() el pool vuelve a arrancar hilos en el siguiente submit,
+// asi un "cleanup" a mitad de sesion no deja el servicio sin workers.
+
+#include <Geode/Geode.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace paimon::concurrency {
+
+class WorkerPool {
+public:
+    enum class Lane : uint8_t { Disk = 0, Decode = 1, Maintenance = 2 };
+    static constexpr size_t LANE_COUNT = 3;
+
+    // contadores para instrumentacion (debug settings / logs)
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t stolen = 0;
+        size_t queued = 0;
+        size_t active = 0;
+        int64_t p50QueueUs = 0; // latencia desde submit hasta arranque del job
+        int64_t p99QueueUs = 0;
+    };
+
+    explicit WorkerPool(std::string name) : m_name(std::move(name)) {
+        unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+        m_laneThreads = {
+            std::clamp<unsigned>(hc / 2, 1, 2),
+            std::clamp<unsigned>(hc > 2 ? hc - 2 : 1, 1, 3),
+            1
+        };
+#else
+        m_laneThreads = {
+            std::clamp<unsigned>(hc / 2, 2, 4),
+            std::clamp<unsigned>(hc > 1 ? hc - 1 : 1, 1, 8),
+            1
+        };
+#endif
+    }
+
+    ~WorkerPool() {
+        shutdown();
+    }
+
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+    // encola un job; devuelve false si el pool se esta apagando y no lo pide
+    // uno de sus propios workers
+    bool submit(Lane lane, int priority, std::function<void()> job) {
+        if (!job) return false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping && t_currentPool != this) return false;
+            ensureStartedLocked();
+            m_queues[static_cast<size_t>(lane)].push(Job{
+                priority, m_nextSeq++, std::chrono::steady_clock::now(), std::move(job)
+            });
+            m_submitted++;
+        }
+        // notify_all: un worker de Decode puede robar un job de Disk
+        m_cv.notify_all();
+        return true;
+    }
+
+    // espera a que todas las colas esten vacias y no haya jobs corriendo.
+    // los hilos siguen vivos; se puede seguir encolando despues.
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleCv.wait(lock, [this] { return queuedLocked() == 0 && m_active == 0; });
+    }
+
+    // deja de aceptar jobs de fuera, ejecuta los que quedan en cola (y los que
+    // esos encolen) y hace join. NO llamar desde un worker.
+    void shutdown() {
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_started || m_stopping) return;
+            m_stopping = true;
+            threads.swap(m_threads);
+        }
+        m_cv.notify_all();
+        for (auto& t : threads) {
+            if (t.joinable()) t.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_started = false;
+            m_stopping = false;
+        }
+        m_idleCv.notify_all();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats s;
+        s.submitted = m_submitted;
+        s.completed = m_completed;
+        s.stolen = m_stolen;
+        s.queued = queuedLocked();
+        s.active = m_active;
+
+        std::vector<int64_t> samples(m_latencySamples.begin(),
+            m_latencySamples.begin() + std::min(m_latencyCount, m_latencySamples.size()));
+        if (!samples.empty()) {
+            auto pick = [&samples](double q) {
+                size_t idx = static_cast<size_t>(q * static_cast<double>(samples.size() - 1));
+                std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+                return samples[idx];
+            };
+            s.p50QueueUs = pick(0.50);
+            s.p99QueueUs = pick(0.99);
+        }
+        return s;
+    }
+
+private:
+    struct Job {
+        int priority;
+        uint64_t seq;
+        std::chrono::steady_clock::time_point enqueuedAt;
+        std::function<void()> fn;
+    };
+
+    // mayor prioridad primero; a igual prioridad, FIFO por seq
+    struct JobOrder {
+        bool operator()(Job const& a, Job const& b) const {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            return a.seq > b.seq;
+        }
+    };
+    using JobQueue = std::priority_queue<Job, std::vector<Job>, JobOrder>;
+
+    std::string m_name;
+    std::array<unsigned, LANE_COUNT> m_laneThreads{};
+    std::array<JobQueue, LANE_COUNT> m_queues;
+    std::vector<std::thread> m_threads;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_idleCv;
+    bool m_started = false;
+    bool m_stopping = false;
+    uint64_t m_nextSeq = 0;
+    uint64_t m_submitted = 0;
+    uint64_t m_completed = 0;
+    uint64_t m_stolen = 0;
+    size_t m_active = 0;
+
+    // pool del worker que corre en este hilo (nullptr fuera de los workers)
+    static inline thread_local WorkerPool const* t_currentPool = nullptr;
+
+    // ring buffer de latencias de cola (microsegundos) para p50/p99
+    static constexpr size_t LATENCY_SAMPLES = 512;
+    std::array<int64_t, LATENCY_SAMPLES> m_latencySamples{};
+    size_t m_latencyCount = 0;
+    size_t m_latencyHead = 0;
+
+    size_t queuedLocked() const {
+        size_t total = 0;
+        for (auto const& q : m_queues) total += q.size();
+        return total;
+    }
+
+    // los hilos se crean en el primer submit: los singletons estaticos que
+    // tienen un pool no arrancan hilos durante la carga de la DLL
+    void ensureStartedLocked() {
+        if (m_started) return;
+        m_started = true;
+        for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            for (unsigned i = 0; i < m_laneThreads[lane]; ++i) {
+                m_threads.emplace_back([this, lane, i] { workerLoop(static_cast<Lane>(lane), i); });
+            }
+        }
+    }
+
+    // saca el mejor job para un worker del carril `home`: primero su propia
+    // cola, luego roba de los carriles hermanos (Disk <-> Decode)
+    bool popLocked(Lane home, Job& out) {
+        auto& own = m_queues[static_cast<size_t>(home)];
+        if (!own.empty()) {
+            out = std::move(const_cast<Job&>(own.top()));
+            own.pop();
+            return true;
+        }
+        if (home == Lane::Maintenance) return false;
+
+        auto sibling = home == Lane::Disk ? Lane::Decode : Lane::Disk;
+        auto& other = m_queues[static_cast<size_t>(sibling)];
+        if (!other.empty()) {
+            out = std::move(const_cast<Job&>(other.top()));
+            other.pop();
+            m_stolen++;
+            return true;
+        }
+        return false;
+    }
+
+    bool hasWorkLocked(Lane home) const {
+        if (!m_queues[static_cast<size_t>(home)].empty()) return true;
+        if (home == Lane::Maintenance) return false;
+        auto sibling = home == Lane::Disk ? Lane::Decode : Lane::Disk;
+        return !m_queues[static_cast<size_t>(sibling)].empty();
+    }
+
+    void recordLatencyLocked(int64_t us) {
+        m_latencySamples[m_latencyHead] = us;
+        m_latencyHead = (m_latencyHead + 1) % LATENCY_SAMPLES;
+        m_latencyCount = std::min(m_latencyCount + 1, LATENCY_SAMPLES);
+    }
+
+    void workerLoop(Lane lane, unsigned index) {
+        static constexpr char const* LANE_NAMES[] = {"Disk", "Decode", "Maint"};
+        geode::utils::thread::setName(fmt::format("{} {} #{}", m_name, LANE_NAMES[static_cast<size_t>(lane)], index));
+        t_currentPool = this;
+
+        // en shutdown solo se sale cuando no queda nada en ninguna cola ni
+        // corriendo: un job en marcha puede encolar otro en cualquier carril
+        auto drained = [this] { return m_stopping && queuedLocked() == 0 && m_active == 0; };
+
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&] { return drained() || hasWorkLocked(lane); });
+                if (!popLocked(lane, job)) {
+                    if (drained()) return;
+                    continue;
+                }
+                m_active++;
+                recordLatencyLocked(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - job.enqueuedAt).count());
+            }
+
+            // con std::async la excepcion se quedaba en el future; aqui mataria
+            // el proceso (std::terminate) y dejaria m_active colgado para waitIdle
+            try {
+                job.fn();
+            } catch (std::exception const& e) {
+                geode::log::error("[{} {}] un job lanzo una excepcion: {}", m_name, LANE_NAMES[static_cast<size_t>(lane)], e.what());
+            } catch (...) {
+                geode::log::error("[{} {}] un job lanzo una excepcion desconocida", m_name, LANE_NAMES[static_cast<size_t>(lane)]);
+            }
+
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_active--;
+                m_completed++;
+                stopping = m_stopping;
+            }
+            m_idleCv.notify_all();
+            // los que esperan en shutdown vuelven a mirar si ya esta todo drenado
+            if (stopping) m_cv.notify_all();
+        }
+    }
+};
+
+} // namespace paimon::concurrency
@@ -0,0 +1,302 @@
+#pragma once
+
+// DownloadGovernor.hpp — Ventana de descargas adaptativa (AIMD) por host.
+// Antes el limite era fijo: 20 tareas en desktop (8 en movil o lo del
+// setting), 10 para URLs y 50 en ProfileThumbs. Con mala conexion 20
+// descargas a la vez acababan todas en timeout; con fibra no llenaban el enlace.
+//
+// Ahora cada host (CDN y Worker por separado) tiene su propia ventana:
+// - cada descarga que sale bien la agranda: +1 por respuesta hasta la primera
+//   perdida (arranque lento) y +1/ventana despues (una por ronda)
+// - solo crece si se esta usando entera y la latencia no se disparo respecto
+//   a la minima vista: si sube es que ya hay cola en algun lado. la latencia
+//   sale solo de respuestas 2xx con cuerpo (los 304/404 no bajan una imagen)
+// - un error de red, timeout, 429 o 5xx la parte a la mitad, una vez por
+//   ronda: los fallos de requests que salieron antes del recorte no recortan
+//   otra vez (una rafaga de timeouts no la tira a 1 de golpe)
+//
+// HttpClient pide turno antes de cada GET binario (acquire) y lo devuelve con
+// la muestra al llegar la respuesta (release). Lo que no entra espera en una
+// cola FIFO por host y sale en el hilo principal cuando hay hueco. Las colas
+// con prioridad propia (ThumbnailLoader, ProfileThumbs) miran window() para
+// no soltar mas de lo que cabe y seguir eligiendo ellas el orden.
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/function.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace paimon::net {
+
+struct HostWindowStats {
+    std::string host;
+    double window = 0;
+    int peakWindow = 0;
+    int inFlight = 0;
+    size_t queued = 0;
+    uint64_t requests = 0;
+    uint64_t failures = 0;      // red, timeout, 429 o 5xx
+    uint64_t timeouts = 0;
+    uint64_t decreases = 0;
+    double latencyMs = 0;       // EWMA
+    double baseLatencyMs = 0;   // minima reciente
+    double throughputKBps = 0;  // EWMA de lo que entrega el host (solo informativo)
+};
+
+class DownloadGovernor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Lo que lleva cada descarga desde que sale hasta su release.
+    struct Ticket {
+        std::string host;
+        Clock::time_point started;
+        std::chrono::milliseconds timeout{0};
+        uint64_t round = 0;  // ronda del host al salir (ver release)
+    };
+
+    using Start = geode::CopyableFunction<void(Ticket)>;
+
+    static constexpr double MIN_WINDOW = 1.0;
+    static constexpr double BACKOFF = 0.5;
+    static constexpr double LATENCY_BLOAT = 2.0;  // latencia/minima a partir de la cual no crece
+    static constexpr double EWMA_ALPHA = 0.2;
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+    static constexpr int MAX_WINDOW = 16;
+    static constexpr int DEFAULT_INITIAL_WINDOW = 8;
+#else
+    static constexpr int MAX_WINDOW = 32;
+    static constexpr int DEFAULT_INITIAL_WINDOW = 12;
+#endif
+
+    static DownloadGovernor& get() {
+        static DownloadGovernor instance;
+        return instance;
+    }
+
+    // "https://cdn.example.com:443/a/b?x" -> "cdn.example.com"
+    static std::string hostOf(std::string_view url) {
+        auto scheme = url.find("://");
+        size_t begin = scheme == std::string_view::npos ? 0 : scheme + 3;
+        size_t end = url.find_first_of(":/?#", begin);
+        return std::string(url.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin));
+    }
+
+    // Con la que arrancan los hosts que aun no tienen muestras (setting de descargas).
+    void setInitialWindow(int window) {
+        std::lock_guard lock(m_mutex);
+        m_initialWindow = std::clamp(window, static_cast<int>(MIN_WINDOW), MAX_WINDOW);
+        for (auto& [name, host] : m_hosts) {
+            if (host.requests == 0) host.window = m_initialWindow;
+        }
+    }
+
+    /**
+     * Pide turno en `host`. Si cabe, `start` corre ya en este hilo; si no,
+     * espera en la cola del host y corre en el hilo principal cuando un
+     * release deje hueco. `start` tiene que acabar llamando a release.
+     */
+    void acquire(std::string const& host, std::chrono::milliseconds timeout, Start start) {
+        std::unique_lock lock(m_mutex);
+        auto& state = hostLocked(host);
+        if (state.inFlight < slots(state)) {
+            auto ticket = issueLocked(host, state, timeout);
+            lock.unlock();
+            if (start) start(std::move(ticket));
+            return;
+        }
+        state.waiting.push_back(Waiting{std::move(start), timeout});
+    }
+
+    /**
+     * Devuelve el turno con la muestra. `status` es el codigo HTTP (<= 0 si
+     * no hubo respuesta). Se puede llamar desde cualquier hilo.
+     */
+    void release(Ticket const& ticket, int status, size_t bytes) {
+        auto now = Clock::now();
+        double latencyMs = std::chrono::duration<double, std::milli>(now - ticket.started).count();
+        bool failed = status <= 0 || status == 408 || status == 429 || status >= 500;
+        bool timedOut = status <= 0 && ticket.timeout.count() > 0 && latencyMs >= ticket.timeout.count() * 0.9;
+
+        std::vector<std::pair<Start, Ticket>> ready;
+        {
+            std::lock_guard lock(m_mutex);
+            auto& state = hostLocked(ticket.host);
+            // con cola o sin hueco la ventana era el limite real; si no, crecer no aporta nada
+            bool saturated = !state.waiting.empty() || state.inFlight >= slots(state);
+            state.inFlight = std::max(0, state.inFlight - 1);
+            state.requests++;
+            state.bytes += bytes;
+
+            if (failed) {
+                state.failures++;
+                if (timedOut) state.timeouts++;
+                if (ticket.round == state.round) {
+                    state.window = std::max(MIN_WINDOW, state.window * BACKOFF);
+                    state.threshold = state.window;
+                    state.round++;
+                    state.decreases++;
+                    // la minima de antes puede no valer ya (otra red, servidor cargado)
+                    state.baseLatencyMs = 0;
+                }
+            } else {
+                // solo cuentan respuestas con cuerpo: un 304 o un 404 corto del Worker
+                // vuelven mucho antes que una imagen y dejarian la minima por los suelos
+                if (status >= 200 && status < 300 && bytes > 0) sampleLatencyLocked(state, latencyMs);
+                bool bloated = state.baseLatencyMs > 0 && state.latencyMs > state.baseLatencyMs * LATENCY_BLOAT;
+                if (saturated && !bloated) {
+                    state.window += state.window < state.threshold ? 1.0 : 1.0 / state.window;
+                    state.window = std::min(state.window, static_cast<double>(MAX_WINDOW));
+                    state.peakWindow = std::max(state.peakWindow, slots(state));
+                }
+            }
+            sampleThroughputLocked(state, now);
+
+            while (!state.waiting.empty() && state.inFlight < slots(state)) {
+                auto next = std::move(state.waiting.front());
+                state.waiting.pop_front();
+                ready.emplace_back(std::move(next.start), issueLocked(ticket.host, state, next.timeout));
+            }
+        }
+
+        if (ready.empty()) return;
+        geode::Loader::get()->queueInMainThread([ready = std::move(ready)]() mutable {
+            for (auto& [start, ticket] : ready) {
+                if (start) start(std::move(ticket));
+            }
+        });
+    }
+
+    // Descargas que caben ahora mismo en `host` (para colas que ordenan por su cuenta).
+    int window(std::string const& host) const {
+        std::lock_guard lock(m_mutex);
+        auto it = m_hosts.find(host);
+        return it == m_hosts.end() ? m_initialWindow : slots(it->second);
+    }
+
+    // Suma de todos los hosts: cuantas descargas tiene sentido tener en marcha.
+    int totalWindow() const {
+        std::lock_guard lock(m_mutex);
+        if (m_hosts.empty()) return m_initialWindow;
+        int total = 0;
+        for (auto const& [name, host] : m_hosts) total += slots(host);
+        return total;
+    }
+
+    std::vector<HostWindowStats> stats() const {
+        std::lock_guard lock(m_mutex);
+        std::vector<HostWindowStats> out;
+        out.reserve(m_hosts.size());
+        for (auto const& [name, host] : m_hosts) {
+            HostWindowStats st;
+            st.host = name;
+            st.window = host.window;
+            st.peakWindow = host.peakWindow;
+            st.inFlight = host.inFlight;
+            st.queued = host.waiting.size();
+            st.requests = host.requests;
+            st.failures = host.failures;
+            st.timeouts = host.timeouts;
+            st.decreases = host.decreases;
+            st.latencyMs = host.latencyMs;
+            st.baseLatencyMs = host.baseLatencyMs;
+            st.throughputKBps = host.throughputBps / 1024.0;
+            out.push_back(std::move(st));
+        }
+        std::sort(out.begin(), out.end(), [](auto const& a, auto const& b) { return a.requests > b.requests; });
+        return out;
+    }
+
+private:
+    struct Waiting {
+        Start start;
+        std::chrono::milliseconds timeout;
+    };
+
+    struct HostState {
+        double window = DEFAULT_INITIAL_WINDOW;
+        double threshold = MAX_WINDOW;  // por debajo crece en arranque lento
+        int peakWindow = 0;
+        int inFlight = 0;
+        uint64_t round = 0;
+        std::deque<Waiting> waiting;
+
+        uint64_t requests = 0;
+        uint64_t failures = 0;
+        uint64_t timeouts = 0;
+        uint64_t decreases = 0;
+        uint64_t bytes = 0;
+
+        double latencyMs = 0;
+        double baseLatencyMs = 0;
+        double throughputBps = 0;
+        Clock::time_point throughputMark{};
+        uint64_t throughputMarkBytes = 0;
+    };
+
+    DownloadGovernor() = default;
+    DownloadGovernor(DownloadGovernor const&) = delete;
+    DownloadGovernor& operator=(DownloadGovernor const&) = delete;
+
+    static int slots(HostState const& state) {
+        return std::max(1, static_cast<int>(std::floor(state.window)));
+    }
+
+    HostState& hostLocked(std::string const& host) {
+        auto [it, inserted] = m_hosts.try_emplace(host);
+        if (inserted) {
+            it->second.window = m_initialWindow;
+            it->second.peakWindow = m_initialWindow;
+        }
+        return it->second;
+    }
+
+    static Ticket issueLocked(std::string const& host, HostState& state, std::chrono::milliseconds timeout) {
+        state.inFlight++;
+        return Ticket{host, Clock::now(), timeout, state.round};
+    }
+
+    static void sampleLatencyLocked(HostState& state, double latencyMs) {
+        state.latencyMs = state.latencyMs == 0
+            ? latencyMs
+            : state.latencyMs + EWMA_ALPHA * (latencyMs - state.latencyMs);
+        // la minima sube despacio sola, asi un cambio de red no la deja clavada abajo
+        if (state.baseLatencyMs == 0 || latencyMs < state.baseLatencyMs) {
+            state.baseLatencyMs = latencyMs;
+        } else {
+            state.baseLatencyMs += 0.01 * (latencyMs - state.baseLatencyMs);
+        }
+    }
+
+    // solo para Diagnostics: la ventana se decide por fallos y latencia, no por esto
+    static void sampleThroughputLocked(HostState& state, Clock::time_point now) {
+        if (state.throughputMark == Clock::time_point{}) {
+            state.throughputMark = now;
+            state.throughputMarkBytes = state.bytes;
+            return;
+        }
+        double seconds = std::chrono::duration<double>(now - state.throughputMark).count();
+        if (seconds < 1.0) return;
+        double rate = (state.bytes - state.throughputMarkBytes) / seconds;
+        state.throughputBps = state.throughputBps == 0
+            ? rate
+            : state.throughputBps + EWMA_ALPHA * (rate - state.throughputBps);
+        state.throughputMark = now;
+        state.throughputMarkBytes = state.bytes;
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, HostState> m_hosts;
+    int m_initialWindow = DEFAULT_INITIAL_WINDOW;
+};
+
+} // namespace paimon::net
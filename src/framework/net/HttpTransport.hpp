@@ -11,8 +11,9 @@
 #include <Geode/Geode.hpp>
 #include <Geode/utils/web.hpp>
 #include <Geode/utils/function.hpp>
-#include "../WebHelper.hpp"
-#include "../Debug.hpp"
+#include "../../utils/WebHelper.hpp"
+#include "RequestCoalescer.hpp"
+#include "../../utils/Debug.hpp"
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -54,7 +55,8 @@ public:
 
     // ── Primitivas de request ───────────────────────────────────────
 
-    // GET/POST con respuesta texto.
+    // GET/POST con respuesta texto. Los GET identicos en vuelo se comparten
+    // (ver RequestCoalescer); un POST tira la memo de respuestas.
     void request(
         std::string const& url,
         std::string const& method,
@@ -63,6 +65,17 @@ public:
         TextCallback callback,
         bool includeModCode = true
     ) {
+        auto& coalescer = RequestCoalescer::get();
+        bool shared = RequestCoalescer::isShareable(method);
+        bool useMemo = shared && RequestCoalescer::allowsMemo(headers);
+        std::string key;
+        if (shared) {
+            key = RequestCoalescer::makeKey(method, url, includeModCode ? "" : "-nomod", headers);
+            if (!coalescer.joinText(key, WebHelper::onMain<std::string>(std::move(callback)), useMemo)) return;
+        } else {
+            coalescer.forgetResponses();
+        }
+
         auto req = geode::utils::web::WebRequest();
         req.timeout(std::chrono::seconds(10));
         req.userAgent("Paimbnails/2.x (Geode)");
@@ -89,14 +102,21 @@ public:
             req.bodyString(body);
         }
 
-        WebHelper::dispatch(std::move(req), method, url,
-            [callback](geode::utils::web::WebResponse res) {
+        // el texto se saca en el runtime; al hilo principal solo llegan los callbacks
+        WebHelper::dispatchOffMain<RequestCoalescer::Steps>(std::move(req), method, url,
+            [callback, shared, useMemo, key](geode::utils::web::WebResponse& res) -> RequestCoalescer::Steps {
                 bool ok = res.ok();
                 std::string text = ok
                     ? res.string().unwrapOr("")
                     : ("HTTP " + std::to_string(res.code()) + ": " + res.string().unwrapOr("Unknown error"));
-                if (callback) callback(ok, text);
-            });
+                if (shared) {
+                    return RequestCoalescer::get().finishText(key, ok, text, useMemo);
+                }
+                RequestCoalescer::Steps steps;
+                if (auto step = WebHelper::onMain<std::string>(callback)(ok, text)) steps.push_back(std::move(step));
+                return steps;
+            },
+            [](RequestCoalescer::Steps steps) { WebHelper::runSteps(steps); });
     }
 
     // GET binario con validacion de magic bytes de imagen.
@@ -106,6 +126,10 @@ public:
         BinaryCallback callback,
         bool validateImage = true
     ) {
+        // con y sin validacion el resultado puede cambiar, no se mezclan
+        auto key = RequestCoalescer::makeKey(validateImage ? "GET" : "GET-RAW", url, "", headers);
+        if (!RequestCoalescer::get().joinBinary(key, WebHelper::bytesOnly(WebHelper::onMain<std::vector<uint8_t>>(std::move(callback))))) return;
+
         auto req = geode::utils::web::WebRequest();
         req.timeout(std::chrono::seconds(15));
         req.userAgent("Paimbnails/2.x (Geode)");
@@ -124,8 +148,9 @@ public:
             req.header("X-Mod-Code", m_modCode);
         }
 
-        WebHelper::dispatch(std::move(req), "GET", url,
-            [callback, validateImage, url](geode::utils::web::WebResponse res) {
+        // copia y validacion de los bytes fuera del hilo principal
+        WebHelper::dispatchOffMain<RequestCoalescer::Steps>(std::move(req), "GET", url,
+            [key, validateImage](geode::utils::web::WebResponse& res) -> RequestCoalescer::Steps {
                 bool ok = res.ok();
                 std::vector<uint8_t> data = ok ? res.data() : std::vector<uint8_t>{};
 
@@ -148,8 +173,10 @@ public:
                     }
                 }
 
-                if (callback) callback(ok, data);
-            });
+                return RequestCoalescer::get().finishBinary(key, ok,
+                    WebHelper::BinaryResponse{res.code(), std::move(data), WebHelper::validatorOf(res)});
+            },
+            [](RequestCoalescer::Steps steps) { WebHelper::runSteps(steps); });
     }
 
     // Upload multipart.
@@ -188,6 +215,7 @@ public:
         }
 
         req.bodyMultipart(form);
+        RequestCoalescer::get().forgetResponses();
 
         WebHelper::dispatch(std::move(req), "POST", url,
             [callback](geode::utils::web::WebResponse res) {
@@ -0,0 +1,249 @@
+#pragma once
+
+// RequestCoalescer.hpp — Single-flight de requests HTTP.
+// Varias partes del mod piden la misma URL casi a la vez (prefetch de vecinos
+// en LocalThumbnailViewPopup, getThumbnails desde el popup y la celda, configs
+// de perfil de varios GJScoreCell...). Con esto, mientras un GET identico
+// (metodo + URL + hash de body y headers) esta en vuelo, los siguientes se
+// cuelgan de el y reciben la misma respuesta en vez de salir a la red.
+//
+// Ademas guarda unos segundos las respuestas JSON de GET que salen bien, para
+// las rafagas que llegan justo despues de que la primera termine. Cualquier
+// escritura (POST/upload) tira esa memo entera.
+//
+// La usan HttpTransport y HttpClient. Los que esperan son
+// WebHelper::OffMainHandler: corren en el worker que recibio la respuesta y
+// lo que devuelven se ejecuta despues en el hilo principal.
+
+#include <Geode/Geode.hpp>
+#include <Geode/utils/function.hpp>
+#include "../../utils/WebHelper.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace paimon::net {
+
+struct CoalescingStats {
+    uint64_t requests = 0;     // los que salieron a la red
+    uint64_t coalesced = 0;    // se colgaron de uno en vuelo
+    uint64_t memoHits = 0;     // servidos desde la memo
+    uint64_t bytesSaved = 0;   // bytes de respuesta que no hubo que bajar
+};
+
+class RequestCoalescer {
+public:
+    using TextHandler   = WebHelper::OffMainHandler<std::string>;
+    // status y validador van con los bytes: un 304 de revalidacion tambien se comparte
+    using BinaryHandler = WebHelper::OffMainHandler<WebHelper::BinaryResponse>;
+    using Steps = std::vector<WebHelper::MainStep>;
+
+    static constexpr auto MEMO_TTL = std::chrono::seconds(3);
+    static constexpr size_t MEMO_MAX_ENTRIES = 64;
+    static constexpr size_t MEMO_MAX_BYTES = 256 * 1024;  // por respuesta
+
+    static RequestCoalescer& get() {
+        static RequestCoalescer instance;
+        return instance;
+    }
+
+    // Solo los GET se comparten; un POST puede tener efectos y sale siempre.
+    static bool isShareable(std::string_view method) {
+        return method == "GET" || method == "get";
+    }
+
+    // metodo + URL + FNV-1a de body y headers (el mod code o el no-cache
+    // cambian la respuesta, asi que dos requests con headers distintos no se juntan)
+    static std::string makeKey(std::string_view method, std::string const& url,
+                               std::string_view body, std::vector<std::string> const& headers) {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](std::string_view s) {
+            for (unsigned char c : s) {
+                hash ^= c;
+                hash *= 1099511628211ULL;
+            }
+            hash ^= 0xff;
+            hash *= 1099511628211ULL;
+        };
+        mix(body);
+        for (auto const& h : headers) mix(h);
+        return fmt::format("{} {}#{:016x}", method, url, hash);
+    }
+
+    // Las respuestas de endpoints que piden no cachear no entran en la memo.
+    static bool allowsMemo(std::vector<std::string> const& headers) {
+        for (auto const& h : headers) {
+            if (h.find("no-cache") != std::string::npos || h.find("no-store") != std::string::npos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ── Texto ───────────────────────────────────────────────────────
+
+    /**
+     * Registra `handler` para `key`.
+     * @return true si el que llama tiene que mandar el request (y luego
+     *         llamar a finishText); false si ya lo cubre uno en vuelo o la memo.
+     */
+    bool joinText(std::string const& key, TextHandler handler, bool useMemo) {
+        std::unique_lock lock(m_mutex);
+        if (useMemo) {
+            auto memo = m_memo.find(key);
+            if (memo != m_memo.end()) {
+                if (Clock::now() < memo->second.expires) {
+                    auto body = memo->second.body;
+                    lock.unlock();
+                    m_memoHits.fetch_add(1, std::memory_order_relaxed);
+                    m_bytesSaved.fetch_add(body.size(), std::memory_order_relaxed);
+                    // mismo camino que una respuesta de red: handler en el runtime, el resto en main
+                    WebHelper::runOffMain<WebHelper::MainStep>(
+                        [handler = std::move(handler), body = std::move(body)]() -> WebHelper::MainStep {
+                            return handler ? handler(true, body) : WebHelper::MainStep{};
+                        },
+                        [](WebHelper::MainStep step) { if (step) step(); });
+                    return false;
+                }
+                m_memo.erase(memo);
+            }
+        }
+        auto [it, inserted] = m_text.try_emplace(key);
+        it->second.push_back(std::move(handler));
+        if (!inserted) {
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Corre los handlers de `key` en este hilo (el worker de la respuesta) y
+    // devuelve lo que hay que hacer en el hilo principal.
+    Steps finishText(std::string const& key, bool ok, std::string const& response, bool useMemo) {
+        std::vector<TextHandler> waiters;
+        {
+            std::lock_guard lock(m_mutex);
+            auto it = m_text.find(key);
+            if (it == m_text.end()) return {};
+            waiters = std::move(it->second);
+            m_text.erase(it);
+            if (ok && useMemo && looksLikeJson(response) && response.size() <= MEMO_MAX_BYTES) {
+                rememberLocked(key, response);
+            }
+        }
+        if (waiters.size() > 1) {
+            m_bytesSaved.fetch_add(response.size() * (waiters.size() - 1), std::memory_order_relaxed);
+        }
+        return runHandlers(waiters, ok, response);
+    }
+
+    // ── Binario ─────────────────────────────────────────────────────
+
+    // Igual que joinText pero sin memo: las imagenes ya tienen sus caches.
+    bool joinBinary(std::string const& key, BinaryHandler handler) {
+        std::lock_guard lock(m_mutex);
+        auto [it, inserted] = m_binary.try_emplace(key);
+        it->second.push_back(std::move(handler));
+        if (!inserted) {
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Steps finishBinary(std::string const& key, bool ok, WebHelper::BinaryResponse const& response) {
+        std::vector<BinaryHandler> waiters;
+        {
+            std::lock_guard lock(m_mutex);
+            auto it = m_binary.find(key);
+            if (it == m_binary.end()) return {};
+            waiters = std::move(it->second);
+            m_binary.erase(it);
+        }
+        if (waiters.size() > 1) {
+            m_bytesSaved.fetch_add(response.data.size() * (waiters.size() - 1), std::memory_order_relaxed);
+        }
+        return runHandlers(waiters, ok, response);
+    }
+
+    // ── Mantenimiento ───────────────────────────────────────────────
+
+    // Tras una escritura lo memorizado puede estar viejo; se tira todo.
+    void forgetResponses() {
+        std::lock_guard lock(m_mutex);
+        m_memo.clear();
+    }
+
+    CoalescingStats stats() const {
+        CoalescingStats st;
+        st.requests = m_requests.load(std::memory_order_relaxed);
+        st.coalesced = m_coalesced.load(std::memory_order_relaxed);
+        st.memoHits = m_memoHits.load(std::memory_order_relaxed);
+        st.bytesSaved = m_bytesSaved.load(std::memory_order_relaxed);
+        return st;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct MemoEntry {
+        std::string body;
+        Clock::time_point expires;
+    };
+
+    RequestCoalescer() = default;
+    RequestCoalescer(RequestCoalescer const&) = delete;
+    RequestCoalescer& operator=(RequestCoalescer const&) = delete;
+
+    template <class Handler, class Payload>
+    static Steps runHandlers(std::vector<Handler>& handlers, bool ok, Payload const& payload) {
+        Steps steps;
+        steps.reserve(handlers.size());
+        for (auto& handler : handlers) {
+            if (!handler) continue;
+            if (auto step = handler(ok, payload)) steps.push_back(std::move(step));
+        }
+        return steps;
+    }
+
+    static bool looksLikeJson(std::string const& body) {
+        auto first = body.find_first_not_of(" \t\r\n");
+        return first != std::string::npos && (body[first] == '{' || body[first] == '[');
+    }
+
+    void rememberLocked(std::string const& key, std::string const& body) {
+        auto now = Clock::now();
+        if (m_memo.size() >= MEMO_MAX_ENTRIES) {
+            std::erase_if(m_memo, [now](auto const& kv) { return kv.second.expires <= now; });
+        }
+        if (m_memo.size() >= MEMO_MAX_ENTRIES) {
+            // todas vivas: fuera la que caduca antes
+            auto oldest = m_memo.begin();
+            for (auto it = m_memo.begin(); it != m_memo.end(); ++it) {
+                if (it->second.expires < oldest->second.expires) oldest = it;
+            }
+            m_memo.erase(oldest);
+        }
+        m_memo[key] = MemoEntry{body, now + MEMO_TTL};
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::vector<TextHandler>> m_text;
+    std::unordered_map<std::string, std::vector<BinaryHandler>> m_binary;
+    std::unordered_map<std::string, MemoEntry> m_memo;
+
+    std::atomic<uint64_t> m_requests{0};
+    std::atomic<uint64_t> m_coalesced{0};
+    std::atomic<uint64_t> m_memoHits{0};
+    std::atomic<uint64_t> m_bytesSaved{0};
+};
+
+} // namespace paimon::net
@@ -0,0 +1,24 @@
+#include <Geode/Geode.hpp>
+
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+
+#include <Geode/modify/AppDelegate.hpp>
+#include "../utils/MemoryBudget.hpp"
+
+using namespace geode::prelude;
+
+// en movil el SO mata primero a las apps de fondo que mas RAM ocupan:
+// al salir a segundo plano recorto los caches de imagen como con presion moderada
+class $modify(PaimonAppDelegate, AppDelegate) {
+    void applicationDidEnterBackground() {
+        AppDelegate::applicationDidEnterBackground();
+        paimon::memory::MemoryBudget::get().onMemoryPressure(paimon::memory::MemoryPressure::Moderate);
+    }
+
+    void applicationWillEnterForeground() {
+        AppDelegate::applicationWillEnterForeground();
+        paimon::memory::MemoryBudget::get().onMemoryPressure(paimon::memory::MemoryPressure::None);
+    }
+};
+
+#endif
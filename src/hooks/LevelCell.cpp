@@ -61,6 +61,24 @@ static float getLevelCellThumbWidthFactor() {
     return std::clamp(widthFactor, PaimonConstants::MIN_THUMB_WIDTH_FACTOR, PaimonConstants::MAX_THUMB_WIDTH_FACTOR);
 }
 
+// prioridad de carga segun donde esta la celda ahora mismo: las visibles van
+// primero (las del centro antes) y las de fuera detras, por cercania al borde.
+// cuantizado a 8px pa no re-priorizar por cada pixel de scroll
+static int computeLevelCellLoadPriority(CCNode* cell) {
+    constexpr int VISIBLE_PRIORITY = 2000;
+    constexpr int OFFSCREEN_PRIORITY = 1000;
+    if (!cell || !cell->getParent()) return 0;
+    auto winSize = CCDirector::sharedDirector()->getWinSize();
+    float bottom = cell->convertToWorldSpace(CCPointZero).y;
+    float top = bottom + cell->getContentSize().height;
+    if (top > 0.f && bottom < winSize.height) {
+        float distanceFromCenter = std::abs((bottom + top) / 2.0f - winSize.height / 2.0f);
+        return VISIBLE_PRIORITY - static_cast<int>(distanceFromCenter / 8.0f);
+    }
+    float offscreen = bottom >= winSize.height ? bottom - winSize.height : -top;
+    return std::max(1, OFFSCREEN_PRIORITY - static_cast<int>(offscreen / 8.0f));
+}
+
 static float calculateLevelCellThumbCoverScale(CCSprite* sprite, float bgWidth, float bgHeight, float widthFactor, float fallback = 1.0f) {
     if (!sprite) {
         return fallback;
@@ -210,6 +228,7 @@ class $modify(PaimonLevelCell, LevelCell) {
         float m_thumbBaseScaleY = 1.0f;
         bool m_thumbnailRequested = false; // pa evitar cargas duplicadas
         int m_requestId = 0; // id unico de request pa invalidar callbacks tardios
+        int m_loadPriority = 0; // ultima prioridad mandada al ThumbnailLoader
         int m_lastRequestedLevelID = 0; // ultimo levelID pedido pa detectar cambios
         bool m_thumbnailApplied = false; // pa no aplicar miniatura varias veces
         bool m_wasInCenter = false; // pa detectar cambios de estado
@@ -552,6 +571,24 @@ class $modify(PaimonLevelCell, LevelCell) {
 
     // setupDarkMode removed Ã¢â‚¬â€ was empty (dead code)
 
+    // la miniatura estatica de este level puede salir del atlas compartido de
+    // ThumbnailLoader (un bind para toda la lista). no con efectos de hover por
+    // shader: muestrean vecinos/UV asumiendo la textura entera
+    bool canUseThumbnailAtlas(CCTexture2D* texture) {
+        auto fields = m_fields.self();
+        if (!fields || !texture || fields->m_staticTexture.data() != texture) return false;
+        cacheSettings();
+        if (!fields->m_cachedHoverEnabled) return true;
+        switch (fields->m_cachedAnimEffect) {
+            case PaimonAnimEffect::None:
+            case PaimonAnimEffect::Brightness:
+            case PaimonAnimEffect::Darken:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     CCSprite* createThumbnailSprite(CCTexture2D* texture, bool allowLevelGIF = true) {
         int32_t levelIDForGIF = m_level ? m_level->m_levelID.value() : 0;
         bool hasLevelGIF = allowLevelGIF && levelIDForGIF > 0 && ThumbnailLoader::get().hasGIFData(levelIDForGIF);
@@ -567,7 +604,13 @@ class $modify(PaimonLevelCell, LevelCell) {
             }
         }
 
-        CCSprite* sprite = PaimonShaderSprite::createWithTexture(texture);
+        CCSprite* sprite = nullptr;
+        if (!hasLevelGIF && canUseThumbnailAtlas(texture)) {
+            if (auto region = ThumbnailLoader::get().atlasRegion(levelIDForGIF)) {
+                sprite = PaimonShaderSprite::createWithTexture(region->texture, region->rect);
+            }
+        }
+        if (!sprite) sprite = PaimonShaderSprite::createWithTexture(texture);
         if (!sprite) return nullptr;
 
         if (hasLevelGIF) {
@@ -606,7 +649,7 @@ class $modify(PaimonLevelCell, LevelCell) {
                         fields->m_thumbSprite->setOpacity(255);
                     }
                 }
-            });
+            }, computeLevelCellLoadPriority(this));
         }
         
         if (sprite) {
@@ -901,7 +944,7 @@ class $modify(PaimonLevelCell, LevelCell) {
                          } else {
                              attachBackgroundSprite(createStaticBackground());
                          }
-                     });
+                     }, computeLevelCellLoadPriority(this));
                  }
              } else {
                  attachBackgroundSprite(createStaticBackground());
@@ -1863,6 +1906,7 @@ class $modify(PaimonLevelCell, LevelCell) {
         this->unschedule(schedule_selector(PaimonLevelCell::updateGalleryCycle));
         this->unschedule(schedule_selector(PaimonLevelCell::updateGradientAnim));
         this->unschedule(schedule_selector(PaimonLevelCell::updateCenterAnimation));
+        this->unschedule(schedule_selector(PaimonLevelCell::updateLoadPriority));
 
         if (auto fields = m_fields.self()) {
             fields->m_isBeingDestroyed = true;
@@ -2647,9 +2691,13 @@ class $modify(PaimonLevelCell, LevelCell) {
             
             if (enableSpinners) showLoadingSpinner();
             
-            log::info("[LevelCell] tryLoadThumbnail: requesting load levelID={} requestId={} hasGif={}", levelID, currentRequestId, fields->m_hasGif);
+            fields->m_loadPriority = computeLevelCellLoadPriority(this);
+            log::info("[LevelCell] tryLoadThumbnail: requesting load levelID={} requestId={} hasGif={} priority={}", levelID, currentRequestId, fields->m_hasGif, fields->m_loadPriority);
             WeakRef<PaimonLevelCell> safeRef = this;
             int capturedVersion = fields->m_loadedInvalidationVersion;
+            // mientras siga en cola la prioridad sigue a la posicion en pantalla
+            this->unschedule(schedule_selector(PaimonLevelCell::updateLoadPriority));
+            this->schedule(schedule_selector(PaimonLevelCell::updateLoadPriority), 0.1f);
 
             // 1) intentar GIF primero para evitar quedar pegado a cache viejo PNG/WEBP
             ThumbnailLoader::get().requestLoad(levelID, fileName, [safeRef, levelID, enableSpinners, currentRequestId, fileName, capturedVersion](CCTexture2D* gifTex, bool gifSuccess) {
@@ -2675,6 +2723,8 @@ class $modify(PaimonLevelCell, LevelCell) {
                 log::debug("[LevelCell] tryLoadThumbnail: GIF not found for levelID={}, trying static", levelID);
 
                 // 2) fallback a estatico si no hay GIF remoto/local
+                int staticPriority = computeLevelCellLoadPriority(cell);
+                if (auto f = cell->m_fields.self()) f->m_loadPriority = staticPriority;
                 ThumbnailLoader::get().requestLoad(levelID, fileName, [safeRef, levelID, enableSpinners, currentRequestId, capturedVersion](CCTexture2D* tex, bool success) {
                     auto cellRef2 = safeRef.lock();
                     auto* cell2 = static_cast<PaimonLevelCell*>(cellRef2.data());
@@ -2706,8 +2756,26 @@ class $modify(PaimonLevelCell, LevelCell) {
                     }
 
                     cell2->startLazyStaticThumbnailLoad(levelID, currentRequestId, enableSpinners, tex);
-                });
-            }, 0, true);
+                }, staticPriority);
+            }, fields->m_loadPriority, true);
+    }
+
+    // re-prioriza la carga pendiente segun la posicion actual (scroll).
+    // se desprograma sola cuando la carga deja la cola
+    void updateLoadPriority(float dt) {
+        auto fields = m_fields.self();
+        if (!fields || fields->m_isBeingDestroyed || !m_level) return;
+        int levelID = m_level->m_levelID.value();
+        auto& loader = ThumbnailLoader::get();
+        if (!fields->m_thumbnailRequested || (!loader.isPending(levelID) && !loader.isPending(levelID, true))) {
+            this->unschedule(schedule_selector(PaimonLevelCell::updateLoadPriority));
+            return;
+        }
+        int priority = computeLevelCellLoadPriority(this);
+        if (priority == fields->m_loadPriority) return;
+        fields->m_loadPriority = priority;
+        loader.updatePriority(levelID, priority, true);
+        loader.updatePriority(levelID, priority);
     }
 
     $override void update(float dt) {
@@ -363,7 +363,7 @@ class $modify(PaimonLevelInfoLayer, LevelInfoLayer) {
                     } else if (auto fallbackSprite = CCSprite::createWithTexture(tex)) {
                         installBackgroundSprite(fallbackSprite, false);
                     }
-                });
+                }, AnimatedGIFSprite::BACKGROUND_PRIORITY);
             }
         } else if (auto finalSprite = CCSprite::createWithTexture(tex)) {
             installBackgroundSprite(finalSprite, false);
@@ -7,7 +7,6 @@
 #include "../features/thumbnails/ui/LevelCellSettingsPopup.hpp"
 #include "../features/backgrounds/services/LayerBackgroundManager.hpp"
 #include "../utils/SpriteHelper.hpp"
-#include "../utils/HttpClient.hpp"
 #include <unordered_set>
 #include <vector>
 
@@ -66,11 +65,6 @@ class $modify(ContextTrackingBrowser, LevelBrowserLayer) {
         (void)self.setHookPriorityAfterPost("LevelBrowserLayer::init", "geode.node-ids");
     }
 
-    struct Fields {
-        // track which level IDs already had their manifest fetched to avoid re-requesting
-        std::unordered_set<int> m_manifestFetchedIds;
-    };
-
     $override
     bool init(GJSearchObject* p0) {
         // limpiar contexto al entrar a busqueda normal
@@ -89,6 +83,22 @@ class $modify(ContextTrackingBrowser, LevelBrowserLayer) {
         return true;
     }
 
+    $override
+    void setupLevelBrowser(CCArray* items) {
+        // la pagina llega entera: resolver su manifest antes de que las celdas
+        // pidan sus miniaturas, asi las descargas van directo al CDN
+        std::vector<int> levelIDs;
+        if (items) {
+            for (auto* obj : CCArrayExt<CCObject*>(items)) {
+                auto* level = typeinfo_cast<GJGameLevel*>(obj);
+                if (level && level->m_levelID.value() > 0) levelIDs.push_back(level->m_levelID.value());
+            }
+        }
+        ThumbnailLoader::get().resolveManifestBatch(levelIDs);
+
+        LevelBrowserLayer::setupLevelBrowser(items);
+    }
+
     $override
     void onExit() {
         this->unschedule(schedule_selector(ContextTrackingBrowser::prefetchVisibleLevelCells));
@@ -176,26 +186,8 @@ class $modify(ContextTrackingBrowser, LevelBrowserLayer) {
             return;
         }
 
-        // batch manifest prefetch — collect IDs we haven't fetched yet
-        std::vector<int> newManifestIds;
-        for (int id : levelIDs) {
-            if (m_fields->m_manifestFetchedIds.find(id) == m_fields->m_manifestFetchedIds.end()) {
-                newManifestIds.push_back(id);
-            }
-        }
-
-        if (!newManifestIds.empty()) {
-            // mark as fetched immediately to prevent duplicate requests on next timer tick
-            for (int id : newManifestIds) {
-                m_fields->m_manifestFetchedIds.insert(id);
-            }
-
-            // single manifest request populates CDN URL cache for all visible levels;
-            // subsequent downloadThumbnail calls will use the cached CDN URLs
-            // instead of hitting the Worker endpoint individually
-            HttpClient::get().fetchManifest(newManifestIds, nullptr);
-        }
-
+        // prefetchLevels hace un solo lookup batch de manifest para los ids que
+        // aun no se conocen (ni en cache, ni en vuelo, ni con un miss reciente)
         ThumbnailLoader::get().prefetchLevels(levelIDs, 3);
     }
 
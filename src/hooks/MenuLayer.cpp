@@ -481,7 +481,7 @@ class $modify(PaimonMenuLayer, MenuLayer) {
 
                     safeContainer->addChild(anim);
                     self->m_fields->m_bgSprite = anim;
-                });
+                }, AnimatedGIFSprite::BACKGROUND_PRIORITY);
                 return;
             } else {
                 // ── Imagen estatica ──
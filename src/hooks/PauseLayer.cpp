@@ -791,15 +791,8 @@ class $modify(PaimonPauseLayer, PauseLayer) {
                         } else {
                                 // guardar copia PNG en cache de ThumbnailLoader para que
                                 // LevelInfoLayer pueda encontrar el thumbnail sin depender del server
-                                {
-                                    auto cachePath = ThumbnailLoader::get().getCachePath(lvlID);
-                                    std::error_code cacheEc;
-                                    std::filesystem::create_directories(cachePath.parent_path(), cacheEc);
-                                    std::ofstream cacheOut(cachePath, std::ios::binary | std::ios::trunc);
-                                    if (cacheOut) {
-                                        cacheOut.write(reinterpret_cast<char const*>(pngData.data()), pngData.size());
-                                        log::info("[PauseLayer] PNG guardado en cache de ThumbnailLoader: {}", geode::utils::string::pathToString(cachePath));
-                                    }
+                                if (ThumbnailLoader::get().storeCachedSource(lvlID, pngData)) {
+                                    log::info("[PauseLayer] PNG guardado en cache de ThumbnailLoader pal nivel {}", lvlID);
                                 }
 
                                 std::string username;
@@ -1361,9 +1361,8 @@ class $modify(PaimonProfilePage, ProfilePage) {
                     }
 
                     if (GIFDecoder::isGIF(imgData.data(), imgData.size())) {
-                        auto gif = GIFDecoder::decode(imgData.data(), imgData.size());
-                        if (!gif.frames.empty()) {
-                            auto const& frame = gif.frames.front();
+                        GIFDecoder::Frame frame;
+                        if (GIFDecoder::decodeFirstFrame(imgData.data(), imgData.size(), frame)) {
                             if (!frame.pixels.empty() && frame.width > 0 && frame.height > 0) {
                                 auto* tex = new CCTexture2D();
                                 if (tex->initWithData(
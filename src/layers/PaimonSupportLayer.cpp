@@ -7,6 +7,7 @@
 #include "../utils/PaimonShaderSprite.hpp"
 #include "../utils/SpriteHelper.hpp"
 #include "../core/QualityConfig.hpp"
+#include "../features/thumbnails/services/ThumbnailLoader.hpp"
 #include <filesystem>
 #include <fstream>
 #include <thread>
@@ -89,35 +90,27 @@ void PaimonSupportLayer::createBackground() {
 // ── thumbnail background dinamico ────────────────────────
 
 void PaimonSupportLayer::loadShowcaseThumbnails() {
-    // escanear el cache local de thumbnails en disco
-    auto cachePath = paimon::quality::cacheDir();
-    
-    std::error_code ec;
-    if (!std::filesystem::exists(cachePath, ec)) return;
-
-    for (auto const& entry : std::filesystem::directory_iterator(cachePath, ec)) {
-        if (ec) break;
-        if (!entry.is_regular_file()) continue;
-        auto ext = geode::utils::string::pathToString(entry.path().extension());
-        // solo png y webp (no gifs animados para el fondo)
-        if (ext != ".png" && ext != ".webp") continue;
+    // thumbnails estaticos del cache de disco (indice del manifest, viven en el pack;
+    // los gifs animados no se usan para el fondo)
+    auto& manifest = ThumbnailLoader::get().diskManifest();
+    for (int levelID : ThumbnailLoader::get().cachedLevelIDs()) {
+        std::lock_guard<std::recursive_mutex> lock(manifest.mutex);
+        auto const* entry = manifest.getEntryLocked(levelID, false);
         // ignorar archivos muy pequenos (< 5kb, posible error)
-        std::error_code sizeEc;
-        auto fsize = entry.file_size(sizeEc);
-        if (sizeEc || fsize < 5000) continue;
-        m_cachedThumbPaths.push_back(geode::utils::string::pathToString(entry.path()));
+        if (!entry || entry->byteSize < 5000) continue;
+        m_cachedThumbIDs.push_back(levelID);
     }
 
-    if (m_cachedThumbPaths.empty()) return;
+    if (m_cachedThumbIDs.empty()) return;
 
     // mezclar aleatoriamente
-    for (int i = (int)m_cachedThumbPaths.size() - 1; i > 0; i--) {
+    for (int i = (int)m_cachedThumbIDs.size() - 1; i > 0; i--) {
         int j = rand() % (i + 1);
-        std::swap(m_cachedThumbPaths[i], m_cachedThumbPaths[j]);
+        std::swap(m_cachedThumbIDs[i], m_cachedThumbIDs[j]);
     }
 
     // limitar a 20 para no abusar
-    if (m_cachedThumbPaths.size() > 20) m_cachedThumbPaths.resize(20);
+    if (m_cachedThumbIDs.size() > 20) m_cachedThumbIDs.resize(20);
 
     m_currentThumbIndex = 0;
 
@@ -129,21 +122,21 @@ void PaimonSupportLayer::loadShowcaseThumbnails() {
 }
 
 void PaimonSupportLayer::cycleThumbnail(float dt) {
-    if (m_cachedThumbPaths.empty() || m_loadingThumb) return;
+    if (m_cachedThumbIDs.empty() || m_loadingThumb) return;
 
     m_loadingThumb = true;
-    auto filePath = m_cachedThumbPaths[m_currentThumbIndex % m_cachedThumbPaths.size()];
+    int levelID = m_cachedThumbIDs[m_currentThumbIndex % m_cachedThumbIDs.size()];
     m_currentThumbIndex++;
 
     // cargar la imagen desde disco en un thread para no trabar UI
     Ref<PaimonSupportLayer> self = this;
 
-    std::thread([self, filePath]() {
+    std::thread([self, levelID]() {
         geode::utils::thread::setName("SupportLayer BG Loader");
 
         CCTexture2D* tex = nullptr;
-        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
+        auto data = ThumbnailLoader::get().readCachedSource(levelID, false);
+        if (data.empty()) {
             Loader::get()->queueInMainThread([self]() {
                 if (!self->getParent()) return;
                 self->m_loadingThumb = false;
@@ -151,12 +144,6 @@ void PaimonSupportLayer::cycleThumbnail(float dt) {
             return;
         }
 
-        auto size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        std::vector<uint8_t> data(size);
-        file.read(reinterpret_cast<char*>(data.data()), size);
-        file.close();
-
         Loader::get()->queueInMainThread([self, data = std::move(data)]() {
             if (!self->getParent()) {
                 self->m_loadingThumb = false;
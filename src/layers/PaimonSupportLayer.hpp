@@ -50,7 +50,7 @@ protected:
 
     cocos2d::CCSprite* m_bgThumb = nullptr;
     cocos2d::CCNode* m_bgDiagonalGlow = nullptr;
-    std::vector<std::string> m_cachedThumbPaths;
+    std::vector<int> m_cachedThumbIDs;
     int m_currentThumbIndex = 0;
     bool m_loadingThumb = false;
 
@@ -2,15 +2,69 @@
 #include "GIFDecoder.hpp"
 #include "DominantColors.hpp"
 #include "Debug.hpp"
+#include "TextureUploadQueue.hpp"
+#include "MemoryBudget.hpp"
+#include "LZBlock.hpp"
 #include "../core/QualityConfig.hpp"
 #include <Geode/loader/Log.hpp>
 #include <fstream>
 #include <filesystem>
 #include <Geode/utils/string.hpp>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#ifdef GEODE_IS_WINDOWS
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace geode::prelude;
 
+// los frames 1..n van detras de las miniaturas (que usan la prioridad de su celda)
+static constexpr int FRAME_UPLOAD_PRIORITY = 0;
+
+// decode incremental: la primera tanda es solo el frame 0 (sale ya en pantalla),
+// luego tandas de STREAM_BATCH_FRAMES cuando quedan menos de STREAM_LOW_WATER por subir
+static constexpr size_t STREAM_FIRST_BATCH = 1;
+static constexpr size_t STREAM_BATCH_FRAMES = 3;
+static constexpr size_t STREAM_LOW_WATER = 2;
+
+// coste de reconstruir un GIF para MemoryBudget: decode completo + subir cada frame
+static double gifRebuildCost(size_t frames) {
+    return 2.0 + 0.25 * static_cast<double>(frames);
+}
+
+// .part de la cache en disco: "<hash>.bin.<pid>-<n>.part", uno por stream.
+// Dos decodes del mismo GIF (abandonLoad relanza el load mientras el stream
+// viejo sigue escribiendo) no comparten archivo, y al limpiar se sabe si el
+// .part es de este proceso o quedo de una sesion anterior
+static uint64_t currentProcessId() {
+#ifdef GEODE_IS_WINDOWS
+    return static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+static std::string makePartPath(std::string const& cachePath) {
+    static std::atomic<uint64_t> s_partCounter{0};
+    return fmt::format("{}.{}-{}.part", cachePath, currentProcessId(),
+        s_partCounter.fetch_add(1, std::memory_order_relaxed));
+}
+
+// false tambien para los del formato viejo ("<hash>.bin.part"), que no tienen pid
+static bool isOwnPartFile(std::string const& filename) {
+    auto pos = filename.find(".bin.");
+    if (pos == std::string::npos) return false;
+    char const* begin = filename.data() + pos + 5;
+    char const* end = filename.data() + filename.size();
+    uint64_t pid = 0;
+    auto [ptr, ec] = std::from_chars(begin, end, pid);
+    return ec == std::errc() && ptr != end && *ptr == '-' && pid == currentProcessId();
+}
+
 static float getContentScaleFactorSafe() {
     // NOTE: GD/Geode UI layout assumes these GIF frames in point-space 1:1.
     // Using device contentScaleFactor here causes double-scaling in several
@@ -18,21 +72,147 @@ static float getContentScaleFactorSafe() {
     return 1.0f;
 }
 
+// hojas de frames: como mucho MAX_SHEET_SIZE de lado (si el canvas no es mas
+// grande), con SHEET_PADDING px de borde extruido alrededor de cada frame
+static constexpr int MAX_SHEET_SIZE = 2048;
+static constexpr int SHEET_PADDING = 2;
+
+// modo ventana: celdas de la ventana por sprite (frames por delante del playhead)
+// y cada cuanto se mira si el sprite sigue en pantalla
+static constexpr int WINDOW_SLOTS = 8;
+static constexpr float VISIBILITY_CHECK_INTERVAL = 0.25f;
+// la ventana va por delante de las subidas de GIFs que aun cargan
+static constexpr int WINDOW_UPLOAD_PRIORITY = FRAME_UPLOAD_PRIORITY + 1;
+
+// un GIF largo pasa a modo ventana cuando sus hojas ocuparian mas de esto
+static size_t windowedThresholdBytes() {
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+    return 2 * 1024 * 1024;
+#else
+    return 4 * 1024 * 1024;
+#endif
+}
+
+static bool shouldWindowGIF(int width, int height, int frameCount) {
+    if (width <= 0 || height <= 0 || frameCount <= WINDOW_SLOTS * 2) return false;
+    size_t cellBytes = static_cast<size_t>(width + 2 * SHEET_PADDING) * (height + 2 * SHEET_PADDING) * 4;
+    return cellBytes * frameCount > windowedThresholdBytes();
+}
+
 static size_t getSharedGIFDataSize(AnimatedGIFSprite::SharedGIFData const& data) {
     size_t entrySize = 0;
-    for (auto* tex : data.textures) {
-        if (!tex) continue;
-        entrySize += tex->getPixelsWide() * tex->getPixelsHigh() * 4;
+    for (auto* sheet : data.sheets) {
+        if (!sheet) continue;
+        entrySize += sheet->getPixelsWide() * sheet->getPixelsHigh() * 4;
+    }
+    // frames comprimidos (los repetidos comparten buffer con el anterior)
+    for (size_t i = 0; i < data.packed.size(); ++i) {
+        auto const& pixels = data.packed[i].pixels;
+        if (!pixels || (i > 0 && pixels == data.packed[i - 1].pixels)) continue;
+        entrySize += pixels->size();
     }
     return entrySize;
 }
 
+namespace {
+// deja un frame de canvas completo listo pa la hoja (en el worker, no en main):
+// recortado a los pixeles con alpha y con SHEET_PADDING px de borde extruido,
+// asi el filtrado lineal no mezcla con el frame de al lado. Si queda igual que
+// el anterior se vacian los pixeles y el sprite reusa el hueco de ese.
+class SheetFramePrep {
+public:
+    void apply(GIFDecoder::Frame& frame) {
+        int srcW = frame.width;
+        int srcH = frame.height;
+        if (srcW <= 0 || srcH <= 0 || frame.pixels.size() < static_cast<size_t>(srcW) * srcH * 4) return;
+
+        // caja de los pixeles visibles
+        int minX = srcW, minY = srcH, maxX = -1, maxY = -1;
+        for (int y = 0; y < srcH; ++y) {
+            uint8_t const* row = frame.pixels.data() + static_cast<size_t>(y) * srcW * 4;
+            int first = -1;
+            for (int x = 0; x < srcW; ++x) {
+                if (row[x * 4 + 3]) { first = x; break; }
+            }
+            if (first < 0) continue;
+            int last = first;
+            for (int x = srcW - 1; x > first; --x) {
+                if (row[x * 4 + 3]) { last = x; break; }
+            }
+            minX = std::min(minX, first);
+            maxX = std::max(maxX, last);
+            if (minY > y) minY = y;
+            maxY = y;
+        }
+        // frame transparente del todo: un pixel vacio
+        if (maxX < 0) minX = minY = maxX = maxY = 0;
+
+        int w = maxX - minX + 1;
+        int h = maxY - minY + 1;
+        int left = frame.left + minX;
+        int top = frame.top + minY;
+        size_t rowBytes = static_cast<size_t>(w) * 4;
+        auto srcRow = [&](int y) {
+            return frame.pixels.data() + (static_cast<size_t>(minY + y) * srcW + minX) * 4;
+        };
+
+        bool same = m_hasLast && m_left == left && m_top == top && m_width == w && m_height == h;
+        for (int y = 0; same && y < h; ++y) {
+            same = std::memcmp(srcRow(y), m_last.data() + rowBytes * y, rowBytes) == 0;
+        }
+        frame.left = left;
+        frame.top = top;
+        frame.width = w;
+        frame.height = h;
+        if (same) {
+            frame.pixels.clear();
+            return;
+        }
+
+        m_last.resize(rowBytes * h);
+        for (int y = 0; y < h; ++y) {
+            std::memcpy(m_last.data() + rowBytes * y, srcRow(y), rowBytes);
+        }
+        m_hasLast = true;
+        m_left = left;
+        m_top = top;
+        m_width = w;
+        m_height = h;
+
+        int pw = w + 2 * SHEET_PADDING;
+        int ph = h + 2 * SHEET_PADDING;
+        std::vector<uint8_t> padded(static_cast<size_t>(pw) * ph * 4);
+        for (int y = 0; y < ph; ++y) {
+            uint8_t const* src = m_last.data() + rowBytes * std::clamp(y - SHEET_PADDING, 0, h - 1);
+            uint8_t* dst = padded.data() + static_cast<size_t>(y) * pw * 4;
+            for (int p = 0; p < SHEET_PADDING; ++p) {
+                std::memcpy(dst + p * 4, src, 4);
+                std::memcpy(dst + (SHEET_PADDING + w + p) * 4, src + (w - 1) * 4, 4);
+            }
+            std::memcpy(dst + SHEET_PADDING * 4, src, rowBytes);
+        }
+        frame.pixels = std::move(padded);
+    }
+
+private:
+    std::vector<uint8_t> m_last; // ultimo frame distinto, recortado y sin borde
+    bool m_hasLast = false;
+    int m_left = 0;
+    int m_top = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
+} // namespace
+
 std::unordered_map<std::string, AnimatedGIFSprite::SharedGIFData> AnimatedGIFSprite::s_gifCache;
 std::list<std::string> AnimatedGIFSprite::s_lruList;
 std::unordered_map<std::string, std::list<std::string>::iterator> AnimatedGIFSprite::s_lruMap;
 std::unordered_set<std::string> AnimatedGIFSprite::s_pinnedGIFs;
 std::mutex AnimatedGIFSprite::s_cacheMutex;
 size_t AnimatedGIFSprite::s_currentCacheSize = 0;
+size_t AnimatedGIFSprite::s_windowBytes = 0;
+int AnimatedGIFSprite::s_windowCount = 0;
+int AnimatedGIFSprite::s_windowedSprites = 0;
 
 size_t AnimatedGIFSprite::getMaxCacheMem() {
     bool ramCache = Mod::get()->getSettingValue<bool>("gif-ram-cache");
@@ -49,20 +229,36 @@ size_t AnimatedGIFSprite::getMaxCacheMem() {
 
 // cosas estaticas de la cola de workers
 std::deque<AnimatedGIFSprite::GIFTask> AnimatedGIFSprite::s_taskQueue;
+paimon::concurrency::IndexedHeap<std::string> AnimatedGIFSprite::s_loadQueue;
+std::unordered_map<std::string, AnimatedGIFSprite::InFlightLoad> AnimatedGIFSprite::s_inFlight;
 std::mutex AnimatedGIFSprite::s_queueMutex;
 std::condition_variable AnimatedGIFSprite::s_queueCV;
-std::thread AnimatedGIFSprite::s_workerThread;
+std::vector<std::thread> AnimatedGIFSprite::s_workerThreads;
 std::atomic<bool> AnimatedGIFSprite::s_workerRunning = false;
 std::atomic<bool> AnimatedGIFSprite::s_shutdownMode = false;
 std::mutex AnimatedGIFSprite::s_workerLifecycleMutex;
+uint64_t AnimatedGIFSprite::s_nextLoadId = 0;
+
+unsigned AnimatedGIFSprite::workerCount() {
+    // decode es CPU puro; dejo nucleos pal main thread y el resto de pools
+    unsigned hc = std::max(1u, std::thread::hardware_concurrency());
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_IOS)
+    return std::clamp<unsigned>(hc / 2, 1, 2);
+#else
+    return std::clamp<unsigned>(hc / 2, 2, 4);
+#endif
+}
 
 void AnimatedGIFSprite::initWorker() {
     std::lock_guard<std::mutex> lock(s_workerLifecycleMutex);
     s_shutdownMode.store(false, std::memory_order_release);
     if (!s_workerRunning.load(std::memory_order_acquire)) {
         s_workerRunning.store(true, std::memory_order_release);
-        s_workerThread = std::thread(workerLoop);
-        PaimonDebug::log("[AnimatedGIFSprite] Worker thread started");
+        unsigned count = workerCount();
+        for (unsigned i = 0; i < count; ++i) {
+            s_workerThreads.emplace_back(workerLoop, i);
+        }
+        PaimonDebug::log("[AnimatedGIFSprite] {} worker threads started", count);
     }
 }
 
@@ -71,17 +267,134 @@ void AnimatedGIFSprite::shutdownWorker() {
     if (!s_workerRunning.load(std::memory_order_acquire)) return;
     s_workerRunning.store(false, std::memory_order_release);
     {
+        // lo que quedaba en cola se tira sin callback, como antes; los
+        // resultados que aun lleguen los para s_shutdownMode
         std::lock_guard<std::mutex> queueLock(s_queueMutex);
         s_taskQueue.clear();
+        s_loadQueue.clear();
+        s_inFlight.clear();
     }
     s_queueCV.notify_all();
-    if (s_workerThread.joinable()) {
-        s_workerThread.join();
+    for (auto& thread : s_workerThreads) {
+        if (thread.joinable()) thread.join();
+    }
+    s_workerThreads.clear();
+}
+
+void AnimatedGIFSprite::enqueueLoad(std::string const& key, std::string const& path,
+                                    std::vector<uint8_t> const* data, AsyncCallback callback, int priority) {
+    initWorker();
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        auto it = s_inFlight.find(key);
+        if (it != s_inFlight.end()) {
+            // ya se esta cargando: me cuelgo de esa carga
+            auto& load = it->second;
+            load.callbacks.push_back(std::move(callback));
+            if (priority > load.priority) {
+                load.priority = priority;
+                s_loadQueue.update(key, priority);
+            }
+            PaimonDebug::log("[AnimatedGIFSprite] {} ya en carga, {} esperando", key, load.callbacks.size());
+            return;
+        }
+        auto& load = s_inFlight[key];
+        load.path = path;
+        // la copia solo pa la primera peticion; las demas se cuelgan de esta
+        if (data) load.data = std::make_shared<std::vector<uint8_t> const>(*data);
+        load.callbacks.push_back(std::move(callback));
+        load.priority = priority;
+        load.id = ++s_nextLoadId;
+        s_loadQueue.push(key, priority);
+    }
+    s_queueCV.notify_one();
+}
+
+void AnimatedGIFSprite::updatePriority(std::string const& key, int priority) {
+    std::lock_guard<std::mutex> lock(s_queueMutex);
+    // solo mientras este en cola; si ya lo tiene un worker no hay nada que mover
+    if (!s_loadQueue.update(key, priority)) return;
+    if (auto it = s_inFlight.find(key); it != s_inFlight.end()) it->second.priority = priority;
+}
+
+void AnimatedGIFSprite::failLoad(std::string const& key) {
+    std::vector<AsyncCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        auto it = s_inFlight.find(key);
+        if (it == s_inFlight.end()) return;
+        callbacks = std::move(it->second.callbacks);
+        s_inFlight.erase(it);
+    }
+    for (auto& cb : callbacks) {
+        if (cb) cb(nullptr);
+    }
+}
+
+void AnimatedGIFSprite::resolveLoadWaiters(std::string const& key) {
+    std::vector<AsyncCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        auto it = s_inFlight.find(key);
+        if (it == s_inFlight.end()) return;
+        callbacks = std::move(it->second.callbacks);
+        s_inFlight.erase(it);
+    }
+    for (auto& cb : callbacks) {
+        if (cb) cb(createFromCache(key));
     }
 }
 
-// version del formato de cache en disco (cambiar si se modifica el formato)
-static constexpr uint32_t DISK_CACHE_VERSION = 2;
+void AnimatedGIFSprite::abandonLoad(std::string const& key) {
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        auto it = s_inFlight.find(key);
+        if (it == s_inFlight.end()) return;
+        if (it->second.callbacks.empty() || s_shutdownMode.load(std::memory_order_acquire) ||
+            !s_workerRunning.load(std::memory_order_acquire)) {
+            s_inFlight.erase(it);
+            return;
+        }
+        // el primero que esperaba pasa a ser el principal del nuevo decode
+        it->second.id = ++s_nextLoadId;
+        s_loadQueue.push(key, it->second.priority);
+    }
+    s_queueCV.notify_one();
+}
+
+paimon::memory::MemoryBudget::SourceId AnimatedGIFSprite::budgetSource() {
+    // el presupuesto comun puede pedir sacar un GIF aunque este cache no este lleno
+    static auto const id = paimon::memory::MemoryBudget::get().registerSource("gifs",
+        [](std::string const& key) { return evictForBudget(key); });
+    return id;
+}
+
+// debe llamarse con s_cacheMutex pillado
+bool AnimatedGIFSprite::eraseCacheEntry(std::string const& key) {
+    auto it = s_gifCache.find(key);
+    if (it == s_gifCache.end()) return false;
+    size_t removeSize = getSharedGIFDataSize(it->second);
+    for (auto* sheet : it->second.sheets) {
+        if (sheet) sheet->release();
+    }
+    if (s_currentCacheSize >= removeSize) s_currentCacheSize -= removeSize;
+    else s_currentCacheSize = 0;
+    s_gifCache.erase(it);
+    auto lruIt = s_lruMap.find(key);
+    if (lruIt != s_lruMap.end()) {
+        s_lruList.erase(lruIt->second);
+        s_lruMap.erase(lruIt);
+    }
+    paimon::memory::MemoryBudget::get().forget(budgetSource(), key);
+    return true;
+}
+
+bool AnimatedGIFSprite::evictForBudget(std::string const& key) {
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    if (isPinned(key)) return false;
+    eraseCacheEntry(key);
+    return true;
+}
 
 // eviccion centralizada: quita entradas LRU hasta que el cache esta por debajo del limite
 // debe llamarse con s_cacheMutex pillado
@@ -91,24 +404,14 @@ void AnimatedGIFSprite::evictIfNeeded() {
         std::string toRemove = s_lruList.front();
         s_lruList.pop_front();
         s_lruMap.erase(toRemove);
-        auto it = s_gifCache.find(toRemove);
-        if (it != s_gifCache.end()) {
-            size_t removeSize = 0;
-            for (auto* tex : it->second.textures) {
-                if (!tex) continue;
-                removeSize += tex->getPixelsWide() * tex->getPixelsHigh() * 4;
-                tex->release();
-            }
-            if (s_currentCacheSize >= removeSize) s_currentCacheSize -= removeSize;
-            else s_currentCacheSize = 0;
-            s_gifCache.erase(it);
-        }
+        eraseCacheEntry(toRemove);
     }
 }
 
 void AnimatedGIFSprite::pinGIF(std::string const& key) {
     std::lock_guard<std::mutex> lock(s_cacheMutex);
     s_pinnedGIFs.insert(key);
+    paimon::memory::MemoryBudget::get().pin(budgetSource(), key);
     // lo saco de la lista LRU si estaba, asi no se lo carga la limpieza
     auto lruIt = s_lruMap.find(key);
     if (lruIt != s_lruMap.end()) {
@@ -120,6 +423,7 @@ void AnimatedGIFSprite::pinGIF(std::string const& key) {
 void AnimatedGIFSprite::unpinGIF(std::string const& key) {
     std::lock_guard<std::mutex> lock(s_cacheMutex);
     if (s_pinnedGIFs.erase(key)) {
+        paimon::memory::MemoryBudget::get().unpin(budgetSource(), key);
         // si lo despincho, lo meto de vuelta en la LRU
         // solo si sigue en el cache
         if (s_gifCache.find(key) != s_gifCache.end()) {
@@ -154,52 +458,30 @@ AnimatedGIFSprite* AnimatedGIFSprite::create(std::string const& filename) {
         
         if (!GIFDecoder::isGIF(data.data(), data.size())) return nullptr;
         
-        auto gifData = GIFDecoder::decode(data.data(), data.size());
-        if (gifData.frames.empty()) return nullptr;
-
-        float sf = getContentScaleFactorSafe();
-        
-        // lo guardo en cache
-        SharedGIFData sharedData;
-        sharedData.width = gifData.width;
-        sharedData.height = gifData.height;
+        // subo cada frame segun sale del decoder, sin tener el GIF entero en RAM
+        GIFDecoder::Stream stream(data.data(), data.size());
+        if (!stream.valid()) return nullptr;
+
+        ret->m_canvasWidth = stream.width();
+        ret->m_canvasHeight = stream.height();
+        ret->m_expectedFrames = GIFDecoder::countFrames(data.data(), data.size());
+        // las hojas llevan el ref extra pa s_gifCache desde que se crean
+        ret->m_texturesLoading = true;
         
-        for (auto const& frame : gifData.frames) {
-            auto texture = new CCTexture2D();
-            if (!texture->initWithData(
-                frame.pixels.data(),
-                kCCTexture2DPixelFormat_RGBA8888,
-                frame.width,
-                frame.height,
-                CCSize(frame.width / sf, frame.height / sf)
-            )) {
-                texture->release();
-                continue;
-            }
-            texture->setAntiAliasTexParameters();
-            
-            sharedData.textures.push_back(texture);
-            sharedData.delays.push_back(frame.delayMs / 1000.0f);
-            sharedData.frameRects.push_back(CCRect(0, 0, frame.width, frame.height));
+        SheetFramePrep prep;
+        GIFDecoder::Frame frame;
+        while (stream.nextFrame(frame)) {
+            prep.apply(frame);
+            ret->m_pendingFrames.push_back(std::move(frame));
+            ret->processNextPendingFrame();
         }
-        
-        {
-            std::lock_guard<std::mutex> lock(s_cacheMutex);
-            // guardo la entrada en cache
-            s_gifCache[filename] = sharedData;
-
-            // calculo tamano aproximado en RAM
-            s_currentCacheSize += getSharedGIFDataSize(sharedData);
+        if (ret->m_frames.empty()) return nullptr;
 
-            if (!isPinned(filename)) {
-                s_lruList.push_back(filename);
-                s_lruMap[filename] = std::prev(s_lruList.end());
-            }
-            evictIfNeeded();
-        }
+        float sf = getContentScaleFactorSafe();
+        ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
         
-        // lo vuelvo a inicializar pero ya tirando del cache
-        ret->initFromCache(filename);
+        // mete las hojas en cache y arranca la animacion
+        ret->finishTextureLoading();
         
         return ret;
     }
@@ -215,38 +497,25 @@ AnimatedGIFSprite* AnimatedGIFSprite::create(const void* data, size_t size) {
         
         if (!GIFDecoder::isGIF(static_cast<const uint8_t*>(data), size)) return nullptr;
         
-        auto gifData = GIFDecoder::decode(static_cast<const uint8_t*>(data), size);
-        if (gifData.frames.empty()) return nullptr;
+        GIFDecoder::Stream stream(static_cast<const uint8_t*>(data), size);
+        if (!stream.valid()) return nullptr;
         
         // GIFs en memoria no se cachean globalmente salvo que tengamos key
         
-        ret->m_canvasWidth = gifData.width;
-        ret->m_canvasHeight = gifData.height;
+        ret->m_canvasWidth = stream.width();
+        ret->m_canvasHeight = stream.height();
+        ret->m_expectedFrames = GIFDecoder::countFrames(static_cast<const uint8_t*>(data), size);
 
         float sf = getContentScaleFactorSafe();
         
-        for (auto const& frame : gifData.frames) {
-            auto texture = new CCTexture2D();
-            if (!texture->initWithData(
-                frame.pixels.data(),
-                kCCTexture2DPixelFormat_RGBA8888,
-                frame.width,
-                frame.height,
-                CCSize(frame.width / sf, frame.height / sf)
-            )) {
-                texture->release();
-                continue;
-            }
-            texture->setAntiAliasTexParameters();
-            
-            auto* gifFrame = new GIFFrame();
-            gifFrame->texture = texture;
-            gifFrame->delay = frame.delayMs / 1000.0f;
-            gifFrame->rect = CCRect(0, 0, frame.width, frame.height);
-            ret->m_frames.push_back(gifFrame);
-            
-            ret->m_frameColors.push_back({ {0,0,0}, {255,255,255} });
+        SheetFramePrep prep;
+        GIFDecoder::Frame frame;
+        while (stream.nextFrame(frame)) {
+            prep.apply(frame);
+            ret->m_pendingFrames.push_back(std::move(frame));
+            ret->processNextPendingFrame();
         }
+        if (ret->m_frames.empty()) return nullptr;
         
         ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
         ret->setCurrentFrame(0);
@@ -258,82 +527,32 @@ AnimatedGIFSprite* AnimatedGIFSprite::create(const void* data, size_t size) {
     return nullptr;
 }
 
-void AnimatedGIFSprite::updateTextureLoading(float dt) {
-    if (m_pendingFrames.empty()) {
-        this->unschedule(schedule_selector(AnimatedGIFSprite::updateTextureLoading));
-        
-        SharedGIFData cacheEntry;
-        cacheEntry.width = m_canvasWidth;
-        cacheEntry.height = m_canvasHeight;
-        
-        for (auto* frame : m_frames) {
-            cacheEntry.textures.push_back(frame->texture);
-            cacheEntry.delays.push_back(frame->delay);
-            cacheEntry.frameRects.push_back(frame->rect);
-        }
-        
-        {
-            std::lock_guard<std::mutex> lock(s_cacheMutex);
-            s_gifCache[m_filename] = cacheEntry;
-            
-            // calculo tamano
-            s_currentCacheSize += getSharedGIFDataSize(cacheEntry);
-
-            // actualizo lru O(1)
-            if (!isPinned(m_filename)) {
-                auto lruIt = s_lruMap.find(m_filename);
-                if (lruIt != s_lruMap.end()) {
-                    s_lruList.erase(lruIt->second);
-                }
-                s_lruList.push_back(m_filename);
-                s_lruMap[m_filename] = std::prev(s_lruList.end());
-            }
-            evictIfNeeded();
-        }
+bool AnimatedGIFSprite::beginTextureLoading() {
+    // antes del frame 0: la hoja que abra ya lleva el ref pa s_gifCache
+    m_texturesLoading = true;
 
-        this->scheduleUpdate();
-        return;
+    // frame 0 ya, asi el callback recibe algo que mostrar
+    while (m_frames.empty() && !m_pendingFrames.empty()) {
+        processNextPendingFrame();
     }
+    if (m_frames.empty()) return false;
 
-    int framesToProcess = 1; 
-    float sf = getContentScaleFactorSafe();
-    
-    while (framesToProcess > 0 && !m_pendingFrames.empty()) {
-        auto frameData = m_pendingFrames.front();
-        
-        auto* gifFrame = new GIFFrame();
-        auto* texture = new CCTexture2D();
-        
-        bool success = texture->initWithData(
-            frameData.pixels.data(),
-            kCCTexture2DPixelFormat_RGBA8888,
-            frameData.width,
-            frameData.height,
-            CCSize(frameData.width / sf, frameData.height / sf)
-        );
-
-        if (success) {
-            texture->setAntiAliasTexParameters();
-            gifFrame->texture = texture;
-            gifFrame->delay = frameData.delayMs / 1000.0f;
-            gifFrame->rect = CCRect(frameData.left, frameData.top, frameData.width, frameData.height);
-
-            m_frames.push_back(gifFrame);
-            m_frameColors.push_back({ {0,0,0}, {255,255,255} });
-            
-            texture->retain();
-        } else {
-            delete gifFrame;
-            texture->release();
-        }
-        
-        m_pendingFrames.erase(m_pendingFrames.begin());
-        framesToProcess--;
-    }
-    
-    if (m_frames.size() == 1) {
-        this->setCurrentFrame(0);
-    }
+    continueTextureLoading();
+    return true;
+}
+
+void AnimatedGIFSprite::queueTextureLoading() {
+    // un frame por job: las miniaturas y otros GIFs se intercalan en la cola
+    // y el presupuesto por frame lo pone TextureUploadQueue
+    paimon::image::TextureUploadQueue::get().post(FRAME_UPLOAD_PRIORITY, [safeRef = WeakRef<AnimatedGIFSprite>(this)]() {
+        auto ref = safeRef.lock();
+        auto* self = static_cast<AnimatedGIFSprite*>(ref.data());
+        if (self) self->updateTextureLoading();
+    });
+}
+
+void AnimatedGIFSprite::updateTextureLoading() {
+    processNextPendingFrame();
 
     // Start animation as soon as 2 frames are available instead of
     // waiting for all pending frames to finish loading.
@@ -341,51 +560,239 @@ void AnimatedGIFSprite::updateTextureLoading(float dt) {
     if (m_frames.size() == 2 && m_isPlaying) {
         this->scheduleUpdate();
     }
+
+    continueTextureLoading();
 }
 
-bool AnimatedGIFSprite::processNextPendingFrame() {
-    if (m_pendingFrames.empty()) return false;
+void AnimatedGIFSprite::continueTextureLoading() {
+    if (m_stream && m_pendingFrames.size() < STREAM_LOW_WATER) {
+        requestMoreFrames();
+    }
 
-    float sf = getContentScaleFactorSafe();
-    auto frameData = m_pendingFrames.front();
+    if (!m_pendingFrames.empty()) {
+        queueTextureLoading();
+    } else if (m_stream) {
+        // el worker aun no ha devuelto la siguiente tanda; appendStreamFrames reanuda
+        m_uploadsStalled = true;
+    } else {
+        finishTextureLoading();
+    }
+}
 
-    auto* gifFrame = new GIFFrame();
-    auto* texture = new CCTexture2D();
+void AnimatedGIFSprite::requestMoreFrames() {
+    if (!m_stream || m_streamInFlight) return;
+    m_streamInFlight = true;
+
+    GIFTask task;
+    task.stream = m_stream;
+    task.onFrames = [safeRef = WeakRef<AnimatedGIFSprite>(this)](std::vector<GIFDecoder::Frame> frames,
+                                                                  std::vector<PackedFrame> packed, bool done) {
+        auto ref = safeRef.lock();
+        auto* self = static_cast<AnimatedGIFSprite*>(ref.data());
+        if (self) self->appendStreamFrames(std::move(frames), std::move(packed), done);
+    };
 
-    bool success = false;
+    initWorker();
     {
-        success = texture->initWithData(
-            frameData.pixels.data(),
-            kCCTexture2DPixelFormat_RGBA8888,
-            frameData.width,
-            frameData.height,
-            CCSize(frameData.width / sf, frameData.height / sf)
-        );
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        // delante de los GIFs nuevos: este ya se esta viendo
+        s_taskQueue.push_front(std::move(task));
     }
+    s_queueCV.notify_one();
+}
 
-    if (success) {
-        texture->setAntiAliasTexParameters();
-        gifFrame->texture = texture;
-        gifFrame->delay = frameData.delayMs / 1000.0f;
-        gifFrame->rect = CCRect(frameData.left, frameData.top, frameData.width, frameData.height);
+void AnimatedGIFSprite::appendStreamFrames(std::vector<GIFDecoder::Frame> frames, std::vector<PackedFrame> packed, bool done) {
+    m_streamInFlight = false;
+    for (auto& frame : frames) {
+        m_pendingFrames.push_back(std::move(frame));
+    }
+    for (auto& frame : packed) {
+        m_pendingPacked.push_back(std::move(frame));
+    }
+    if (done) m_stream.reset();
 
-        m_frames.push_back(gifFrame);
-        m_frameColors.push_back({ {0,0,0}, {255,255,255} });
-        texture->retain();
+    if (!m_uploadsStalled) return;
+    m_uploadsStalled = false;
+    continueTextureLoading();
+}
+
+void AnimatedGIFSprite::finishTextureLoading() {
+    m_texturesLoading = false;
+
+    SharedGIFData cacheEntry;
+    cacheEntry.width = m_canvasWidth;
+    cacheEntry.height = m_canvasHeight;
+    // los refs extra de las hojas pasan a ser del cache
+    cacheEntry.sheets = m_sheets;
+    
+    for (auto const& frame : m_frames) {
+        cacheEntry.frameSheets.push_back(frame.sheet);
+        cacheEntry.sheetRects.push_back(frame.sheetRect);
+        cacheEntry.delays.push_back(frame.delay);
+        cacheEntry.frameRects.push_back(frame.rect);
+    }
+    cacheEntry.packed = m_packed;
+    if (m_windowed) {
+        PaimonDebug::log("[AnimatedGIFSprite] {}: {} frames en ventana de {}, {} KB comprimidos",
+            m_filename, m_frames.size(), windowSlotCount(), getSharedGIFDataSize(cacheEntry) / 1024);
     } else {
-        delete gifFrame;
-        texture->release();
+        PaimonDebug::log("[AnimatedGIFSprite] {}: {} frames en {} hojas",
+            m_filename, m_frames.size(), m_sheets.size());
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        // otro sprite pudo cargar el mismo GIF a la vez: fuera su entrada (y sus refs)
+        eraseCacheEntry(m_filename);
+        s_gifCache[m_filename] = cacheEntry;
+        
+        // calculo tamano
+        size_t entrySize = getSharedGIFDataSize(cacheEntry);
+        s_currentCacheSize += entrySize;
+        paimon::memory::MemoryBudget::get().touch(budgetSource(), m_filename,
+            entrySize, gifRebuildCost(cacheEntry.delays.size()));
+
+        // actualizo lru O(1)
+        if (!isPinned(m_filename)) {
+            auto lruIt = s_lruMap.find(m_filename);
+            if (lruIt != s_lruMap.end()) {
+                s_lruList.erase(lruIt->second);
+            }
+            s_lruList.push_back(m_filename);
+            s_lruMap[m_filename] = std::prev(s_lruList.end());
+        }
+        evictIfNeeded();
     }
 
+    this->scheduleUpdate();
+
+    // los createAsync que esperaban este GIF reciben copias del cache
+    if (m_ownsLoad) {
+        m_ownsLoad = false;
+        resolveLoadWaiters(m_filename);
+    }
+}
+
+bool AnimatedGIFSprite::processNextPendingFrame() {
+    if (m_pendingFrames.empty()) return false;
+
+    auto frameData = std::move(m_pendingFrames.front());
     m_pendingFrames.erase(m_pendingFrames.begin());
 
+    GIFFrame gifFrame;
+    bool success = false;
+    if (m_windowed) {
+        // el worker manda cada frame comprimido; solo el 0 trae pixeles y va a su hoja
+        PackedFrame packed;
+        if (!m_pendingPacked.empty()) {
+            packed = std::move(m_pendingPacked.front());
+            m_pendingPacked.pop_front();
+        }
+        if (!packed.pixels) {
+            if (!m_frames.empty()) {
+                gifFrame = m_frames.back();
+                packed = m_packed.back();
+                success = true;
+            }
+        } else if (m_frames.empty()) {
+            success = uploadToSheet(frameData, gifFrame);
+        } else {
+            gifFrame.sheet = -1;
+            gifFrame.source = static_cast<int>(m_frames.size());
+            gifFrame.rect = CCRect(packed.left, packed.top, packed.width, packed.height);
+            success = true;
+        }
+        if (success) m_packed.push_back(std::move(packed));
+    } else if (frameData.pixels.empty()) {
+        // igual que el anterior: mismo hueco de la hoja, solo cambia el delay
+        if (!m_frames.empty()) {
+            gifFrame = m_frames.back();
+            success = true;
+        }
+    } else {
+        success = uploadToSheet(frameData, gifFrame);
+    }
+
+    if (success) {
+        gifFrame.delay = frameData.delayMs / 1000.0f;
+        m_frames.push_back(gifFrame);
+        m_frameColors.push_back({ {0,0,0}, {255,255,255} });
+    }
+
     if (success && m_frames.size() == 1) {
         this->setCurrentFrame(0);
+    } else if (success && m_windowed) {
+        pumpWindow();
     }
 
     return success;
 }
 
+bool AnimatedGIFSprite::uploadToSheet(GIFDecoder::Frame const& frame, GIFFrame& out) {
+    // los pixeles ya traen el borde extruido
+    int pw = frame.width + 2 * SHEET_PADDING;
+    int ph = frame.height + 2 * SHEET_PADDING;
+    if (frame.width <= 0 || frame.height <= 0 ||
+        frame.pixels.size() != static_cast<size_t>(pw) * ph * 4) {
+        return false;
+    }
+
+    auto& cursor = m_sheetCursor;
+    if (!m_sheets.empty() && cursor.x + pw > cursor.width) {
+        // estanteria llena: la siguiente empieza debajo de la mas alta
+        cursor.x = 0;
+        cursor.y += cursor.shelfHeight;
+        cursor.shelfHeight = 0;
+    }
+    if (m_sheets.empty() || cursor.x + pw > cursor.width || cursor.y + ph > cursor.height) {
+        if (!openSheet(pw, ph)) return false;
+    }
+
+    // hueco nunca usado de la hoja: sub-imagen sin tocar lo que ya se ve
+    ccGLBindTexture2D(m_sheets.back()->getName());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, cursor.x, cursor.y, pw, ph, GL_RGBA, GL_UNSIGNED_BYTE, frame.pixels.data());
+
+    float sf = getContentScaleFactorSafe();
+    out.sheet = static_cast<int>(m_sheets.size()) - 1;
+    out.sheetRect = CCRect((cursor.x + SHEET_PADDING) / sf, (cursor.y + SHEET_PADDING) / sf,
+                           frame.width / sf, frame.height / sf);
+    out.rect = CCRect(frame.left, frame.top, frame.width, frame.height);
+
+    cursor.x += pw;
+    cursor.shelfHeight = std::max(cursor.shelfHeight, ph);
+    return true;
+}
+
+bool AnimatedGIFSprite::openSheet(int minWidth, int minHeight) {
+    // celdas del canvas entero: cualquier frame recortado cabe en una, asi una
+    // hoja con N celdas siempre aguanta N frames (recortados entran mas)
+    int cellW = std::max(m_canvasWidth + 2 * SHEET_PADDING, minWidth);
+    int cellH = std::max(m_canvasHeight + 2 * SHEET_PADDING, minHeight);
+    // en modo ventana la hoja solo lleva el frame 0
+    int remaining = m_windowed ? 1 : std::max(1, m_expectedFrames - static_cast<int>(m_frames.size()));
+    int cols = std::clamp(MAX_SHEET_SIZE / cellW, 1, remaining);
+    int rows = std::clamp((remaining + cols - 1) / cols, 1, std::max(1, MAX_SHEET_SIZE / cellH));
+    int width = cols * cellW;
+    int height = rows * cellH;
+
+    float sf = getContentScaleFactorSafe();
+    auto* sheet = new CCTexture2D();
+    // sin datos: cada frame se sube a su hueco con glTexSubImage2D
+    if (!sheet->initWithData(nullptr, kCCTexture2DPixelFormat_RGBA8888, width, height,
+                             CCSize(width / sf, height / sf))) {
+        sheet->release();
+        log::warn("[AnimatedGIFSprite] No se pudo crear hoja {}x{} pa {}", width, height, m_filename);
+        return false;
+    }
+    sheet->setAntiAliasTexParameters();
+    // ref extra pa s_gifCache; finishTextureLoading se lo pasa a la entrada
+    if (m_texturesLoading) sheet->retain();
+
+    m_sheets.push_back(sheet);
+    m_sheetCursor = SheetCursor{0, 0, 0, width, height};
+    return true;
+}
+
 std::string AnimatedGIFSprite::getCachePath(std::string const& path) {
     auto cacheDir = getDiskCacheDir();
     std::error_code ec;
@@ -417,7 +824,21 @@ void AnimatedGIFSprite::pruneDiskCache() {
 
     for (auto const& entry : std::filesystem::directory_iterator(cacheDir, ec)) {
         if (ec || !entry.is_regular_file()) continue;
-        if (geode::utils::string::toLower(geode::utils::string::pathToString(entry.path().extension())) != ".bin") continue;
+        auto ext = geode::utils::string::toLower(geode::utils::string::pathToString(entry.path().extension()));
+        if (ext == ".part") {
+            // restos de un decode incremental que se corto (crash o cierre). los
+            // de otra sesion ya no tienen dueño; los de esta pueden estar
+            // escribiendose, solo se borran si llevan mucho sin tocarse
+            auto name = geode::utils::string::pathToString(entry.path().filename());
+            bool stale = !isOwnPartFile(name);
+            if (!stale) {
+                auto mtime = std::filesystem::last_write_time(entry.path(), ec);
+                stale = !ec && std::filesystem::file_time_type::clock::now() - mtime > std::chrono::hours(1);
+            }
+            if (stale) std::filesystem::remove(entry.path(), ec);
+            continue;
+        }
+        if (ext != ".bin") continue;
         size_t bytes = static_cast<size_t>(entry.file_size(ec));
         if (ec) continue;
         auto mtime = std::filesystem::last_write_time(entry.path(), ec);
@@ -446,333 +867,316 @@ void AnimatedGIFSprite::pruneDiskCache() {
     }
 }
 
-bool AnimatedGIFSprite::loadFromDiskCache(std::string const& path, DiskCacheEntry& outEntry) {
+std::unique_ptr<GIFFrameStore::Reader> AnimatedGIFSprite::openDiskCache(std::string const& path) {
     auto cachePath = getCachePath(path);
     std::error_code existsEc;
-    if (!std::filesystem::exists(cachePath, existsEc) || existsEc) return false;
+    if (!std::filesystem::exists(cachePath, existsEc) || existsEc) return nullptr;
 
     // miro la fecha de modificacion
     std::error_code ec;
     auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
-    if (ec) return false;
+    if (ec) return nullptr;
     auto sourceTime = std::filesystem::last_write_time(path, ec);
-    if (ec) return false;
+    if (ec) return nullptr;
 
     // si la fuente es mas nueva que la cache, la tiro
-    if (sourceTime > cacheTime) return false;
+    if (sourceTime > cacheTime) return nullptr;
 
-    std::ifstream file(cachePath, std::ios::binary);
-    if (!file) return false;
-
-    // cabecera: version, ancho, alto, nº de frames
-    uint32_t version;
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
-    if (version != DISK_CACHE_VERSION) return false;
-
-    file.read(reinterpret_cast<char*>(&outEntry.width), sizeof(outEntry.width));
-    file.read(reinterpret_cast<char*>(&outEntry.height), sizeof(outEntry.height));
-
-    uint32_t frameCount;
-    file.read(reinterpret_cast<char*>(&frameCount), sizeof(frameCount));
+    // version vieja o cabecera rota: se vuelve a decodificar y se sobrescribe
+    auto reader = std::make_unique<GIFFrameStore::Reader>();
+    if (!reader->open(cachePath)) return nullptr;
+    return reader;
+}
 
-    outEntry.frames.resize(frameCount);
-    for (uint32_t i = 0; i < frameCount; ++i) {
-        auto& frame = outEntry.frames[i];
-        file.read(reinterpret_cast<char*>(&frame.delay), sizeof(frame.delay));
-        file.read(reinterpret_cast<char*>(&frame.width), sizeof(frame.width));
-        file.read(reinterpret_cast<char*>(&frame.height), sizeof(frame.height));
+// estado de un GIF que se decodifica por tandas; lo comparten el sprite y la
+// tarea del worker, pero solo el worker toca el stream (una tanda a la vez).
+// La fuente es el GIF o su cache en disco, que se lee por tandas igual.
+struct AnimatedGIFSprite::StreamState {
+    std::unique_ptr<GIFDecoder::Stream> gif;
+    std::shared_ptr<std::vector<uint8_t> const> borrowed; // bytes de un GIF en memoria
+    std::unique_ptr<GIFFrameStore::Reader> cached;
+    int frameCount = 0;
+    SheetFramePrep prep;
+    // GIF largo: los frames salen comprimidos pa modo ventana
+    bool windowed = false;
+    size_t produced = 0;
+
+    // cache en disco escrita a la vez que se decodifica (solo GIFs de archivo):
+    // va a un .part propio del stream y se renombra al terminar, asi nunca se
+    // lee a medias
+    std::string partPath;
+    std::string cachePath;
+    GIFFrameStore::Writer disk;
+
+    explicit StreamState(std::vector<uint8_t> data)
+        : frameCount(GIFDecoder::countFrames(data.data(), data.size())) {
+        gif = std::make_unique<GIFDecoder::Stream>(std::move(data));
+        windowed = valid() && shouldWindowGIF(width(), height(), frameCount);
+    }
 
-        uint32_t dataSize;
-        file.read(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
+    // GIF en memoria: el stream lee de los bytes compartidos sin copiarlos
+    explicit StreamState(std::shared_ptr<std::vector<uint8_t> const> data)
+        : borrowed(std::move(data)), frameCount(GIFDecoder::countFrames(borrowed->data(), borrowed->size())) {
+        gif = std::make_unique<GIFDecoder::Stream>(borrowed->data(), borrowed->size());
+        windowed = valid() && shouldWindowGIF(width(), height(), frameCount);
+    }
 
-        frame.pixels.resize(dataSize);
-        file.read(reinterpret_cast<char*>(frame.pixels.data()), dataSize);
+    StreamState(std::unique_ptr<GIFFrameStore::Reader> reader, std::string path)
+        : cached(std::move(reader)), cachePath(std::move(path)) {
+        frameCount = static_cast<int>(cached->frameCount());
+        windowed = shouldWindowGIF(width(), height(), frameCount);
     }
 
-    return file.good();
-}
+    ~StreamState() {
+        // el sprite se fue antes de acabar: fuera el archivo a medias
+        if (disk.isOpen()) {
+            disk.abandon();
+            std::error_code ec;
+            std::filesystem::remove(partPath, ec);
+        }
+    }
 
-void AnimatedGIFSprite::saveToDiskCache(std::string const& path, DiskCacheEntry const& entry) {
-    auto cachePath = getCachePath(path);
-    std::ofstream file(cachePath, std::ios::binary);
-    if (!file) return;
+    bool valid() const { return cached || (gif && gif->valid()); }
+    int width() const { return cached ? cached->width() : gif->width(); }
+    int height() const { return cached ? cached->height() : gif->height(); }
+    bool done() const { return cached ? cached->done() : gif->done(); }
 
-    uint32_t version = DISK_CACHE_VERSION;
-    file.write(reinterpret_cast<char const*>(&version), sizeof(version));
-    file.write(reinterpret_cast<char const*>(&entry.width), sizeof(entry.width));
-    file.write(reinterpret_cast<char const*>(&entry.height), sizeof(entry.height));
+    void openDiskCache(std::string const& sourcePath) {
+        cachePath = getCachePath(sourcePath);
+        partPath = makePartPath(cachePath);
+        disk.open(partPath, width(), height());
+    }
 
-    uint32_t frameCount = entry.frames.size();
-    file.write(reinterpret_cast<char const*>(&frameCount), sizeof(frameCount));
+    void closeDiskCache() {
+        if (!disk.isOpen()) return;
+        bool ok = disk.finish();
 
-    for (auto const& frame : entry.frames) {
-        file.write(reinterpret_cast<char const*>(&frame.delay), sizeof(frame.delay));
-        file.write(reinterpret_cast<char const*>(&frame.width), sizeof(frame.width));
-        file.write(reinterpret_cast<char const*>(&frame.height), sizeof(frame.height));
+        std::error_code ec;
+        if (ok) std::filesystem::rename(partPath, cachePath, ec);
+        if (!ok || ec) std::filesystem::remove(partPath, ec);
+        else pruneDiskCache();
+    }
 
-        uint32_t dataSize = frame.pixels.size();
-        file.write(reinterpret_cast<char const*>(&dataSize), sizeof(dataSize));
-        file.write(reinterpret_cast<char const*>(frame.pixels.data()), dataSize);
+    // decodifica hasta `count` frames ya listos pa la hoja; true si ya no hay mas.
+    // En modo ventana cada frame va tambien comprimido a `packed` y solo el
+    // frame 0 conserva los pixeles sin comprimir
+    bool decode(std::vector<GIFDecoder::Frame>& out, std::vector<PackedFrame>& packed, size_t count) {
+        GIFDecoder::Frame frame;
+        while (out.size() < count && (cached ? cached->nextFrame(frame) : gif->nextFrame(frame))) {
+            // la cache en disco guarda el canvas completo
+            if (disk.isOpen()) disk.append(frame);
+            prep.apply(frame);
+            if (windowed) {
+                PackedFrame p{frame.left, frame.top, frame.width, frame.height, nullptr};
+                if (!frame.pixels.empty()) {
+                    auto bytes = std::make_shared<std::vector<uint8_t>>();
+                    paimon::lz::compress(frame.pixels.data(), frame.pixels.size(), *bytes);
+                    bytes->shrink_to_fit();
+                    p.pixels = std::move(bytes);
+                }
+                packed.push_back(std::move(p));
+                if (produced > 0) frame.pixels = {};
+            }
+            produced++;
+            out.push_back(std::move(frame));
+        }
+        if (!done()) return false;
+        if (cached && cached->failed()) {
+            // archivo corrupto: fuera, el proximo load decodifica el GIF
+            log::warn("[AnimatedGIFSprite] Cache en disco corrupta: {}", cachePath);
+            std::error_code ec;
+            std::filesystem::remove(cachePath, ec);
+        }
+        closeDiskCache();
+        return true;
     }
-    file.flush();
-    pruneDiskCache();
-}
+};
+
+void AnimatedGIFSprite::workerLoop(unsigned index) {
+    geode::utils::thread::setName(fmt::format("GIF Decode #{}", index));
+    // al arrancar: fuera los .part que dejo una sesion anterior
+    if (index == 0) pruneDiskCache();
 
-void AnimatedGIFSprite::workerLoop() {
     while (true) {
         GIFTask task;
+        std::string key;
+        uint64_t loadId = 0;
+        std::string path;
+        std::shared_ptr<std::vector<uint8_t> const> data;
         {
             std::unique_lock<std::mutex> lock(s_queueMutex);
-            s_queueCV.wait(lock, []{ return !s_taskQueue.empty() || !s_workerRunning.load(std::memory_order_acquire); });
+            s_queueCV.wait(lock, [] {
+                return !s_taskQueue.empty() || !s_loadQueue.empty() || !s_workerRunning.load(std::memory_order_acquire);
+            });
             
-            if (!s_workerRunning.load(std::memory_order_acquire) && s_taskQueue.empty()) break;
+            if (!s_workerRunning.load(std::memory_order_acquire) && s_taskQueue.empty() && s_loadQueue.empty()) break;
             
-            task = s_taskQueue.front();
-            s_taskQueue.pop_front();
-        }
-        
-        // proceso la tarea que toque
-        if (task.isData) {
-            // decodificar desde memoria
-            if (!GIFDecoder::isGIF(task.data.data(), task.data.size())) {
-                Loader::get()->queueInMainThread([cb = task.callback]() { if (cb) cb(nullptr); });
-                continue;
+            if (!s_taskQueue.empty()) {
+                task = std::move(s_taskQueue.front());
+                s_taskQueue.pop_front();
+            } else {
+                key = *s_loadQueue.pop();
+                auto it = s_inFlight.find(key);
+                if (it == s_inFlight.end()) continue;
+                loadId = it->second.id;
+                path = it->second.path;
+                data = it->second.data;
             }
-            
-            auto gifData = GIFDecoder::decode(task.data.data(), task.data.size());
-            
-            Loader::get()->queueInMainThread([key = task.key, gifData = std::move(gifData), cb = task.callback]() mutable {
-                if (s_shutdownMode.load(std::memory_order_acquire)) {
-                    if (cb) cb(nullptr);
-                    return;
-                }
-                if (gifData.frames.empty()) {
-                    if (cb) cb(nullptr);
-                    return;
-                }
-                
-                auto ret = new AnimatedGIFSprite();
-                if (ret) {
-                    ret->m_filename = key;
-                    ret->m_canvasWidth = gifData.width;
-                    ret->m_canvasHeight = gifData.height;
-
-                    if (!ret->init()) {
-                        CC_SAFE_DELETE(ret);
-                        if (cb) cb(nullptr);
-                        return;
-                    }
-
-                    float sf = getContentScaleFactorSafe();
-                    ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
-
-                    // proceso todos los frames ya pa dejar el GIF entero en cache
-                    for (auto const& frameData : gifData.frames) {
-                        auto* gifFrame = new GIFFrame();
-                        auto* texture = new CCTexture2D();
-
-                        bool success = texture->initWithData(
-                            frameData.pixels.data(),
-                            kCCTexture2DPixelFormat_RGBA8888,
-                            frameData.width,
-                            frameData.height,
-                            CCSize(frameData.width / sf, frameData.height / sf)
-                        );
-
-                        if (success) {
-                            texture->setAntiAliasTexParameters();
-                            gifFrame->texture = texture;
-                            gifFrame->delay = frameData.delayMs / 1000.0f;
-                            gifFrame->rect = CCRect(frameData.left, frameData.top, frameData.width, frameData.height);
-                            ret->m_frames.push_back(gifFrame);
-                            ret->m_frameColors.push_back({ {0,0,0}, {255,255,255} });
-                            texture->retain();
-                        } else {
-                            delete gifFrame;
-                            texture->release();
-                        }
-                    }
-
-                    if (ret->m_frames.empty()) {
-                        CC_SAFE_DELETE(ret);
-                        if (cb) cb(nullptr);
-                        return;
-                    }
-
-                    // guardo en cache con todos los frames ya listos
-                    SharedGIFData cacheEntry;
-                    cacheEntry.width = ret->m_canvasWidth;
-                    cacheEntry.height = ret->m_canvasHeight;
-
-                    for (auto* frame : ret->m_frames) {
-                        cacheEntry.textures.push_back(frame->texture);
-                        cacheEntry.delays.push_back(frame->delay);
-                        cacheEntry.frameRects.push_back(frame->rect);
-                    }
-
-                    {
-                        std::lock_guard<std::mutex> lock(s_cacheMutex);
-                        s_gifCache[key] = cacheEntry;
-                        s_currentCacheSize += getSharedGIFDataSize(cacheEntry);
-                        if (!isPinned(key)) {
-                            s_lruList.push_back(key);
-                            s_lruMap[key] = std::prev(s_lruList.end());
-                        }
-                        evictIfNeeded();
-                    }
-
-                    log::info("[AnimatedGIFSprite] Cached complete GIF from data with key: {} ({} frames)", key, ret->m_frames.size());
-
-                    // pongo el primer frame y arranco la animacion
-                    ret->setCurrentFrame(0);
-                    ret->scheduleUpdate();
-                    ret->autorelease();
-
-                    if (cb) cb(ret);
-                } else {
-                    if (cb) cb(nullptr);
+        }
+
+        if (loadId) {
+            runLoad(std::move(key), loadId, path, std::move(data));
+            continue;
+        }
+
+        // siguiente tanda de un GIF que ya se esta mostrando
+        if (task.stream) {
+            std::vector<GIFDecoder::Frame> frames;
+            std::vector<PackedFrame> packed;
+            bool done = task.stream->decode(frames, packed, STREAM_BATCH_FRAMES);
+            Loader::get()->queueInMainThread([frames = std::move(frames), packed = std::move(packed), done,
+                                              onFrames = std::move(task.onFrames)]() mutable {
+                if (s_shutdownMode.load(std::memory_order_acquire)) return;
+                if (onFrames) onFrames(std::move(frames), std::move(packed), done);
+            });
+            continue;
+        }
+
+        // frames de la ventana de un GIF largo que se esta viendo
+        if (!task.unpack.empty()) {
+            std::vector<std::pair<int, std::vector<uint8_t>>> unpacked;
+            for (auto const& [source, frame] : task.unpack) {
+                if (!frame.pixels) continue;
+                std::vector<uint8_t> pixels(static_cast<size_t>(frame.width + 2 * SHEET_PADDING) *
+                                            (frame.height + 2 * SHEET_PADDING) * 4);
+                if (paimon::lz::decompress(frame.pixels->data(), frame.pixels->size(), pixels.data(), pixels.size())) {
+                    unpacked.emplace_back(source, std::move(pixels));
                 }
+            }
+            Loader::get()->queueInMainThread([unpacked = std::move(unpacked), onUnpacked = std::move(task.onUnpacked)]() mutable {
+                if (s_shutdownMode.load(std::memory_order_acquire)) return;
+                if (onUnpacked) onUnpacked(std::move(unpacked));
             });
-            
+        }
+    }
+}
+
+void AnimatedGIFSprite::runLoad(std::string key, uint64_t id, std::string const& path,
+                                std::shared_ptr<std::vector<uint8_t> const> data) {
+    // el resultado es de este decode y no de uno anterior de la misma key
+    auto isCurrent = [key, id]() {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        auto it = s_inFlight.find(key);
+        return it != s_inFlight.end() && it->second.id == id;
+    };
+    auto fail = [key, isCurrent]() {
+        Loader::get()->queueInMainThread([key, isCurrent]() {
+            if (isCurrent()) failLoad(key);
+        });
+    };
+
+    std::shared_ptr<StreamState> state;
+    std::vector<GIFDecoder::Frame> frames;
+    std::vector<PackedFrame> packed;
+    bool done = false;
+
+    if (!data) {
+        // primero intento tirar del cache en disco: se lee por tandas
+        // igual que el GIF, sin cargar el archivo entero
+        if (auto cached = openDiskCache(path)) {
+            state = std::make_shared<StreamState>(std::move(cached), getCachePath(path));
+            done = state->decode(frames, packed, STREAM_FIRST_BATCH);
+            // cache rota (decode ya la borro): toca decodificar el GIF
+            if (frames.empty()) state.reset();
+        }
+    }
+
+    if (!state) {
+        if (data) {
+            // decodificar desde memoria (los bytes siguen en la entrada de s_inFlight)
+            if (!GIFDecoder::isGIF(data->data(), data->size())) return fail();
+            state = std::make_shared<StreamState>(std::move(data));
         } else {
             // decodificar desde archivo
-            // primero intento tirar del cache en disco
-            DiskCacheEntry cachedEntry;
-            if (loadFromDiskCache(task.path, cachedEntry)) {
-                Loader::get()->queueInMainThread([path = task.path, cachedEntry = std::move(cachedEntry), cb = task.callback]() mutable {
-                    if (s_shutdownMode.load(std::memory_order_acquire)) {
-                        if (cb) cb(nullptr);
-                        return;
-                    }
-                    auto ret = new AnimatedGIFSprite();
-                    if (ret) {
-                        ret->m_filename = path;
-                        ret->m_canvasWidth = cachedEntry.width;
-                        ret->m_canvasHeight = cachedEntry.height;
-                        
-                        if (!ret->init()) {
-                            CC_SAFE_DELETE(ret);
-                            if (cb) cb(nullptr);
-                            return;
-                        }
-                        
-                        float sf = getContentScaleFactorSafe();
-                        ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
-                        
-                        // cargo todos los frames desde el cache (ya vienen procesados)
-                        for (auto const& frame : cachedEntry.frames) {
-                            auto texture = new CCTexture2D();
-                            if (!texture->initWithData(
-                                frame.pixels.data(),
-                                kCCTexture2DPixelFormat_RGBA8888,
-                                frame.width,
-                                frame.height,
-                                CCSize(frame.width / sf, frame.height / sf)
-                            )) {
-                                texture->release();
-                                continue;
-                            }
-                            texture->setAntiAliasTexParameters();
-                            
-                            auto* gifFrame = new GIFFrame();
-                            gifFrame->texture = texture;
-                            gifFrame->delay = frame.delay;
-                            gifFrame->rect = CCRect(0, 0, frame.width, frame.height);
-                            
-                            ret->m_frames.push_back(gifFrame);
-                            ret->m_frameColors.push_back({ {0,0,0}, {255,255,255} });
-                            texture->retain();
-                        }
-                        
-                        if (!ret->m_frames.empty()) {
-                            ret->setCurrentFrame(0);
-                            ret->scheduleUpdate();
-                        }
-                        
-                        ret->autorelease();
-                        if (cb) cb(ret);
-                    } else {
-                        if (cb) cb(nullptr);
-                    }
-                });
-                continue;
-            }
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return fail();
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!GIFDecoder::isGIF(bytes.data(), bytes.size())) return fail();
+
+            state = std::make_shared<StreamState>(std::move(bytes));
+            // la cache en disco se va escribiendo con cada tanda
+            if (state->valid()) state->openDiskCache(path);
+        }
 
-            std::ifstream file(task.path, std::ios::binary);
-            if (!file) {
-                Loader::get()->queueInMainThread([cb = task.callback]() { if (cb) cb(nullptr); });
-                continue;
-            }
+        // solo el frame 0: el sprite sale ya y el resto llega por tandas
+        frames.clear();
+        packed.clear();
+        done = state->decode(frames, packed, STREAM_FIRST_BATCH);
+    }
 
-            std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
+    int width = state->width();
+    int height = state->height();
+    int frameCount = state->frameCount;
+    bool windowed = state->windowed;
+    if (done) state.reset();
+
+    Loader::get()->queueInMainThread([key = std::move(key), isCurrent, width, height, frameCount, windowed,
+                                      frames = std::move(frames), packed = std::move(packed),
+                                      state = std::move(state)]() mutable {
+        if (s_shutdownMode.load(std::memory_order_acquire) || !isCurrent()) return;
+        if (frames.empty()) {
+            failLoad(key);
+            return;
+        }
 
-            if (!GIFDecoder::isGIF(data.data(), data.size())) {
-                Loader::get()->queueInMainThread([cb = task.callback]() { if (cb) cb(nullptr); });
-                continue;
+        // el primero que lo pidio se lleva este sprite; el resto espera al cache
+        AsyncCallback cb;
+        {
+            std::lock_guard<std::mutex> lock(s_queueMutex);
+            auto& callbacks = s_inFlight[key].callbacks;
+            if (!callbacks.empty()) {
+                cb = std::move(callbacks.front());
+                callbacks.erase(callbacks.begin());
             }
+        }
+        
+        auto ret = new AnimatedGIFSprite();
+        ret->m_filename = key;
+        ret->m_canvasWidth = width;
+        ret->m_canvasHeight = height;
+        ret->m_expectedFrames = frameCount;
+        ret->m_pendingFrames = std::move(frames);
+        ret->m_stream = std::move(state);
+        if (windowed) {
+            ret->m_windowed = true;
+            ret->m_pendingPacked.assign(std::make_move_iterator(packed.begin()), std::make_move_iterator(packed.end()));
+            s_windowedSprites++;
+        }
 
-            auto gifData = GIFDecoder::decode(data.data(), data.size());
-            
-            // guardo en cache de disco (RGBA8888)
-            DiskCacheEntry newCacheEntry;
-            newCacheEntry.width = gifData.width;
-            newCacheEntry.height = gifData.height;
-            
-            for (auto const& frame : gifData.frames) {
-                DiskCacheEntry::Frame cacheFrame;
-                cacheFrame.delay = frame.delayMs / 1000.0f;
-                cacheFrame.width = frame.width;
-                cacheFrame.height = frame.height;
-                cacheFrame.pixels = frame.pixels;
-                newCacheEntry.frames.push_back(std::move(cacheFrame));
-            }
-            saveToDiskCache(task.path, newCacheEntry);
-            
-            Loader::get()->queueInMainThread([path = task.path, gifData = std::move(gifData), cb = task.callback]() mutable {
-                if (s_shutdownMode.load(std::memory_order_acquire)) {
-                    if (cb) cb(nullptr);
-                    return;
-                }
-                if (gifData.frames.empty()) {
-                    if (cb) cb(nullptr);
-                    return;
-                }
-                
-                auto ret = new AnimatedGIFSprite();
-                if (ret) {
-                    ret->m_filename = path;
-                    ret->m_canvasWidth = gifData.width;
-                    ret->m_canvasHeight = gifData.height;
-                    ret->m_pendingFrames = std::move(gifData.frames);
-
-                    if (!ret->init()) {
-                        CC_SAFE_DELETE(ret);
-                        if (cb) cb(nullptr);
-                        return;
-                    }
-
-                    float sf = getContentScaleFactorSafe();
-                    ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
-
-                    // me aseguro de tener al menos un frame antes del callback
-                    ret->processNextPendingFrame();
-
-                    // el resto de frames se cargan poco a poco en el update
-                    if (!ret->m_pendingFrames.empty()) {
-                        ret->schedule(schedule_selector(AnimatedGIFSprite::updateTextureLoading));
-                    } else {
-                        ret->scheduleUpdate();
-                    }
-                    ret->autorelease();
-
-                    if (cb) cb(ret);
-                } else {
-                    if (cb) cb(nullptr);
-                }
-            });
+        if (!ret->init()) {
+            CC_SAFE_DELETE(ret);
+            failLoad(key);
+            if (cb) cb(nullptr);
+            return;
         }
-    }
+
+        float sf = getContentScaleFactorSafe();
+        ret->setContentSize(CCSize(ret->m_canvasWidth / sf, ret->m_canvasHeight / sf));
+
+        // frame 0 ya; el resto se decodifica y sube por tandas y al terminar
+        // queda el GIF entero en cache (y ahi reciben copia los demas)
+        ret->m_ownsLoad = true;
+        if (!ret->beginTextureLoading()) {
+            ret->m_ownsLoad = false;
+            CC_SAFE_DELETE(ret);
+            failLoad(key);
+            if (cb) cb(nullptr);
+            return;
+        }
+        ret->autorelease();
+
+        if (cb) cb(ret);
+    });
 }
 
 void AnimatedGIFSprite::clearCache() {
@@ -780,8 +1184,8 @@ void AnimatedGIFSprite::clearCache() {
     shutdownWorker();
     std::lock_guard<std::mutex> lock(s_cacheMutex);
     for (auto& [key, data] : s_gifCache) {
-        for (auto* tex : data.textures) {
-            if (tex) tex->release();
+        for (auto* sheet : data.sheets) {
+            if (sheet) sheet->release();
         }
     }
     s_gifCache.clear();
@@ -789,28 +1193,13 @@ void AnimatedGIFSprite::clearCache() {
     s_lruMap.clear();
     s_pinnedGIFs.clear();
     s_currentCacheSize = 0;
+    paimon::memory::MemoryBudget::get().forgetAll(budgetSource());
     PaimonDebug::log("[AnimatedGIFSprite] Cache cleared");
 }
 
 void AnimatedGIFSprite::remove(std::string const& filename) {
     std::lock_guard<std::mutex> lock(s_cacheMutex);
-    auto it = s_gifCache.find(filename);
-    if (it != s_gifCache.end()) {
-        size_t removeSize = 0;
-        for (auto* tex : it->second.textures) {
-            if (tex) {
-                removeSize += tex->getPixelsWide() * tex->getPixelsHigh() * 4;
-                tex->release();
-            }
-        }
-        if (s_currentCacheSize >= removeSize) s_currentCacheSize -= removeSize;
-        else s_currentCacheSize = 0;
-        s_gifCache.erase(it);
-        auto lruIt = s_lruMap.find(filename);
-        if (lruIt != s_lruMap.end()) {
-            s_lruList.erase(lruIt->second);
-            s_lruMap.erase(lruIt);
-        }
+    if (eraseCacheEntry(filename)) {
         PaimonDebug::log("[AnimatedGIFSprite] Removed from cache: {}", filename);
     }
 }
@@ -825,11 +1214,18 @@ AnimatedGIFSprite::~AnimatedGIFSprite() {
     this->unscheduleUpdate();
     this->setTexture(nullptr);
     
-    for (auto* frame : m_frames) {
-        if (frame) {
-            delete frame;
-        }
+    m_shaderCanvas = nullptr;
+    releaseWindow();
+    if (m_windowed) s_windowedSprites--;
+    // se fue antes de acabar de cargar: los que esperaban necesitan otro decode
+    if (m_ownsLoad) abandonLoad(m_filename);
+    
+    for (auto* sheet : m_sheets) {
+        // carga cortada a medias: el ref extra era pa s_gifCache y nunca llego
+        if (m_texturesLoading) sheet->release();
+        sheet->release();
     }
+    m_sheets.clear();
     m_frames.clear();
 }
 
@@ -852,24 +1248,46 @@ bool AnimatedGIFSprite::initFromCache(std::string const& cacheKey) {
         }
         s_lruList.push_back(cacheKey);
         s_lruMap[cacheKey] = std::prev(s_lruList.end());
+
+        paimon::memory::MemoryBudget::get().touch(budgetSource(), cacheKey,
+            getSharedGIFDataSize(cachedData), gifRebuildCost(cachedData.delays.size()));
     }
     m_canvasWidth = cachedData.width;
     m_canvasHeight = cachedData.height;
+    m_windowed = !cachedData.packed.empty();
     
-    PaimonDebug::log("[AnimatedGIFSprite] Cache hit for: {}, size: {}x{}, frames: {}", 
-        cacheKey, m_canvasWidth, m_canvasHeight, cachedData.textures.size());
-
-    for (size_t i = 0; i < cachedData.textures.size(); ++i) {
-        auto* gifFrame = new GIFFrame();
-        gifFrame->texture = cachedData.textures[i];
-        gifFrame->texture->retain(); // retain pa esta instancia del sprite
-        gifFrame->delay = (i < cachedData.delays.size()) ? cachedData.delays[i] : 0.1f;
-        gifFrame->rect = (i < cachedData.frameRects.size()) ? cachedData.frameRects[i] : CCRect(0, 0, m_canvasWidth, m_canvasHeight);
+    PaimonDebug::log("[AnimatedGIFSprite] Cache hit for: {}, size: {}x{}, frames: {}, sheets: {}{}", 
+        cacheKey, m_canvasWidth, m_canvasHeight, cachedData.delays.size(), cachedData.sheets.size(),
+        m_windowed ? " (ventana)" : "");
+
+    for (auto* sheet : cachedData.sheets) {
+        sheet->retain(); // retain pa esta instancia del sprite
+        m_sheets.push_back(sheet);
+    }
+
+    size_t frameCount = std::min({cachedData.frameSheets.size(), cachedData.sheetRects.size(), cachedData.delays.size()});
+    if (m_windowed) frameCount = std::min(frameCount, cachedData.packed.size());
+    for (size_t i = 0; i < frameCount; ++i) {
+        GIFFrame gifFrame;
+        gifFrame.sheet = cachedData.frameSheets[i];
+        gifFrame.sheetRect = cachedData.sheetRects[i];
+        gifFrame.delay = cachedData.delays[i];
+        gifFrame.rect = (i < cachedData.frameRects.size()) ? cachedData.frameRects[i] : CCRect(0, 0, m_canvasWidth, m_canvasHeight);
+        if (m_windowed) {
+            // frames de la ventana: se saltan sin romper el indice de m_packed
+            bool repeated = i > 0 && cachedData.packed[i].pixels == cachedData.packed[i - 1].pixels;
+            gifFrame.source = repeated ? m_frames.back().source : static_cast<int>(i);
+            if (gifFrame.sheet >= static_cast<int>(m_sheets.size())) gifFrame.sheet = -1;
+            m_packed.push_back(cachedData.packed[i]);
+        } else if (gifFrame.sheet < 0 || gifFrame.sheet >= static_cast<int>(m_sheets.size())) {
+            continue;
+        }
         m_frames.push_back(gifFrame);
         
         // colores por defecto pa evitar indice fuera de rango
         m_frameColors.push_back({ {0,0,0}, {255,255,255} });
     }
+    if (m_windowed) s_windowedSprites++;
     
     if (m_frames.empty()) {
         log::error("[AnimatedGIFSprite] Cached frames empty for: {}", cacheKey);
@@ -900,7 +1318,7 @@ AnimatedGIFSprite* AnimatedGIFSprite::createFromCache(std::string const& key) {
     return nullptr;
 }
 
-void AnimatedGIFSprite::createAsync(std::vector<uint8_t> const& data, std::string const& key, AsyncCallback callback) {
+void AnimatedGIFSprite::createAsync(std::vector<uint8_t> const& data, std::string const& key, AsyncCallback callback, int priority) {
     log::debug("[AnimatedGIFSprite] createAsync(data): key={} size={}", key, data.size());
     if (data.empty()) {
         if (callback) callback(nullptr);
@@ -914,23 +1332,12 @@ void AnimatedGIFSprite::createAsync(std::vector<uint8_t> const& data, std::strin
         return;
     }
 
-    initWorker();
-
-    {
-        std::lock_guard<std::mutex> lock(s_queueMutex);
-        GIFTask task;
-        task.data = data;
-        task.key = key;
-        task.callback = callback;
-        task.isData = true;
-        s_taskQueue.push_back(task);
-    }
-    s_queueCV.notify_one();
+    enqueueLoad(key, {}, &data, std::move(callback), priority);
 }
 
 
 
-void AnimatedGIFSprite::createAsync(std::string const& path, AsyncCallback callback) {
+void AnimatedGIFSprite::createAsync(std::string const& path, AsyncCallback callback, int priority) {
     log::debug("[AnimatedGIFSprite] createAsync(path): {}", path);
     std::error_code existsEc;
     if (!std::filesystem::exists(path, existsEc) || existsEc) {
@@ -945,21 +1352,12 @@ void AnimatedGIFSprite::createAsync(std::string const& path, AsyncCallback callb
         return;
     }
 
-    initWorker();
-
-    {
-        std::lock_guard<std::mutex> lock(s_queueMutex);
-        GIFTask task;
-        task.path = path;
-        task.callback = callback;
-        task.isData = false;
-        s_taskQueue.push_back(task);
-    }
-    s_queueCV.notify_one();
+    enqueueLoad(path, path, nullptr, std::move(callback), priority);
 }
 
 void AnimatedGIFSprite::update(float dt) {
     CCSprite::update(dt);
+    updateResidency(dt);
     updateAnimation(dt);
 }
 
@@ -967,35 +1365,46 @@ void AnimatedGIFSprite::updateAnimation(float dt) {
     if (!m_isPlaying || m_frames.empty()) {
         return;
     }
+    // fuera de pantalla un GIF en ventana se queda en el frame 0
+    if (m_windowed && !m_onScreen) {
+        return;
+    }
     
     m_frameTimer += dt;
     
     // Obtener el delay del frame actual
     float currentDelay = 0.1f;
-    if (m_currentFrame < m_frames.size() && m_frames[m_currentFrame]) {
-        currentDelay = m_frames[m_currentFrame]->delay;
+    if (m_currentFrame < m_frames.size()) {
+        currentDelay = m_frames[m_currentFrame].delay;
     }
     if (currentDelay <= 0.0f) {
         currentDelay = 0.1f; // Delay por defecto de 100ms
     }
     
     if (m_frameTimer >= currentDelay) {
-        m_frameTimer = 0.0f;
-        
         // Avanzar al siguiente frame
-        m_currentFrame++;
+        unsigned int next = m_currentFrame + 1;
         
-        if (m_currentFrame >= m_frames.size()) {
+        if (next >= m_frames.size()) {
             if (m_loop) {
-                m_currentFrame = 0;
+                next = 0;
             } else {
+                m_frameTimer = 0.0f;
                 m_currentFrame = m_frames.size() - 1;
                 m_isPlaying = false;
                 return;
             }
         }
+
+        // modo ventana: si el siguiente aun no esta en GPU me quedo en este
+        // frame con el timer lleno, y cambia en cuanto se suba
+        if (!isFrameReady(next)) {
+            pumpWindow();
+            return;
+        }
         
-        setCurrentFrame(m_currentFrame);
+        setCurrentFrame(next);
+        if (m_windowed) pumpWindow();
     }
 }
 
@@ -1005,50 +1414,336 @@ void AnimatedGIFSprite::setCurrentFrame(unsigned int frame) {
         return;
     }
     
+    auto const& gifFrame = m_frames[frame];
+    CCTexture2D* texture = nullptr;
+    CCRect sheetRect;
+    if (!frameTexture(gifFrame, texture, sheetRect)) {
+        // frame de la ventana que aun no esta subido
+        if (m_windowed) pumpWindow();
+        return;
+    }
+
     m_currentFrame = frame;
     m_frameTimer = 0.0f;
+
+    if (m_useShaderCanvas && drawToShaderCanvas(gifFrame, texture, sheetRect)) return;
+
+    float sf = getContentScaleFactorSafe();
+    
+    // offset del rect recortado respecto al centro del canvas (gif top-left, cocos bottom-left)
+    float left = gifFrame.rect.origin.x;
+    float top = gifFrame.rect.origin.y;
+    float w = gifFrame.rect.size.width;
+    float h = gifFrame.rect.size.height;
+    
+    float centerX = left + w / 2.0f;
+    float centerY = (m_canvasHeight - top) - h / 2.0f;
     
-    if (m_frames[m_currentFrame] && m_frames[m_currentFrame]->texture) {
-        auto* gifFrame = m_frames[m_currentFrame];
+    float canvasCenterX = m_canvasWidth / 2.0f;
+    float canvasCenterY = m_canvasHeight / 2.0f;
+    
+    // lo mismo que setDisplayFrame pero sin crear un CCSpriteFrame por tick;
+    // la textura solo cambia al pasar a otra hoja
+    m_obUnflippedOffsetPositionFromCenter = CCPoint((centerX - canvasCenterX) / sf, (centerY - canvasCenterY) / sf);
+    if (this->getTexture() != texture) {
+        this->setTexture(texture);
+    }
+    this->setTextureRect(sheetRect, false, CCSize(m_canvasWidth / sf, m_canvasHeight / sf));
+}
 
-        float sf = getContentScaleFactorSafe();
-        
-        // offset pa CCSpriteFrame (gif top-left, cocos bottom-left)
-        float left = gifFrame->rect.origin.x;
-        float top = gifFrame->rect.origin.y;
-        float w = gifFrame->rect.size.width;
-        float h = gifFrame->rect.size.height;
-        
-        float centerX = left + w / 2.0f;
-        float centerY = (m_canvasHeight - top) - h / 2.0f;
-        
-        float canvasCenterX = m_canvasWidth / 2.0f;
-        float canvasCenterY = m_canvasHeight / 2.0f;
-        
-        CCPoint offset((centerX - canvasCenterX) / sf, (centerY - canvasCenterY) / sf);
-        
-        // comprobar si la textura es placeholder (mas chica que el frame)
-        auto texPx = gifFrame->texture->getContentSizeInPixels();
-        bool isPlaceholder = (texPx.width < w || texPx.height < h);
-        
-        CCRect rectToUse = CCRect(0, 0, w, h);
-        CCPoint offsetToUse = offset;
-        
-        if (isPlaceholder) {
-            rectToUse = CCRect(0, 0, texPx.width, texPx.height);
-            offsetToUse = CCPoint(0, 0);
+void AnimatedGIFSprite::setShaderProgram(CCGLProgram* program) {
+    CCSprite::setShaderProgram(program);
+
+    bool useCanvas = program &&
+        program != CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor);
+    if (useCanvas == m_useShaderCanvas) return;
+    m_useShaderCanvas = useCanvas;
+    // sin shader se vuelve a pintar directo de la hoja; la textura del canvas
+    // sigue viva mientras el sprite la tenga puesta
+    if (!useCanvas) m_shaderCanvas = nullptr;
+    if (!m_frames.empty()) setCurrentFrame(m_currentFrame);
+}
+
+bool AnimatedGIFSprite::drawToShaderCanvas(GIFFrame const& gifFrame, CCTexture2D* source, CCRect const& sourceRect) {
+    float sf = getContentScaleFactorSafe();
+    CCSize canvasSize(m_canvasWidth / sf, m_canvasHeight / sf);
+    if (!m_shaderCanvas) {
+        m_shaderCanvas = CCRenderTexture::create(canvasSize.width, canvasSize.height, kCCTexture2DPixelFormat_RGBA8888);
+        if (!m_shaderCanvas) return false;
+        // igual que las texturas por frame de antes: lineal y clamp al borde
+        m_shaderCanvas->getSprite()->getTexture()->setAntiAliasTexParameters();
+    }
+
+    auto* blit = CCSprite::createWithTexture(source, sourceRect);
+    if (!blit) return false;
+    // el render texture sale boca abajo: con flipY queda derecho al muestrearlo,
+    // y el top del GIF pasa a medirse desde abajo
+    blit->setFlipY(true);
+    blit->setAnchorPoint({0.0f, 0.0f});
+    blit->setPosition({gifFrame.rect.origin.x / sf, gifFrame.rect.origin.y / sf});
+    // copia tal cual (alpha sin premultiplicar, como las texturas de la hoja)
+    blit->setBlendFunc({GL_ONE, GL_ZERO});
+
+    m_shaderCanvas->beginWithClear(0, 0, 0, 0);
+    blit->visit();
+    m_shaderCanvas->end();
+
+    auto* texture = m_shaderCanvas->getSprite()->getTexture();
+    m_obUnflippedOffsetPositionFromCenter = CCPointZero;
+    if (this->getTexture() != texture) {
+        this->setTexture(texture);
+    }
+    this->setTextureRect(CCRect(CCPointZero, texture->getContentSize()), false, canvasSize);
+    return true;
+}
+
+bool AnimatedGIFSprite::frameTexture(GIFFrame const& frame, CCTexture2D*& texture, CCRect& rect) const {
+    if (frame.sheet >= 0) {
+        if (frame.sheet >= static_cast<int>(m_sheets.size())) return false;
+        texture = m_sheets[frame.sheet];
+        rect = frame.sheetRect;
+        return true;
+    }
+    int slot = windowSlotOf(frame.source);
+    if (!m_window || slot < 0) return false;
+    texture = m_window;
+    rect = windowSlotRect(slot, frame.rect.size);
+    return true;
+}
+
+// ── Modo ventana ────────────────────────────────────────────────────
+
+int AnimatedGIFSprite::windowSlotCount() const {
+    int cellW = m_canvasWidth + 2 * SHEET_PADDING;
+    int cellH = m_canvasHeight + 2 * SHEET_PADDING;
+    int cols = std::clamp(MAX_SHEET_SIZE / std::max(1, cellW), 1, WINDOW_SLOTS);
+    int rows = std::max(1, MAX_SHEET_SIZE / std::max(1, cellH));
+    // minimo 2: una celda con el frame que se ve y otra pa ir subiendo el siguiente
+    return std::clamp(cols * rows, 2, WINDOW_SLOTS);
+}
+
+int AnimatedGIFSprite::windowSlotOf(int source) const {
+    for (size_t i = 0; i < m_slotSource.size(); ++i) {
+        if (m_slotSource[i] == source) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+CCRect AnimatedGIFSprite::windowSlotRect(int slot, CCSize const& frameSize) const {
+    float sf = getContentScaleFactorSafe();
+    int cellW = m_canvasWidth + 2 * SHEET_PADDING;
+    int cellH = m_canvasHeight + 2 * SHEET_PADDING;
+    int x = (slot % m_windowCols) * cellW + SHEET_PADDING;
+    int y = (slot / m_windowCols) * cellH + SHEET_PADDING;
+    return CCRect(x / sf, y / sf, frameSize.width / sf, frameSize.height / sf);
+}
+
+std::vector<int> AnimatedGIFSprite::wantedWindowSources() const {
+    std::vector<int> wanted;
+    size_t slots = static_cast<size_t>(windowSlotCount());
+    size_t count = m_frames.size();
+    // el actual primero: su celda nunca se pisa mientras se ve
+    for (size_t i = 0; i < count && wanted.size() < slots; ++i) {
+        size_t index = m_currentFrame + i;
+        if (index >= count) {
+            if (!m_loop) break;
+            index -= count;
+        }
+        auto const& frame = m_frames[index];
+        if (frame.sheet >= 0) continue; // frame 0 (o repetido del 0): esta en la hoja
+        if (std::find(wanted.begin(), wanted.end(), frame.source) == wanted.end()) {
+            wanted.push_back(frame.source);
         }
+    }
+    return wanted;
+}
 
-        auto spriteFrame = CCSpriteFrame::createWithTexture(
-            gifFrame->texture, 
-            rectToUse, 
-            false, 
-            offsetToUse, 
-            CCSize(m_canvasWidth / sf, m_canvasHeight / sf)
-        );
-        
-        this->setDisplayFrame(spriteFrame);
+bool AnimatedGIFSprite::isFrameReady(unsigned int frame) const {
+    if (frame >= m_frames.size()) return false;
+    auto const& gifFrame = m_frames[frame];
+    if (gifFrame.sheet >= 0) return true;
+    return m_window && windowSlotOf(gifFrame.source) >= 0;
+}
+
+bool AnimatedGIFSprite::openWindow() {
+    int slots = windowSlotCount();
+    int cellW = m_canvasWidth + 2 * SHEET_PADDING;
+    int cellH = m_canvasHeight + 2 * SHEET_PADDING;
+    int cols = std::clamp(MAX_SHEET_SIZE / cellW, 1, slots);
+    int rows = (slots + cols - 1) / cols;
+    int width = cols * cellW;
+    int height = rows * cellH;
+
+    float sf = getContentScaleFactorSafe();
+    auto* window = new CCTexture2D();
+    if (!window->initWithData(nullptr, kCCTexture2DPixelFormat_RGBA8888, width, height,
+                              CCSize(width / sf, height / sf))) {
+        window->release();
+        log::warn("[AnimatedGIFSprite] No se pudo crear ventana {}x{} pa {}", width, height, m_filename);
+        return false;
+    }
+    window->setAntiAliasTexParameters();
+
+    m_window = window;
+    m_windowCols = cols;
+    m_slotSource.assign(slots, -1);
+    s_windowBytes += static_cast<size_t>(width) * height * 4;
+    s_windowCount++;
+    return true;
+}
+
+void AnimatedGIFSprite::releaseWindow() {
+    m_slotSource.clear();
+    if (!m_window) return;
+    size_t bytes = static_cast<size_t>(m_window->getPixelsWide()) * m_window->getPixelsHigh() * 4;
+    s_windowBytes = s_windowBytes >= bytes ? s_windowBytes - bytes : 0;
+    s_windowCount--;
+    m_window->release();
+    m_window = nullptr;
+}
+
+void AnimatedGIFSprite::dropWindow() {
+    // lo que este en camino del worker ya no vale
+    m_windowGeneration++;
+    m_windowPending.clear();
+    // el frame 0 vive en la hoja del cache; asi el sprite suelta su ref de la ventana
+    if (!m_frames.empty() && (m_currentFrame != 0 || (m_window && this->getTexture() == m_window))) {
+        setCurrentFrame(0);
+    }
+    releaseWindow();
+}
+
+void AnimatedGIFSprite::pumpWindow() {
+    if (!m_windowed || !m_onScreen || !m_isPlaying) return;
+
+    std::vector<std::pair<int, PackedFrame>> unpack;
+    for (int source : wantedWindowSources()) {
+        if (windowSlotOf(source) >= 0) continue;
+        if (std::find(m_windowPending.begin(), m_windowPending.end(), source) != m_windowPending.end()) continue;
+        if (source <= 0 || source >= static_cast<int>(m_packed.size())) continue;
+        m_windowPending.push_back(source);
+        unpack.emplace_back(source, m_packed[source]);
+    }
+    if (unpack.empty()) return;
+
+    GIFTask task;
+    task.unpack = std::move(unpack);
+    task.onUnpacked = [safeRef = WeakRef<AnimatedGIFSprite>(this), generation = m_windowGeneration](
+                          std::vector<std::pair<int, std::vector<uint8_t>>> frames) {
+        // una subida por job, igual que la carga: el presupuesto lo pone la cola
+        for (auto& [source, pixels] : frames) {
+            paimon::image::TextureUploadQueue::get().post(WINDOW_UPLOAD_PRIORITY,
+                [safeRef, generation, source = source, pixels = std::move(pixels)]() {
+                    auto ref = safeRef.lock();
+                    auto* self = static_cast<AnimatedGIFSprite*>(ref.data());
+                    if (self) self->uploadWindowFrame(generation, source, pixels);
+                });
+        }
+    };
+
+    initWorker();
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        // delante de todo: es lo que se esta viendo ahora
+        s_taskQueue.push_front(std::move(task));
+    }
+    s_queueCV.notify_one();
+}
+
+void AnimatedGIFSprite::uploadWindowFrame(unsigned generation, int source, std::vector<uint8_t> const& pixels) {
+    if (generation != m_windowGeneration) return;
+    std::erase(m_windowPending, source);
+    if (!m_onScreen || source <= 0 || source >= static_cast<int>(m_packed.size())) return;
+
+    auto const& packed = m_packed[source];
+    int pw = packed.width + 2 * SHEET_PADDING;
+    int ph = packed.height + 2 * SHEET_PADDING;
+    if (pixels.size() != static_cast<size_t>(pw) * ph * 4) return;
+
+    // el playhead pudo pasar de largo mientras se descomprimia
+    auto wanted = wantedWindowSources();
+    auto isWanted = [&](int s) { return std::find(wanted.begin(), wanted.end(), s) != wanted.end(); };
+    if (!isWanted(source)) return;
+    if (!m_window && !openWindow()) return;
+
+    // celda libre, o la de un frame que ya quedo atras
+    int slot = -1;
+    for (size_t i = 0; i < m_slotSource.size(); ++i) {
+        if (m_slotSource[i] < 0) {
+            slot = static_cast<int>(i);
+            break;
+        }
+        if (slot < 0 && !isWanted(m_slotSource[i])) slot = static_cast<int>(i);
+    }
+    if (slot < 0) return;
+
+    int cellW = m_canvasWidth + 2 * SHEET_PADDING;
+    int cellH = m_canvasHeight + 2 * SHEET_PADDING;
+    ccGLBindTexture2D(m_window->getName());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_windowCols) * cellW, (slot / m_windowCols) * cellH,
+                    pw, ph, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    m_slotSource[slot] = source;
+}
+
+bool AnimatedGIFSprite::isOnScreen() {
+    if (!this->isRunning()) return false;
+    for (CCNode* node = this; node; node = node->getParent()) {
+        if (!node->isVisible()) return false;
+    }
+
+    auto size = this->getContentSize();
+    CCRect world = CCRectApplyAffineTransform(CCRect(0, 0, size.width, size.height), this->nodeToWorldTransform());
+    auto winSize = CCDirector::sharedDirector()->getWinSize();
+    if (!world.intersectsRect(CCRect(0, 0, winSize.width, winSize.height))) return false;
+
+    // las listas (TableView, ScrollLayer) recortan a su area: una celda fuera
+    // de la lista puede seguir dentro de la pantalla
+    for (CCNode* node = this->getParent(); node; node = node->getParent()) {
+        auto* scroll = typeinfo_cast<CCScrollLayerExt*>(node);
+        if (!scroll) continue;
+        auto view = scroll->getContentSize();
+        CCRect viewRect = CCRectApplyAffineTransform(CCRect(0, 0, view.width, view.height), scroll->nodeToWorldTransform());
+        if (!world.intersectsRect(viewRect)) return false;
+    }
+    return true;
+}
+
+void AnimatedGIFSprite::updateResidency(float dt) {
+    if (!m_windowed) return;
+    m_visibilityTimer -= dt;
+    if (m_visibilityTimer > 0.0f) return;
+    m_visibilityTimer = VISIBILITY_CHECK_INTERVAL;
+
+    bool onScreen = isOnScreen();
+    if (onScreen == m_onScreen) return;
+    m_onScreen = onScreen;
+    if (onScreen) {
+        pumpWindow();
+    } else {
+        dropWindow();
+    }
+}
+
+void AnimatedGIFSprite::onExit() {
+    CCSprite::onExit();
+    // fuera del arbol no se dibuja: la ventana se suelta ya
+    if (m_windowed) {
+        m_onScreen = false;
+        m_visibilityTimer = 0.0f;
+        dropWindow();
+    }
+}
+
+AnimatedGIFSprite::ResidencyStats AnimatedGIFSprite::residencyStats() {
+    ResidencyStats stats;
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        stats.cacheBytes = s_currentCacheSize;
     }
+    stats.windowBytes = s_windowBytes;
+    stats.windows = s_windowCount;
+    stats.windowedSprites = s_windowedSprites;
+    return stats;
 }
 
 void AnimatedGIFSprite::draw() {
@@ -3,6 +3,9 @@
 #include <Geode/Geode.hpp>
 #include <Geode/utils/function.hpp>
 #include "GIFDecoder.hpp"
+#include "GIFFrameStore.hpp"
+#include "MemoryBudget.hpp"
+#include "../framework/concurrency/IndexedHeap.hpp"
 #include <vector>
 #include <string>
 #include <utility>
@@ -17,6 +20,7 @@
 #include <atomic>
 #include <filesystem>
 #include <chrono>
+#include <memory>
 
 // Animated sprite that plays GIF frames with caching and incremental loading.
 class AnimatedGIFSprite : public cocos2d::CCSprite {
@@ -28,26 +32,47 @@ public:
     static void unpinGIF(std::string const& key);
     static bool isPinned(std::string const& key);
 
+    // Frame of a windowed GIF kept LZ-compressed in RAM (trimmed and padded
+    // like a sheet frame). A repeated frame shares the previous one's pixels.
+    struct PackedFrame {
+        int left = 0;
+        int top = 0;
+        int width = 0;
+        int height = 0;
+        std::shared_ptr<std::vector<uint8_t> const> pixels;
+    };
+
+    // Frames are packed (trimmed) into a few sheet textures; playing only
+    // changes the texture rect. The cache holds one ref per sheet.
+    // Windowed GIFs only have frame 0 in a sheet; every frame is in `packed`.
     struct SharedGIFData {
-        std::vector<cocos2d::CCTexture2D*> textures;
+        std::vector<cocos2d::CCTexture2D*> sheets;
+        std::vector<int> frameSheets;            // sheet index per frame (-1: window)
+        std::vector<cocos2d::CCRect> sheetRects; // frame rect inside its sheet
         std::vector<float> delays;
         std::vector<cocos2d::CCRect> frameRects; // Stores left, top, width, height
+        std::vector<PackedFrame> packed;         // windowed only, one per frame
         int width;
         int height;
     };
 
+    // GIF memory: the shared cache (sheets + compressed frames) and the
+    // per-sprite window textures. Main thread only.
+    struct ResidencyStats {
+        size_t cacheBytes = 0;
+        size_t windowBytes = 0;
+        int windows = 0;
+        int windowedSprites = 0;
+    };
+    static ResidencyStats residencyStats();
+
 protected:
     struct GIFFrame {
-        cocos2d::CCTexture2D* texture = nullptr;
+        int sheet = 0; // index in m_sheets, -1 = lives in the window
+        int source = 0; // windowed: first frame with these pixels
+        cocos2d::CCRect sheetRect; // Where it lives in the sheet
         cocos2d::CCRect rect; // Position and size in canvas
         float delay = 0.1f; // Seconds
-        
-        ~GIFFrame() {
-            if (texture) {
-                texture->release();
-                texture = nullptr;
-            }
-        }
     };
     
     static std::unordered_map<std::string, SharedGIFData> s_gifCache;
@@ -63,8 +88,14 @@ protected:
     
     // eviccion centralizada: quita entradas LRU hasta que el cache esta por debajo del limite
     static void evictIfNeeded();
+    // suelta texturas, tamaño, LRU y la cuenta en MemoryBudget; con s_cacheMutex pillado
+    static bool eraseCacheEntry(std::string const& key);
+    // registro en MemoryBudget (perezoso) y su callback de eviccion (main thread)
+    static paimon::memory::MemoryBudget::SourceId budgetSource();
+    static bool evictForBudget(std::string const& key);
 
-    std::vector<GIFFrame*> m_frames;
+    std::vector<GIFFrame> m_frames;
+    std::vector<cocos2d::CCTexture2D*> m_sheets; // un retain por hoja
     // Dominant colors per frame: {A, B}
     std::vector<std::pair<cocos2d::ccColor3B, cocos2d::ccColor3B>> m_frameColors;
     
@@ -76,8 +107,83 @@ protected:
     int m_canvasWidth = 0;
     int m_canvasHeight = 0;
     
+    // ya recortados y con borde (SheetFramePrep); sin pixeles = repite el anterior
     std::vector<GIFDecoder::Frame> m_pendingFrames;
-    void updateTextureLoading(float dt);
+    bool m_texturesLoading = false; // hojas con ref extra pa s_gifCache aun sin entrada
+
+    // hoja abierta: estanterias de izquierda a derecha, de arriba a abajo
+    struct SheetCursor {
+        int x = 0;
+        int y = 0;
+        int shelfHeight = 0;
+        int width = 0;
+        int height = 0;
+    };
+    SheetCursor m_sheetCursor;
+    int m_expectedFrames = 0; // countFrames(); solo pa dimensionar las hojas
+    bool uploadToSheet(GIFDecoder::Frame const& frame, GIFFrame& out);
+    bool openSheet(int minWidth, int minHeight);
+
+    // con un shader propio el frame se copia a una textura del tamaño del
+    // canvas: los shaders muestrean vecinos o usan v_texCoord en 0..1 y en la
+    // hoja verian los otros frames
+    geode::Ref<cocos2d::CCRenderTexture> m_shaderCanvas;
+    bool m_useShaderCanvas = false;
+    bool drawToShaderCanvas(GIFFrame const& frame, cocos2d::CCTexture2D* texture, cocos2d::CCRect const& rect);
+    // hoja (o celda de la ventana) y rect de un frame; false si aun no esta en GPU
+    bool frameTexture(GIFFrame const& frame, cocos2d::CCTexture2D*& texture, cocos2d::CCRect& rect) const;
+
+    // modo ventana (GIFs largos): en GPU solo esta la hoja del frame 0, que
+    // comparte el cache, y una ventana de pocas celdas con los frames que
+    // vienen detras del playhead. El resto vive comprimido en m_packed y el
+    // worker lo descomprime por delante. Fuera de pantalla el sprite suelta la
+    // ventana y se queda en el frame 0.
+    bool m_windowed = false;
+    std::vector<PackedFrame> m_packed;
+    std::deque<PackedFrame> m_pendingPacked; // en orden con m_pendingFrames
+    cocos2d::CCTexture2D* m_window = nullptr; // un retain; null sin ventana
+    int m_windowCols = 1;
+    std::vector<int> m_slotSource;    // source en cada celda (-1 libre)
+    std::vector<int> m_windowPending; // sources pedidos al worker aun sin subir
+    unsigned m_windowGeneration = 0;  // descarta lo que llegue tras soltar la ventana
+    bool m_onScreen = false;
+    float m_visibilityTimer = 0.0f;
+    static size_t s_windowBytes;
+    static int s_windowCount;
+    static int s_windowedSprites;
+
+    int windowSlotCount() const;
+    int windowSlotOf(int source) const;
+    cocos2d::CCRect windowSlotRect(int slot, cocos2d::CCSize const& frameSize) const;
+    // sources que deberian estar en la ventana, del playhead en adelante
+    std::vector<int> wantedWindowSources() const;
+    bool isFrameReady(unsigned int frame) const;
+    bool openWindow();
+    // vuelve al frame 0 y suelta la ventana
+    void dropWindow();
+    void releaseWindow();
+    void pumpWindow();
+    void uploadWindowFrame(unsigned generation, int source, std::vector<uint8_t> const& pixels);
+    bool isOnScreen();
+    void updateResidency(float dt);
+
+    // frame 0 en el acto, el resto un job por frame en TextureUploadQueue;
+    // false si ningun frame se pudo subir
+    bool beginTextureLoading();
+    void queueTextureLoading();
+    void updateTextureLoading();
+    // siguiente subida, pedir otra tanda al worker o cerrar la carga
+    void continueTextureLoading();
+    void finishTextureLoading();
+
+    // decode incremental: el worker saca los frames por tandas pequeñas con
+    // GIFDecoder::Stream, asi en RAM solo vive el canvas y un par de frames
+    struct StreamState;
+    std::shared_ptr<StreamState> m_stream; // != null mientras quedan frames por decodificar
+    bool m_streamInFlight = false;  // hay una tanda pedida al worker
+    bool m_uploadsStalled = false;  // la subida espera a la siguiente tanda
+    void requestMoreFrames();
+    void appendStreamFrames(std::vector<GIFDecoder::Frame> frames, std::vector<PackedFrame> packed, bool done);
 
     void updateAnimation(float dt);
     
@@ -96,50 +202,72 @@ public:
     static bool isCached(std::string const& filename);
     
     using AsyncCallback = geode::CopyableFunction<void(AnimatedGIFSprite*)>;
-    static void createAsync(std::string const& path, AsyncCallback callback);
-    static void createAsync(std::vector<uint8_t> const& data, std::string const& key, AsyncCallback callback);
+    // Higher priority decodes first (visible cells above offscreen ones).
+    // Concurrent calls for the same key share one decode: the first caller
+    // gets the sprite that streams in, the rest get cache copies once it's done.
+    static void createAsync(std::string const& path, AsyncCallback callback, int priority = 0);
+    static void createAsync(std::vector<uint8_t> const& data, std::string const& key, AsyncCallback callback, int priority = 0);
+    // re-prioritizes a createAsync that is still queued (e.g. on scroll)
+    static void updatePriority(std::string const& key, int priority);
+    // full-screen backgrounds: ahead of any list cell
+    static constexpr int BACKGROUND_PRIORITY = 4000;
     
     static AnimatedGIFSprite* createFromCache(std::string const& key);
 
-    // Disk cache
-    struct DiskCacheEntry {
-        int width;
-        int height;
-        struct Frame {
-            std::vector<uint8_t> pixels; // RGBA8888
-            float delay;
-            int width;
-            int height;
-        };
-        std::vector<Frame> frames;
-    };
-    
-    static bool loadFromDiskCache(std::string const& path, DiskCacheEntry& outEntry);
-    static void saveToDiskCache(std::string const& path, DiskCacheEntry const& entry);
+    // Disk cache (GIFFrameStore format)
     static std::string getCachePath(std::string const& path);
 
 private:
     static constexpr auto MAX_DISK_CACHE_AGE = std::chrono::hours(24 * 21);
 
-    // Worker queue
+    // lector de la cache en disco de `path`; null si no hay o es mas vieja que el GIF
+    static std::unique_ptr<GIFFrameStore::Reader> openDiskCache(std::string const& path);
+
+    // Worker queue: tandas de GIFs en pantalla y frames de ventanas
     struct GIFTask {
-        std::string path;
-        std::vector<uint8_t> data;
-        std::string key;
-        AsyncCallback callback;
-        bool isData = false;
+        // siguiente tanda de un GIF ya en pantalla (callback creado en main thread)
+        std::shared_ptr<StreamState> stream;
+        geode::CopyableFunction<void(std::vector<GIFDecoder::Frame>, std::vector<PackedFrame>, bool)> onFrames;
+        // frames de la ventana a descomprimir (source, frame comprimido)
+        std::vector<std::pair<int, PackedFrame>> unpack;
+        geode::CopyableFunction<void(std::vector<std::pair<int, std::vector<uint8_t>>>)> onUnpacked;
     };
     
+    // GIF por cargar (createAsync); una por key aunque la pidan varios
+    struct InFlightLoad {
+        std::string path;
+        std::shared_ptr<std::vector<uint8_t> const> data; // GIFs en memoria
+        std::vector<AsyncCallback> callbacks; // el primero se lleva el sprite que carga
+        int priority = 0;
+        uint64_t id = 0; // cambia en cada decode: descarta resultados de uno viejo
+    };
+
+    // lo que ya esta en pantalla va antes que cualquier carga nueva
     static std::deque<GIFTask> s_taskQueue;
+    static paimon::concurrency::IndexedHeap<std::string> s_loadQueue;
+    static std::unordered_map<std::string, InFlightLoad> s_inFlight; // bajo s_queueMutex
     static std::mutex s_queueMutex;
     static std::condition_variable s_queueCV;
-    static std::thread s_workerThread;
+    static std::vector<std::thread> s_workerThreads;
     static std::atomic<bool> s_workerRunning;
     static std::atomic<bool> s_shutdownMode;
     static std::mutex s_workerLifecycleMutex;
-    static void workerLoop();
+    static uint64_t s_nextLoadId;
+    static unsigned workerCount();
+    static void workerLoop(unsigned index);
+    static void runLoad(std::string key, uint64_t id, std::string const& path,
+                        std::shared_ptr<std::vector<uint8_t> const> data);
     static void initWorker();
     static void shutdownWorker();
+    static void enqueueLoad(std::string const& key, std::string const& path,
+                            std::vector<uint8_t> const* data, AsyncCallback callback, int priority);
+    // todos los que esperan `key` reciben nullptr
+    static void failLoad(std::string const& key);
+    // el sprite principal ya esta en cache: copias pa los demas
+    static void resolveLoadWaiters(std::string const& key);
+    // el sprite principal murio a medias: otro decode pa los que esperan
+    static void abandonLoad(std::string const& key);
+    bool m_ownsLoad = false; // sprite principal de una entrada de s_inFlight
 
 public:
     void play() { m_isPlaying = true; this->scheduleUpdate(); }
@@ -147,8 +275,8 @@ public:
     void stop() { 
         m_isPlaying = false; 
         m_currentFrame = 0;
-        if (!m_frames.empty() && m_frames[0] && m_frames[0]->texture) {
-            this->setTexture(m_frames[0]->texture);
+        if (!m_frames.empty()) {
+            this->setCurrentFrame(0);
         }
     }
 
@@ -158,6 +286,7 @@ public:
             this->scheduleUpdate();
         }
     }
+    void onExit() override;
     
     void setLoop(bool loop) { m_loop = loop; }
     bool isPlaying() const { return m_isPlaying; }
@@ -169,6 +298,9 @@ public:
     
     void setCurrentFrame(unsigned int frame);
 
+    // any program other than the default one renders through m_shaderCanvas
+    void setShaderProgram(cocos2d::CCGLProgram* program) override;
+
     // Used by the async loader to ensure frame 0 exists before layout.
     bool processNextPendingFrame();
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/**
+ * BinaryIO — lo minimo para los formatos binarios propios de la cache
+ * (journal del manifest, manifest del CDN, pack de thumbs, thumbs decodificados).
+ *
+ * Todo en little-endian byte a byte, asi el archivo es igual en cualquier
+ * plataforma y no hace falta alinear nada.
+ */
+namespace paimon::binio {
+
+template <typename T>
+inline void putLE(uint8_t* dst, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dst[i] = static_cast<uint8_t>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+inline T getLE(uint8_t const* src) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        v |= static_cast<uint64_t>(src[i]) << (8 * i);
+    }
+    return static_cast<T>(v);
+}
+
+namespace detail {
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        table[i] = c;
+    }
+    return table;
+}
+inline constexpr auto CRC_TABLE = makeCrcTable();
+} // namespace detail
+
+// CRC-32 (IEEE, el de zip/png)
+inline uint32_t crc32(uint8_t const* data, size_t size) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        c = detail::CRC_TABLE[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// lee el archivo entero en `out`; false si no se pudo abrir o leer
+inline bool readWholeFile(std::filesystem::path const& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    auto size = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    out.resize(size);
+    if (size > 0) file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
+
+} // namespace paimon::binio
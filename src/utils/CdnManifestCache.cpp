@@ -0,0 +1,431 @@
+#include "CdnManifestCache.hpp"
+#include "BinaryIO.hpp"
+#include "Debug.hpp"
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/string.hpp>
+#include <matjson.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+using namespace geode::prelude;
+
+namespace paimon::net {
+
+namespace {
+using binio::crc32;
+using binio::getLE;
+using binio::putLE;
+using binio::readWholeFile;
+
+constexpr char MAGIC[4] = {'P', 'C', 'M', '1'};
+constexpr size_t HEADER_SIZE = 8;
+constexpr size_t RECORD_HEADER_SIZE = 8; // u32 len + u32 crc
+constexpr size_t OP_FIXED_SIZE = 1 + 4 + 8; // op + levelId + lastUse
+// con menos de esto entre usos no vale la pena escribir el touch
+constexpr int64_t TOUCH_GRANULARITY_S = 60;
+// el log se compacta cuando pasa del doble de lo vivo mas este margen
+constexpr uint64_t COMPACT_SLACK_BYTES = 64 * 1024;
+
+enum class Op : uint8_t {
+    Put   = 1,
+    Touch = 2,
+    Evict = 3,
+};
+
+int64_t nowEpoch() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+size_t clampLen(std::string const& s) {
+    return std::min<size_t>(s.size(), 0xFFFF);
+}
+
+// bytes que ocupa un Put en el log (header incluido)
+uint64_t putRecordBytes(CdnManifestEntry const& e) {
+    return RECORD_HEADER_SIZE + OP_FIXED_SIZE + 4 * 2 +
+        clampLen(e.format) + clampLen(e.cdnUrl) + clampLen(e.version) + clampLen(e.id);
+}
+
+void encodeOp(std::vector<uint8_t>& buf, Op op, int levelId, int64_t lastUse, CdnManifestEntry const* entry) {
+    size_t start = buf.size();
+    buf.resize(start + RECORD_HEADER_SIZE + OP_FIXED_SIZE);
+    uint8_t* p = buf.data() + start + RECORD_HEADER_SIZE;
+    p[0] = static_cast<uint8_t>(op);
+    putLE<int32_t>(p + 1, levelId);
+    putLE<int64_t>(p + 5, lastUse);
+    if (entry) {
+        for (auto const* s : {&entry->format, &entry->cdnUrl, &entry->version, &entry->id}) {
+            uint8_t len[2];
+            putLE<uint16_t>(len, static_cast<uint16_t>(clampLen(*s)));
+            buf.insert(buf.end(), len, len + 2);
+            buf.insert(buf.end(), s->begin(), s->begin() + clampLen(*s));
+        }
+    }
+    size_t payloadLen = buf.size() - start - RECORD_HEADER_SIZE;
+    putLE<uint32_t>(buf.data() + start, static_cast<uint32_t>(payloadLen));
+    putLE<uint32_t>(buf.data() + start + 4, crc32(buf.data() + start + RECORD_HEADER_SIZE, payloadLen));
+}
+
+struct Loaded {
+    CdnManifestEntry entry;
+    int64_t lastUse = 0;
+};
+
+// aplica los registros validos; devuelve hasta donde llego (0 si el header no sirve)
+uint64_t replay(std::vector<uint8_t> const& data, std::unordered_map<int, Loaded>& out, size_t& records) {
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, 4) != 0) return 0;
+
+    uint64_t off = HEADER_SIZE;
+    while (off + RECORD_HEADER_SIZE <= data.size()) {
+        uint8_t const* rec = data.data() + off;
+        uint64_t len = getLE<uint32_t>(rec);
+        if (len < OP_FIXED_SIZE || off + RECORD_HEADER_SIZE + len > data.size()) break;
+        uint8_t const* payload = rec + RECORD_HEADER_SIZE;
+        if (crc32(payload, static_cast<size_t>(len)) != getLE<uint32_t>(rec + 4)) break;
+
+        auto op = static_cast<Op>(payload[0]);
+        int levelId = getLE<int32_t>(payload + 1);
+        int64_t lastUse = getLE<int64_t>(payload + 5);
+        bool valid = true;
+        switch (op) {
+            case Op::Put: {
+                Loaded l;
+                l.lastUse = lastUse;
+                uint64_t pos = OP_FIXED_SIZE;
+                for (auto* s : {&l.entry.format, &l.entry.cdnUrl, &l.entry.version, &l.entry.id}) {
+                    if (pos + 2 > len) { valid = false; break; }
+                    uint64_t slen = getLE<uint16_t>(payload + pos);
+                    pos += 2;
+                    if (pos + slen > len) { valid = false; break; }
+                    s->assign(reinterpret_cast<char const*>(payload + pos), static_cast<size_t>(slen));
+                    pos += slen;
+                }
+                if (valid) out[levelId] = std::move(l);
+                break;
+            }
+            case Op::Touch:
+                if (auto it = out.find(levelId); it != out.end()) it->second.lastUse = lastUse;
+                break;
+            case Op::Evict:
+                out.erase(levelId);
+                break;
+            default:
+                valid = false;
+                break;
+        }
+        if (!valid) break;
+
+        off += RECORD_HEADER_SIZE + len;
+        records++;
+    }
+    return off;
+}
+
+// fecha de modificacion en epoch s (el json no guardaba usos); ahora si falla
+int64_t mtimeEpoch(std::filesystem::path const& path) {
+    std::error_code ec;
+    auto ftime = std::filesystem::last_write_time(path, ec);
+    if (ec) return nowEpoch();
+    auto sys = std::chrono::system_clock::now() + (ftime - std::filesystem::file_time_type::clock::now());
+    return std::chrono::duration_cast<std::chrono::seconds>(sys.time_since_epoch()).count();
+}
+
+bool loadLegacyJson(std::filesystem::path const& path, std::unordered_map<int, Loaded>& out) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) return false;
+    std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    if (json.empty()) return false;
+
+    auto parseResult = matjson::parse(json);
+    if (!parseResult.isOk()) {
+        PaimonDebug::warn("[CdnManifestCache] manifest_cache.json parse error");
+        return false;
+    }
+    auto& root = parseResult.unwrap();
+    if (!root.isObject()) return false;
+
+    std::vector<std::pair<int, Loaded>> inFileOrder;
+    for (auto& [key, val] : root) {
+        if (!val.isObject()) continue;
+        auto parsed = geode::utils::numFromString<int>(key);
+        if (!parsed.isOk() || parsed.unwrap() <= 0) continue;
+
+        Loaded l;
+        l.entry.format  = val["format"].asString().unwrapOr("");
+        l.entry.cdnUrl  = val["cdnUrl"].asString().unwrapOr("");
+        l.entry.version = val["version"].asString().unwrapOr("");
+        l.entry.id      = val["id"].asString().unwrapOr("");
+        if (!l.entry.cdnUrl.empty()) inFileOrder.emplace_back(parsed.unwrap(), std::move(l));
+    }
+
+    // con lastUse=0 todas empataban y el recorte a la capacidad (y el LRU
+    // despues) sacaba al azar: usos crecientes en orden de archivo que
+    // terminan en la fecha del json, asi quedan por detras de todo lo nuevo
+    int64_t use = mtimeEpoch(path) - static_cast<int64_t>(inFileOrder.size());
+    for (auto& [id, l] : inFileOrder) {
+        l.lastUse = ++use;
+        out[id] = std::move(l);
+    }
+    return true;
+}
+} // namespace
+
+// ── Carga ───────────────────────────────────────────────────────────
+
+void CdnManifestCache::load(std::filesystem::path const& path, std::filesystem::path const& legacyJsonPath) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::lock_guard io(m_ioMutex);
+    std::lock_guard lock(m_mutex);
+    m_path = path;
+    m_legacyPath = legacyJsonPath;
+    m_entries.clear();
+    m_order.clear();
+    m_pending.clear();
+    m_pendingTouches.clear();
+    m_fileBytes = 0;
+    m_liveRecordBytes = 0;
+    m_needsCompaction = false;
+
+    std::unordered_map<int, Loaded> loaded;
+    size_t records = 0;
+    char const* source = "none";
+    std::error_code ec;
+    std::vector<uint8_t> data;
+    if (std::filesystem::exists(path, ec) && readWholeFile(path, data)) {
+        uint64_t valid = replay(data, loaded, records);
+        if (valid == 0) {
+            log::warn("[CdnManifestCache] {} unreadable, starting empty", geode::utils::string::pathToString(path));
+            loaded.clear();
+            m_needsCompaction = true;
+        } else {
+            source = "binary";
+            // cola rota (crash a mitad de un append): se corta en el ultimo registro valido
+            if (valid < data.size()) {
+                log::warn("[CdnManifestCache] log truncated at {} of {} bytes", valid, data.size());
+                std::filesystem::resize_file(path, valid, ec);
+            }
+            m_fileBytes = valid;
+        }
+    } else if (std::filesystem::exists(legacyJsonPath, ec) && loadLegacyJson(legacyJsonPath, loaded)) {
+        // el proximo flush escribe el log entero y borra el json
+        source = "json";
+        m_needsCompaction = true;
+    } else {
+        m_needsCompaction = true;
+    }
+
+    // orden LRU desde lastUse; si hay mas que la capacidad se quedan los mas recientes
+    std::vector<std::pair<int, Loaded*>> byUse;
+    byUse.reserve(loaded.size());
+    for (auto& [id, l] : loaded) byUse.emplace_back(id, &l);
+    std::sort(byUse.begin(), byUse.end(), [](auto const& a, auto const& b) {
+        return a.second->lastUse > b.second->lastUse;
+    });
+    if (byUse.size() > m_capacity) {
+        byUse.resize(m_capacity);
+        m_needsCompaction = true;
+    }
+    m_entries.reserve(byUse.size());
+    for (auto& [id, l] : byUse) {
+        m_order.push_back(id);
+        m_liveRecordBytes += putRecordBytes(l->entry);
+        m_entries.emplace(id, Node{std::move(l->entry), l->lastUse, std::prev(m_order.end())});
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    m_stats.loadMs = ms;
+    m_stats.loadedRecords = records;
+    m_stats.loadSource = source;
+    m_lastFlush = Clock::now();
+    log::info("[CdnManifestCache] loaded {} entries from {} ({} records, {} bytes) in {:.2f} ms",
+        m_entries.size(), source, records, data.size(), ms);
+}
+
+// ── Consultas ───────────────────────────────────────────────────────
+
+std::optional<CdnManifestEntry> CdnManifestCache::get(int levelId) {
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(levelId);
+    if (it == m_entries.end()) {
+        m_stats.misses++;
+        return std::nullopt;
+    }
+    m_stats.hits++;
+    touchLocked(it->second, levelId);
+    return it->second.entry;
+}
+
+bool CdnManifestCache::contains(int levelId) const {
+    std::lock_guard lock(m_mutex);
+    return m_entries.contains(levelId);
+}
+
+void CdnManifestCache::put(int levelId, CdnManifestEntry entry) {
+    std::lock_guard lock(m_mutex);
+    int64_t now = nowEpoch();
+    auto it = m_entries.find(levelId);
+    if (it != m_entries.end()) {
+        auto& node = it->second;
+        m_order.splice(m_order.begin(), m_order, node.order);
+        if (node.entry.cdnUrl == entry.cdnUrl && node.entry.version == entry.version &&
+            node.entry.format == entry.format && node.entry.id == entry.id) {
+            // el lookup repitio lo que ya sabiamos: cuenta como uso, nada mas
+            touchLocked(node, levelId);
+            return;
+        }
+        m_liveRecordBytes -= putRecordBytes(node.entry);
+        node.entry = std::move(entry);
+        node.lastUse = now;
+        m_pendingTouches.erase(levelId);
+        m_liveRecordBytes += putRecordBytes(node.entry);
+        encodeOp(m_pending, Op::Put, levelId, now, &node.entry);
+        return;
+    }
+
+    m_order.push_front(levelId);
+    auto& node = m_entries.emplace(levelId, Node{std::move(entry), now, m_order.begin()}).first->second;
+    m_liveRecordBytes += putRecordBytes(node.entry);
+    encodeOp(m_pending, Op::Put, levelId, now, &node.entry);
+    evictLocked();
+}
+
+void CdnManifestCache::touchLocked(Node& node, int levelId) {
+    m_order.splice(m_order.begin(), m_order, node.order);
+    int64_t now = nowEpoch();
+    if (now - node.lastUse < TOUCH_GRANULARITY_S) return;
+    node.lastUse = now;
+    m_pendingTouches[levelId] = now;
+}
+
+void CdnManifestCache::evictLocked() {
+    while (m_entries.size() > m_capacity && !m_order.empty()) {
+        int victim = m_order.back();
+        m_order.pop_back();
+        auto it = m_entries.find(victim);
+        if (it == m_entries.end()) continue;
+        m_liveRecordBytes -= putRecordBytes(it->second.entry);
+        m_entries.erase(it);
+        m_pendingTouches.erase(victim);
+        encodeOp(m_pending, Op::Evict, victim, 0, nullptr);
+        m_stats.evictions++;
+    }
+}
+
+// ── Persistencia ────────────────────────────────────────────────────
+
+std::vector<uint8_t> CdnManifestCache::snapshotLocked() const {
+    std::vector<uint8_t> buf(HEADER_SIZE, 0);
+    std::memcpy(buf.data(), MAGIC, 4);
+    buf.reserve(HEADER_SIZE + m_liveRecordBytes);
+    // del menos al mas reciente: el replay termina con el orden correcto
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it) {
+        auto const& node = m_entries.at(*it);
+        encodeOp(buf, Op::Put, *it, node.lastUse, &node.entry);
+    }
+    return buf;
+}
+
+void CdnManifestCache::flushIfDue() {
+    writeOut(false);
+}
+
+void CdnManifestCache::flush() {
+    writeOut(true);
+}
+
+void CdnManifestCache::writeOut(bool force) {
+    std::lock_guard io(m_ioMutex);
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> ops;
+    std::vector<uint8_t> snapshot;
+    bool compact = false;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_path.empty()) return; // todavia no se cargo
+
+        size_t pendingBytes = m_pending.size() + m_pendingTouches.size() * (RECORD_HEADER_SIZE + OP_FIXED_SIZE);
+        if (pendingBytes == 0 && !m_needsCompaction) return;
+        if (!force && pendingBytes < FLUSH_BATCH_BYTES && Clock::now() - m_lastFlush < FLUSH_INTERVAL) return;
+
+        for (auto const& [id, lastUse] : m_pendingTouches) {
+            if (m_entries.contains(id)) encodeOp(m_pending, Op::Touch, id, lastUse, nullptr);
+        }
+        m_pendingTouches.clear();
+
+        compact = m_needsCompaction || m_fileBytes == 0 ||
+            m_fileBytes + m_pending.size() > 2 * (HEADER_SIZE + m_liveRecordBytes) + COMPACT_SLACK_BYTES;
+        if (compact) snapshot = snapshotLocked();
+        ops.swap(m_pending);
+        m_lastFlush = Clock::now();
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_path.parent_path(), ec);
+
+    bool ok = false;
+    uint64_t written = 0;
+    if (compact) {
+        auto tmpPath = m_path;
+        tmpPath += ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (file) file.write(reinterpret_cast<char const*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+            ok = static_cast<bool>(file);
+        }
+        if (ok) {
+            std::filesystem::rename(tmpPath, m_path, ec);
+            ok = !ec;
+        }
+        if (ok) {
+            written = snapshot.size();
+            std::filesystem::remove(m_legacyPath, ec);
+        } else {
+            std::filesystem::remove(tmpPath, ec);
+            log::warn("[CdnManifestCache] could not compact {}", geode::utils::string::pathToString(m_path));
+        }
+    }
+    // sin compactar (o si fallo, con un log ya existente): append de las ops
+    bool appended = false;
+    if (!ok && !ops.empty() && (!compact || m_fileBytes > 0)) {
+        std::ofstream file(m_path, std::ios::binary | std::ios::app);
+        if (file) file.write(reinterpret_cast<char const*>(ops.data()), static_cast<std::streamsize>(ops.size()));
+        ok = appended = static_cast<bool>(file);
+        if (!ok) log::error("[CdnManifestCache] could not append to {}", geode::utils::string::pathToString(m_path));
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (compact && written > 0) {
+        m_fileBytes = written;
+        m_needsCompaction = false;
+        m_stats.compactions++;
+    } else if (appended) {
+        m_fileBytes += ops.size();
+    } else if (!ok) {
+        // las ops vuelven delante de las que llegaron mientras tanto
+        ops.insert(ops.end(), m_pending.begin(), m_pending.end());
+        m_pending.swap(ops);
+        if (compact) m_needsCompaction = true;
+        return;
+    }
+    m_stats.flushes++;
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    PaimonDebug::log("[CdnManifestCache] flushed {} entries ({}, {} bytes) in {:.2f} ms",
+        m_entries.size(), written > 0 ? "compact" : "append", written > 0 ? written : ops.size(), ms);
+}
+
+CdnManifestCache::Stats CdnManifestCache::stats() const {
+    std::lock_guard lock(m_mutex);
+    Stats st = m_stats;
+    st.entries = m_entries.size();
+    st.capacity = m_capacity;
+    st.fileBytes = m_fileBytes;
+    st.pendingBytes = m_pending.size();
+    return st;
+}
+
+} // namespace paimon::net
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * CdnManifestCache — cache acotado de las URLs directas de CDN (/api/manifest).
+ *
+ * Reemplaza el unordered_map de HttpClient que al pasarse del limite borraba
+ * entradas al azar y el manifest_cache.json que se reescribia entero en cada
+ * fetch. Ahora:
+ *
+ * - LRU: get() mueve la entrada al frente y al llenarse sale la menos usada.
+ *   La ultima vez que se uso cada level se guarda en disco, asi el orden (y
+ *   las URLs de los levels que mas se ven) sobrevive entre sesiones.
+ * - Disco: manifest_cache.bin, un log append-only con registros enmarcados
+ *   (u32 len | u32 crc32 | payload). put/touch/evict solo encolan bytes; se
+ *   escriben en tandas (flushIfDue: por tamaño o por tiempo) y al salir.
+ *   Cuando el log pesa bastante mas que lo vivo se compacta (tmp + rename).
+ * - Un registro truncado o con crc invalido corta el replay ahi: se pierden
+ *   solo las ops posteriores, nunca el cache entero.
+ *
+ * Formato (little-endian):
+ *   header 8 bytes: "PCM1" | u32 reservado
+ *   payload: u8 op | i32 levelId | i64 lastUse (epoch s) | [Put: 4 x (u16 len | bytes)]
+ *
+ * Thread-safe. La I/O corre fuera del lock de las entradas, asi un flush en
+ * un worker no frena los get() del hilo principal.
+ */
+namespace paimon::net {
+
+struct CdnManifestEntry {
+    std::string format;   // "webp", "png", "gif", etc.
+    std::string cdnUrl;   // direct Bunny CDN URL
+    std::string version;  // revision/version token
+    std::string id;       // thumbnail id
+};
+
+class CdnManifestCache {
+public:
+    struct Stats {
+        size_t entries = 0;
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t flushes = 0;
+        uint64_t compactions = 0;
+        uint64_t fileBytes = 0;
+        size_t pendingBytes = 0;
+        // arranque: cuanto costo cargar y de donde
+        double loadMs = 0;
+        size_t loadedRecords = 0;
+        char const* loadSource = "none"; // "binary", "json" o "none"
+    };
+
+    static constexpr size_t FLUSH_BATCH_BYTES = 8 * 1024;
+    static constexpr auto FLUSH_INTERVAL = std::chrono::seconds(30);
+
+    explicit CdnManifestCache(size_t capacity) : m_capacity(capacity) {}
+
+    // lee el log (o migra el json viejo si el log no existe todavia)
+    void load(std::filesystem::path const& path, std::filesystem::path const& legacyJsonPath);
+
+    // con touch: cuenta como uso para el LRU
+    std::optional<CdnManifestEntry> get(int levelId);
+    // sin touch (planificacion de lookups, no es un uso real)
+    bool contains(int levelId) const;
+    void put(int levelId, CdnManifestEntry entry);
+
+    // escribe las ops encoladas si ya hay una tanda o paso FLUSH_INTERVAL
+    void flushIfDue();
+    // escribe lo que haya (salida del juego)
+    void flush();
+
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        CdnManifestEntry entry;
+        int64_t lastUse = 0;
+        std::list<int>::iterator order;
+    };
+
+    size_t m_capacity;
+
+    mutable std::mutex m_mutex;   // entradas, orden y buffer pendiente
+    std::unordered_map<int, Node> m_entries;
+    std::list<int> m_order;       // frente = usado hace menos
+    std::vector<uint8_t> m_pending;
+    // touches coalescidos por level: un solo registro por flush
+    std::unordered_map<int, int64_t> m_pendingTouches;
+    Clock::time_point m_lastFlush = Clock::now();
+    bool m_needsCompaction = false;
+
+    std::mutex m_ioMutex;         // orden de escritura al archivo (se toma antes que m_mutex)
+    std::filesystem::path m_path;
+    std::filesystem::path m_legacyPath;
+    uint64_t m_fileBytes = 0;
+    uint64_t m_liveRecordBytes = 0; // lo que ocuparia el log recien compactado
+
+    Stats m_stats;
+
+    void evictLocked();
+    void touchLocked(Node& node, int levelId);
+    std::vector<uint8_t> snapshotLocked() const;
+    void writeOut(bool force);
+};
+
+} // namespace paimon::net
@@ -1,10 +1,9 @@
 #include "DominantColors.hpp"
 #include "../utils/Constants.hpp"
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <cmath>
-#include <map>
-#include <unordered_map>
 #include <random>
 #include <limits>
 
@@ -17,43 +16,28 @@ namespace {
         double b;  // azul‑amarillo [-128, 127]
     };
     
-    // RGB [0,255] -> XYZ (D65)
-    static void rgbToXYZ(uint8_t r, uint8_t g, uint8_t b, double& X, double& Y, double& Z) {
-        // normalizo RGB a [0, 1]
-        double R = r / 255.0;
-        double G = g / 255.0;
-        double B = b / 255.0;
-        
-        // aplico gamma sRGB
-        auto gammaCorrect = [](double v) -> double {
-            return (v <= 0.04045) ? (v / 12.92) : std::pow((v + 0.055) / 1.055, 2.4);
-        };
-        
-        R = gammaCorrect(R);
-        G = gammaCorrect(G);
-        B = gammaCorrect(B);
-        
-        // matriz RGB->XYZ (D65)
-        X = R * 0.4124564 + G * 0.3575761 + B * 0.1804375;
-        Y = R * 0.2126729 + G * 0.7151522 + B * 0.0721750;
-        Z = R * 0.0193339 + G * 0.1191920 + B * 0.9503041;
-        
-        // escalo al punto blanco D65
-        X *= 100.0;
-        Y *= 100.0;
-        Z *= 100.0;
+    // sRGB [0,255] -> lineal [0,1]; la gamma con pow era lo que mas costaba por pixel
+    static std::array<double, 256> const& srgbToLinearTable() {
+        static auto const table = [] {
+            std::array<double, 256> t{};
+            for (int i = 0; i < 256; i++) {
+                double v = i / 255.0;
+                t[i] = (v <= 0.04045) ? (v / 12.92) : std::pow((v + 0.055) / 1.055, 2.4);
+            }
+            return t;
+        }();
+        return table;
     }
     
-    // XYZ -> LAB (CIE L*a*b*)
-    static LABColor xyzToLAB(double X, double Y, double Z) {
-        // punto blanco D65
-        const double Xn = 95.047;
-        const double Yn = 100.000;
-        const double Zn = 108.883;
+    // RGB [0,255] -> LAB (D65), con la gamma de la tabla
+    static LABColor rgbToLAB(uint8_t r, uint8_t g, uint8_t b) {
+        auto const& lin = srgbToLinearTable();
+        double R = lin[r], G = lin[g], B = lin[b];
         
-        double x = X / Xn;
-        double y = Y / Yn;
-        double z = Z / Zn;
+        // matriz RGB->XYZ (D65), ya dividida por el punto blanco
+        double x = (R * 0.4124564 + G * 0.3575761 + B * 0.1804375) / 0.95047;
+        double y =  R * 0.2126729 + G * 0.7151522 + B * 0.0721750;
+        double z = (R * 0.0193339 + G * 0.1191920 + B * 0.9503041) / 1.08883;
         
         auto f = [](double t) -> double {
             const double delta = 6.0 / 29.0;
@@ -72,13 +56,6 @@ namespace {
         return lab;
     }
     
-    // RGB -> LAB directo
-    static LABColor rgbToLAB(uint8_t r, uint8_t g, uint8_t b) {
-        double X, Y, Z;
-        rgbToXYZ(r, g, b, X, Y, Z);
-        return xyzToLAB(X, Y, Z);
-    }
-    
     // LAB -> XYZ
     static void labToXYZ(LABColor const& lab, double& X, double& Y, double& Z) {
         const double Xn = 95.047;
@@ -137,14 +114,6 @@ namespace {
     
     // ==================== CIEDE2000 DELTA E ====================
     
-    // distancia LAB rapida (sirve pa hacer clustering)
-    static double deltaESimple(LABColor const& lab1, LABColor const& lab2) {
-        double dL = lab1.L - lab2.L;
-        double da = lab1.a - lab2.a;
-        double db = lab1.b - lab2.b;
-        return std::sqrt(dL * dL + da * da + db * db);
-    }
-    
     // Delta E (CIEDE2000) para comparaciones finas
     static double deltaE2000(LABColor const& lab1, LABColor const& lab2) {
         // implementacion CIEDE2000 simplificada
@@ -222,127 +191,178 @@ namespace {
         return dE;
     }
     
+    // ==================== HISTOGRAMA ====================
+    
+    // 5 bits por canal: 32768 cubos. Cada cubo guarda la media RGB real de lo
+    // que cayo dentro, asi el error de cuantizar no llega al color final
+    constexpr int HIST_BITS = 5;
+    constexpr int HIST_BINS = 1 << (HIST_BITS * 3);
+    
+    // rejilla de ~2000 muestras como antes, pero ya sin cortar al llegar a
+    // 2000 (con el peso del borde se quedaba en la parte de arriba)
+    constexpr int MAX_SAMPLES = 2000;
+    
+    struct Histogram {
+        std::vector<uint32_t> count = std::vector<uint32_t>(HIST_BINS, 0);
+        std::vector<uint32_t> sumR = std::vector<uint32_t>(HIST_BINS, 0);
+        std::vector<uint32_t> sumG = std::vector<uint32_t>(HIST_BINS, 0);
+        std::vector<uint32_t> sumB = std::vector<uint32_t>(HIST_BINS, 0);
+        std::vector<uint16_t> used;  // cubos tocados, pa no recorrer los 32768
+        
+        void add(uint8_t r, uint8_t g, uint8_t b, uint32_t weight) {
+            uint32_t bin = (uint32_t(r >> 3) << 10) | (uint32_t(g >> 3) << 5) | uint32_t(b >> 3);
+            if (count[bin] == 0) used.push_back(static_cast<uint16_t>(bin));
+            count[bin] += weight;
+            sumR[bin] += r * weight;
+            sumG[bin] += g * weight;
+            sumB[bin] += b * weight;
+        }
+    };
+    
+    // cubos ocupados en LAB, en columnas pa que el bucle de k-means vectorice
+    struct WeightedBins {
+        std::vector<float> L, a, b, w;
+        double total = 0.0;
+        
+        size_t size() const { return w.size(); }
+        LABColor lab(size_t i) const { return LABColor{L[i], a[i], b[i]}; }
+    };
+    
+    // vuelca el histograma a cubos LAB y lo deja a cero pa la siguiente imagen
+    static WeightedBins takeBins(Histogram& hist) {
+        WeightedBins bins;
+        size_t n = hist.used.size();
+        bins.L.reserve(n); bins.a.reserve(n); bins.b.reserve(n); bins.w.reserve(n);
+        for (uint16_t bin : hist.used) {
+            uint32_t c = hist.count[bin];
+            LABColor lab = rgbToLAB(
+                static_cast<uint8_t>((hist.sumR[bin] + c / 2) / c),
+                static_cast<uint8_t>((hist.sumG[bin] + c / 2) / c),
+                static_cast<uint8_t>((hist.sumB[bin] + c / 2) / c));
+            bins.L.push_back(static_cast<float>(lab.L));
+            bins.a.push_back(static_cast<float>(lab.a));
+            bins.b.push_back(static_cast<float>(lab.b));
+            bins.w.push_back(static_cast<float>(c));
+            bins.total += c;
+            hist.count[bin] = hist.sumR[bin] = hist.sumG[bin] = hist.sumB[bin] = 0;
+        }
+        hist.used.clear();
+        return bins;
+    }
+    
+    // uno por hilo: LevelColors extrae en paralelo y son 512 KB por histograma
+    static Histogram& threadHistogram() {
+        thread_local Histogram hist;
+        return hist;
+    }
+    
     // ==================== K-MEANS CLUSTERING ====================
     
     struct Cluster {
         LABColor centroid;
-        std::vector<size_t> members;  // indices de pixel
-        uint32_t pixelCount = 0;
+        double weight = 0.0;  // pixeles (con su peso) que caen en el cluster
     };
     
-    // inicializo K centroides con un K-Means++ simplificado
-    static std::vector<LABColor> initializeCentroids(
-        std::vector<LABColor> const& pixels, int K, std::mt19937& rng
-    ) {
+    // distancia al cuadrado de cada cubo a `c`; se queda con la menor en `best`
+    static void nearestTo(WeightedBins const& bins, LABColor const& c, int k,
+                          std::vector<float>& best, std::vector<int>& label) {
+        float cL = static_cast<float>(c.L), ca = static_cast<float>(c.a), cb = static_cast<float>(c.b);
+        float const* L = bins.L.data();
+        float const* A = bins.a.data();
+        float const* B = bins.b.data();
+        float* bd = best.data();
+        int* lb = label.data();
+        size_t n = bins.size();
+        for (size_t i = 0; i < n; i++) {
+            float dL = L[i] - cL, da = A[i] - ca, db = B[i] - cb;
+            float d = dL * dL + da * da + db * db;
+            bool closer = d < bd[i];
+            bd[i] = closer ? d : bd[i];
+            lb[i] = closer ? k : lb[i];
+        }
+    }
+    
+    // cubo elegido con probabilidad proporcional a `weights`
+    static size_t pickWeighted(std::vector<double> const& weights, double total, std::mt19937& rng) {
+        std::uniform_real_distribution<double> prob(0.0, total);
+        double target = prob(rng);
+        double cumulative = 0.0;
+        for (size_t i = 0; i < weights.size(); i++) {
+            cumulative += weights[i];
+            if (cumulative >= target && weights[i] > 0.0) return i;
+        }
+        return weights.size() - 1;
+    }
+    
+    // K-Means++ con los cubos pesados por nº de pixeles
+    static std::vector<LABColor> initializeCentroids(WeightedBins const& bins, int K, std::mt19937& rng) {
         std::vector<LABColor> centroids;
-        if (pixels.empty()) return centroids;
+        if (bins.size() == 0) return centroids;
         
-        // primer centroide: random
-        std::uniform_int_distribution<size_t> dist(0, pixels.size() - 1);
-        centroids.push_back(pixels[dist(rng)]);
+        // primer centroide: un pixel al azar (= cubo segun su peso)
+        std::vector<double> weights(bins.w.begin(), bins.w.end());
+        centroids.push_back(bins.lab(pickWeighted(weights, bins.total, rng)));
         
-        // siguientes: K-Means++ usando distancia simple
+        std::vector<float> best(bins.size(), std::numeric_limits<float>::max());
+        std::vector<int> label(bins.size(), 0);
         for (int k = 1; k < K; k++) {
-            std::vector<double> distances(pixels.size());
-            double totalDist = 0.0;
-            
-            for (size_t i = 0; i < pixels.size(); i++) {
-                double minDist = std::numeric_limits<double>::max();
-                for (auto const& c : centroids) {
-                    double d = deltaESimple(pixels[i], c);  // distancia rapida
-                    minDist = std::min(minDist, d);
-                }
-                distances[i] = minDist * minDist;
-                totalDist += distances[i];
-            }
+            nearestTo(bins, centroids.back(), k - 1, best, label);
             
-            if (totalDist == 0.0) break;  // evito division por cero
-            
-            // elijo el siguiente centroide con prob proporcional a la distancia
-            std::uniform_real_distribution<double> prob(0.0, totalDist);
-            double target = prob(rng);
-            double cumulative = 0.0;
-            
-            for (size_t i = 0; i < pixels.size(); i++) {
-                cumulative += distances[i];
-                if (cumulative >= target) {
-                    centroids.push_back(pixels[i]);
-                    break;
-                }
+            double totalDist = 0.0;
+            for (size_t i = 0; i < bins.size(); i++) {
+                weights[i] = static_cast<double>(bins.w[i]) * best[i];
+                totalDist += weights[i];
             }
+            if (totalDist == 0.0) break;  // todo el mismo color
             
-            // si no se eligio ninguno, meto uno random y sigo
-            if (centroids.size() <= static_cast<size_t>(k)) {
-                centroids.push_back(pixels[dist(rng)]);
-            }
+            centroids.push_back(bins.lab(pickWeighted(weights, totalDist, rng)));
         }
         
         return centroids;
     }
     
-    // K-means en LAB (un poco optimizado)
-    static std::vector<Cluster> kMeansClustering(
-        std::vector<LABColor> const& pixels, int K, int maxIterations = 10
-    ) {
-        if (pixels.empty() || K <= 0) return {};
+    // K-means en LAB sobre los cubos del histograma
+    static std::vector<Cluster> kMeansClustering(WeightedBins const& bins, int K, int maxIterations = 10) {
+        if (bins.size() == 0 || K <= 0) return {};
         
         std::mt19937 rng(42);  // seed fija para que el resultado sea reproducible
-        K = std::min(K, static_cast<int>(pixels.size()));
+        K = std::min(K, static_cast<int>(bins.size()));
         
-        // inicializo centroides
-        std::vector<LABColor> centroids = initializeCentroids(pixels, K, rng);
-        if (centroids.size() < static_cast<size_t>(K)) {
-            K = static_cast<int>(centroids.size());
-        }
+        std::vector<LABColor> centroids = initializeCentroids(bins, K, rng);
+        K = static_cast<int>(centroids.size());
         
         std::vector<Cluster> clusters(K);
+        std::vector<float> best(bins.size());
+        std::vector<int> label(bins.size());
         
-        // iteracion de k-means (distancia simple para ir rapido)
         for (int iter = 0; iter < maxIterations; iter++) {
-            // limpio clusters
-            for (auto& cluster : clusters) {
-                cluster.members.clear();
-                cluster.pixelCount = 0;
+            // asigno cada cubo al centroide mas cercano
+            std::fill(best.begin(), best.end(), std::numeric_limits<float>::max());
+            for (int k = 0; k < K; k++) {
+                nearestTo(bins, centroids[k], k, best, label);
             }
             
-            // asigno cada pixel al centroide mas cercano
-            for (size_t i = 0; i < pixels.size(); i++) {
-                double minDist = std::numeric_limits<double>::max();
-                int bestCluster = 0;
-                
-                for (int k = 0; k < K; k++) {
-                    double dist = deltaESimple(pixels[i], centroids[k]);  // distancia rapida
-                    if (dist < minDist) {
-                        minDist = dist;
-                        bestCluster = k;
-                    }
-                }
-                
-                clusters[bestCluster].members.push_back(i);
-                clusters[bestCluster].pixelCount++;
+            // recalculo centroides (media pesada)
+            std::vector<double> sumL(K, 0.0), sumA(K, 0.0), sumB(K, 0.0), sumW(K, 0.0);
+            for (size_t i = 0; i < bins.size(); i++) {
+                int k = label[i];
+                double w = bins.w[i];
+                sumL[k] += w * bins.L[i];
+                sumA[k] += w * bins.a[i];
+                sumB[k] += w * bins.b[i];
+                sumW[k] += w;
             }
             
-            // recalculo centroides
             bool converged = true;
             for (int k = 0; k < K; k++) {
-                if (clusters[k].members.empty()) continue;
+                clusters[k].weight = sumW[k];
+                if (sumW[k] == 0.0) continue;
                 
-                double sumL = 0.0, sumA = 0.0, sumB = 0.0;
-                for (size_t idx : clusters[k].members) {
-                    sumL += pixels[idx].L;
-                    sumA += pixels[idx].a;
-                    sumB += pixels[idx].b;
-                }
-                
-                LABColor newCentroid;
-                newCentroid.L = sumL / clusters[k].members.size();
-                newCentroid.a = sumA / clusters[k].members.size();
-                newCentroid.b = sumB / clusters[k].members.size();
-                
-                // comprobacion cutre de convergencia
-                if (deltaESimple(centroids[k], newCentroid) > 1.0) {
-                    converged = false;
-                }
+                LABColor newCentroid{sumL[k] / sumW[k], sumA[k] / sumW[k], sumB[k] / sumW[k]};
+                double dL = newCentroid.L - centroids[k].L;
+                double da = newCentroid.a - centroids[k].a;
+                double db = newCentroid.b - centroids[k].b;
+                if (dL * dL + da * da + db * db > 1.0) converged = false;
                 
                 centroids[k] = newCentroid;
                 clusters[k].centroid = newCentroid;
@@ -354,7 +374,7 @@ namespace {
         // ordeno clusters por tamano (desc)
         std::sort(clusters.begin(), clusters.end(),
             [](Cluster const& a, Cluster const& b) {
-                return a.pixelCount > b.pixelCount;
+                return a.weight > b.weight;
             });
         
         return clusters;
@@ -374,129 +394,93 @@ namespace {
             b > PaimonConstants::UI_WHITE_THRESHOLD) return true;
         return false;
     }
-
-    // convertir RGB [0..255] a HSV (h en [0..360), s,v en [0..1])
-    static void rgb2hsv(uint8_t r, uint8_t g, uint8_t b, float& h, float& s, float& v) {
-        float rf = r / 255.f, gf = g / 255.f, bf = b / 255.f;
-        float cmax = std::max(rf, std::max(gf, bf));
-        float cmin = std::min(rf, std::min(gf, bf));
-        float d = cmax - cmin;
-        // Hue
-        if (d == 0) h = 0;
-        else if (cmax == rf) h = 60.f * std::fmod(((gf - bf) / d), 6.f);
-        else if (cmax == gf) h = 60.f * (((bf - rf) / d) + 2.f);
-        else h = 60.f * (((rf - gf) / d) + 4.f);
-        if (h < 0) h += 360.f;
-        // Saturation
-        s = (cmax == 0.f) ? 0.f : (d / cmax);
-        // Value
-        v = cmax;
+    
+    // saturacion HSV < 0.08 o valor < 0.12, en enteros (sin pasar por HSV)
+    static bool isDullOrDark(uint8_t r, uint8_t g, uint8_t b) {
+        int cmax = std::max(r, std::max(g, b));
+        int cmin = std::min(r, std::min(g, b));
+        if (cmax * 100 < 12 * 255) return true;
+        return (cmax - cmin) * 100 < 8 * cmax;
+    }
+    
+    // media LAB pesada de todos los cubos
+    static LABColor averageLab(WeightedBins const& bins) {
+        double sumL = 0, sumA = 0, sumB = 0;
+        for (size_t i = 0; i < bins.size(); i++) {
+            sumL += bins.w[i] * bins.L[i];
+            sumA += bins.w[i] * bins.a[i];
+            sumB += bins.w[i] * bins.b[i];
+        }
+        return LABColor{sumL / bins.total, sumA / bins.total, sumB / bins.total};
     }
 }
 
 std::pair<DCColor, DCColor> DominantColors::extract(const uint8_t* rgb, int width, int height) {
     if (!rgb || width <= 0 || height <= 0) return { DCColor{0,0,0}, DCColor{0,0,0} };
 
-    // K-means in LAB (CIEDE2000).
-    
-    // recoger muestras y convertir a LAB
-    std::vector<LABColor> labPixels;
-    std::vector<DCColor> rgbPixels;  // Mantener RGB original para referencia
+    // K-means in LAB (CIEDE2000) over a 5-bit color histogram.
     
     const int borderTop = height * 15 / 100;
     const int borderBottom = height * 85 / 100;
     const int borderLeft = width * 15 / 100;
     const int borderRight = width * 85 / 100;
     
-    // limitar muestras (k-means es costoso)
+    // limitar muestras (el k-means va sobre cubos, pero el histograma no deja de costar)
     const int totalPixels = width * height;
-    const int maxSamples = 2000;
     int step = 1;
     
-    if (totalPixels > maxSamples) {
-        step = static_cast<int>(std::sqrt(static_cast<double>(totalPixels) / maxSamples)) + 1;
+    if (totalPixels > MAX_SAMPLES) {
+        step = static_cast<int>(std::sqrt(static_cast<double>(totalPixels) / MAX_SAMPLES)) + 1;
     }
     
+    auto& hist = threadHistogram();
+    
     for (int y = 0; y < height; y += step) {
         bool inBorderY = (y < borderTop || y > borderBottom);
-        const uint8_t* row = rgb + (y * width * 3);
+        const uint8_t* row = rgb + (static_cast<size_t>(y) * width * 3);
         
         for (int x = 0; x < width; x += step) {
             bool inBorderX = (x < borderLeft || x > borderRight);
             const uint8_t* p = row + x * 3;
             uint8_t r = p[0], g = p[1], b = p[2];
             
-            // filtrar UI/extremos probables
-            if (isLikelyUIOrObject(r, g, b)) continue;
-            
-            float h, s, v;
-            rgb2hsv(r, g, b, h, s, v);
-            
-            // filtrar baja saturacion y muy oscuro
-            if (s < 0.08f || v < 0.12f) continue;
+            // filtrar UI/extremos probables, baja saturacion y muy oscuro
+            if (isLikelyUIOrObject(r, g, b) || isDullOrDark(r, g, b)) continue;
             
             // sesgo leve a muestras del borde
-            int weight = (inBorderY || inBorderX) ? 2 : 1;
-            
-            // Add weighted samples.
-            LABColor lab = rgbToLAB(r, g, b);
-            for (int w = 0; w < weight; w++) {
-                labPixels.push_back(lab);
-                rgbPixels.push_back(DCColor{r, g, b});
-                
-                // limitar numero de muestras
-                if (labPixels.size() >= maxSamples) break;
-            }
-            if (labPixels.size() >= maxSamples) break;
+            hist.add(r, g, b, (inBorderY || inBorderX) ? 2 : 1);
         }
-        if (labPixels.size() >= maxSamples) break;
     }
     
+    WeightedBins bins = takeBins(hist);
+    
     // fallback si no hay suficientes muestras
-    if (labPixels.size() < 100) {
-        // promedio con filtrado minimo
-        double sumL = 0, sumA = 0, sumB = 0;
-        int count = 0;
-        
-        for (int y = 0; y < height; y++) {
-            const uint8_t* row = rgb + (y * width * 3);
-            for (int x = 0; x < width; x++) {
+    if (bins.total < 100) {
+        // promedio con filtrado minimo (misma rejilla, sin recorrer cada pixel)
+        for (int y = 0; y < height; y += step) {
+            const uint8_t* row = rgb + (static_cast<size_t>(y) * width * 3);
+            for (int x = 0; x < width; x += step) {
                 const uint8_t* p = row + x * 3;
-                if (!isLikelyUIOrObject(p[0], p[1], p[2])) {
-                    LABColor lab = rgbToLAB(p[0], p[1], p[2]);
-                    sumL += lab.L; sumA += lab.a; sumB += lab.b;
-                    count++;
-                }
+                if (!isLikelyUIOrObject(p[0], p[1], p[2])) hist.add(p[0], p[1], p[2], 1);
             }
         }
         
-        if (count == 0) return {DCColor{40,40,40}, DCColor{60,60,60}};
+        WeightedBins all = takeBins(hist);
+        if (all.total == 0.0) return {DCColor{40,40,40}, DCColor{60,60,60}};
         
-        LABColor avgLab;
-        avgLab.L = sumL / count;
-        avgLab.a = sumA / count;
-        avgLab.b = sumB / count;
-        DCColor avg = labToRGB(avgLab);
+        DCColor avg = labToRGB(averageLab(all));
         return {avg, avg};
     }
     
     // K-means in LAB.
-    const int K = std::min(5, static_cast<int>(labPixels.size() / 50));  // Minimum 50 pixels per cluster
+    const int K = std::min(5, static_cast<int>(bins.total / 50));  // Minimum 50 pixels per cluster
     if (K < 2) {
         // muy pocas muestras
-        double sumL = 0, sumA = 0, sumB = 0;
-        for (auto const& lab : labPixels) {
-            sumL += lab.L; sumA += lab.a; sumB += lab.b;
-        }
-        LABColor avgLab;
-        avgLab.L = sumL / labPixels.size();
-        avgLab.a = sumA / labPixels.size();
-        avgLab.b = sumB / labPixels.size();
-        DCColor avg = labToRGB(avgLab);
+        DCColor avg = labToRGB(averageLab(bins));
         return {avg, avg};
     }
     
-    std::vector<Cluster> clusters = kMeansClustering(labPixels, K, 10);
+    std::vector<Cluster> clusters = kMeansClustering(bins, K, 10);
     
     if (clusters.empty()) {
         return {DCColor{40,40,40}, DCColor{60,60,60}};
@@ -510,17 +494,15 @@ std::pair<DCColor, DCColor> DominantColors::extract(const uint8_t* rgb, int widt
     
     DCColor color2 = color1;  // por defecto igual que color1
     int bestClusterIndex = -1;
-    uint32_t bestClusterSize = 0;
     
     // elegir el primer cluster (mas grande) fuera del rango de color1
     for (size_t i = 1; i < clusters.size(); i++) {
-        if (clusters[i].pixelCount == 0) continue;
+        if (clusters[i].weight == 0.0) continue;
         
         double deltaE = deltaE2000(clusters[0].centroid, clusters[i].centroid);
         
         if (deltaE >= DELTA_E_MIN_THRESHOLD) {
             bestClusterIndex = static_cast<int>(i);
-            bestClusterSize = clusters[i].pixelCount;
             color2 = labToRGB(clusters[i].centroid);
             break;  // primer cluster grande fuera del rango
         }
@@ -531,7 +513,7 @@ std::pair<DCColor, DCColor> DominantColors::extract(const uint8_t* rgb, int widt
         // elegir el cluster mas distinto
         double maxDeltaE = 0.0;
         for (size_t i = 1; i < clusters.size(); i++) {
-            if (clusters[i].pixelCount == 0) continue;
+            if (clusters[i].weight == 0.0) continue;
             
             double deltaE = deltaE2000(clusters[0].centroid, clusters[i].centroid);
             if (deltaE > maxDeltaE) {
@@ -19,57 +19,149 @@ bool GIFDecoder::getDimensions(uint8_t const* data, size_t size, int& width, int
     return parseHeader(ptr, end, width, height);
 }
 
+int GIFDecoder::countFrames(uint8_t const* data, size_t size) {
+    int width = 0, height = 0;
+    if (!getDimensions(data, size, width, height)) return 0;
+
+    uint8_t const* ptr = data + 10; // firma + dimensiones
+    uint8_t const* end = data + size;
+    auto skipTable = [&](uint8_t flags) {
+        if (!(flags & 0x80)) return;
+        size_t bytes = static_cast<size_t>(3) << ((flags & 0x07) + 1);
+        ptr = bytes < static_cast<size_t>(end - ptr) ? ptr + bytes : end;
+    };
+    // salta sub-bloques hasta el terminador; false si se acaba el archivo antes
+    auto skipSubBlocks = [&]() {
+        while (ptr < end) {
+            uint8_t len = *ptr++;
+            if (len == 0) return true;
+            if (len >= end - ptr) break;
+            ptr += len;
+        }
+        ptr = end;
+        return false;
+    };
+
+    uint8_t flags = *ptr;
+    ptr += 3; // flags, fondo, aspect ratio
+    skipTable(flags);
+
+    int frames = 0;
+    while (ptr < end && frames < MAX_FRAMES) {
+        uint8_t block = *ptr++;
+        if (block == 0x21) {
+            if (ptr >= end) break;
+            ptr++; // etiqueta
+            if (!skipSubBlocks()) break;
+        } else if (block == 0x2C) {
+            if (end - ptr < 10) break; // descriptor + tamaño minimo LZW
+            uint8_t imageFlags = ptr[8];
+            ptr += 9;
+            skipTable(imageFlags);
+            if (ptr >= end) break;
+            ptr++; // tamaño minimo LZW
+            // truncado: Stream lo descarta, asi que tampoco cuenta
+            if (!skipSubBlocks()) break;
+            frames++;
+        } else {
+            break; // 0x3B o basura
+        }
+    }
+    return frames;
+}
+
+bool GIFDecoder::decodeFirstFrame(uint8_t const* data, size_t size, Frame& out) {
+    // el Stream para en el primer descriptor de imagen; los bloques de
+    // datos que vienen detras ni se leen
+    Stream stream(data, size);
+    if (!stream.valid()) return false;
+    return stream.nextFrame(out) && !out.pixels.empty();
+}
+
 GIFDecoder::GIFData GIFDecoder::decode(uint8_t const* data, size_t size) {
     GIFData result;
     result.isAnimated = false;
+    result.width = 0;
+    result.height = 0;
+
+    Stream stream(data, size);
+    if (!stream.valid()) return result;
+    result.width = stream.width();
+    result.height = stream.height();
+
+    Frame frame;
+    while (stream.nextFrame(frame)) {
+        result.frames.push_back(std::move(frame));
+    }
+
+    result.isAnimated = result.frames.size() > 1;
+    log::info("[GIFDecoder] Decodificados {} frames ({}x{})", result.frames.size(), result.width, result.height);
     
-    if (!isGIF(data, size)) {
+    return result;
+}
+
+// ── Stream ──────────────────────────────────────────────────────────
+
+GIFDecoder::Stream::Stream(std::vector<uint8_t> data) : m_owned(std::move(data)) {
+    m_data = m_owned.data();
+    m_size = m_owned.size();
+    init();
+}
+
+GIFDecoder::Stream::Stream(uint8_t const* data, size_t size) : m_data(data), m_size(size) {
+    init();
+}
+
+void GIFDecoder::Stream::init() {
+    m_done = true;
+    if (!m_data || !isGIF(m_data, m_size)) {
         log::error("[GIFDecoder] Not a valid GIF");
-        return result;
+        return;
     }
 
-    uint8_t const* ptr = data;
-    uint8_t const* end = data + size;
+    uint8_t const* ptr = m_data;
+    uint8_t const* end = m_data + m_size;
 
-    if (!parseHeader(ptr, end, result.width, result.height)) {
+    if (!parseHeader(ptr, end, m_width, m_height)) {
         log::error("[GIFDecoder] Failed to parse header");
-        return result;
+        return;
     }
 
     // leo flags
-    if (ptr >= end) return result;
+    if (ptr >= end) return;
     uint8_t flags = *ptr++;
     bool hasGlobalColorTable = (flags & 0x80) != 0;
-    int colorResolution = ((flags & 0x70) >> 4) + 1;
     int globalColorTableSize = 1 << ((flags & 0x07) + 1);
 
     // salto color de fondo y aspect ratio
     ptr += 2;
 
     // leo la tabla global de colores si toca
-    std::vector<uint8_t> globalPalette;
     if (hasGlobalColorTable) {
-        if (!parseColorTable(ptr, end, globalPalette, globalColorTableSize)) {
+        if (!parseColorTable(ptr, end, m_globalPalette, globalColorTableSize)) {
             log::error("[GIFDecoder] Failed to parse global color table");
-            return result;
+            return;
         }
     }
 
-    // parseo frames
-    int frameCount = 0;
-    int currentDelay = 100; // delay por defecto
-    int transparentIndex = -1;
-    bool hasTransparency = false;
-    int disposalMethod = 0; // 0: nada, 1: dejar, 2: limpiar, 3: restaurar previo
-    
-    // canvas donde voy componiendo el GIF entero
-    std::vector<uint8_t> canvas(result.width * result.height * 4, 0);
-    std::vector<uint8_t> backupCanvas = canvas;
-    
-    int prevDisposal = 0;
-    RawFrame prevRawFrame = {std::vector<uint8_t>(), 0, 0, 0, 0};
+    // canvas donde voy componiendo el GIF
+    m_canvas.assign(static_cast<size_t>(m_width) * m_height * 4, 0);
+    m_pos = static_cast<size_t>(ptr - m_data);
+    m_valid = true;
+    m_done = false;
+}
+
+bool GIFDecoder::Stream::nextFrame(Frame& out) {
+    if (m_done) return false;
+    if (m_frameCount >= MAX_FRAMES) {
+        m_done = true;
+        return false;
+    }
 
-    while (ptr < end && frameCount < 500) {
+    uint8_t const* ptr = m_data + m_pos;
+    uint8_t const* end = m_data + m_size;
+
+    while (ptr < end) {
         if (*ptr == 0x21) { // bloque de extension
             ptr++;
             if (ptr >= end) break;
@@ -85,10 +177,10 @@ GIFDecoder::GIFData GIFDecoder::decode(uint8_t const* data, size_t size) {
                     uint8_t transIdx = ptr[2];
                     ptr += 3;
                     
-                    currentDelay = (delay == 0) ? 100 : delay * 10; // GIF usa centesimas de segundo
-                    hasTransparency = (packed & 1) != 0;
-                    transparentIndex = transIdx;
-                    disposalMethod = (packed >> 2) & 0x07;
+                    m_delay = (delay == 0) ? 100 : delay * 10; // GIF usa centesimas de segundo
+                    m_hasTransparency = (packed & 1) != 0;
+                    m_transparentIndex = transIdx;
+                    m_disposal = (packed >> 2) & 0x07;
                 } else {
                     ptr += blockSize;
                 }
@@ -103,73 +195,68 @@ GIFDecoder::GIFData GIFDecoder::decode(uint8_t const* data, size_t size) {
                 }
             }
         } else if (*ptr == 0x2C) { // descriptor de imagen
-            RawFrame rawFrame;
-            if (parseFrame(ptr, end, rawFrame, globalPalette, transparentIndex, hasTransparency)) {
-                
-                // 1. manejo el "disposal" del frame anterior
-                if (prevDisposal == 2) {
-                    // restauro a fondo (transparente)
-                    for (int y = 0; y < prevRawFrame.height; y++) {
-                        for (int x = 0; x < prevRawFrame.width; x++) {
-                            int cy = prevRawFrame.top + y;
-                            int cx = prevRawFrame.left + x;
-                            if (cx >= 0 && cx < result.width && cy >= 0 && cy < result.height) {
-                                int idx = (cy * result.width + cx) * 4;
-                                canvas[idx] = 0;
-                                canvas[idx+1] = 0;
-                                canvas[idx+2] = 0;
-                                canvas[idx+3] = 0;
-                            }
+            // clear() conserva la capacidad; el resize de parseFrame rellena a 0
+            m_raw.pixels.clear();
+            if (!parseFrame(ptr, end, m_raw, m_globalPalette, m_transparentIndex, m_hasTransparency)) {
+                break;
+            }
+
+            // 1. manejo el "disposal" del frame anterior
+            if (m_prevDisposal == 2) {
+                // restauro a fondo (transparente)
+                for (int y = 0; y < m_prevHeight; y++) {
+                    int cy = m_prevTop + y;
+                    if (cy < 0 || cy >= m_height) continue;
+                    for (int x = 0; x < m_prevWidth; x++) {
+                        int cx = m_prevLeft + x;
+                        if (cx >= 0 && cx < m_width) {
+                            std::memset(&m_canvas[(static_cast<size_t>(cy) * m_width + cx) * 4], 0, 4);
                         }
                     }
-                } else if (prevDisposal == 3) {
-                    // restauro al canvas anterior
-                    canvas = backupCanvas;
-                }
-                
-                // 2. si este frame pide disposal 3, guardo copia del canvas
-                if (disposalMethod == 3) {
-                    backupCanvas = canvas;
                 }
-                
-                // 3. dibujo el frame actual encima del canvas
-                for (int y = 0; y < rawFrame.height; y++) {
-                    for (int x = 0; x < rawFrame.width; x++) {
-                        int cy = rawFrame.top + y;
-                        int cx = rawFrame.left + x;
-                        if (cx >= 0 && cx < result.width && cy >= 0 && cy < result.height) {
-                            int rawIdx = (y * rawFrame.width + x) * 4;
-                            int canvasIdx = (cy * result.width + cx) * 4;
-                            
-                            if (rawFrame.pixels[rawIdx + 3] > 0) {
-                                canvas[canvasIdx] = rawFrame.pixels[rawIdx];
-                                canvas[canvasIdx+1] = rawFrame.pixels[rawIdx+1];
-                                canvas[canvasIdx+2] = rawFrame.pixels[rawIdx+2];
-                                canvas[canvasIdx+3] = rawFrame.pixels[rawIdx+3];
-                            }
+            } else if (m_prevDisposal == 3 && !m_backup.empty()) {
+                // restauro al canvas anterior
+                m_canvas = m_backup;
+            }
+            
+            // 2. si este frame pide disposal 3, guardo copia del canvas
+            if (m_disposal == 3) {
+                m_backup = m_canvas;
+            }
+            
+            // 3. dibujo el frame actual encima del canvas
+            for (int y = 0; y < m_raw.height; y++) {
+                int cy = m_raw.top + y;
+                if (cy < 0 || cy >= m_height) continue;
+                for (int x = 0; x < m_raw.width; x++) {
+                    int cx = m_raw.left + x;
+                    if (cx >= 0 && cx < m_width) {
+                        size_t rawIdx = (static_cast<size_t>(y) * m_raw.width + x) * 4;
+                        size_t canvasIdx = (static_cast<size_t>(cy) * m_width + cx) * 4;
+                        if (m_raw.pixels[rawIdx + 3] > 0) {
+                            std::memcpy(&m_canvas[canvasIdx], &m_raw.pixels[rawIdx], 4);
                         }
                     }
                 }
-                
-                // 4. guardo un frame que cubre todo el canvas
-                Frame frame;
-                frame.left = 0;
-                frame.top = 0;
-                frame.width = result.width;
-                frame.height = result.height;
-                frame.delayMs = currentDelay;
-                frame.pixels = canvas;
-                
-                result.frames.push_back(frame);
-                frameCount++;
-                
-                // 5. actualizo estado para el siguiente frame
-                prevDisposal = disposalMethod;
-                prevRawFrame = rawFrame;
-                
-            } else {
-                break;
             }
+            
+            // 4. devuelvo un frame que cubre todo el canvas
+            out.left = 0;
+            out.top = 0;
+            out.width = m_width;
+            out.height = m_height;
+            out.delayMs = m_delay;
+            out.pixels.assign(m_canvas.begin(), m_canvas.end());
+            
+            // 5. actualizo estado para el siguiente frame
+            m_prevDisposal = m_disposal;
+            m_prevLeft = m_raw.left;
+            m_prevTop = m_raw.top;
+            m_prevWidth = m_raw.width;
+            m_prevHeight = m_raw.height;
+            m_frameCount++;
+            m_pos = static_cast<size_t>(ptr - m_data);
+            return true;
         } else if (*ptr == 0x3B) { // trailer (fin del GIF)
             break;
         } else {
@@ -177,10 +264,17 @@ GIFDecoder::GIFData GIFDecoder::decode(uint8_t const* data, size_t size) {
         }
     }
 
-    result.isAnimated = result.frames.size() > 1;
-    log::info("[GIFDecoder] Decodificados {} frames ({}x{})", result.frames.size(), result.width, result.height);
-    
-    return result;
+    m_pos = m_size;
+    m_done = true;
+    // el canvas ya no hace falta
+    m_canvas = {};
+    m_backup = {};
+    m_raw.pixels = {};
+    return false;
+}
+
+size_t GIFDecoder::Stream::residentBytes() const {
+    return m_size + m_canvas.capacity() + m_backup.capacity() + m_raw.pixels.capacity() + m_globalPalette.capacity();
 }
 
 bool GIFDecoder::parseHeader(uint8_t const*& ptr, uint8_t const* end, int& width, int& height) {
@@ -204,122 +298,209 @@ bool GIFDecoder::parseColorTable(uint8_t const*& ptr, uint8_t const* end, std::v
     return true;
 }
 
-// descompresion LZW del stream de indices
-static bool lzwDecode(std::vector<uint8_t> const& compressed, std::vector<uint8_t>& output, int minCodeSize, int pixelCount) {
-    int clearCode = 1 << minCodeSize;
-    int eoiCode = clearCode + 1;
-    int nextCode = eoiCode + 1;
-    int currentCodeSize = minCodeSize + 1;
-    int codeMask = (1 << currentCodeSize) - 1;
-
-    // entrada del diccionario LZW
-    struct DictEntry {
-        int prefix = -1;
-        uint8_t suffix = 0;
-        int length = 0;
-    };
-    // pre‑reservo el diccionario (max 4096 codigos)
-    std::vector<DictEntry> dictionary(4096);
-    
-    // inicializo el diccionario base
+namespace {
+
+// lee los codigos LZW directamente de los sub-bloques (tamaño + datos),
+// sin juntarlos antes en un buffer aparte
+class SubBlockBits {
+public:
+    SubBlockBits(uint8_t const* ptr, uint8_t const* end) : m_ptr(ptr), m_end(end) {}
+
+    // false cuando no quedan datos (terminador, fin del archivo o bloque cortado)
+    bool read(int width, int& code) {
+        while (m_count < width) {
+            int byte = nextByte();
+            if (byte < 0) return false;
+            m_bits |= static_cast<uint32_t>(byte) << m_count;
+            m_count += 8;
+        }
+        code = static_cast<int>(m_bits & ((1u << width) - 1));
+        m_bits >>= width;
+        m_count -= width;
+        return true;
+    }
+
+    // salta lo que quede hasta el terminador; devuelve el puntero justo detras
+    uint8_t const* finish() {
+        if (!m_terminated && !m_truncated) {
+            m_ptr += m_left;
+            m_left = 0;
+            while (m_ptr < m_end) {
+                uint8_t size = *m_ptr++;
+                if (size == 0) break;
+                if (m_ptr + size > m_end) {
+                    m_truncated = true;
+                    m_ptr = m_end;
+                    break;
+                }
+                m_ptr += size;
+            }
+        }
+        return m_ptr;
+    }
+
+    bool truncated() const { return m_truncated; }
+
+private:
+    int nextByte() {
+        if (m_left == 0) {
+            if (m_terminated || m_truncated || m_ptr >= m_end) return -1;
+            uint8_t size = *m_ptr++;
+            if (size == 0) {
+                m_terminated = true;
+                return -1;
+            }
+            if (m_ptr + size > m_end) {
+                m_truncated = true;
+                m_ptr = m_end;
+                return -1;
+            }
+            m_left = size;
+        }
+        m_left--;
+        return *m_ptr++;
+    }
+
+    uint8_t const* m_ptr;
+    uint8_t const* m_end;
+    size_t m_left = 0;
+    uint32_t m_bits = 0;
+    int m_count = 0;
+    bool m_terminated = false;
+    bool m_truncated = false;
+};
+
+// entrada de la tabla LZW: con el primer byte y la longitud cada cadena se
+// escribe de atras hacia delante directamente en su sitio, sin buffer ni reverse
+struct LzwEntry {
+    uint16_t prefix;
+    uint8_t suffix;
+    uint8_t first;
+    uint16_t length;
+};
+
+constexpr int LZW_MAX_CODES = 4096;
+constexpr uint16_t LZW_NO_PREFIX = 0xFFFF;
+
+// copia la cadena `code` en out[pos..]; corta lo que no quepa en pixelCount
+inline int lzwEmit(LzwEntry const* table, int code, uint8_t* out, int pos, int pixelCount) {
+    int len = table[code].length;
+    int fit = std::min(len, pixelCount - pos);
+    // si no cabe entera, la cola (el final de la cadena) sobra
+    for (int skip = len - fit; skip > 0; --skip) code = table[code].prefix;
+    for (int i = fit - 1; i >= 0; --i) {
+        out[pos + i] = table[code].suffix;
+        code = table[code].prefix;
+    }
+    return fit;
+}
+
+// descompresion LZW del stream de indices. Devuelve cuantos indices salieron
+// (menos de pixelCount si llega el EOI antes) o -1 si hay un codigo invalido.
+// Si se acaban los datos sin EOI, el resto queda con el indice 0.
+int lzwDecode(SubBlockBits& in, uint8_t* out, int minCodeSize, int pixelCount) {
+    int const clearCode = 1 << minCodeSize;
+    int const eoiCode = clearCode + 1;
+    int codeSize = minCodeSize + 1;
+
+    LzwEntry table[LZW_MAX_CODES];
     for (int i = 0; i < clearCode; ++i) {
-        dictionary[i] = { -1, (uint8_t)i, 1 };
+        table[i] = { LZW_NO_PREFIX, static_cast<uint8_t>(i), static_cast<uint8_t>(i), 1 };
     }
-    
+
     int dictSize = eoiCode + 1;
     int oldCode = -1;
-    
-    // estado de lectura de bits
-    int bitPos = 0;
-    int bytePos = 0;
-    
-    output.reserve(pixelCount);
-    
-    // buffer reutilizable para secuencias LZW (evita alloc por codigo)
-    std::vector<uint8_t> sequence;
-    sequence.reserve(4096);
-    
-    while (output.size() < pixelCount) {
-        // leo un codigo
-        int code = 0;
-        for (int i = 0; i < currentCodeSize; ++i) {
-            if (bytePos >= compressed.size()) break;
-            if ((compressed[bytePos] >> bitPos) & 1) {
-                code |= (1 << i);
-            }
-            bitPos++;
-            if (bitPos == 8) {
-                bitPos = 0;
-                bytePos++;
-            }
+    int pos = 0;
+
+    while (pos < pixelCount) {
+        int code;
+        if (!in.read(codeSize, code)) {
+            std::memset(out + pos, 0, static_cast<size_t>(pixelCount - pos));
+            return pixelCount;
         }
-        
+
         if (code == clearCode) {
-            currentCodeSize = minCodeSize + 1;
-            codeMask = (1 << currentCodeSize) - 1;
+            codeSize = minCodeSize + 1;
             dictSize = eoiCode + 1;
-            nextCode = eoiCode + 1;
             oldCode = -1;
             continue;
         }
-        
         if (code == eoiCode) break;
-        
+
         if (oldCode == -1) {
             if (code < dictSize) {
-                output.push_back(dictionary[code].suffix);
+                out[pos++] = table[code].suffix;
                 oldCode = code;
             }
             continue;
         }
-        
-        int inCode = code;
-        sequence.clear();
-        
-        if (code >= dictSize) {
-            if (code == dictSize) {
-                // caso especial: code = nextCode
-                int temp = oldCode;
-                while (temp != -1) {
-                    sequence.push_back(dictionary[temp].suffix);
-                    temp = dictionary[temp].prefix;
-                }
-                std::reverse(sequence.begin(), sequence.end());
-                sequence.push_back(sequence[0]);
-            } else {
-                // codigo invalido, corto aqui
-                return false;
-            }
+
+        uint8_t first;
+        if (code < dictSize) {
+            first = table[code].first;
+            pos += lzwEmit(table, code, out, pos, pixelCount);
+        } else if (code == dictSize) {
+            // caso especial KwKwK: cadena anterior + su primer byte
+            first = table[oldCode].first;
+            pos += lzwEmit(table, oldCode, out, pos, pixelCount);
+            if (pos < pixelCount) out[pos++] = first;
         } else {
-            int temp = code;
-            while (temp != -1) {
-                sequence.push_back(dictionary[temp].suffix);
-                temp = dictionary[temp].prefix;
-            }
-            std::reverse(sequence.begin(), sequence.end());
+            // codigo invalido, corto aqui
+            return -1;
         }
-        
-        output.insert(output.end(), sequence.begin(), sequence.end());
-        
+
         // anado entrada nueva al diccionario
-        if (dictSize < 4096) {
-            int temp = oldCode;
-            
-            uint8_t firstChar = sequence[0];
-            dictionary[dictSize] = { oldCode, firstChar, dictionary[oldCode].length + 1 };
+        if (dictSize < LZW_MAX_CODES) {
+            table[dictSize] = {
+                static_cast<uint16_t>(oldCode), first, table[oldCode].first,
+                static_cast<uint16_t>(table[oldCode].length + 1)
+            };
             dictSize++;
-            
-            if (dictSize >= (1 << currentCodeSize) && currentCodeSize < 12) {
-                currentCodeSize++;
+            if (dictSize >= (1 << codeSize) && codeSize < 12) {
+                codeSize++;
             }
         }
-        
-        oldCode = inCode;
+
+        oldCode = code;
     }
-    
-    return true;
+
+    return pos;
 }
 
+// reordena las filas de un frame entrelazado (pasadas 0/4/2/1) sobre el mismo
+// buffer: sigue los ciclos de la permutacion con una sola fila de apoyo
+void deinterlaceInPlace(uint8_t* rows, int width, int height) {
+    static constexpr int passStart[] = {0, 4, 2, 1};
+    static constexpr int passStep[] = {8, 8, 4, 2};
+
+    // fila decodificada n -> fila real dest[n]
+    std::vector<int> dest;
+    dest.reserve(height);
+    for (int pass = 0; pass < 4; ++pass) {
+        for (int y = passStart[pass]; y < height; y += passStep[pass]) dest.push_back(y);
+    }
+
+    size_t const stride = static_cast<size_t>(width);
+    std::vector<uint8_t> carry(stride);
+    std::vector<uint8_t> hold(stride);
+    std::vector<bool> placed(height, false);
+    for (int start = 0; start < height; ++start) {
+        if (placed[start] || dest[start] == start) continue;
+        std::memcpy(carry.data(), rows + start * stride, stride);
+        int n = start;
+        do {
+            int to = dest[n];
+            std::memcpy(hold.data(), rows + to * stride, stride);
+            std::memcpy(rows + to * stride, carry.data(), stride);
+            carry.swap(hold);
+            placed[n] = true;
+            n = to;
+        } while (n != start);
+    }
+}
+
+} // namespace
+
 bool GIFDecoder::parseFrame(uint8_t const*& ptr, uint8_t const* end, RawFrame& frame, std::vector<uint8_t> const& globalPalette, int transparentIndex, bool hasTransparency) {
     if (ptr + 10 > end) return false;
     
@@ -337,96 +518,72 @@ bool GIFDecoder::parseFrame(uint8_t const*& ptr, uint8_t const* end, RawFrame& f
     int localColorTableSize = hasLocalColorTable ? (1 << ((flags & 0x07) + 1)) : 0;
     bool interlaced = (flags & 0x40) != 0;
     
-    // leo tabla local de colores si existe
-    std::vector<uint8_t> localPalette;
+    // la tabla local se usa en el sitio, sin copiarla
+    uint8_t const* palette = globalPalette.data();
+    size_t paletteSize = globalPalette.size();
     if (hasLocalColorTable) {
-        if (!parseColorTable(ptr, end, localPalette, localColorTableSize)) {
-            return false;
-        }
+        if (ptr + localColorTableSize * 3 > end) return false;
+        palette = ptr;
+        paletteSize = static_cast<size_t>(localColorTableSize) * 3;
+        ptr += paletteSize;
     }
     
-    std::vector<uint8_t> const& palette = hasLocalColorTable ? localPalette : globalPalette;
-    
     // leo el tamano minimo del codigo LZW
     if (ptr >= end) return false;
     uint8_t lzwMinCodeSize = *ptr++;
+    if (lzwMinCodeSize > 11) return false;
     
-    // junto los datos comprimidos en un vector
-    std::vector<uint8_t> compressedData;
-    while (ptr < end) {
-        uint8_t blockSize = *ptr++;
-        if (blockSize == 0) break;
-        if (ptr + blockSize > end) return false;
-        compressedData.insert(compressedData.end(), ptr, ptr + blockSize);
-        ptr += blockSize;
-    }
-    
-    // descomprimo el stream LZW
-    std::vector<uint8_t> indices;
-    if (!lzwDecode(compressedData, indices, lzwMinCodeSize, frame.width * frame.height)) {
+    // los indices van en el ultimo cuarto del buffer RGBA: al expandir, el
+    // pixel i (bytes 4i..4i+3) nunca pisa un indice que aun no se ha leido
+    int const pixelCount = frame.width * frame.height;
+    size_t const n = static_cast<size_t>(pixelCount);
+    frame.pixels.resize(n * 4);
+    uint8_t* rgba = frame.pixels.data();
+    uint8_t* indices = rgba + n * 3;
+
+    SubBlockBits bits(ptr, end);
+    int decoded = lzwDecode(bits, indices, lzwMinCodeSize, pixelCount);
+    ptr = bits.finish();
+    if (decoded < 0 || bits.truncated()) {
         log::error("[GIFDecoder] Error descomprimiendo LZW");
         return false;
     }
     
-    // construyo el frame en RGBA
-    frame.pixels.resize(frame.width * frame.height * 4);
-    
-    // si esta entrelazado, reordeno indices
-    std::vector<uint8_t> deinterlacedIndices(frame.width * frame.height);
-    if (interlaced) {
-        int passOffsets[] = {0, 4, 2, 1};
-        int passInc[] = {8, 8, 4, 2};
-        
-        int currentPass = 0;
-        int currentY = 0;
-        int currentX = 0;
-        
-        for (uint8_t idx : indices) {
-            if (currentY >= frame.height) break;
-            
-            deinterlacedIndices[currentY * frame.width + currentX] = idx;
-            
-            currentX++;
-            if (currentX == frame.width) {
-                currentX = 0;
-                currentY += passInc[currentPass];
-                if (currentY >= frame.height) {
-                    currentPass++;
-                    if (currentPass < 4) {
-                        currentY = passOffsets[currentPass];
-                    }
-                }
-            }
-        }
-    } else {
-        deinterlacedIndices = indices;
+    // si esta entrelazado, reordeno las filas en el sitio (lo que no llego queda en 0)
+    if (interlaced && frame.width > 0) {
+        std::memset(indices + decoded, 0, n - static_cast<size_t>(decoded));
+        deinterlaceInPlace(indices, frame.width, frame.height);
+        decoded = pixelCount;
     }
     
-    // paso de indices a RGBA
-    for (int i = 0; i < frame.width * frame.height; i++) {
-        if (i >= deinterlacedIndices.size()) break;
-        
-        uint8_t colorIndex = deinterlacedIndices[i];
-        
-        if (hasTransparency && colorIndex == transparentIndex) {
-            frame.pixels[i * 4 + 0] = 0;
-            frame.pixels[i * 4 + 1] = 0;
-            frame.pixels[i * 4 + 2] = 0;
-            frame.pixels[i * 4 + 3] = 0;
-        } else {
-            if (colorIndex * 3 + 2 < palette.size()) {
-                frame.pixels[i * 4 + 0] = palette[colorIndex * 3 + 0];
-                frame.pixels[i * 4 + 1] = palette[colorIndex * 3 + 1];
-                frame.pixels[i * 4 + 2] = palette[colorIndex * 3 + 2];
-                frame.pixels[i * 4 + 3] = 255;
-            } else {
-                // indice fuera de rango, dejo negro opaco
-                frame.pixels[i * 4 + 0] = 0;
-                frame.pixels[i * 4 + 1] = 0;
-                frame.pixels[i * 4 + 2] = 0;
-                frame.pixels[i * 4 + 3] = 255;
-            }
+    // paso de indices a RGBA con una tabla de 256 colores ya empaquetados
+    uint32_t lut[256];
+    for (int i = 0; i < 256; ++i) {
+        uint8_t c[4] = {0, 0, 0, 255}; // indice fuera de rango: negro opaco
+        if (hasTransparency && i == transparentIndex) {
+            c[3] = 0;
+        } else if (static_cast<size_t>(i) * 3 + 2 < paletteSize) {
+            c[0] = palette[i * 3 + 0];
+            c[1] = palette[i * 3 + 1];
+            c[2] = palette[i * 3 + 2];
         }
+        std::memcpy(&lut[i], c, 4);
+    }
+
+    size_t const count = static_cast<size_t>(decoded);
+    size_t i = 0;
+    // de 4 en 4: leo los 4 indices antes de escribir sus 16 bytes
+    for (; i + 4 <= count; i += 4) {
+        uint32_t px[4] = { lut[indices[i]], lut[indices[i + 1]], lut[indices[i + 2]], lut[indices[i + 3]] };
+        std::memcpy(rgba + i * 4, px, sizeof(px));
+    }
+    for (; i < count; ++i) {
+        uint32_t px = lut[indices[i]];
+        std::memcpy(rgba + i * 4, &px, 4);
+    }
+    // EOI antes de tiempo: el resto transparente
+    if (count < n) {
+        std::memset(rgba + count * 4, 0, (n - count) * 4);
     }
     
     return true;
@@ -25,8 +25,84 @@ public:
         bool isAnimated;
     };
 
+    // decode() y Stream cortan aqui
+    static constexpr int MAX_FRAMES = 500;
+
+private:
+    struct RawFrame {
+        std::vector<uint8_t> pixels;
+        int width, height, left, top;
+    };
+
+public:
+    /**
+     * Incremental decoder: each nextFrame() composites one more frame onto the
+     * canvas. Only the compressed stream, the canvas, the disposal backup and
+     * one frame of scratch stay in memory, so callers can show frame 0 before
+     * the rest is decoded and keep just a few frames alive at a time.
+     * Not thread-safe; one thread at a time.
+     */
+    class Stream {
+    public:
+        // takes ownership of the GIF bytes
+        explicit Stream(std::vector<uint8_t> data);
+        // borrows the bytes; the caller keeps them alive while the stream is used
+        Stream(uint8_t const* data, size_t size);
+
+        Stream(Stream const&) = delete;
+        Stream& operator=(Stream const&) = delete;
+
+        bool valid() const { return m_valid; }
+        bool done() const { return m_done; }
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        int framesDecoded() const { return m_frameCount; }
+
+        /**
+         * Decodes the next frame as a full-canvas RGBA frame into `out`
+         * (reuses out.pixels' storage).
+         * @return false at the end of the GIF or on a decoding error
+         */
+        bool nextFrame(Frame& out);
+
+        // bytes held by the decoder right now (stream + canvas + backup + scratch)
+        size_t residentBytes() const;
+
+    private:
+        void init();
+
+        std::vector<uint8_t> m_owned;
+        uint8_t const* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_pos = 0;
+
+        std::vector<uint8_t> m_globalPalette;
+        std::vector<uint8_t> m_canvas;
+        std::vector<uint8_t> m_backup; // solo si algun frame usa disposal 3
+        RawFrame m_raw;
+
+        int m_width = 0;
+        int m_height = 0;
+        bool m_valid = false;
+        bool m_done = false;
+        int m_frameCount = 0;
+
+        // estado de la extension de control grafico para el proximo frame
+        int m_delay = 100;
+        int m_transparentIndex = -1;
+        bool m_hasTransparency = false;
+        int m_disposal = 0; // 0: nada, 1: dejar, 2: limpiar, 3: restaurar previo
+
+        // disposal y rect del frame anterior
+        int m_prevDisposal = 0;
+        int m_prevLeft = 0;
+        int m_prevTop = 0;
+        int m_prevWidth = 0;
+        int m_prevHeight = 0;
+    };
+
     /**
-     * Decodes a GIF from in-memory data.
+     * Decodes every frame of a GIF from in-memory data (built on Stream).
      * @param data GIF data
      * @param size Data size in bytes
      * @return GIFData with all frames, or an empty structure on failure
@@ -43,15 +119,25 @@ public:
      */
     static bool getDimensions(uint8_t const* data, size_t size, int& width, int& height);
 
+    /**
+     * Counts image descriptors by hopping over the data sub-blocks, without
+     * decompressing anything (capped at MAX_FRAMES). A last frame whose data
+     * is cut off before its terminator is not counted: Stream drops it too.
+     */
+    static int countFrames(uint8_t const* data, size_t size);
+
+    /**
+     * Decodes only the first frame (full canvas, RGBA). Stops right after the
+     * first image descriptor, so the rest of the animation is never
+     * decompressed. For static thumbnails and color sampling.
+     * @return false if the data is not a GIF or has no decodable frame
+     */
+    static bool decodeFirstFrame(uint8_t const* data, size_t size, Frame& out);
+
 private:
     // Internal decoding helpers
     static bool parseHeader(uint8_t const*& ptr, uint8_t const* end, int& width, int& height);
     static bool parseColorTable(uint8_t const*& ptr, uint8_t const* end, std::vector<uint8_t>& palette, int size);
-    struct RawFrame {
-        std::vector<uint8_t> pixels;
-        int width, height, left, top;
-    };
-    
     static bool parseFrame(uint8_t const*& ptr, uint8_t const* end, RawFrame& frame, std::vector<uint8_t> const& globalPalette, int transparentIndex, bool hasTransparency);
 };
 
@@ -0,0 +1,235 @@
+#include "GIFFrameStore.hpp"
+#include "LZBlock.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+enum RecordKind : uint8_t {
+    RECORD_KEY = 0,    // pixeles tal cual del rect
+    RECORD_DELTA = 1,  // XOR contra el canvas anterior
+    RECORD_REPEAT = 2, // canvas igual que el anterior, sin datos
+};
+
+// cabecera: version, ancho, alto, nº de frames
+constexpr std::streamoff FRAME_COUNT_OFFSET = sizeof(uint32_t) + 2 * sizeof(int32_t);
+
+template <class T>
+void writePod(std::ofstream& file, T const& value) {
+    file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+template <class T>
+bool readPod(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+inline bool samePixel(uint8_t const* a, uint8_t const* b) {
+    uint32_t pa, pb;
+    std::memcpy(&pa, a, 4);
+    std::memcpy(&pb, b, 4);
+    return pa == pb;
+}
+} // namespace
+
+// ── Writer ──────────────────────────────────────────────────────────
+
+bool GIFFrameStore::Writer::open(std::string const& path, int width, int height) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) return false;
+
+    m_width = width;
+    m_height = height;
+    m_frames = 0;
+    m_ok = width > 0 && height > 0;
+    m_prev.clear();
+
+    uint32_t version = DISK_CACHE_VERSION;
+    int32_t w = width;
+    int32_t h = height;
+    writePod(m_file, version);
+    writePod(m_file, w);
+    writePod(m_file, h);
+    writePod(m_file, m_frames);
+    m_bytes = FRAME_COUNT_OFFSET + sizeof(uint32_t);
+    m_ok = m_ok && m_file.good();
+    return m_ok;
+}
+
+void GIFFrameStore::Writer::writeRecord(uint8_t kind, int delayMs, int left, int top, int width, int height,
+                                        std::vector<uint8_t> const& packed) {
+    int32_t fields[5] = {delayMs, left, top, width, height};
+    uint32_t packedSize = static_cast<uint32_t>(packed.size());
+    writePod(m_file, kind);
+    m_file.write(reinterpret_cast<char const*>(fields), sizeof(fields));
+    writePod(m_file, packedSize);
+    if (packedSize) m_file.write(reinterpret_cast<char const*>(packed.data()), packedSize);
+    m_bytes += sizeof(kind) + sizeof(fields) + sizeof(packedSize) + packedSize;
+    m_ok = m_ok && m_file.good();
+}
+
+bool GIFFrameStore::Writer::append(GIFDecoder::Frame const& frame) {
+    if (!m_ok || !m_file.is_open()) return false;
+    size_t const rowBytes = static_cast<size_t>(m_width) * 4;
+    size_t const canvasBytes = rowBytes * m_height;
+    if (frame.width != m_width || frame.height != m_height || frame.pixels.size() < canvasBytes) {
+        m_ok = false;
+        return false;
+    }
+    uint8_t const* cur = frame.pixels.data();
+
+    if (m_frames == 0) {
+        // keyframe: el canvas entero
+        paimon::lz::compress(cur, canvasBytes, m_packed);
+        writeRecord(RECORD_KEY, frame.delayMs, 0, 0, m_width, m_height, m_packed);
+        m_prev.assign(cur, cur + canvasBytes);
+        m_frames++;
+        return m_ok;
+    }
+
+    // filas y columnas que cambiaron respecto al canvas anterior
+    int minY = -1, maxY = -1;
+    for (int y = 0; y < m_height; ++y) {
+        if (std::memcmp(cur + rowBytes * y, m_prev.data() + rowBytes * y, rowBytes) != 0) {
+            if (minY < 0) minY = y;
+            maxY = y;
+        }
+    }
+    if (minY < 0) {
+        writeRecord(RECORD_REPEAT, frame.delayMs, 0, 0, 0, 0, {});
+        m_frames++;
+        return m_ok;
+    }
+
+    int minX = m_width, maxX = -1;
+    for (int y = minY; y <= maxY; ++y) {
+        uint8_t const* a = cur + rowBytes * y;
+        uint8_t const* b = m_prev.data() + rowBytes * y;
+        int x = 0;
+        while (x < minX && samePixel(a + x * 4, b + x * 4)) x++;
+        minX = std::min(minX, x);
+        int x2 = m_width - 1;
+        while (x2 > maxX && samePixel(a + x2 * 4, b + x2 * 4)) x2--;
+        maxX = std::max(maxX, x2);
+    }
+    int w = maxX - minX + 1;
+    int h = maxY - minY + 1;
+    size_t deltaRow = static_cast<size_t>(w) * 4;
+
+    // XOR: lo que no cambio dentro del rect queda a cero y comprime casi gratis
+    m_delta.resize(deltaRow * h);
+    for (int y = 0; y < h; ++y) {
+        size_t offset = rowBytes * (minY + y) + static_cast<size_t>(minX) * 4;
+        uint8_t const* a = cur + offset;
+        uint8_t* b = m_prev.data() + offset;
+        uint8_t* d = m_delta.data() + deltaRow * y;
+        for (size_t i = 0; i < deltaRow; ++i) d[i] = a[i] ^ b[i];
+        std::memcpy(b, a, deltaRow);
+    }
+
+    paimon::lz::compress(m_delta.data(), m_delta.size(), m_packed);
+    writeRecord(RECORD_DELTA, frame.delayMs, minX, minY, w, h, m_packed);
+    m_frames++;
+    return m_ok;
+}
+
+bool GIFFrameStore::Writer::finish() {
+    if (!m_file.is_open()) return false;
+    m_file.seekp(FRAME_COUNT_OFFSET);
+    writePod(m_file, m_frames);
+    m_file.flush();
+    bool ok = m_ok && m_file.good() && m_frames > 0;
+    m_file.close();
+    m_prev = {};
+    m_delta = {};
+    m_packed = {};
+    return ok;
+}
+
+void GIFFrameStore::Writer::abandon() {
+    if (m_file.is_open()) m_file.close();
+    m_ok = false;
+}
+
+// ── Reader ──────────────────────────────────────────────────────────
+
+bool GIFFrameStore::Reader::open(std::string const& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file) return false;
+
+    uint32_t version = 0;
+    int32_t width = 0, height = 0;
+    uint32_t frameCount = 0;
+    if (!readPod(m_file, version) || version != DISK_CACHE_VERSION) return false;
+    if (!readPod(m_file, width) || !readPod(m_file, height) || !readPod(m_file, frameCount)) return false;
+    if (width <= 0 || height <= 0 || width > 4096 || height > 4096) return false;
+    if (frameCount == 0 || frameCount > static_cast<uint32_t>(GIFDecoder::MAX_FRAMES)) return false;
+
+    m_width = width;
+    m_height = height;
+    m_frameCount = frameCount;
+    m_next = 0;
+    m_failed = false;
+    m_canvas.assign(static_cast<size_t>(width) * height * 4, 0);
+    return true;
+}
+
+bool GIFFrameStore::Reader::nextFrame(GIFDecoder::Frame& out) {
+    if (done()) return false;
+
+    uint8_t kind = 0;
+    int32_t fields[5] = {};
+    uint32_t packedSize = 0;
+    if (!readPod(m_file, kind) ||
+        !m_file.read(reinterpret_cast<char*>(fields), sizeof(fields)) ||
+        !readPod(m_file, packedSize)) {
+        m_failed = true;
+        return false;
+    }
+    auto [delayMs, left, top, width, height] = fields;
+
+    if (kind == RECORD_KEY || kind == RECORD_DELTA) {
+        bool inside = width > 0 && height > 0 && left >= 0 && top >= 0 &&
+            left <= m_width - width && top <= m_height - height;
+        size_t rawSize = static_cast<size_t>(width) * height * 4;
+        if (!inside || packedSize > paimon::lz::compressBound(rawSize)) {
+            m_failed = true;
+            return false;
+        }
+
+        m_packed.resize(packedSize);
+        m_raw.resize(rawSize);
+        if (!m_file.read(reinterpret_cast<char*>(m_packed.data()), packedSize) ||
+            !paimon::lz::decompress(m_packed.data(), packedSize, m_raw.data(), rawSize)) {
+            m_failed = true;
+            return false;
+        }
+
+        size_t rowBytes = static_cast<size_t>(m_width) * 4;
+        size_t rectRow = static_cast<size_t>(width) * 4;
+        for (int y = 0; y < height; ++y) {
+            uint8_t* dst = m_canvas.data() + rowBytes * (top + y) + static_cast<size_t>(left) * 4;
+            uint8_t const* src = m_raw.data() + rectRow * y;
+            if (kind == RECORD_KEY) {
+                std::memcpy(dst, src, rectRow);
+            } else {
+                for (size_t i = 0; i < rectRow; ++i) dst[i] ^= src[i];
+            }
+        }
+    } else if (kind != RECORD_REPEAT || packedSize != 0) {
+        m_failed = true;
+        return false;
+    }
+
+    m_next++;
+    out.left = 0;
+    out.top = 0;
+    out.width = m_width;
+    out.height = m_height;
+    out.delayMs = delayMs;
+    out.pixels.assign(m_canvas.begin(), m_canvas.end());
+    return true;
+}
+
+size_t GIFFrameStore::Reader::residentBytes() const {
+    return m_canvas.capacity() + m_raw.capacity() + m_packed.capacity();
+}
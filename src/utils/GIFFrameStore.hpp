@@ -0,0 +1,93 @@
+#pragma once
+#include "GIFDecoder.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * On-disk store of decoded GIF frames (AnimatedGIFSprite's disk cache).
+ *
+ * Frame 0 is a keyframe with the whole canvas; every later frame keeps only
+ * the rectangle that changed against the previous canvas, XORed with it so
+ * untouched pixels inside the rect become zeros. Each record is compressed
+ * with paimon::lz. Records are read one at a time, so playback can start as
+ * soon as the first one is in, and only the canvas plus one record live in
+ * memory on either side.
+ *
+ * Layout (little endian):
+ *   u32 version, i32 width, i32 height, u32 frameCount
+ *   per frame: u8 kind, i32 delayMs, i32 left, top, width, height,
+ *              u32 packedSize, packedSize bytes
+ */
+class GIFFrameStore {
+public:
+    // change whenever the layout changes; older files are treated as a miss
+    static constexpr uint32_t DISK_CACHE_VERSION = 3;
+
+    class Writer {
+    public:
+        // truncates `path`; the frame count is patched in by finish()
+        bool open(std::string const& path, int width, int height);
+        bool isOpen() const { return m_file.is_open(); }
+
+        // `frame` must be a full-canvas RGBA frame (GIFDecoder::Stream output)
+        bool append(GIFDecoder::Frame const& frame);
+
+        // patches the frame count and closes; false if any write failed
+        bool finish();
+        // closes without a valid frame count (the caller deletes the file)
+        void abandon();
+
+        uint32_t frames() const { return m_frames; }
+        uint64_t bytesWritten() const { return m_bytes; }
+
+    private:
+        void writeRecord(uint8_t kind, int delayMs, int left, int top, int width, int height,
+                         std::vector<uint8_t> const& packed);
+
+        std::ofstream m_file;
+        int m_width = 0;
+        int m_height = 0;
+        uint32_t m_frames = 0;
+        uint64_t m_bytes = 0;
+        bool m_ok = false;
+        std::vector<uint8_t> m_prev;   // canvas anterior
+        std::vector<uint8_t> m_delta;  // rect cambiado (XOR), sin comprimir
+        std::vector<uint8_t> m_packed;
+    };
+
+    class Reader {
+    public:
+        // false if the file is missing, from another version or has a bad header
+        bool open(std::string const& path);
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        uint32_t frameCount() const { return m_frameCount; }
+        bool done() const { return m_next >= m_frameCount || m_failed; }
+        // a record was truncated or corrupt
+        bool failed() const { return m_failed; }
+
+        /**
+         * Reads and applies the next record; `out` gets the full canvas
+         * (reuses out.pixels' storage).
+         * @return false at the end or on corrupt data
+         */
+        bool nextFrame(GIFDecoder::Frame& out);
+
+        // bytes held right now (canvas + record buffers)
+        size_t residentBytes() const;
+
+    private:
+        std::ifstream m_file;
+        int m_width = 0;
+        int m_height = 0;
+        uint32_t m_frameCount = 0;
+        uint32_t m_next = 0;
+        bool m_failed = false;
+        std::vector<uint8_t> m_canvas;
+        std::vector<uint8_t> m_raw;
+        std::vector<uint8_t> m_packed;
+    };
+};
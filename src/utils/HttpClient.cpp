@@ -1,6 +1,8 @@
 #include "HttpClient.hpp"
 #include "Debug.hpp"
 #include "WebHelper.hpp"
+#include "../framework/net/RequestCoalescer.hpp"
+#include "../framework/net/DownloadGovernor.hpp"
 #include <Geode/Geode.hpp>
 #include <Geode/utils/web.hpp>
 #include <Geode/binding/GJAccountManager.hpp>
@@ -86,6 +88,30 @@ void HttpClient::performRequest(
     geode::CopyableFunction<void(bool, std::string const&)> callback,
     bool includeStoredModCode
 ) {
+    performRequestOffMain(url, method, postData, headers,
+        WebHelper::onMain<std::string>(std::move(callback)), includeStoredModCode);
+}
+
+void HttpClient::performRequestOffMain(
+    std::string const& url,
+    std::string const& method,
+    std::string const& postData,
+    std::vector<std::string> const& headers,
+    TextHandler handler,
+    bool includeStoredModCode
+) {
+    // GETs iguales en vuelo salen una sola vez; cualquier POST tira la memo
+    auto& coalescer = paimon::net::RequestCoalescer::get();
+    bool shared = paimon::net::RequestCoalescer::isShareable(method);
+    bool useMemo = shared && paimon::net::RequestCoalescer::allowsMemo(headers);
+    std::string key;
+    if (shared) {
+        key = paimon::net::RequestCoalescer::makeKey(method, url, includeStoredModCode ? "" : "-nomod", headers);
+        if (!coalescer.joinText(key, handler, useMemo)) return;
+    } else {
+        coalescer.forgetResponses();
+    }
+
     auto req = web::WebRequest();
     req.timeout(std::chrono::seconds(10));
 
@@ -114,14 +140,24 @@ void HttpClient::performRequest(
         req.bodyString(postData);
     }
 
-    WebHelper::dispatch(std::move(req), method, url, [callback](web::WebResponse res) {
-        bool success = res.ok();
-        std::string responseStr = success
-            ? res.string().unwrapOr("")
-            : ("HTTP " + std::to_string(res.code()) + ": " + res.string().unwrapOr("Unknown error"));
+    // lectura del texto y handlers en el runtime; a main solo llegan sus pasos
+    WebHelper::dispatchOffMain<paimon::net::RequestCoalescer::Steps>(std::move(req), method, url,
+        [handler, shared, useMemo, key](web::WebResponse& res) -> paimon::net::RequestCoalescer::Steps {
+            bool success = res.ok();
+            std::string responseStr = success
+                ? res.string().unwrapOr("")
+                : ("HTTP " + std::to_string(res.code()) + ": " + res.string().unwrapOr("Unknown error"));
 
-        if (callback) callback(success, responseStr);
-    });
+            if (shared) {
+                return paimon::net::RequestCoalescer::get().finishText(key, success, responseStr, useMemo);
+            }
+            paimon::net::RequestCoalescer::Steps steps;
+            if (handler) {
+                if (auto step = handler(success, responseStr)) steps.push_back(std::move(step));
+            }
+            return steps;
+        },
+        [](paimon::net::RequestCoalescer::Steps steps) { WebHelper::runSteps(steps); });
 }
 
 void HttpClient::performBinaryRequest(
@@ -129,73 +165,104 @@ void HttpClient::performBinaryRequest(
     std::vector<std::string> const& headers,
     geode::CopyableFunction<void(bool, std::vector<uint8_t> const&)> callback
 ) {
-    auto req = web::WebRequest();
-    req.timeout(std::chrono::seconds(15));
-
-    // meto headers
-    for (auto const& header : headers) {
-        size_t colonPos = header.find(':');
-        if (colonPos != std::string::npos) {
-            std::string key = header.substr(0, colonPos);
-            std::string value = header.substr(colonPos + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            req.header(key, value);
-        }
-    }
+    performBinaryRequestOffMain(url, headers, WebHelper::bytesOnly(WebHelper::onMain<std::vector<uint8_t>>(std::move(callback))));
+}
 
-    if (!m_modCode.empty()) {
-        req.header("X-Mod-Code", m_modCode);
+void HttpClient::performBinaryRequestOffMain(
+    std::string const& url,
+    std::vector<std::string> const& headers,
+    ResponseHandler handler
+) {
+    // el prefetch del popup, la celda y downloadFromUrl piden a menudo la misma imagen a la vez
+    auto key = paimon::net::RequestCoalescer::makeKey("GET", url, "", headers);
+    if (!paimon::net::RequestCoalescer::get().joinBinary(key, std::move(handler))) {
+        PaimonDebug::log("[HttpClient] Binary GET {} joined an in-flight request", url);
+        return;
     }
 
-    std::string urlCopy = url; // pa logs
-
-    WebHelper::dispatch(std::move(req), "GET", url, [callback, urlCopy](web::WebResponse res) {
-        bool success = res.ok();
-        std::vector<uint8_t> data = success ? res.data() : std::vector<uint8_t>{};
+    constexpr auto timeout = std::chrono::seconds(15);
+
+    // cada host (CDN, Worker) tiene su ventana: si esta llena el GET espera turno
+    // y el timeout cuenta desde que sale de verdad
+    auto host = paimon::net::DownloadGovernor::hostOf(url);
+    paimon::net::DownloadGovernor::get().acquire(host, timeout,
+        [this, url, headers, key, timeout](paimon::net::DownloadGovernor::Ticket ticket) {
+        auto req = web::WebRequest();
+        req.timeout(timeout);
+
+        // meto headers
+        for (auto const& header : headers) {
+            size_t colonPos = header.find(':');
+            if (colonPos != std::string::npos) {
+                std::string key = header.substr(0, colonPos);
+                std::string value = header.substr(colonPos + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                req.header(key, value);
+            }
+        }
 
-        int statusCode = res.code();
-        PaimonDebug::log("[HttpClient] Binary GET {} -> status={}, size={}", urlCopy, statusCode, data.size());
+        if (!m_modCode.empty()) {
+            req.header("X-Mod-Code", m_modCode);
+        }
 
-        // Check Content-Type: if server returned JSON/HTML error, treat as failure
-        if (success && !data.empty()) {
-            auto ct = res.header("Content-Type");
-            std::string contentType = ct.has_value() ? std::string(ct.value()) : "";
-            PaimonDebug::log("[HttpClient] Binary response Content-Type: {}", contentType);
-
-            // If content-type is JSON or HTML, it's an error response, not binary data
-            if (contentType.find("application/json") != std::string::npos ||
-                contentType.find("text/html") != std::string::npos) {
-                std::string body(data.begin(), data.begin() + std::min(data.size(), (size_t)500));
-                PaimonDebug::log("[HttpClient] Binary request got non-image response: {}", body);
-                success = false;
-                data.clear();
-            }
+        std::string urlCopy = url; // pa logs
+
+        // copia de los bytes y validacion en el runtime, no en el hilo principal
+        WebHelper::dispatchOffMain<paimon::net::RequestCoalescer::Steps>(std::move(req), "GET", url,
+            [key, urlCopy, ticket](web::WebResponse& res) -> paimon::net::RequestCoalescer::Steps {
+                bool success = res.ok();
+                std::vector<uint8_t> data = success ? res.data() : std::vector<uint8_t>{};
+
+                int statusCode = res.code();
+                PaimonDebug::log("[HttpClient] Binary GET {} -> status={}, size={}", urlCopy, statusCode, data.size());
+                // latencia y resultado ajustan la ventana del host (y sueltan al siguiente en cola)
+                paimon::net::DownloadGovernor::get().release(ticket, statusCode, data.size());
+                // viaja con la respuesta (tambien en un 304) pa la proxima revalidacion
+                std::string validator = WebHelper::validatorOf(res);
+
+                // Check Content-Type: if server returned JSON/HTML error, treat as failure
+                if (success && !data.empty()) {
+                    auto ct = res.header("Content-Type");
+                    std::string contentType = ct.has_value() ? std::string(ct.value()) : "";
+                    PaimonDebug::log("[HttpClient] Binary response Content-Type: {}", contentType);
+
+                    // If content-type is JSON or HTML, it's an error response, not binary data
+                    if (contentType.find("application/json") != std::string::npos ||
+                        contentType.find("text/html") != std::string::npos) {
+                        std::string body(data.begin(), data.begin() + std::min(data.size(), (size_t)500));
+                        PaimonDebug::log("[HttpClient] Binary request got non-image response: {}", body);
+                        success = false;
+                        data.clear();
+                    }
 
-            // Also validate magic bytes: PNG, JPEG, GIF, WEBP, BMP
-            if (success && data.size() >= 4) {
-                bool validImage = false;
-                // PNG: 89 50 4E 47
-                if (data[0] == 0x89 && data[1] == 0x50 && data[2] == 0x4E && data[3] == 0x47) validImage = true;
-                // JPEG: FF D8 FF
-                else if (data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) validImage = true;
-                // GIF: GIF8
-                else if (data[0] == 'G' && data[1] == 'I' && data[2] == 'F' && data[3] == '8') validImage = true;
-                // WEBP: RIFF....WEBP
-                else if (data.size() >= 12 && data[0] == 'R' && data[1] == 'I' && data[2] == 'F' && data[3] == 'F'
-                    && data[8] == 'W' && data[9] == 'E' && data[10] == 'B' && data[11] == 'P') validImage = true;
-                // BMP: BM
-                else if (data[0] == 'B' && data[1] == 'M') validImage = true;
-
-                if (!validImage) {
-                    std::string preview(data.begin(), data.begin() + std::min(data.size(), (size_t)200));
-                    PaimonDebug::log("[HttpClient] Binary response does not look like an image. First bytes: {}", preview);
-                    success = false;
-                    data.clear();
+                    // Also validate magic bytes: PNG, JPEG, GIF, WEBP, BMP
+                    if (success && data.size() >= 4) {
+                        bool validImage = false;
+                        // PNG: 89 50 4E 47
+                        if (data[0] == 0x89 && data[1] == 0x50 && data[2] == 0x4E && data[3] == 0x47) validImage = true;
+                        // JPEG: FF D8 FF
+                        else if (data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) validImage = true;
+                        // GIF: GIF8
+                        else if (data[0] == 'G' && data[1] == 'I' && data[2] == 'F' && data[3] == '8') validImage = true;
+                        // WEBP: RIFF....WEBP
+                        else if (data.size() >= 12 && data[0] == 'R' && data[1] == 'I' && data[2] == 'F' && data[3] == 'F'
+                            && data[8] == 'W' && data[9] == 'E' && data[10] == 'B' && data[11] == 'P') validImage = true;
+                        // BMP: BM
+                        else if (data[0] == 'B' && data[1] == 'M') validImage = true;
+
+                        if (!validImage) {
+                            std::string preview(data.begin(), data.begin() + std::min(data.size(), (size_t)200));
+                            PaimonDebug::log("[HttpClient] Binary response does not look like an image. First bytes: {}", preview);
+                            success = false;
+                            data.clear();
+                        }
+                    }
                 }
-            }
-        }
 
-        if (callback) callback(success, data);
+                return paimon::net::RequestCoalescer::get().finishBinary(key, success,
+                    WebHelper::BinaryResponse{statusCode, std::move(data), std::move(validator)});
+            },
+            [](paimon::net::RequestCoalescer::Steps steps) { WebHelper::runSteps(steps); });
     });
 }
 
@@ -244,6 +311,7 @@ void HttpClient::performUpload(
 
     // mando body multipart de geode
     req.bodyMultipart(form);
+    paimon::net::RequestCoalescer::get().forgetResponses();
 
     WebHelper::dispatch(std::move(req), "POST", url, [callback](web::WebResponse res) {
         bool success = res.ok();
@@ -457,6 +525,7 @@ void HttpClient::uploadProfileConfig(int accountID, std::string const& jsonConfi
         req.header("X-Mod-Code", m_modCode);
     }
     req.bodyMultipart(form);
+    paimon::net::RequestCoalescer::get().forgetResponses();
 
     WebHelper::dispatch(std::move(req), "POST", url, [callback = std::move(callback)](web::WebResponse res) mutable {
         bool success = res.ok();
@@ -589,15 +658,17 @@ void HttpClient::uploadGIF(int levelId, std::vector<uint8_t> const& gifData, std
 }
 
 void HttpClient::getThumbnails(int levelId, GenericCallback callback) {
+    getThumbnailsOffMain(levelId, WebHelper::onMain<std::string>(std::move(callback)));
+}
+
+void HttpClient::getThumbnailsOffMain(int levelId, TextHandler handler) {
     std::string url = m_serverURL + "/api/thumbnails/list?levelId=" + std::to_string(levelId);
     std::vector<std::string> headers = {
         "X-API-Key: " + m_apiKey,
         "Cache-Control: no-cache"
     };
     
-    performRequest(url, "GET", "", headers, [callback = std::move(callback)](bool success, std::string const& response) {
-        callback(success, response);
-    });
+    performRequestOffMain(url, "GET", "", headers, std::move(handler));
 }
 
 void HttpClient::getThumbnailInfo(int levelId, GenericCallback callback) {
@@ -731,24 +802,82 @@ void HttpClient::fetchManifest(std::vector<int> const& levelIds, std::function<v
     std::string url = m_serverURL + "/api/manifest?ids=" + ids;
     PaimonDebug::log("[HttpClient] fetchManifest for {} levels: {}", levelIds.size(), url);
 
+    // downloads for these IDs park until the lookup answers
+    {
+        std::lock_guard<std::mutex> lock(m_manifestMutex);
+        for (int id : levelIds) m_manifestInFlight.try_emplace(id);
+    }
+
     std::vector<std::string> headers = {
         "X-API-Key: " + m_apiKey,
         "Accept: application/json"
     };
 
-    performRequest(url, "GET", "", headers, [this, callback](bool success, std::string const& response) {
+    // parse + save run off the main thread; only releasing the parked downloads goes back to it
+    performRequestOffMain(url, "GET", "", headers, [this, callback, levelIds](bool success, std::string const& response) -> WebHelper::MainStep {
         if (success) {
             updateManifestFromJson(response);
-            saveManifestToDisk();
+            // write-behind: only appends once a batch has built up
+            m_manifestCache.flushIfDue();
             PaimonDebug::log("[HttpClient] Manifest fetched and cached successfully");
-            if (callback) callback(true);
         } else {
             PaimonDebug::warn("[HttpClient] Failed to fetch manifest: {}", response);
-            if (callback) callback(false);
         }
+
+        return [this, callback, levelIds, success]() {
+            // release parked downloads: they now hit the CDN URL or take the Worker fallback
+            std::vector<std::function<void()>> waiters;
+            {
+                std::lock_guard<std::mutex> lock(m_manifestMutex);
+                time_t now = std::time(nullptr);
+                if (success) pruneManifestMissesLocked(now);
+                for (int id : levelIds) {
+                    // only a real answer is a miss; a failed request retries next time
+                    if (success && !m_manifestCache.contains(id)) m_manifestMisses[id] = now;
+                    auto it = m_manifestInFlight.find(id);
+                    if (it == m_manifestInFlight.end()) continue;
+                    for (auto& w : it->second) waiters.push_back(std::move(w));
+                    m_manifestInFlight.erase(it);
+                }
+            }
+            for (auto& w : waiters) w();
+
+            if (callback) callback(success);
+        };
     });
 }
 
+void HttpClient::pruneManifestMissesLocked(time_t now) {
+    std::erase_if(m_manifestMisses, [now](auto const& kv) { return now - kv.second >= MANIFEST_MISS_TTL; });
+    if (m_manifestMisses.size() < MAX_MANIFEST_MISSES) return;
+
+    // still full inside the TTL: keep the newest half, the rest just gets asked again
+    std::vector<std::pair<time_t, int>> byAge;
+    byAge.reserve(m_manifestMisses.size());
+    for (auto const& [id, at] : m_manifestMisses) byAge.emplace_back(at, id);
+    auto cut = byAge.begin() + static_cast<std::ptrdiff_t>(byAge.size() - MAX_MANIFEST_MISSES / 2);
+    std::nth_element(byAge.begin(), cut, byAge.end());
+    for (auto it = byAge.begin(); it != cut; ++it) m_manifestMisses.erase(it->second);
+}
+
+HttpClient::ManifestLookupPlan HttpClient::planManifestLookup(std::vector<int> const& levelIds) {
+    ManifestLookupPlan plan;
+    std::lock_guard<std::mutex> lock(m_manifestMutex);
+    time_t now = std::time(nullptr);
+    for (int id : levelIds) {
+        if (m_manifestCache.contains(id)) {
+            plan.hits++;
+        } else if (m_manifestInFlight.contains(id)) {
+            plan.inFlight++;
+        } else if (auto miss = m_manifestMisses.find(id); miss != m_manifestMisses.end() && now - miss->second < MANIFEST_MISS_TTL) {
+            plan.knownMisses++;
+        } else {
+            plan.missing.push_back(id);
+        }
+    }
+    return plan;
+}
+
 void HttpClient::updateManifestFromJson(std::string const& json) {
     auto parseResult = matjson::parse(json);
     if (!parseResult.isOk()) {
@@ -779,112 +908,28 @@ void HttpClient::updateManifestFromJson(std::string const& json) {
         entry.id      = val["id"].asString().unwrapOr("");
 
         if (!entry.cdnUrl.empty()) {
-            m_manifestCache[levelId] = std::move(entry);
+            // over the limit the least recently used level goes, not a random one
+            m_manifestCache.put(levelId, std::move(entry));
+            m_manifestMisses.erase(levelId);
             count++;
         }
     }
 
     PaimonDebug::log("[HttpClient] Manifest updated: {} entries cached", count);
-
-    // prune if over limit — erase arbitrary entries to stay within bounds
-    while (m_manifestCache.size() > MAX_MANIFEST_ENTRIES) {
-        m_manifestCache.erase(m_manifestCache.begin());
-    }
 }
 
 std::optional<HttpClient::ManifestEntry> HttpClient::getManifestEntry(int levelId) {
-    std::lock_guard<std::mutex> lock(m_manifestMutex);
-    auto it = m_manifestCache.find(levelId);
-    if (it != m_manifestCache.end()) {
-        return it->second;
-    }
-    return std::nullopt;
+    return m_manifestCache.get(levelId);
 }
 
 void HttpClient::saveManifestToDisk() {
-    std::lock_guard<std::mutex> lock(m_manifestMutex);
-
-    if (m_manifestCache.empty()) return;
-
-    auto path = Mod::get()->getSaveDir() / "manifest_cache.json";
-
-    matjson::Value root = matjson::Value::object();
-    for (auto& [levelId, entry] : m_manifestCache) {
-        matjson::Value obj = matjson::Value::object();
-        obj["format"]  = entry.format;
-        obj["cdnUrl"]  = entry.cdnUrl;
-        obj["version"] = entry.version;
-        obj["id"]      = entry.id;
-        root[std::to_string(levelId)] = std::move(obj);
-    }
-
-    std::string json = root.dump(matjson::NO_INDENTATION);
-
-    std::error_code ec;
-    std::filesystem::create_directories(path.parent_path(), ec);
-
-    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
-    if (ofs.is_open()) {
-        ofs.write(json.data(), json.size());
-        ofs.close();
-        PaimonDebug::log("[HttpClient] Manifest saved to disk ({} entries)", m_manifestCache.size());
-    } else {
-        PaimonDebug::warn("[HttpClient] Failed to write manifest_cache.json");
-    }
+    m_manifestCache.flush();
 }
 
 void HttpClient::loadManifestFromDisk() {
-    auto path = Mod::get()->getSaveDir() / "manifest_cache.json";
-
-    std::error_code ec;
-    if (!std::filesystem::exists(path, ec)) return;
-
-    std::ifstream ifs(path, std::ios::binary);
-    if (!ifs.is_open()) return;
-
-    std::string json((std::istreambuf_iterator<char>(ifs)),
-                      std::istreambuf_iterator<char>());
-    ifs.close();
-
-    if (json.empty()) return;
-
-    auto parseResult = matjson::parse(json);
-    if (!parseResult.isOk()) {
-        PaimonDebug::warn("[HttpClient] manifest_cache.json parse error");
-        return;
-    }
-    auto& root = parseResult.unwrap();
-    if (!root.isObject()) return;
-
-    std::lock_guard<std::mutex> lock(m_manifestMutex);
-    int count = 0;
-
-    for (auto& [key, val] : root) {
-        if (!val.isObject()) continue;
-
-        auto parsed = geode::utils::numFromString<int>(key);
-        if (!parsed.isOk()) continue;
-        int levelId = parsed.unwrap();
-        if (levelId <= 0) continue;
-
-        ManifestEntry entry;
-        entry.format  = val["format"].asString().unwrapOr("");
-        entry.cdnUrl  = val["cdnUrl"].asString().unwrapOr("");
-        entry.version = val["version"].asString().unwrapOr("");
-        entry.id      = val["id"].asString().unwrapOr("");
-
-        if (!entry.cdnUrl.empty()) {
-            m_manifestCache[levelId] = std::move(entry);
-            count++;
-        }
-    }
-
-    PaimonDebug::log("[HttpClient] Manifest loaded from disk: {} entries", count);
-
-    // prune if over limit
-    while (m_manifestCache.size() > MAX_MANIFEST_ENTRIES) {
-        m_manifestCache.erase(m_manifestCache.begin());
-    }
+    auto dir = Mod::get()->getSaveDir();
+    // the old manifest_cache.json is imported once and removed on the first write
+    m_manifestCache.load(dir / "manifest_cache.bin", dir / "manifest_cache.json");
 }
 
 void HttpClient::downloadReported(int levelId, DownloadCallback callback) {
@@ -893,16 +938,49 @@ void HttpClient::downloadReported(int levelId, DownloadCallback callback) {
 }
 
 void HttpClient::downloadThumbnail(int levelId, bool isGif, DownloadCallback callback) {
-    if (!isGif) {
-        downloadThumbnail(levelId, callback);
-        return;
-    }
-    std::string url = m_serverURL + "/t/" + std::to_string(levelId) + ".gif";
-    downloadFromUrl(url, callback);
+    downloadThumbnailOffMain(levelId, isGif, WebHelper::onMain<std::vector<uint8_t>>(
+        [callback = std::move(callback)](bool success, std::vector<uint8_t> const& data) {
+            if (success && !data.empty()) {
+                callback(true, data, 0, 0);
+            } else {
+                callback(false, {}, 0, 0);
+            }
+        }));
 }
 
 void HttpClient::downloadThumbnail(int levelId, DownloadCallback callback) {
-    PaimonDebug::log("[HttpClient] downloadThumbnail para level {} (formato unico, sin extension)", levelId);
+    downloadThumbnail(levelId, false, std::move(callback));
+}
+
+void HttpClient::downloadThumbnailOffMain(int levelId, bool isGif, BinaryHandler handler) {
+    fetchThumbnail(levelId, isGif, "", WebHelper::bytesOnly(std::move(handler)));
+}
+
+void HttpClient::fetchThumbnail(int levelId, bool isGif, std::string const& validator, ResponseHandler handler) {
+    if (isGif) {
+        // mismo request que downloadFromUrl con la URL del .gif
+        std::string url = m_serverURL + "/t/" + std::to_string(levelId) + ".gif";
+        std::vector<std::string> headers = { "X-API-Key: " + m_apiKey };
+        for (auto& h : WebHelper::conditionalHeaders(validator)) headers.push_back(std::move(h));
+        performBinaryRequestOffMain(url, headers, std::move(handler));
+        return;
+    }
+
+    PaimonDebug::log("[HttpClient] downloadThumbnail para level {} (formato unico, sin extension){}",
+        levelId, validator.empty() ? "" : ", condicional");
+
+    // A batched manifest lookup covering this level is in flight: wait for it
+    // instead of paying a Worker round-trip that the CDN URL would avoid
+    {
+        std::lock_guard<std::mutex> lock(m_manifestMutex);
+        if (auto it = m_manifestInFlight.find(levelId); it != m_manifestInFlight.end()) {
+            PaimonDebug::log("[HttpClient] Level {} waiting for in-flight manifest lookup", levelId);
+            it->second.push_back([this, levelId, validator, handler]() {
+                fetchThumbnail(levelId, false, validator, handler);
+            });
+            return;
+        }
+    }
 
     // Check manifest cache first — use direct Bunny CDN URL if available
     auto manifestEntry = getManifestEntry(levelId);
@@ -910,14 +988,16 @@ void HttpClient::downloadThumbnail(int levelId, DownloadCallback callback) {
         PaimonDebug::log("[HttpClient] Manifest hit for level {}: CDN URL={}", levelId, manifestEntry->cdnUrl);
 
         std::vector<std::string> cdnHeaders = { "Connection: keep-alive" };
-        performBinaryRequest(manifestEntry->cdnUrl, cdnHeaders, [callback = std::move(callback), levelId](bool success, std::vector<uint8_t> const& data) {
-            if (success && !data.empty()) {
-                PaimonDebug::log("[HttpClient] CDN download success for level {}: {} bytes", levelId, data.size());
-                callback(true, data, 0, 0);
-            } else {
+        for (auto& h : WebHelper::conditionalHeaders(validator)) cdnHeaders.push_back(std::move(h));
+        performBinaryRequestOffMain(manifestEntry->cdnUrl, cdnHeaders, [handler = std::move(handler), levelId](bool success, WebHelper::BinaryResponse const& res) -> WebHelper::MainStep {
+            if (success && !res.data.empty()) {
+                PaimonDebug::log("[HttpClient] CDN download success for level {}: {} bytes", levelId, res.data.size());
+            } else if (res.status != 304) {
                 PaimonDebug::warn("[HttpClient] CDN download failed for level {}, no fallback", levelId);
-                callback(false, {}, 0, 0);
+            } else {
+                PaimonDebug::log("[HttpClient] CDN copy for level {} still fresh (304)", levelId);
             }
+            return handler ? handler(success, res) : WebHelper::MainStep{};
         });
         return;
     }
@@ -929,19 +1009,21 @@ void HttpClient::downloadThumbnail(int levelId, DownloadCallback callback) {
         "X-API-Key: " + m_apiKey,
         "Connection: keep-alive"
     };
+    for (auto& h : WebHelper::conditionalHeaders(validator)) headers.push_back(std::move(h));
 
     // Single request: /t/{levelId} without extension — server auto-detects format.
     // Client handles all formats (GIF/WebP/PNG/JPG) via magic bytes in bytesToTexture().
     std::string url = m_serverURL + "/t/" + std::to_string(levelId);
 
-    performBinaryRequest(url, headers, [callback = std::move(callback), levelId](bool success, std::vector<uint8_t> const& data) {
-        if (success && !data.empty()) {
+    performBinaryRequestOffMain(url, headers, [handler = std::move(handler), levelId](bool success, WebHelper::BinaryResponse const& res) -> WebHelper::MainStep {
+        if (success && !res.data.empty()) {
             PaimonDebug::log("[HttpClient] Found thumbnail for level {}", levelId);
-            callback(true, data, 0, 0);
-        } else {
+        } else if (res.status != 304) {
             PaimonDebug::warn("[HttpClient] No thumbnail found for level {}", levelId);
-            callback(false, {}, 0, 0);
+        } else {
+            PaimonDebug::log("[HttpClient] Thumbnail for level {} still fresh (304)", levelId);
         }
+        return handler ? handler(success, res) : WebHelper::MainStep{};
     });
 }
 
@@ -1064,6 +1146,10 @@ void HttpClient::checkModeratorAccount(std::string const& username, int accountI
 }
 
 void HttpClient::getBanList(BanListCallback callback) {
+    getBanListOffMain(WebHelper::onMain<std::string>(std::move(callback)));
+}
+
+void HttpClient::getBanListOffMain(TextHandler handler) {
     PaimonDebug::log("[HttpClient] Getting ban list");
     std::string reqUser = GJAccountManager::get()->m_username;
     int reqAccountID = GJAccountManager::get()->m_accountID;
@@ -1073,7 +1159,7 @@ void HttpClient::getBanList(BanListCallback callback) {
         "X-Mod-Code: " + m_modCode,
         "Accept: application/json"
     };
-    performRequest(url, "GET", "", headers, callback);
+    performRequestOffMain(url, "GET", "", headers, std::move(handler));
 }
 
 void HttpClient::banUser(std::string const& username, std::string const& reason, BanUserCallback callback) {
@@ -1231,14 +1317,28 @@ void HttpClient::downloadFromUrlRaw(std::string const& url, DownloadCallback cal
     // Descarga binaria SIN validar magic bytes de imagen.
     // util para archivos de audio (MP3, OGG, etc.) que no pasan
     // la validacion de formato de imagen en performBinaryRequest.
-    auto req = web::WebRequest();
-    req.timeout(std::chrono::seconds(30));
-
     std::vector<std::string> headers = {
         "X-API-Key: " + m_apiKey,
         "Cache-Control: no-cache, no-store, must-revalidate",
         "Pragma: no-cache"
     };
+
+    // varias celdas pueden pedir la misma cancion a la vez
+    auto coalesceKey = paimon::net::RequestCoalescer::makeKey("GET-RAW", url, "", headers);
+    bool first = paimon::net::RequestCoalescer::get().joinBinary(coalesceKey, WebHelper::bytesOnly(WebHelper::onMain<std::vector<uint8_t>>(
+        [callback = std::move(callback)](bool success, std::vector<uint8_t> const& data) {
+            if (!callback) return;
+            if (success && !data.empty()) {
+                callback(true, data, 0, 0);
+            } else {
+                callback(false, {}, 0, 0);
+            }
+        })));
+    if (!first) return;
+
+    auto req = web::WebRequest();
+    req.timeout(std::chrono::seconds(30));
+
     for (auto const& header : headers) {
         size_t colonPos = header.find(':');
         if (colonPos != std::string::npos) {
@@ -1255,44 +1355,45 @@ void HttpClient::downloadFromUrlRaw(std::string const& url, DownloadCallback cal
 
     std::string urlCopy = url;
 
-    WebHelper::dispatch(std::move(req), "GET", url, [callback, urlCopy](web::WebResponse res) {
-        bool success = res.ok();
-        std::vector<uint8_t> data = success ? res.data() : std::vector<uint8_t>{};
+    WebHelper::dispatchOffMain<paimon::net::RequestCoalescer::Steps>(std::move(req), "GET", url,
+        [coalesceKey, urlCopy](web::WebResponse& res) -> paimon::net::RequestCoalescer::Steps {
+            bool success = res.ok();
+            std::vector<uint8_t> data = success ? res.data() : std::vector<uint8_t>{};
 
-        int statusCode = res.code();
-        PaimonDebug::log("[HttpClient] Raw binary GET {} -> status={}, size={}", urlCopy, statusCode, data.size());
+            int statusCode = res.code();
+            PaimonDebug::log("[HttpClient] Raw binary GET {} -> status={}, size={}", urlCopy, statusCode, data.size());
 
-        // Solo verificar Content-Type para rechazar errores JSON/HTML
-        if (success && !data.empty()) {
-            auto ct = res.header("Content-Type");
-            std::string contentType = ct.has_value() ? std::string(ct.value()) : "";
-
-            if (contentType.find("application/json") != std::string::npos ||
-                contentType.find("text/html") != std::string::npos) {
-                std::string body(data.begin(), data.begin() + std::min(data.size(), (size_t)500));
-                PaimonDebug::log("[HttpClient] Raw binary request got error response: {}", body);
-                success = false;
-                data.clear();
-            }
-        }
-
-        if (callback) {
+            // Solo verificar Content-Type para rechazar errores JSON/HTML
             if (success && !data.empty()) {
-                callback(true, data, 0, 0);
-            } else {
-                callback(false, {}, 0, 0);
+                auto ct = res.header("Content-Type");
+                std::string contentType = ct.has_value() ? std::string(ct.value()) : "";
+
+                if (contentType.find("application/json") != std::string::npos ||
+                    contentType.find("text/html") != std::string::npos) {
+                    std::string body(data.begin(), data.begin() + std::min(data.size(), (size_t)500));
+                    PaimonDebug::log("[HttpClient] Raw binary request got error response: {}", body);
+                    success = false;
+                    data.clear();
+                }
             }
-        }
-    });
+
+            return paimon::net::RequestCoalescer::get().finishBinary(coalesceKey, success,
+                WebHelper::BinaryResponse{statusCode, std::move(data), {}});
+        },
+        [](paimon::net::RequestCoalescer::Steps steps) { WebHelper::runSteps(steps); });
 }
 
 void HttpClient::get(std::string const& endpoint, GenericCallback callback) {
+    getOffMain(endpoint, WebHelper::onMain<std::string>(std::move(callback)));
+}
+
+void HttpClient::getOffMain(std::string const& endpoint, TextHandler handler) {
     std::string url = m_serverURL + endpoint;
     std::vector<std::string> headers = {
         "X-API-Key: " + m_apiKey,
         "Accept: application/json"
     };
-    performRequest(url, "GET", "", headers, callback);
+    performRequestOffMain(url, "GET", "", headers, std::move(handler));
 }
 
 void HttpClient::post(std::string const& endpoint, std::string const& data, GenericCallback callback) {
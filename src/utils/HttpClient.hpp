@@ -4,6 +4,8 @@
 #include <Geode/utils/web.hpp>
 #include <Geode/utils/function.hpp>
 #include "ThumbnailTypes.hpp"
+#include "WebHelper.hpp"
+#include "CdnManifestCache.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -24,6 +26,16 @@ public:
     using BanUserCallback = geode::CopyableFunction<void(bool success, std::string const& message)>;
     using ModeratorsListCallback = geode::CopyableFunction<void(bool success, std::vector<std::string> const& moderators)>;
 
+    // respuestas procesadas fuera del hilo principal: ParseFn corre en el runtime
+    // de async con el texto y solo su resultado llega al callback (en main)
+    template <class T>
+    using ParseFn = geode::CopyableFunction<T(bool success, std::string const& response)>;
+    template <class T>
+    using ParsedCallback = geode::CopyableFunction<void(T result)>;
+    using TextHandler = WebHelper::OffMainHandler<std::string>;
+    using BinaryHandler = WebHelper::OffMainHandler<std::vector<uint8_t>>;
+    using ResponseHandler = WebHelper::OffMainHandler<WebHelper::BinaryResponse>;
+
     static HttpClient& get() {
         static HttpClient instance;
         return instance;
@@ -49,6 +61,10 @@ public:
 
     // lista thumbs
     void getThumbnails(int levelId, GenericCallback callback);
+    template <class T>
+    void getThumbnails(int levelId, ParseFn<T> parse, ParsedCallback<T> callback) {
+        getThumbnailsOffMain(levelId, WebHelper::parseThen<T>(std::move(parse), std::move(callback)));
+    }
 
     // info thumb
     void getThumbnailInfo(int levelId, GenericCallback callback);
@@ -93,6 +109,12 @@ public:
     // descarga thumb (respeta setting priority)
     void downloadThumbnail(int levelId, DownloadCallback callback);
     void downloadThumbnail(int levelId, bool isGif, DownloadCallback callback);
+    // igual, pero el handler recibe los bytes en un worker (sin pasar por main)
+    void downloadThumbnailOffMain(int levelId, bool isGif, BinaryHandler handler);
+    // descarga condicional: con `validator` (ETag o "lm:<fecha>") manda
+    // If-None-Match / If-Modified-Since y un 304 llega con status 304 y sin bytes.
+    // la respuesta trae el validador nuevo pa guardarlo junto al archivo
+    void fetchThumbnail(int levelId, bool isGif, std::string const& validator, ResponseHandler handler);
     
     // existe thumb?
     void checkThumbnailExists(int levelId, CheckCallback callback);
@@ -107,6 +129,10 @@ public:
 
     // lista baneados
     void getBanList(BanListCallback callback);
+    template <class T>
+    void getBanList(ParseFn<T> parse, ParsedCallback<T> callback) {
+        getBanListOffMain(WebHelper::parseThen<T>(std::move(parse), std::move(callback)));
+    }
 
     // banear user
     void banUser(std::string const& username, std::string const& reason, BanUserCallback callback);
@@ -126,6 +152,10 @@ public:
 
     // get/post generico
     void get(std::string const& endpoint, GenericCallback callback);
+    template <class T>
+    void getParsed(std::string const& endpoint, ParseFn<T> parse, ParsedCallback<T> callback) {
+        getOffMain(endpoint, WebHelper::parseThen<T>(std::move(parse), std::move(callback)));
+    }
     void post(std::string const& endpoint, std::string const& data, GenericCallback callback);
     // post autenticado (incluye X-Mod-Code para operaciones privilegiadas)
     void postWithAuth(std::string const& endpoint, std::string const& data, GenericCallback callback);
@@ -146,20 +176,27 @@ public:
         UploadCallback callback);
 
     // manifest cache — stores CDN URLs fetched from /api/manifest to bypass Worker
-    struct ManifestEntry {
-        std::string format;   // "webp", "png", "gif", etc.
-        std::string cdnUrl;   // direct Bunny CDN URL
-        std::string version;  // revision/version token
-        std::string id;       // thumbnail id
-    };
+    using ManifestEntry = paimon::net::CdnManifestEntry;
 
     void fetchManifest(std::vector<int> const& levelIds, std::function<void(bool)> callback);
     std::optional<ManifestEntry> getManifestEntry(int levelId);
+
+    // split of a page of level IDs before a batched lookup:
+    // missing = not cached, not in flight and without a recent miss
+    struct ManifestLookupPlan {
+        std::vector<int> missing;
+        size_t hits = 0;        // already have a CDN URL
+        size_t knownMisses = 0; // manifest answered recently without an entry
+        size_t inFlight = 0;    // covered by a lookup that has not returned yet
+    };
+    ManifestLookupPlan planManifestLookup(std::vector<int> const& levelIds);
     void updateManifestFromJson(std::string const& json);
 
-    // disk persistence for manifest cache
+    // disk persistence for manifest cache: appends batched ops (write-behind);
+    // saveManifestToDisk forces whatever is pending out (exit)
     void saveManifestToDisk();
     void loadManifestFromDisk();
+    paimon::net::CdnManifestCache::Stats manifestCacheStats() const { return m_manifestCache.stats(); }
 
 private:
     HttpClient();
@@ -180,10 +217,24 @@ private:
     std::map<int, ExistsCacheEntry> m_existsCache;
     static constexpr int EXISTS_CACHE_DURATION = 300; // 5 min
 
-    // manifest cache — CDN URLs indexed by levelId
-    std::unordered_map<int, ManifestEntry> m_manifestCache;
-    std::mutex m_manifestMutex;
+    // manifest cache — CDN URLs indexed by levelId, LRU with its own lock.
+    // m_manifestMutex guards the lookup bookkeeping below (in-flight, misses)
     static constexpr size_t MAX_MANIFEST_ENTRIES = 5000;
+    paimon::net::CdnManifestCache m_manifestCache{MAX_MANIFEST_ENTRIES};
+    std::mutex m_manifestMutex;
+    // batched lookups in flight: downloads for these IDs wait for the answer
+    // instead of falling back to the Worker (/t/{id}) in the meantime
+    std::unordered_map<int, std::vector<std::function<void()>>> m_manifestInFlight;
+    // IDs the manifest answered without an entry (no thumbnail / no CDN copy)
+    std::unordered_map<int, time_t> m_manifestMisses;
+    static constexpr int MANIFEST_MISS_TTL = 300; // 5 min, same as exists cache
+    static constexpr size_t MAX_MANIFEST_MISSES = MAX_MANIFEST_ENTRIES;
+    // drops expired misses, then the oldest ones over the cap; m_manifestMutex held
+    void pruneManifestMissesLocked(time_t now);
+
+    void getOffMain(std::string const& endpoint, TextHandler handler);
+    void getThumbnailsOffMain(int levelId, TextHandler handler);
+    void getBanListOffMain(TextHandler handler);
 
     // request async
     void performRequest(
@@ -195,12 +246,27 @@ private:
         bool includeStoredModCode = true
     );
     
+    // el handler corre en el runtime de async con la respuesta ya leida
+    void performRequestOffMain(
+        std::string const& url,
+        std::string const& method,
+        std::string const& postData,
+        std::vector<std::string> const& headers,
+        TextHandler handler,
+        bool includeStoredModCode = true
+    );
+
     // descarga binary (sin a string)
     void performBinaryRequest(
         std::string const& url,
         std::vector<std::string> const& headers,
         geode::CopyableFunction<void(bool, std::vector<uint8_t> const&)> callback
     );
+    void performBinaryRequestOffMain(
+        std::string const& url,
+        std::vector<std::string> const& headers,
+        ResponseHandler handler
+    );
 
     // sube archivo
     void performUpload(
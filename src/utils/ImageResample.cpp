@@ -0,0 +1,256 @@
+#include "ImageResample.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PAIMON_RESAMPLE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PAIMON_RESAMPLE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace paimon::image {
+
+namespace {
+
+// contribucion de un rango de pixeles fuente a un pixel destino
+struct Span {
+    int start = 0;
+    int count = 0;
+    int weightOffset = 0;
+};
+
+// calcula, para cada pixel destino, que pixeles fuente cubre y con que peso
+// (fraccion de area cubierta, normalizada a 1)
+void buildSpans(int srcLen, int dstLen, std::vector<Span>& spans, std::vector<float>& weights) {
+    spans.resize(dstLen);
+    weights.clear();
+    weights.reserve(static_cast<size_t>(dstLen) * (srcLen / dstLen + 2));
+
+    double scale = static_cast<double>(srcLen) / static_cast<double>(dstLen);
+    for (int i = 0; i < dstLen; ++i) {
+        double a = i * scale;
+        double b = std::min<double>((i + 1) * scale, srcLen);
+        int s = std::clamp(static_cast<int>(std::floor(a)), 0, srcLen - 1);
+        int e = std::clamp(static_cast<int>(std::ceil(b)), s + 1, srcLen);
+
+        auto& span = spans[i];
+        span.start = s;
+        span.weightOffset = static_cast<int>(weights.size());
+
+        double total = 0.0;
+        for (int j = s; j < e; ++j) {
+            double w = std::min<double>(b, j + 1) - std::max<double>(a, j);
+            if (w <= 0.0) w = 0.0;
+            weights.push_back(static_cast<float>(w));
+            total += w;
+        }
+        span.count = e - s;
+        if (total <= 0.0) {
+            // upscale degenerado: el pixel cae dentro de uno solo
+            weights[span.weightOffset] = 1.f;
+            total = 1.0;
+        }
+        float inv = static_cast<float>(1.0 / total);
+        for (int k = 0; k < span.count; ++k) {
+            weights[span.weightOffset + k] *= inv;
+        }
+    }
+}
+
+// ── kernels ──────────────────────────────────────────────────────────
+// la entrada es RGBA sin premultiplicar: si se promedia tal cual, el color
+// de los pixeles transparentes (negro casi siempre) ensucia los bordes. Se
+// acumula con el color pesado por alfa (r*a, g*a, b*a, a) y al guardar se
+// divide por el alfa acumulado.
+
+constexpr float INV_255 = 1.f / 255.f;
+// por debajo de esto el pixel es transparente y el color no importa
+constexpr float MIN_ALPHA = 1e-4f;
+
+// peso de r, g y b para un pixel con alfa `a` (el de alfa es `w` sin mas)
+inline float colorWeight(uint8_t a, float w) {
+    return w * (static_cast<float>(a) * INV_255);
+}
+
+// factor que deshace el peso por alfa de r, g y b al guardar
+inline float unpremultiplyScale(float alpha) {
+    return alpha > MIN_ALPHA ? 255.f / alpha : 0.f;
+}
+
+inline uint8_t toByte(float v) {
+    // +0.5 y truncado = redondeo (los valores nunca son negativos)
+    return static_cast<uint8_t>(std::clamp(static_cast<int>(v + 0.5f), 0, 255));
+}
+
+inline void storePixelScalar(float const* acc, uint8_t* out) {
+    float k = unpremultiplyScale(acc[3]);
+    out[0] = toByte(acc[0] * k);
+    out[1] = toByte(acc[1] * k);
+    out[2] = toByte(acc[2] * k);
+    out[3] = toByte(acc[3]);
+}
+
+#if PAIMON_RESAMPLE_SSE2
+
+inline void horizontalRow(uint8_t const* srcRow, float* outRow, std::vector<Span> const& spans, float const* weights) {
+    __m128i const zero = _mm_setzero_si128();
+    for (size_t x = 0; x < spans.size(); ++x) {
+        auto const& span = spans[x];
+        __m128 acc = _mm_setzero_ps();
+        uint8_t const* p = srcRow + static_cast<size_t>(span.start) * 4;
+        float const* w = weights + span.weightOffset;
+        for (int k = 0; k < span.count; ++k, p += 4) {
+            int32_t px;
+            std::memcpy(&px, p, 4);
+            __m128i v = _mm_cvtsi32_si128(px);
+            v = _mm_unpacklo_epi8(v, zero);
+            v = _mm_unpacklo_epi16(v, zero);
+            float cw = colorWeight(p[3], w[k]);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set_ps(w[k], cw, cw, cw)));
+        }
+        _mm_storeu_ps(outRow + x * 4, acc);
+    }
+}
+
+inline void accumulateRow(float* acc, float const* row, float w, size_t n) {
+    __m128 vw = _mm_set1_ps(w);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps(acc + i);
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(row + i), vw));
+        _mm_storeu_ps(acc + i, a);
+    }
+    for (; i < n; ++i) acc[i] += row[i] * w;
+}
+
+// un pixel sin el peso por alfa, +0.5 y truncado a int32
+inline __m128i unpremultiplyPixel(float const* acc) {
+    float k = unpremultiplyScale(acc[3]);
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(acc), _mm_set_ps(1.f, k, k, k));
+    return _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+}
+
+inline void storeRow(float const* acc, uint8_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        // packs/packus saturan a [0,255]
+        __m128i ab = _mm_packs_epi32(unpremultiplyPixel(acc + i), unpremultiplyPixel(acc + i + 4));
+        __m128i cd = _mm_packs_epi32(unpremultiplyPixel(acc + i + 8), unpremultiplyPixel(acc + i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(ab, cd));
+    }
+    for (; i < n; i += 4) storePixelScalar(acc + i, out + i);
+}
+
+#elif PAIMON_RESAMPLE_NEON
+
+inline void horizontalRow(uint8_t const* srcRow, float* outRow, std::vector<Span> const& spans, float const* weights) {
+    for (size_t x = 0; x < spans.size(); ++x) {
+        auto const& span = spans[x];
+        float32x4_t acc = vdupq_n_f32(0.f);
+        uint8_t const* p = srcRow + static_cast<size_t>(span.start) * 4;
+        float const* w = weights + span.weightOffset;
+        for (int k = 0; k < span.count; ++k, p += 4) {
+            uint32_t px;
+            std::memcpy(&px, p, 4);
+            uint8x8_t v8 = vreinterpret_u8_u32(vdup_n_u32(px));
+            uint32x4_t v32 = vmovl_u16(vget_low_u16(vmovl_u8(v8)));
+            float32x4_t vw = vsetq_lane_f32(w[k], vdupq_n_f32(colorWeight(p[3], w[k])), 3);
+            acc = vmlaq_f32(acc, vcvtq_f32_u32(v32), vw);
+        }
+        vst1q_f32(outRow + x * 4, acc);
+    }
+}
+
+inline void accumulateRow(float* acc, float const* row, float w, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), vld1q_f32(row + i), w));
+    }
+    for (; i < n; ++i) acc[i] += row[i] * w;
+}
+
+// un pixel sin el peso por alfa, +0.5 y truncado a int32
+inline int32x4_t unpremultiplyPixel(float const* acc) {
+    float k = unpremultiplyScale(acc[3]);
+    float32x4_t v = vmulq_f32(vld1q_f32(acc), vsetq_lane_f32(1.f, vdupq_n_f32(k), 3));
+    return vcvtq_s32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)));
+}
+
+inline void storeRow(float const* acc, uint8_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int32x4_t a = unpremultiplyPixel(acc + i);
+        int32x4_t b = unpremultiplyPixel(acc + i + 4);
+        uint16x8_t ab = vcombine_u16(vqmovun_s32(a), vqmovun_s32(b));
+        vst1_u8(out + i, vqmovn_u16(ab));
+    }
+    for (; i < n; i += 4) storePixelScalar(acc + i, out + i);
+}
+
+#else
+
+inline void horizontalRow(uint8_t const* srcRow, float* outRow, std::vector<Span> const& spans, float const* weights) {
+    for (size_t x = 0; x < spans.size(); ++x) {
+        auto const& span = spans[x];
+        float acc[4] = {0.f, 0.f, 0.f, 0.f};
+        uint8_t const* p = srcRow + static_cast<size_t>(span.start) * 4;
+        float const* w = weights + span.weightOffset;
+        for (int k = 0; k < span.count; ++k, p += 4) {
+            float cw = colorWeight(p[3], w[k]);
+            acc[0] += p[0] * cw;
+            acc[1] += p[1] * cw;
+            acc[2] += p[2] * cw;
+            acc[3] += p[3] * w[k];
+        }
+        std::memcpy(outRow + x * 4, acc, sizeof(acc));
+    }
+}
+
+inline void accumulateRow(float* acc, float const* row, float w, size_t n) {
+    for (size_t i = 0; i < n; ++i) acc[i] += row[i] * w;
+}
+
+inline void storeRow(float const* acc, uint8_t* out, size_t n) {
+    for (size_t i = 0; i < n; i += 4) storePixelScalar(acc + i, out + i);
+}
+
+#endif
+
+} // namespace
+
+std::vector<uint8_t> resampleAreaRGBA(uint8_t const* src, int srcW, int srcH, int dstW, int dstH) {
+    if (!src || srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0) return {};
+
+    std::vector<Span> xSpans, ySpans;
+    std::vector<float> xWeights, yWeights;
+    buildSpans(srcW, dstW, xSpans, xWeights);
+    buildSpans(srcH, dstH, ySpans, yWeights);
+
+    size_t const dstRowFloats = static_cast<size_t>(dstW) * 4;
+
+    // pasada horizontal: srcH filas de dstW pixeles en float
+    std::vector<float> tmp(dstRowFloats * static_cast<size_t>(srcH));
+    for (int y = 0; y < srcH; ++y) {
+        horizontalRow(src + static_cast<size_t>(y) * srcW * 4, tmp.data() + dstRowFloats * y, xSpans, xWeights.data());
+    }
+
+    // pasada vertical: cada fila destino es la suma ponderada de sus filas fuente
+    std::vector<uint8_t> out(dstRowFloats * static_cast<size_t>(dstH));
+    std::vector<float> acc(dstRowFloats);
+    for (int y = 0; y < dstH; ++y) {
+        auto const& span = ySpans[y];
+        std::fill(acc.begin(), acc.end(), 0.f);
+        for (int k = 0; k < span.count; ++k) {
+            accumulateRow(acc.data(), tmp.data() + dstRowFloats * (span.start + k),
+                yWeights[span.weightOffset + k], dstRowFloats);
+        }
+        storeRow(acc.data(), out.data() + dstRowFloats * y, dstRowFloats);
+    }
+
+    return out;
+}
+
+} // namespace paimon::image
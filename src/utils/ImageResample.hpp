@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * ImageResample — reescalado de buffers RGBA8888 en CPU.
+ *
+ * resampleAreaRGBA hace un promedio por area (box filter real): cada pixel
+ * destino es la media ponderada de todos los pixeles fuente que cubre,
+ * incluyendo la cobertura fraccional de los bordes. El color se pondera
+ * por alfa (como si estuviera premultiplicado) para que los pixeles
+ * transparentes no tiñan los bordes; entrada y salida siguen siendo RGBA
+ * sin premultiplicar. Es separable
+ * (horizontal y luego vertical) y usa SSE2 en x86/x64 y NEON en ARM;
+ * en otras plataformas cae a una version escalar con el mismo resultado.
+ *
+ * Pensado para correr en hilos de decode, nunca en el main thread.
+ */
+namespace paimon::image {
+
+// Devuelve un buffer dstW*dstH*4. Si algun tamaño es invalido devuelve vacio.
+std::vector<uint8_t> resampleAreaRGBA(uint8_t const* src, int srcW, int srcH, int dstW, int dstH);
+
+} // namespace paimon::image
@@ -0,0 +1,160 @@
+#include "LZBlock.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace paimon::lz {
+
+namespace {
+constexpr size_t MIN_MATCH = 4;
+// el formato pide que los ultimos 5 bytes sean literales y que el ultimo
+// match empiece al menos 12 bytes antes del final
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MF_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 14;
+// sin match en 64 intentos seguidos el paso crece (zonas incompresibles)
+constexpr unsigned SKIP_TRIGGER = 6;
+
+inline uint32_t read32(uint8_t const* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// longitudes >= 15: el nibble va a 15 y el resto en bytes de 255 + uno final
+inline void writeLength(std::vector<uint8_t>& out, size_t len) {
+    while (len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(len));
+}
+
+void emitSequence(std::vector<uint8_t>& out, uint8_t const* literals, size_t litLen,
+                  size_t matchLen, size_t offset) {
+    size_t matchCode = matchLen - MIN_MATCH;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(litLen, 15) << 4) | std::min<size_t>(matchCode, 15));
+    out.push_back(token);
+    if (litLen >= 15) writeLength(out, litLen - 15);
+    out.insert(out.end(), literals, literals + litLen);
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) writeLength(out, matchCode - 15);
+}
+
+void emitLastLiterals(std::vector<uint8_t>& out, uint8_t const* literals, size_t litLen) {
+    out.push_back(static_cast<uint8_t>(std::min<size_t>(litLen, 15) << 4));
+    if (litLen >= 15) writeLength(out, litLen - 15);
+    if (litLen) out.insert(out.end(), literals, literals + litLen);
+}
+
+// lee una longitud extendida; false si se acaba la entrada
+inline bool readLength(uint8_t const*& ip, uint8_t const* end, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+} // namespace
+
+size_t compressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+void compress(uint8_t const* src, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(compressBound(size));
+    if (size <= MF_LIMIT) {
+        emitLastLiterals(out, src, size);
+        return;
+    }
+
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+    size_t const matchLimit = size - LAST_LITERALS;
+    size_t const ipLimit = size - MF_LIMIT;
+    size_t anchor = 0;
+    size_t ip = 0;
+    unsigned attempts = 1u << SKIP_TRIGGER;
+
+    while (ip < ipLimit) {
+        uint32_t seq = read32(src + ip);
+        uint32_t h = hash4(seq);
+        size_t ref = table[h];
+        table[h] = static_cast<uint32_t>(ip);
+
+        if (ref >= ip || ip - ref > MAX_OFFSET || read32(src + ref) != seq) {
+            ip += attempts++ >> SKIP_TRIGGER;
+            continue;
+        }
+
+        // alargo hacia atras sobre los literales pendientes
+        while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+            ip--;
+            ref--;
+        }
+        size_t len = MIN_MATCH;
+        while (ip + len < matchLimit && src[ip + len] == src[ref + len]) len++;
+
+        emitSequence(out, src + anchor, ip - anchor, len, ip - ref);
+        ip += len;
+        anchor = ip;
+        attempts = 1u << SKIP_TRIGGER;
+        if (ip < ipLimit) table[hash4(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+    }
+
+    emitLastLiterals(out, src + anchor, size - anchor);
+}
+
+bool decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t dstSize) {
+    uint8_t const* ip = src;
+    uint8_t const* const iend = src + size;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dstSize;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !readLength(ip, iend, litLen)) return false;
+        if (litLen > static_cast<size_t>(iend - ip) || litLen > static_cast<size_t>(oend - op)) return false;
+        if (litLen) std::memcpy(op, ip, litLen);
+        op += litLen;
+        ip += litLen;
+
+        // la ultima secuencia solo trae literales
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+        size_t matchLen = token & 15;
+        if (matchLen == 15 && !readLength(ip, iend, matchLen)) return false;
+        matchLen += MIN_MATCH;
+        if (matchLen > static_cast<size_t>(oend - op)) return false;
+
+        // copias solapadas (offset < len, p.ej. un pixel RGBA repetido con
+        // offset 4): memcpy no admite solape, asi que se copia por trozos de
+        // como mucho op - match bytes. match no se mueve y op si, por eso
+        // cada trozo sale de bytes ya escritos y respeta el periodo offset
+        uint8_t const* match = op - offset;
+        while (matchLen > 0) {
+            size_t chunk = std::min(matchLen, static_cast<size_t>(op - match));
+            std::memcpy(op, match, chunk);
+            op += chunk;
+            matchLen -= chunk;
+        }
+    }
+
+    return op == oend;
+}
+
+} // namespace paimon::lz
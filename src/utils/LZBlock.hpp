@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Small LZ77 block codec in the LZ4 block format (token, literals, 16-bit
+ * offset, match length). Greedy single-probe hash matching: fast to write and
+ * very fast to read, which is what a disk cache of decoded frames needs.
+ * Blocks are self-contained; there is no framing or checksum.
+ */
+namespace paimon::lz {
+
+// worst case size of compress() output for `size` input bytes
+size_t compressBound(size_t size);
+
+// replaces `out` with the compressed form of src[0..size)
+void compress(uint8_t const* src, size_t size, std::vector<uint8_t>& out);
+
+/**
+ * Decompresses a whole block into dst. Every length and offset is checked,
+ * so corrupt input fails instead of writing out of bounds.
+ * @return true only if the block decodes to exactly dstSize bytes
+ */
+bool decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t dstSize);
+
+} // namespace paimon::lz
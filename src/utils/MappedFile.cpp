@@ -0,0 +1,72 @@
+#include "MappedFile.hpp"
+#include <Geode/Geode.hpp>
+
+#if defined(GEODE_IS_WINDOWS) || defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<MappedFile> MappedFile::open(std::filesystem::path const& path) {
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+
+#if defined(GEODE_IS_WINDOWS) || defined(_WIN32)
+    // FILE_SHARE_WRITE: los segmentos del pack se siguen escribiendo mientras estan mapeados
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // el mapping mantiene su propia referencia al archivo
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    mf->m_mapping = mapping;
+    mf->m_data = static_cast<uint8_t const*>(view);
+    mf->m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // el mapeo sigue valido despues de cerrar el descriptor
+    ::close(fd);
+    if (addr == MAP_FAILED) return nullptr;
+
+    mf->m_data = static_cast<uint8_t const*>(addr);
+    mf->m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return mf;
+}
+
+MappedFile::~MappedFile() {
+    if (!m_data) return;
+#if defined(GEODE_IS_WINDOWS) || defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+/**
+ * MappedFile — mapeo de solo lectura de un archivo completo en memoria.
+ *
+ * Usa mmap en POSIX (Android, macOS, iOS) y CreateFileMapping en Windows.
+ * Las paginas vienen del page cache del SO sin copia intermedia; el mapeo
+ * vive mientras haya un shared_ptr, asi se puede pasar el buffer al main
+ * thread (initWithData) sin copiarlo.
+ */
+class MappedFile {
+public:
+    // devuelve nullptr si el archivo no existe, esta vacio o no se pudo mapear
+    static std::shared_ptr<MappedFile> open(std::filesystem::path const& path);
+
+    ~MappedFile();
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    uint8_t const* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile() = default;
+
+    uint8_t const* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(GEODE_IS_WINDOWS) || defined(_WIN32)
+    void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,498 @@
+#include "MemoryBudget.hpp"
+#include "Debug.hpp"
+#include "../core/Settings.hpp"
+#include <Geode/Geode.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+
+#if defined(GEODE_IS_WINDOWS)
+#include <Windows.h>
+#elif defined(GEODE_IS_MACOS) || defined(GEODE_IS_IOS)
+#include <dispatch/dispatch.h>
+#define PAIMON_OS_PRESSURE_SOURCE 1
+#endif
+
+using namespace geode::prelude;
+
+namespace paimon::memory {
+
+namespace {
+constexpr float SAMPLE_INTERVAL = 2.0f;
+constexpr double MODERATE_FACTOR = 0.6;
+constexpr double CRITICAL_FACTOR = 0.3;
+// enforce baja hasta aqui (fraccion del limite), no justo al limite
+constexpr double TRIM_LOW_WATER = 0.9;
+// fraccion de RAM libre del sistema por debajo de la cual hay presion
+constexpr double MODERATE_FREE_RATIO = 0.10;
+constexpr double CRITICAL_FREE_RATIO = 0.05;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+struct SystemMemory {
+    int64_t totalMB = 0;
+    int64_t availableMB = 0;
+    bool osLow = false; // el SO ya marco memoria baja
+};
+
+// lee archivos / llama al SO: solo desde un worker
+std::optional<SystemMemory> querySystemMemory() {
+#if defined(GEODE_IS_WINDOWS)
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) return std::nullopt;
+    SystemMemory mem{
+        static_cast<int64_t>(status.ullTotalPhys / (1024 * 1024)),
+        static_cast<int64_t>(status.ullAvailPhys / (1024 * 1024))
+    };
+    // el mismo umbral que usa el SO para avisar a sus propios caches
+    static HANDLE lowNotification = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+    BOOL low = FALSE;
+    if (lowNotification && QueryMemoryResourceNotification(lowNotification, &low)) mem.osLow = low != FALSE;
+    return mem;
+#elif defined(GEODE_IS_ANDROID) || defined(__linux__)
+    std::ifstream in("/proc/meminfo");
+    if (!in) return std::nullopt;
+    SystemMemory mem;
+    bool hasTotal = false, hasAvail = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        long long kb = 0;
+        if (std::sscanf(line.c_str(), "MemTotal: %lld kB", &kb) == 1) { mem.totalMB = kb / 1024; hasTotal = true; }
+        else if (std::sscanf(line.c_str(), "MemAvailable: %lld kB", &kb) == 1) { mem.availableMB = kb / 1024; hasAvail = true; }
+        if (hasTotal && hasAvail) return mem;
+    }
+    return std::nullopt;
+#else
+    // mac/iOS: sin un "disponible" fiable sin APIs de mach; avisa el dispatch source
+    return std::nullopt;
+#endif
+}
+
+double pressureFactor(MemoryPressure level) {
+    switch (level) {
+        case MemoryPressure::Moderate: return MODERATE_FACTOR;
+        case MemoryPressure::Critical: return CRITICAL_FACTOR;
+        default:                       return 1.0;
+    }
+}
+
+char const* pressureName(MemoryPressure level) {
+    switch (level) {
+        case MemoryPressure::Moderate: return "moderate";
+        case MemoryPressure::Critical: return "critical";
+        default:                       return "none";
+    }
+}
+
+double gdsfPriority(double inflation, uint32_t freq, double cost, size_t bytes) {
+    double mb = std::max(static_cast<double>(bytes) / BYTES_PER_MB, 1.0 / 64.0);
+    return inflation + static_cast<double>(freq) * cost / mb;
+}
+} // namespace
+
+// nodo suelto en el scheduler que muestrea la RAM del sistema
+class MemoryPressureTicker : public CCNode {
+public:
+    static MemoryPressureTicker* create() {
+        auto* ret = new MemoryPressureTicker();
+        if (ret && ret->init()) { ret->autorelease(); return ret; }
+        CC_SAFE_DELETE(ret);
+        return nullptr;
+    }
+
+    void start() {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(
+            schedule_selector(MemoryPressureTicker::onTick), this, SAMPLE_INTERVAL, kCCRepeatForever, 0.0f, false);
+    }
+
+    void stop() {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(
+            schedule_selector(MemoryPressureTicker::onTick), this);
+    }
+
+private:
+    void onTick(float) {
+        MemoryBudget::get().samplePressure();
+    }
+};
+
+namespace {
+// retenido para siempre, igual que el ticker de TextureUploadQueue
+MemoryPressureTicker* s_ticker = nullptr;
+
+#ifdef PAIMON_OS_PRESSURE_SOURCE
+dispatch_source_t s_pressureSource = nullptr;
+
+// en una cola de GCD: solo traduce el nivel y salta al main thread
+void onOsMemoryPressure(void*) {
+    auto flags = dispatch_source_get_data(s_pressureSource);
+    MemoryPressure level = MemoryPressure::None;
+    if (flags & DISPATCH_MEMORYPRESSURE_CRITICAL) level = MemoryPressure::Critical;
+    else if (flags & DISPATCH_MEMORYPRESSURE_WARN) level = MemoryPressure::Moderate;
+    Loader::get()->queueInMainThread([level]() {
+        MemoryBudget::get().onMemoryPressure(level);
+    });
+}
+
+void startOsPressureSource() {
+    if (s_pressureSource) return;
+    s_pressureSource = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+        DISPATCH_MEMORYPRESSURE_NORMAL | DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+        dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    if (!s_pressureSource) return;
+    dispatch_source_set_event_handler_f(s_pressureSource, onOsMemoryPressure);
+    dispatch_resume(s_pressureSource);
+}
+
+void stopOsPressureSource() {
+    if (!s_pressureSource) return;
+    dispatch_source_cancel(s_pressureSource);
+}
+#endif
+}
+
+MemoryBudget& MemoryBudget::get() {
+    static MemoryBudget instance;
+    return instance;
+}
+
+MemoryBudget::SourceId MemoryBudget::registerSource(std::string name, EvictFn evict) {
+    SourceId id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto src = std::make_unique<Source>();
+        src->name = std::move(name);
+        src->evict = std::move(evict);
+        m_sources.push_back(std::move(src));
+        id = static_cast<SourceId>(m_sources.size() - 1);
+    }
+    // el presupuesto lee settings y el ticker toca el scheduler: main thread
+    if (!m_armed.exchange(true, std::memory_order_acq_rel)) {
+        Loader::get()->queueInMainThread([this]() { arm(); });
+    }
+    return id;
+}
+
+void MemoryBudget::setSampleExecutor(Executor executor) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sampleExecutor = std::move(executor);
+}
+
+MemoryBudget::Source* MemoryBudget::sourceLocked(SourceId id) const {
+    if (id < 0 || static_cast<size_t>(id) >= m_sources.size()) return nullptr;
+    return m_sources[static_cast<size_t>(id)].get();
+}
+
+void MemoryBudget::heapInsertLocked(Source& src, std::string const& key, Entry const& e) {
+    if (e.evicting || e.bytes == 0 || src.pinned.count(key)) return;
+    m_heap.insert(HeapNode{e.priority, e.seq, &src, &key});
+}
+
+void MemoryBudget::heapEraseLocked(Entry const& e) {
+    // seq es unico, con (H, seq) alcanza para encontrar el nodo
+    m_heap.erase(HeapNode{e.priority, e.seq, nullptr, nullptr});
+}
+
+void MemoryBudget::touch(SourceId id, std::string const& key, size_t bytes, double cost) {
+    bool over = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto* src = sourceLocked(id);
+        if (!src) return;
+
+        auto [it, inserted] = src->entries.try_emplace(key);
+        auto& e = it->second;
+        if (!inserted) {
+            src->hits++;
+            heapEraseLocked(e);
+        }
+        // el tamaño puede cambiar (re-subida con otra calidad): ajusto la suma
+        src->bytes = src->bytes - e.bytes + bytes;
+        m_used = m_used - e.bytes + bytes;
+        m_peak = std::max(m_peak, m_used);
+
+        e.bytes = bytes;
+        e.cost = std::max(cost, 0.01);
+        e.freq++;
+        e.priority = gdsfPriority(m_inflation, e.freq, e.cost, e.bytes);
+        e.seq = ++m_seq;
+        heapInsertLocked(*src, it->first, e);
+        over = m_budget > 0 && m_used > m_budget;
+    }
+    if (over) requestEnforce();
+}
+
+void MemoryBudget::forget(SourceId id, std::string const& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* src = sourceLocked(id);
+    if (!src) return;
+    auto it = src->entries.find(key);
+    if (it == src->entries.end()) return;
+    heapEraseLocked(it->second);
+    src->bytes -= std::min(src->bytes, it->second.bytes);
+    m_used -= std::min(m_used, it->second.bytes);
+    src->entries.erase(it);
+}
+
+void MemoryBudget::forgetAll(SourceId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* src = sourceLocked(id);
+    if (!src) return;
+    for (auto const& [key, e] : src->entries) heapEraseLocked(e);
+    m_used -= std::min(m_used, src->bytes);
+    src->bytes = 0;
+    src->entries.clear();
+    src->pinned.clear();
+}
+
+void MemoryBudget::pin(SourceId id, std::string const& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* src = sourceLocked(id);
+    if (!src || !src->pinned.insert(key).second) return;
+    if (auto it = src->entries.find(key); it != src->entries.end()) heapEraseLocked(it->second);
+}
+
+void MemoryBudget::unpin(SourceId id, std::string const& key) {
+    bool over = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto* src = sourceLocked(id);
+        if (!src || !src->pinned.erase(key)) return;
+        if (auto it = src->entries.find(key); it != src->entries.end()) heapInsertLocked(*src, it->first, it->second);
+        over = m_budget > 0 && m_used > m_budget;
+    }
+    if (over) requestEnforce();
+}
+
+void MemoryBudget::requestEnforce() {
+    if (m_shutdown.load(std::memory_order_acquire)) return;
+    if (m_enforceQueued.exchange(true, std::memory_order_acq_rel)) return;
+    Loader::get()->queueInMainThread([this]() {
+        m_enforceQueued.store(false, std::memory_order_release);
+        enforce();
+    });
+}
+
+void MemoryBudget::enforce() {
+    if (m_shutdown.load(std::memory_order_acquire)) return;
+    size_t target;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_budget == 0) return;
+        auto limit = static_cast<double>(m_budget) * pressureFactor(m_pressure);
+        if (static_cast<double>(m_used) <= limit) return;
+        m_enforceRuns++;
+        target = static_cast<size_t>(limit * TRIM_LOW_WATER);
+    }
+    trimTo(target);
+}
+
+void MemoryBudget::trimTo(size_t target) {
+    // de a una y siempre la de H mas bajo del heap: el lock se suelta para el
+    // callback (el cache suelta la entrada y puede llamar forget()). Las que
+    // se niegan vuelven al heap al final, si no saldrian otra vez enseguida
+    std::vector<Victim> refused;
+    size_t evicted = 0;
+    size_t freed = 0;
+    while (true) {
+        Victim v{};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_used <= target || m_heap.empty()) break;
+            auto node = m_heap.begin();
+            v = Victim{node->source, *node->key, node->priority, 0, node->seq};
+            m_heap.erase(node);
+            auto it = v.source->entries.find(v.key);
+            if (it == v.source->entries.end()) continue;
+            it->second.evicting = true;
+            v.bytes = it->second.bytes;
+        }
+
+        bool gone = v.source->evict ? v.source->evict(v.key) : false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = v.source->entries.find(v.key);
+        if (!gone) {
+            if (it != v.source->entries.end()) {
+                it->second.evicting = false;
+                refused.push_back(std::move(v));
+            }
+            continue;
+        }
+        // si forget() ya la quito (o volvio a entrar nueva) no la descuento otra vez
+        if (it != v.source->entries.end() && it->second.evicting) {
+            v.source->bytes -= std::min(v.source->bytes, it->second.bytes);
+            m_used -= std::min(m_used, it->second.bytes);
+            v.source->entries.erase(it);
+        }
+        v.source->evictions++;
+        v.source->evictedBytes += v.bytes;
+        m_inflation = std::max(m_inflation, v.priority);
+        evicted++;
+        freed += v.bytes;
+    }
+
+    if (!refused.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const& v : refused) {
+            auto it = v.source->entries.find(v.key);
+            if (it != v.source->entries.end()) heapInsertLocked(*v.source, it->first, it->second);
+        }
+    }
+
+    if (evicted > 0) {
+        PaimonDebug::log("[MemoryBudget] evicted {} entries ({:.1f} MB) to reach {:.1f} MB",
+            evicted, freed / BYTES_PER_MB, target / BYTES_PER_MB);
+    }
+}
+
+void MemoryBudget::onMemoryPressure(MemoryPressure level) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pressure = level;
+        if (level != MemoryPressure::None) m_pressureTrims++;
+    }
+    if (level != MemoryPressure::None) {
+        log::info("[MemoryBudget] memory pressure: {} ({:.1f} MB in image caches)",
+            pressureName(level), usedBytes() / BYTES_PER_MB);
+    }
+    enforce();
+}
+
+void MemoryBudget::samplePressure() {
+    if (m_shutdown.load(std::memory_order_acquire)) return;
+    Executor executor;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        executor = m_sampleExecutor;
+    }
+    // leer /proc/meminfo en el main thread mete tirones: sin worker no se muestrea
+    if (!executor) return;
+    if (m_sampleInFlight.exchange(true, std::memory_order_acq_rel)) return;
+
+    bool queued = executor([this]() {
+        auto mem = querySystemMemory();
+        Loader::get()->queueInMainThread([this, mem]() {
+            m_sampleInFlight.store(false, std::memory_order_release);
+            if (!mem) return;
+            applySample(mem->totalMB, mem->availableMB, mem->osLow);
+        });
+    });
+    if (!queued) m_sampleInFlight.store(false, std::memory_order_release);
+}
+
+void MemoryBudget::applySample(int64_t totalMB, int64_t availableMB, bool osLow) {
+    if (m_shutdown.load(std::memory_order_acquire)) return;
+    MemoryPressure level = MemoryPressure::None;
+    MemoryPressure previous;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        previous = m_pressure;
+        if (totalMB > 0) {
+            m_systemTotalMB = totalMB;
+            m_systemAvailableMB = availableMB;
+            // en equipos con poca RAM, nunca mas de 1/8 de la fisica
+            m_budget = std::min(m_budget, static_cast<size_t>(totalMB) * 1024 * 1024 / 8);
+            double freeRatio = static_cast<double>(availableMB) / static_cast<double>(totalMB);
+            if (freeRatio < CRITICAL_FREE_RATIO) level = MemoryPressure::Critical;
+            else if (freeRatio < MODERATE_FREE_RATIO) level = MemoryPressure::Moderate;
+        }
+        if (osLow && level == MemoryPressure::None) level = MemoryPressure::Moderate;
+    }
+
+    if (level != previous) {
+        onMemoryPressure(level);
+    } else {
+        // sigue apretado (o bajo el tope de 1/8): lo que entro desde el ultimo
+        // muestreo tambien se recorta; si no pasa del limite no hace nada
+        enforce();
+    }
+}
+
+void MemoryBudget::arm() {
+    size_t budget = paimon::settings::quality::memoryBudgetBytes();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budget = budget;
+    }
+    PaimonDebug::log("[MemoryBudget] budget {:.0f} MB", budget / BYTES_PER_MB);
+
+#ifdef PAIMON_OS_PRESSURE_SOURCE
+    // el SO avisa cuando cambia el nivel, no hace falta muestrear
+    startOsPressureSource();
+#else
+    if (!s_ticker) {
+        s_ticker = MemoryPressureTicker::create();
+        if (!s_ticker) return;
+        s_ticker->retain();
+    }
+    s_ticker->start();
+    // el primer muestreo ya pone el tope de 1/8 de la RAM fisica
+    samplePressure();
+#endif
+    enforce();
+}
+
+void MemoryBudget::shutdown() {
+    m_shutdown.store(true, std::memory_order_release);
+    if (s_ticker) s_ticker->stop();
+#ifdef PAIMON_OS_PRESSURE_SOURCE
+    stopOsPressureSource();
+#endif
+}
+
+size_t MemoryBudget::budgetBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+size_t MemoryBudget::usedBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_used;
+}
+
+MemoryBudget::Stats MemoryBudget::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.budgetBytes = m_budget;
+    s.usedBytes = m_used;
+    s.peakBytes = m_peak;
+    s.pressure = m_pressure;
+    s.enforceRuns = m_enforceRuns;
+    s.pressureTrims = m_pressureTrims;
+    s.inflation = m_inflation;
+    s.systemAvailableMB = m_systemAvailableMB;
+    s.systemTotalMB = m_systemTotalMB;
+    for (auto const& src : m_sources) {
+        SourceStats ss;
+        ss.name = src->name;
+        ss.entries = src->entries.size();
+        ss.bytes = src->bytes;
+        for (auto const& key : src->pinned) {
+            if (auto it = src->entries.find(key); it != src->entries.end()) ss.pinnedBytes += it->second.bytes;
+        }
+        ss.hits = src->hits;
+        ss.evictions = src->evictions;
+        ss.evictedBytes = src->evictedBytes;
+        s.sources.push_back(std::move(ss));
+    }
+    return s;
+}
+
+std::string MemoryBudget::dump() const {
+    auto s = stats();
+    std::string out = fmt::format(
+        "budget {:.1f} MB, used {:.1f} MB (peak {:.1f}), pressure {}, system {}/{} MB free, {} trims, L={:.2f}",
+        s.budgetBytes / BYTES_PER_MB, s.usedBytes / BYTES_PER_MB, s.peakBytes / BYTES_PER_MB,
+        pressureName(s.pressure), s.systemAvailableMB, s.systemTotalMB, s.pressureTrims, s.inflation);
+    for (auto const& src : s.sources) {
+        out += fmt::format("\n  {:<12} {:>4} entries {:>7.1f} MB ({:.1f} pinned), {} hits, {} evicted ({:.1f} MB)",
+            src.name, src.entries, src.bytes / BYTES_PER_MB, src.pinnedBytes / BYTES_PER_MB,
+            src.hits, src.evictions, src.evictedBytes / BYTES_PER_MB);
+    }
+    return out;
+}
+
+} // namespace paimon::memory
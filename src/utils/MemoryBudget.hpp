@@ -0,0 +1,184 @@
+#pragma once
+
+#include <Geode/utils/function.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * MemoryBudget — un solo presupuesto de RAM para todos los caches de imagen.
+ *
+ * Cada cache (thumbnails, URLs de galeria, GIFs, perfiles) sigue con su
+ * propio limite como techo, pero ademas se registra aqui y avisa de cada
+ * entrada con touch(bytes, coste): el coste es lo que cuesta reconstruirla
+ * (1 = volver a decodificar un thumbnail estatico del disco). Cuando la suma
+ * pasa del presupuesto se saca lo que menos vale entre TODOS los caches con
+ * GDSF: H = L + frecuencia * coste / MB, se evicta el H mas bajo y L sube al
+ * H del evictado (asi lo viejo envejece sin recorrer nada). Las entradas
+ * evictables viven en un set ordenado por H que touch()/forget() mantienen,
+ * asi enforce() solo mira las que saca. Recorta hasta un poco por debajo del
+ * limite para que los touch siguientes no vuelvan a disparar otro enforce.
+ *
+ * - touch()/forget()/pin() son thread-safe y baratos.
+ * - La eviccion corre siempre en el main thread (los callbacks sueltan
+ *   texturas) y fuera del lock, asi los caches pueden llamar forget() desde
+ *   su propio camino de borrado sin deadlock. Orden permitido: lock del
+ *   cache -> lock del presupuesto, nunca al reves.
+ * - Las entradas pineadas (pinGIF) no se tocan.
+ * - Presion de memoria del sistema recorta por debajo del presupuesto. En
+ *   mac/iOS la avisa el SO (dispatch source de memory pressure); en Windows y
+ *   Android se muestrea cada 2s en un worker (setSampleExecutor), nunca en el
+ *   main thread. En movil pasar a segundo plano cuenta como presion moderada.
+ */
+namespace paimon::memory {
+
+enum class MemoryPressure {
+    None,
+    Moderate, // recorta al ~60% del presupuesto
+    Critical, // recorta al ~30%
+};
+
+class MemoryBudget {
+public:
+    using SourceId = int;
+    // true = la entrada ya no esta en el cache (evictada o ya no existia);
+    // false = no se pudo soltar ahora, se sigue contando
+    using EvictFn = geode::Function<bool(std::string const& key)>;
+    // encola un job fuera del main thread; false si no se pudo
+    using Executor = std::function<bool(std::function<void()>)>;
+
+    struct SourceStats {
+        std::string name;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t pinnedBytes = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;
+    };
+
+    struct Stats {
+        size_t budgetBytes = 0;
+        size_t usedBytes = 0;
+        size_t peakBytes = 0;
+        MemoryPressure pressure = MemoryPressure::None;
+        uint64_t enforceRuns = 0;
+        uint64_t pressureTrims = 0;
+        double inflation = 0;            // L de GDSF
+        int64_t systemAvailableMB = -1;  // -1 si la plataforma no lo expone
+        int64_t systemTotalMB = -1;
+        std::vector<SourceStats> sources;
+    };
+
+    static MemoryBudget& get();
+
+    SourceId registerSource(std::string name, EvictFn evict);
+    // donde corre la lectura de memoria del sistema; sin executor no se muestrea
+    void setSampleExecutor(Executor executor);
+
+    // alta o hit: sube la frecuencia y recalcula H
+    void touch(SourceId id, std::string const& key, size_t bytes, double cost);
+    void forget(SourceId id, std::string const& key);
+    void forgetAll(SourceId id);
+    void pin(SourceId id, std::string const& key);
+    void unpin(SourceId id, std::string const& key);
+
+    // desde cualquier hilo; se junta en un solo enforce() en el main thread
+    void requestEnforce();
+    // main thread
+    void enforce();
+    void onMemoryPressure(MemoryPressure level);
+    // cierre: deja de evictar y de muestrear
+    void shutdown();
+
+    size_t budgetBytes() const;
+    size_t usedBytes() const;
+    Stats stats() const;
+    std::string dump() const;
+
+private:
+    MemoryBudget() = default;
+
+    struct Entry {
+        size_t bytes = 0;
+        double cost = 1.0;
+        uint32_t freq = 0;
+        double priority = 0; // H
+        uint64_t seq = 0;    // desempate: el mas viejo primero
+        bool evicting = false;
+    };
+
+    struct Source {
+        std::string name;
+        EvictFn evict;
+        std::unordered_map<std::string, Entry> entries;
+        std::unordered_set<std::string> pinned;
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;
+    };
+
+    struct Victim {
+        Source* source;
+        std::string key;
+        double priority;
+        size_t bytes;
+        uint64_t seq;
+    };
+
+    // entrada evictable en el orden de GDSF; key apunta a la clave del mapa de
+    // su Source (los nodos de unordered_map no se mueven)
+    struct HeapNode {
+        double priority;
+        uint64_t seq;
+        Source* source;
+        std::string const* key;
+        bool operator<(HeapNode const& o) const {
+            if (priority != o.priority) return priority < o.priority;
+            return seq < o.seq;
+        }
+    };
+
+    Source* sourceLocked(SourceId id) const;
+    // mete la entrada en m_heap si se puede evictar (no pineada ni en eviccion)
+    void heapInsertLocked(Source& src, std::string const& key, Entry const& e);
+    void heapEraseLocked(Entry const& e);
+    void trimTo(size_t target);
+    void samplePressure();
+    // main thread, con lo que leyo el worker (-1 = la plataforma no lo expone)
+    void applySample(int64_t totalMB, int64_t availableMB, bool osLow);
+    void arm();
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Source>> m_sources; // punteros estables: los callbacks corren sin lock
+    std::set<HeapNode> m_heap;
+    Executor m_sampleExecutor;
+    size_t m_used = 0;
+    size_t m_peak = 0;
+    size_t m_budget = 0;
+    double m_inflation = 0;
+    uint64_t m_seq = 0;
+    uint64_t m_enforceRuns = 0;
+    uint64_t m_pressureTrims = 0;
+    MemoryPressure m_pressure = MemoryPressure::None;
+    int64_t m_systemAvailableMB = -1;
+    int64_t m_systemTotalMB = -1;
+
+    std::atomic<bool> m_enforceQueued{false};
+    std::atomic<bool> m_sampleInFlight{false};
+    std::atomic<bool> m_armed{false};
+    std::atomic<bool> m_shutdown{false};
+
+    friend class MemoryPressureTicker;
+};
+
+} // namespace paimon::memory
@@ -49,6 +49,18 @@ public:
         return nullptr;
     }
 
+    // sub-rect (en puntos) de una textura compartida, p.ej. una pagina de atlas
+    static PaimonShaderSprite* createWithTexture(CCTexture2D* texture, CCRect const& rect) {
+        auto sprite = new PaimonShaderSprite();
+        if (sprite && sprite->initWithTexture(texture, rect)) {
+            sprite->autorelease();
+            sprite->setID("paimon-shader-sprite"_spr);
+            return sprite;
+        }
+        CC_SAFE_DELETE(sprite);
+        return nullptr;
+    }
+
     void draw() override {
         CC_NODE_DRAW_SETUP();
 
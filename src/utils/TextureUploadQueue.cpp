@@ -0,0 +1,156 @@
+#include "TextureUploadQueue.hpp"
+#include "Debug.hpp"
+#include "../core/Settings.hpp"
+#include <Geode/Geode.hpp>
+#include <algorithm>
+#include <optional>
+
+using namespace geode::prelude;
+
+namespace paimon::image {
+
+// nodo suelto registrado directo en el scheduler (no vive en ninguna escena)
+class TextureUploadTicker : public CCNode {
+public:
+    static TextureUploadTicker* create() {
+        auto* ret = new TextureUploadTicker();
+        if (ret && ret->init()) { ret->autorelease(); return ret; }
+        CC_SAFE_DELETE(ret);
+        return nullptr;
+    }
+
+    void start() {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(
+            schedule_selector(TextureUploadTicker::onTick), this, 0.0f, kCCRepeatForever, 0.0f, false);
+    }
+
+    void stop() {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(
+            schedule_selector(TextureUploadTicker::onTick), this);
+    }
+
+private:
+    void onTick(float) {
+        TextureUploadQueue::get().tick();
+    }
+};
+
+namespace {
+// retenido para siempre: no quiero que se destruya en la destruccion estatica
+TextureUploadTicker* s_ticker = nullptr;
+}
+
+TextureUploadQueue& TextureUploadQueue::get() {
+    static TextureUploadQueue instance;
+    return instance;
+}
+
+void TextureUploadQueue::post(int priority, Job job) {
+    bool needsArm = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_heap.push_back(Entry{priority, m_nextSeq++, std::move(job)});
+        std::push_heap(m_heap.begin(), m_heap.end(), lowerPriority);
+        m_stats.peakDepth = std::max(m_stats.peakDepth, m_heap.size());
+        needsArm = !m_armed;
+        m_armed = true;
+    }
+    // el scheduler solo se toca desde el main thread
+    if (needsArm) {
+        Loader::get()->queueInMainThread([this]() { arm(); });
+    }
+}
+
+void TextureUploadQueue::arm() {
+    // el presupuesto se relee una vez por rafaga, no cada frame
+    m_budgetMs = static_cast<float>(std::clamp(paimon::settings::thumbnails::uploadBudgetMs(), 0.5, 16.0));
+    if (!s_ticker) {
+        s_ticker = TextureUploadTicker::create();
+        if (!s_ticker) return;
+        s_ticker->retain();
+    }
+    s_ticker->start();
+}
+
+void TextureUploadQueue::tick() {
+    auto start = Clock::now();
+    auto budget = std::chrono::duration<double, std::milli>(m_budgetMs);
+    uint64_t ran = 0;
+
+    while (true) {
+        std::optional<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_heap.empty()) break;
+            std::pop_heap(m_heap.begin(), m_heap.end(), lowerPriority);
+            entry.emplace(std::move(m_heap.back()));
+            m_heap.pop_back();
+        }
+        // fuera del lock: el job puede volver a encolar
+        entry->job();
+        ran++;
+        if (Clock::now() - start >= budget) break;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    bool drained = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ran > 0) {
+            m_stats.lastFrameMs = ms;
+            m_stats.maxFrameMs = std::max(m_stats.maxFrameMs, ms);
+            m_stats.uploads += ran;
+            m_stats.frames++;
+            if (ms > m_budgetMs) m_stats.overBudgetFrames++;
+        }
+        m_stats.depth = m_heap.size();
+        m_stats.budgetMs = m_budgetMs;
+        if (m_heap.empty()) {
+            // bajo el mismo lock que post(): un post posterior vuelve a armar
+            m_armed = false;
+            drained = true;
+        }
+    }
+    if (ran > 0) {
+        m_burstFrameMs.push_back(static_cast<float>(ms));
+        m_burstUploads += ran;
+    }
+    if (drained) {
+        if (s_ticker) s_ticker->stop();
+        endBurst();
+    }
+}
+
+void TextureUploadQueue::endBurst() {
+    if (m_burstFrameMs.empty()) return;
+
+    auto frames = m_burstFrameMs;
+    std::sort(frames.begin(), frames.end());
+    float p50 = frames[frames.size() / 2];
+    float worst = frames.back();
+    size_t peak = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        peak = m_stats.peakDepth;
+        m_stats.peakDepth = m_heap.size();
+    }
+    PaimonDebug::log("[TextureUploadQueue] rafaga: {} subidas en {} frames, ms/frame p50={:.2f} max={:.2f} (presupuesto {:.1f}), cola max={}",
+        m_burstUploads, frames.size(), p50, worst, m_budgetMs, peak);
+
+    m_burstFrameMs.clear();
+    m_burstUploads = 0;
+}
+
+size_t TextureUploadQueue::depth() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_heap.size();
+}
+
+TextureUploadQueue::Stats TextureUploadQueue::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s = m_stats;
+    s.depth = m_heap.size();
+    return s;
+}
+
+} // namespace paimon::image
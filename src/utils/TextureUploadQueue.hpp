@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Geode/utils/function.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * TextureUploadQueue — subidas a GPU repartidas entre frames.
+ *
+ * Los workers dejan aqui el trabajo de main thread que crea texturas
+ * (new CCTexture2D + initWithData) en vez de mandarlo con queueInMainThread.
+ * Cada frame se ejecutan jobs por orden de prioridad (mayor primero, FIFO en
+ * empate) hasta gastar el presupuesto en ms ("texture-upload-budget-ms");
+ * siempre corre al menos uno para que la cola avance aunque un job solo se
+ * coma el presupuesto. Asi 20 descargas que terminan juntas se reparten en
+ * varios frames en lugar de trabar la lista en uno.
+ *
+ * post() es thread-safe; los jobs corren en el main thread y pueden volver a
+ * encolar (p.ej. el siguiente frame de un GIF).
+ */
+namespace paimon::image {
+
+class TextureUploadQueue {
+public:
+    using Job = geode::Function<void()>;
+
+    struct Stats {
+        float budgetMs = 0;
+        size_t depth = 0;             // jobs en cola ahora mismo
+        size_t peakDepth = 0;         // maximo de la rafaga actual/ultima
+        double lastFrameMs = 0;       // ms de subida del ultimo frame con trabajo
+        double maxFrameMs = 0;        // peor frame desde el arranque
+        uint64_t uploads = 0;
+        uint64_t frames = 0;          // frames con al menos una subida
+        uint64_t overBudgetFrames = 0;
+    };
+
+    static TextureUploadQueue& get();
+
+    void post(int priority, Job job);
+
+    size_t depth() const;
+    Stats stats() const;
+
+private:
+    TextureUploadQueue() = default;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        int priority;
+        uint64_t seq;
+        Job job;
+    };
+    static bool lowerPriority(Entry const& a, Entry const& b) {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.seq > b.seq;
+    }
+
+    void arm();
+    void tick();
+    void endBurst();
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_heap; // max-heap con lowerPriority
+    uint64_t m_nextSeq = 0;
+    bool m_armed = false;      // tick registrado (o a punto) en el scheduler
+    Stats m_stats;             // tambien bajo m_mutex: stats() se lee desde cualquier hilo
+
+    // solo main thread
+    float m_budgetMs = 2.0f;
+    std::vector<float> m_burstFrameMs;
+    uint64_t m_burstUploads = 0;
+
+    friend class TextureUploadTicker;
+};
+
+} // namespace paimon::image
@@ -4,19 +4,156 @@
 #include <Geode/utils/web.hpp>
 #include <Geode/utils/async.hpp>
 #include <Geode/utils/function.hpp>
+#include <arc/future/Future.hpp>
 #include <string>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <memory>
+#include <vector>
 
 /**
  * WebHelper — Centralized async web dispatch for Paimbnails.
  *
  * Uses Geode v5 native async::spawn + WebFuture for non-blocking requests.
  * The callback is guaranteed to run on the main (Cocos2d-x) thread.
+ *
+ * dispatchOffMain() additionally runs a transform (parse, validate, copy) on
+ * the async runtime and only hands the typed result to the main thread.
  */
 namespace WebHelper {
 
+// A piece of work posted back to the main thread once a response is handled.
+using MainStep = geode::CopyableFunction<void()>;
+
+/**
+ * Response handler that runs off the main thread. Whatever it returns runs
+ * afterwards on the main thread (an empty step means nothing left to do).
+ */
+template <class Payload>
+using OffMainHandler = geode::CopyableFunction<MainStep(bool success, Payload const& payload)>;
+
+// ── Main-thread time per response ───────────────────────────────────
+
+enum class Delivery {
+    Inline,   // dispatch(): the whole callback runs on the main thread
+    OffMain,  // dispatchOffMain(): only the typed result reaches it
+};
+
+struct MainThreadStats {
+    uint64_t responses = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+    double meanMs() const { return responses ? totalMs / responses : 0; }
+};
+
+namespace detail {
+    struct MainThreadCounters {
+        std::atomic<uint64_t> responses{0};
+        std::atomic<uint64_t> totalUs{0};
+        std::atomic<uint64_t> maxUs{0};
+    };
+
+    inline MainThreadCounters& counters(Delivery kind) {
+        static MainThreadCounters inlineCounters;
+        static MainThreadCounters offMainCounters;
+        return kind == Delivery::Inline ? inlineCounters : offMainCounters;
+    }
+
+    // Times a main-thread callback and adds it to the counters of `kind`.
+    template <class F>
+    void timeOnMain(Delivery kind, F&& fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+        auto& c = counters(kind);
+        c.responses.fetch_add(1, std::memory_order_relaxed);
+        c.totalUs.fetch_add(us, std::memory_order_relaxed);
+        uint64_t prev = c.maxUs.load(std::memory_order_relaxed);
+        while (us > prev && !c.maxUs.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+    }
+}
+
+inline MainThreadStats mainThreadStats(Delivery kind) {
+    auto& c = detail::counters(kind);
+    MainThreadStats st;
+    st.responses = c.responses.load(std::memory_order_relaxed);
+    st.totalMs = c.totalUs.load(std::memory_order_relaxed) / 1000.0;
+    st.maxMs = c.maxUs.load(std::memory_order_relaxed) / 1000.0;
+    return st;
+}
+
+// ── Handler adapters ────────────────────────────────────────────────
+
+/**
+ * Wraps a regular main-thread callback as an OffMainHandler. The payload is
+ * copied off the main thread; the callback itself still runs on it.
+ */
+template <class Payload>
+OffMainHandler<Payload> onMain(geode::CopyableFunction<void(bool, Payload const&)> cb) {
+    return [cb = std::move(cb)](bool success, Payload const& payload) -> MainStep {
+        if (!cb) return {};
+        return [cb, success, payload]() { cb(success, payload); };
+    };
+}
+
+/**
+ * `parse` runs off the main thread; only its result is passed to `done` on
+ * the main thread.
+ */
+template <class T, class Payload = std::string>
+OffMainHandler<Payload> parseThen(
+    geode::CopyableFunction<T(bool, Payload const&)> parse,
+    geode::CopyableFunction<void(T)> done
+) {
+    return [parse = std::move(parse), done = std::move(done)](bool success, Payload const& payload) -> MainStep {
+        auto result = std::make_shared<T>(parse(success, payload));
+        return [done, result]() {
+            if (done) done(std::move(*result));
+        };
+    };
+}
+
+// ── Conditional requests ────────────────────────────────────────────
+
+/**
+ * Binary response plus what a later revalidation needs. `status` is 304 when
+ * the server confirmed the caller's cached copy; `data` is empty then.
+ */
+struct BinaryResponse {
+    int status = 0;
+    std::vector<uint8_t> data;
+    std::string validator;  // see validatorOf()
+};
+
+// The response's ETag, or "lm:" + Last-Modified when the server only sends
+// the date. Empty if it sends neither.
+inline std::string validatorOf(geode::utils::web::WebResponse& res) {
+    if (auto etag = res.header("ETag"); etag.has_value() && !etag->empty()) {
+        return std::string(etag.value());
+    }
+    if (auto modified = res.header("Last-Modified"); modified.has_value() && !modified->empty()) {
+        return "lm:" + std::string(modified.value());
+    }
+    return {};
+}
+
+// Headers that turn a GET into a revalidation of a stored validator.
+inline std::vector<std::string> conditionalHeaders(std::string const& validator) {
+    if (validator.empty()) return {};
+    if (validator.starts_with("lm:")) return { "If-Modified-Since: " + validator.substr(3) };
+    return { "If-None-Match: " + validator };
+}
+
+// Adapts a bytes-only handler; a 304 reaches it as a plain failure.
+inline OffMainHandler<BinaryResponse> bytesOnly(OffMainHandler<std::vector<uint8_t>> handler) {
+    return [handler = std::move(handler)](bool success, BinaryResponse const& res) -> MainStep {
+        return handler ? handler(success, res.data) : MainStep{};
+    };
+}
+
 inline std::string normalizeMethod(std::string method) {
     std::transform(
         method.begin(),
@@ -48,12 +185,72 @@ inline void dispatch(
 
     auto handle = geode::async::spawn(std::move(future), [safeCb](geode::utils::web::WebResponse res) {
         if (safeCb && *safeCb) {
-            (*safeCb)(std::move(res));
+            detail::timeOnMain(Delivery::Inline, [&] { (*safeCb)(std::move(res)); });
         }
     });
     handle.setName("Paimbnails WebRequest");
 }
 
+/**
+ * Like dispatch(), but `transform` runs on the async runtime as soon as the
+ * response arrives; only its result is posted to `cb` on the main thread.
+ *
+ * @param transform Parses/validates/copies the response. Must not touch
+ *                  Cocos objects.
+ * @param cb        Receives the transform's result on the main thread.
+ */
+template <class T>
+void dispatchOffMain(
+    geode::utils::web::WebRequest&& req,
+    std::string const& method,
+    std::string const& url,
+    geode::CopyableFunction<T(geode::utils::web::WebResponse&)> transform,
+    geode::CopyableFunction<void(T)> cb
+) {
+    auto future = req.send(normalizeMethod(method), url);
+
+    // parametros (no capturas) para que vivan en el frame de la corutina
+    auto work = [](auto future, auto transform) -> arc::Future<T> {
+        auto res = co_await std::move(future);
+        co_return transform(res);
+    }(std::move(future), std::move(transform));
+
+    auto safeCb = std::make_shared<decltype(cb)>(std::move(cb));
+    auto handle = geode::async::spawn(std::move(work), [safeCb](T result) {
+        if (safeCb && *safeCb) {
+            detail::timeOnMain(Delivery::OffMain, [&] { (*safeCb)(std::move(result)); });
+        }
+    });
+    handle.setName("Paimbnails WebRequest");
+}
+
+/**
+ * Runs `work` on the async runtime and hands its result to `cb` on the main
+ * thread. For responses that never hit the network (e.g. memoized ones) but
+ * still go through an OffMainHandler.
+ */
+template <class T>
+void runOffMain(geode::CopyableFunction<T()> work, geode::CopyableFunction<void(T)> cb) {
+    auto task = [](auto work) -> arc::Future<T> {
+        co_return work();
+    }(std::move(work));
+
+    auto safeCb = std::make_shared<decltype(cb)>(std::move(cb));
+    auto handle = geode::async::spawn(std::move(task), [safeCb](T result) {
+        if (safeCb && *safeCb) {
+            detail::timeOnMain(Delivery::OffMain, [&] { (*safeCb)(std::move(result)); });
+        }
+    });
+    handle.setName("Paimbnails OffMain");
+}
+
+// Runs a batch of main-thread steps (what a shared request fans out to).
+inline void runSteps(std::vector<MainStep>& steps) {
+    for (auto& step : steps) {
+        if (step) step();
+    }
+}
+
 inline void dispatchOwned(
     geode::async::TaskHolder<geode::utils::web::WebResponse>& owner,
     geode::utils::web::WebRequest&& req,
@@ -65,7 +262,7 @@ inline void dispatchOwned(
     auto safeCb = std::make_shared<decltype(cb)>(std::move(cb));
     owner.spawn("Paimbnails WebRequest", std::move(future), [safeCb](geode::utils::web::WebResponse res) {
         if (safeCb && *safeCb) {
-            (*safeCb)(std::move(res));
+            detail::timeOnMain(Delivery::Inline, [&] { (*safeCb)(std::move(res)); });
         }
     });
 }
@@ -0,0 +1,44 @@
+#include "features/thumbnails/services/LevelColorsScan.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace paimon::colors;
+
+namespace {
+int failures = 0;
+
+void check(bool ok, char const* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FALLO: %s\n", what);
+        failures++;
+    }
+}
+} // namespace
+
+int main() {
+    constexpr uint64_t OLD_REV = 0x1111;
+    constexpr uint64_t NEW_REV = 0x2222;
+
+    // misma revision con colores: nada que hacer
+    check(planScan(ScanMark{OLD_REV, false}, OLD_REV, true) == ScanAction::Skip, "misma revision con colores");
+    // misma revision que fallo: no se reintenta
+    check(planScan(ScanMark{OLD_REV, true}, OLD_REV, false) == ScanAction::Skip, "misma revision fallida");
+    // sin checkpoint pero con colores de una carga normal: se adoptan
+    check(planScan(std::nullopt, NEW_REV, true) == ScanAction::Adopt, "adoptar colores sin marca");
+    check(planScan(std::nullopt, NEW_REV, false) == ScanAction::Extract, "nivel nuevo");
+
+    // miniatura re-subida: los colores guardados son de la version vieja
+    auto action = planScan(ScanMark{OLD_REV, false}, NEW_REV, true);
+    check(action == ScanAction::Recompute, "revision cambiada -> Recompute");
+    check(!reuseStoredPair(action, true), "Recompute no reutiliza el par viejo");
+    // tambien si la revision vieja habia fallado
+    check(planScan(ScanMark{OLD_REV, true}, NEW_REV, false) == ScanAction::Recompute, "revision cambiada tras fallo");
+
+    // Extract si reutiliza lo que otra carga guardo mientras esperaba en la cola
+    check(reuseStoredPair(ScanAction::Extract, true), "Extract reutiliza un par nuevo");
+    check(!reuseStoredPair(ScanAction::Extract, false), "Extract sin par decodifica");
+
+    if (failures) return EXIT_FAILURE;
+    std::puts("LevelColorsScan: ok");
+    return EXIT_SUCCESS;
+}